@@ -503,6 +503,752 @@ namespace FloatVectorHelpers
     };
    #endif
 
+    //==============================================================================
+    /*  The transcendental and reduction kernels below are written once against an
+        "Ops" interface and use the widest registers the target has: AVX2 when the
+        compiler targets it, otherwise SSE2, or NEON on 64-bit ARM (which also has
+        double lanes, and is used on Apple targets where everything else goes through
+        vDSP). ScalarKernelOps implements the same interface on single values. It is
+        the fallback, and it handles the loop tails, so every element of a vector
+        goes through the same arithmetic wherever it sits.
+    */
+   #if JUCE_USE_SSE_INTRINSICS && defined (__AVX2__)
+    #define JUCE_FVO_KERNELS_AVX2 1
+   #elif JUCE_USE_SSE_INTRINSICS
+    #define JUCE_FVO_KERNELS_SSE 1
+   #elif JUCE_64BIT && (defined (__ARM_NEON) || defined (_M_ARM64))
+    #define JUCE_FVO_KERNELS_NEON 1
+   #endif
+
+    template <typename FloatType> struct KernelConstants;
+
+    template <>
+    struct KernelConstants<float>
+    {
+        using Bits = uint32;
+
+        static constexpr Bits  signBits            = 0x80000000;
+        static constexpr Bits  mantissaBits        = 0x007fffff;
+        static constexpr Bits  oneBits             = 0x3f800000;
+        static constexpr Bits  mantissaOffsetBits  = 0x4b000000;   // 2^23
+        static constexpr float mantissaOffset      = 8388608.0f;   // 2^23
+        static constexpr float exponentMagic       = 8388735.0f;   // 2^23 + 127, puts an integer into the exponent field
+        static constexpr float roundingMagic       = 12582912.0f;  // 1.5 * 2^23
+        static constexpr float exponentBias        = 127.0f;
+        static constexpr float minNormal           = 1.17549435e-38f;
+        static constexpr float subnormalScale      = 33554432.0f;  // 2^25
+        static constexpr float subnormalExponent   = 25.0f;
+        static constexpr float ln2Hi               = 0.693359375f;
+        static constexpr float ln2Lo               = -2.12194440e-4f;
+        static constexpr float log2e               = 1.44269504f;
+        static constexpr float sqrt2               = 1.41421356f;
+        static constexpr float expMin              = -104.0f;      // exp underflows to 0 below this
+        static constexpr float expMax              = 89.0f;        // and overflows to infinity above it
+        static constexpr float tanhMax             = 10.0f;        // tanh rounds to 1 above this
+        static constexpr Bits  splitBits           = 0xfffff000;   // keeps the top 12 significant bits
+        static constexpr float nepersPerDecibelHi  = 0.115142822265625f;   // ln (10) / 20 in 12 bits
+        static constexpr float nepersPerDecibelLo  = -1.35676155e-5f;
+
+        // expm1 (r) = r + r^2 * (1/2! + r * (1/3! + ...)) for |r| <= log (2) / 2
+        static constexpr float expCoefficients[] = { 1.0f / 2.0f, 1.0f / 6.0f, 1.0f / 24.0f, 1.0f / 120.0f,
+                                                     1.0f / 720.0f, 1.0f / 5040.0f };
+
+        // log (m) = 2s + 2s * s^2 * (1/3 + s^2 * (1/5 + ...)) with s = (m - 1) / (m + 1)
+        static constexpr float logCoefficients[] = { 1.0f / 3.0f, 1.0f / 5.0f, 1.0f / 7.0f, 1.0f / 9.0f };
+    };
+
+    template <>
+    struct KernelConstants<double>
+    {
+        using Bits = uint64;
+
+        static constexpr Bits   signBits           = 0x8000000000000000ULL;
+        static constexpr Bits   mantissaBits       = 0x000fffffffffffffULL;
+        static constexpr Bits   oneBits            = 0x3ff0000000000000ULL;
+        static constexpr Bits   mantissaOffsetBits = 0x4330000000000000ULL;   // 2^52
+        static constexpr double mantissaOffset     = 4503599627370496.0;      // 2^52
+        static constexpr double exponentMagic      = 4503599627371519.0;      // 2^52 + 1023
+        static constexpr double roundingMagic      = 6755399441055744.0;      // 1.5 * 2^52
+        static constexpr double exponentBias       = 1023.0;
+        static constexpr double minNormal          = 2.2250738585072014e-308;
+        static constexpr double subnormalScale     = 18014398509481984.0;     // 2^54
+        static constexpr double subnormalExponent  = 54.0;
+        static constexpr double ln2Hi              = 6.93147180369123816490e-01;
+        static constexpr double ln2Lo              = 1.90821492927058770002e-10;
+        static constexpr double log2e              = 1.4426950408889634;
+        static constexpr double sqrt2              = 1.4142135623730951;
+        static constexpr double expMin             = -746.0;
+        static constexpr double expMax             = 710.0;
+        static constexpr double tanhMax            = 20.0;
+        static constexpr Bits   splitBits          = 0xfffffffff8000000ULL;   // keeps the top 27 significant bits
+        static constexpr double nepersPerDecibelHi = 0.115129254758358;       // ln (10) / 20 in 26 bits
+        static constexpr double nepersPerDecibelLo = -1.086557175080848e-10;
+
+        static constexpr double expCoefficients[] = { 1.0 / 2.0, 1.0 / 6.0, 1.0 / 24.0, 1.0 / 120.0, 1.0 / 720.0,
+                                                      1.0 / 5040.0, 1.0 / 40320.0, 1.0 / 362880.0, 1.0 / 3628800.0,
+                                                      1.0 / 39916800.0, 1.0 / 479001600.0, 1.0 / 6227020800.0 };
+
+        static constexpr double logCoefficients[] = { 1.0 / 3.0, 1.0 / 5.0, 1.0 / 7.0, 1.0 / 9.0, 1.0 / 11.0,
+                                                      1.0 / 13.0, 1.0 / 15.0, 1.0 / 17.0, 1.0 / 19.0 };
+    };
+
+    //==============================================================================
+    template <typename FloatType>
+    struct ScalarKernelOps
+    {
+        using Type = FloatType;
+        using Vec = FloatType;
+        using Mask = bool;
+        using Bits = typename KernelConstants<FloatType>::Bits;
+        using IndexType = Bits;
+        using Index = Bits;
+        static constexpr int numParallel = 1;
+        static constexpr int numMantissaBits = sizeof (FloatType) == 4 ? 23 : 52;
+
+        static forcedinline Bits toBits (Vec v) noexcept                    { Bits b; memcpy (&b, &v, sizeof (b)); return b; }
+        static forcedinline Vec fromBits (Bits b) noexcept                  { Vec v; memcpy (&v, &b, sizeof (v)); return v; }
+
+        static forcedinline Vec load (const Type* p) noexcept               { return *p; }
+        static forcedinline void store (Type* p, Vec v) noexcept            { *p = v; }
+        static forcedinline Vec broadcast (Type v) noexcept                 { return v; }
+
+        static forcedinline Vec add (Vec a, Vec b) noexcept                 { return a + b; }
+        static forcedinline Vec sub (Vec a, Vec b) noexcept                 { return a - b; }
+        static forcedinline Vec mul (Vec a, Vec b) noexcept                 { return a * b; }
+        static forcedinline Vec div (Vec a, Vec b) noexcept                 { return a / b; }
+        static forcedinline Vec min (Vec a, Vec b) noexcept                 { return a < b ? a : b; }
+        static forcedinline Vec max (Vec a, Vec b) noexcept                 { return a > b ? a : b; }
+
+        // The accumulator a never holds a NaN, so these skip NaNs in b
+        static forcedinline Vec minNumber (Vec a, Vec b) noexcept           { return b < a ? b : a; }
+        static forcedinline Vec maxNumber (Vec a, Vec b) noexcept           { return b > a ? b : a; }
+
+        static forcedinline Vec bitAnd (Vec a, Vec b) noexcept              { return fromBits (toBits (a) & toBits (b)); }
+        static forcedinline Vec bitOr (Vec a, Vec b) noexcept               { return fromBits (toBits (a) | toBits (b)); }
+        static forcedinline Vec shiftIntoExponent (Vec v) noexcept          { return fromBits (toBits (v) << numMantissaBits); }
+        static forcedinline Vec shiftOutOfExponent (Vec v) noexcept         { return fromBits (toBits (v) >> numMantissaBits); }
+
+        static forcedinline Mask lessThan (Vec a, Vec b) noexcept           { return a < b; }
+        static forcedinline Mask greaterThan (Vec a, Vec b) noexcept        { return a > b; }
+        static forcedinline Mask greaterOrEqual (Vec a, Vec b) noexcept     { return a >= b; }
+        static forcedinline Mask equal (Vec a, Vec b) noexcept              { return exactlyEqual (a, b); }
+        static forcedinline Vec select (Mask m, Vec a, Vec b) noexcept      { return m ? a : b; }
+
+        static forcedinline Index indexInit() noexcept                      { return 0; }
+        static forcedinline Index indexBroadcast (IndexType i) noexcept     { return i; }
+        static forcedinline Index indexAdd (Index a, Index b) noexcept      { return a + b; }
+        static forcedinline Index indexSelect (Mask m, Index a, Index b) noexcept { return m ? a : b; }
+        static forcedinline void indexStore (IndexType* p, Index i) noexcept { *p = i; }
+    };
+
+    template <typename FloatType>
+    struct KernelOps : public ScalarKernelOps<FloatType> {};
+
+   #if JUCE_FVO_KERNELS_AVX2
+    template <>
+    struct KernelOps<float>
+    {
+        using Type = float;
+        using Vec = __m256;
+        using Mask = __m256;
+        using Bits = uint32;
+        using IndexType = uint32;
+        using Index = __m256i;
+        static constexpr int numParallel = 8;
+
+        static forcedinline Vec load (const Type* p) noexcept               { return _mm256_loadu_ps (p); }
+        static forcedinline void store (Type* p, Vec v) noexcept            { _mm256_storeu_ps (p, v); }
+        static forcedinline Vec broadcast (Type v) noexcept                 { return _mm256_set1_ps (v); }
+        static forcedinline Vec fromBits (Bits b) noexcept                  { return _mm256_castsi256_ps (_mm256_set1_epi32 ((int) b)); }
+
+        static forcedinline Vec add (Vec a, Vec b) noexcept                 { return _mm256_add_ps (a, b); }
+        static forcedinline Vec sub (Vec a, Vec b) noexcept                 { return _mm256_sub_ps (a, b); }
+        static forcedinline Vec mul (Vec a, Vec b) noexcept                 { return _mm256_mul_ps (a, b); }
+        static forcedinline Vec div (Vec a, Vec b) noexcept                 { return _mm256_div_ps (a, b); }
+        static forcedinline Vec min (Vec a, Vec b) noexcept                 { return _mm256_min_ps (a, b); }
+        static forcedinline Vec max (Vec a, Vec b) noexcept                 { return _mm256_max_ps (a, b); }
+        static forcedinline Vec minNumber (Vec a, Vec b) noexcept           { return _mm256_min_ps (b, a); }
+        static forcedinline Vec maxNumber (Vec a, Vec b) noexcept           { return _mm256_max_ps (b, a); }
+
+        static forcedinline Vec bitAnd (Vec a, Vec b) noexcept              { return _mm256_and_ps (a, b); }
+        static forcedinline Vec bitOr (Vec a, Vec b) noexcept               { return _mm256_or_ps (a, b); }
+        static forcedinline Vec shiftIntoExponent (Vec v) noexcept          { return _mm256_castsi256_ps (_mm256_slli_epi32 (_mm256_castps_si256 (v), 23)); }
+        static forcedinline Vec shiftOutOfExponent (Vec v) noexcept         { return _mm256_castsi256_ps (_mm256_srli_epi32 (_mm256_castps_si256 (v), 23)); }
+
+        static forcedinline Mask lessThan (Vec a, Vec b) noexcept           { return _mm256_cmp_ps (a, b, _CMP_LT_OQ); }
+        static forcedinline Mask greaterThan (Vec a, Vec b) noexcept        { return _mm256_cmp_ps (a, b, _CMP_GT_OQ); }
+        static forcedinline Mask greaterOrEqual (Vec a, Vec b) noexcept     { return _mm256_cmp_ps (a, b, _CMP_GE_OQ); }
+        static forcedinline Mask equal (Vec a, Vec b) noexcept              { return _mm256_cmp_ps (a, b, _CMP_EQ_OQ); }
+        static forcedinline Vec select (Mask m, Vec a, Vec b) noexcept      { return _mm256_blendv_ps (b, a, m); }
+
+        static forcedinline Index indexInit() noexcept                      { return _mm256_setr_epi32 (0, 1, 2, 3, 4, 5, 6, 7); }
+        static forcedinline Index indexBroadcast (IndexType i) noexcept     { return _mm256_set1_epi32 ((int) i); }
+        static forcedinline Index indexAdd (Index a, Index b) noexcept      { return _mm256_add_epi32 (a, b); }
+        static forcedinline Index indexSelect (Mask m, Index a, Index b) noexcept { return _mm256_blendv_epi8 (b, a, _mm256_castps_si256 (m)); }
+        static forcedinline void indexStore (IndexType* p, Index i) noexcept { _mm256_storeu_si256 (reinterpret_cast<__m256i*> (p), i); }
+    };
+
+    template <>
+    struct KernelOps<double>
+    {
+        using Type = double;
+        using Vec = __m256d;
+        using Mask = __m256d;
+        using Bits = uint64;
+        using IndexType = uint64;
+        using Index = __m256i;
+        static constexpr int numParallel = 4;
+
+        static forcedinline Vec load (const Type* p) noexcept               { return _mm256_loadu_pd (p); }
+        static forcedinline void store (Type* p, Vec v) noexcept            { _mm256_storeu_pd (p, v); }
+        static forcedinline Vec broadcast (Type v) noexcept                 { return _mm256_set1_pd (v); }
+        static forcedinline Vec fromBits (Bits b) noexcept                  { return _mm256_castsi256_pd (_mm256_set1_epi64x ((long long) b)); }
+
+        static forcedinline Vec add (Vec a, Vec b) noexcept                 { return _mm256_add_pd (a, b); }
+        static forcedinline Vec sub (Vec a, Vec b) noexcept                 { return _mm256_sub_pd (a, b); }
+        static forcedinline Vec mul (Vec a, Vec b) noexcept                 { return _mm256_mul_pd (a, b); }
+        static forcedinline Vec div (Vec a, Vec b) noexcept                 { return _mm256_div_pd (a, b); }
+        static forcedinline Vec min (Vec a, Vec b) noexcept                 { return _mm256_min_pd (a, b); }
+        static forcedinline Vec max (Vec a, Vec b) noexcept                 { return _mm256_max_pd (a, b); }
+        static forcedinline Vec minNumber (Vec a, Vec b) noexcept           { return _mm256_min_pd (b, a); }
+        static forcedinline Vec maxNumber (Vec a, Vec b) noexcept           { return _mm256_max_pd (b, a); }
+
+        static forcedinline Vec bitAnd (Vec a, Vec b) noexcept              { return _mm256_and_pd (a, b); }
+        static forcedinline Vec bitOr (Vec a, Vec b) noexcept               { return _mm256_or_pd (a, b); }
+        static forcedinline Vec shiftIntoExponent (Vec v) noexcept          { return _mm256_castsi256_pd (_mm256_slli_epi64 (_mm256_castpd_si256 (v), 52)); }
+        static forcedinline Vec shiftOutOfExponent (Vec v) noexcept         { return _mm256_castsi256_pd (_mm256_srli_epi64 (_mm256_castpd_si256 (v), 52)); }
+
+        static forcedinline Mask lessThan (Vec a, Vec b) noexcept           { return _mm256_cmp_pd (a, b, _CMP_LT_OQ); }
+        static forcedinline Mask greaterThan (Vec a, Vec b) noexcept        { return _mm256_cmp_pd (a, b, _CMP_GT_OQ); }
+        static forcedinline Mask greaterOrEqual (Vec a, Vec b) noexcept     { return _mm256_cmp_pd (a, b, _CMP_GE_OQ); }
+        static forcedinline Mask equal (Vec a, Vec b) noexcept              { return _mm256_cmp_pd (a, b, _CMP_EQ_OQ); }
+        static forcedinline Vec select (Mask m, Vec a, Vec b) noexcept      { return _mm256_blendv_pd (b, a, m); }
+
+        static forcedinline Index indexInit() noexcept                      { return _mm256_setr_epi64x (0, 1, 2, 3); }
+        static forcedinline Index indexBroadcast (IndexType i) noexcept     { return _mm256_set1_epi64x ((long long) i); }
+        static forcedinline Index indexAdd (Index a, Index b) noexcept      { return _mm256_add_epi64 (a, b); }
+        static forcedinline Index indexSelect (Mask m, Index a, Index b) noexcept { return _mm256_blendv_epi8 (b, a, _mm256_castpd_si256 (m)); }
+        static forcedinline void indexStore (IndexType* p, Index i) noexcept { _mm256_storeu_si256 (reinterpret_cast<__m256i*> (p), i); }
+    };
+
+   #elif JUCE_FVO_KERNELS_SSE
+    template <>
+    struct KernelOps<float>
+    {
+        using Type = float;
+        using Vec = __m128;
+        using Mask = __m128;
+        using Bits = uint32;
+        using IndexType = uint32;
+        using Index = __m128i;
+        static constexpr int numParallel = 4;
+
+        static forcedinline Vec load (const Type* p) noexcept               { return _mm_loadu_ps (p); }
+        static forcedinline void store (Type* p, Vec v) noexcept            { _mm_storeu_ps (p, v); }
+        static forcedinline Vec broadcast (Type v) noexcept                 { return _mm_set1_ps (v); }
+        static forcedinline Vec fromBits (Bits b) noexcept                  { return _mm_castsi128_ps (_mm_set1_epi32 ((int) b)); }
+
+        static forcedinline Vec add (Vec a, Vec b) noexcept                 { return _mm_add_ps (a, b); }
+        static forcedinline Vec sub (Vec a, Vec b) noexcept                 { return _mm_sub_ps (a, b); }
+        static forcedinline Vec mul (Vec a, Vec b) noexcept                 { return _mm_mul_ps (a, b); }
+        static forcedinline Vec div (Vec a, Vec b) noexcept                 { return _mm_div_ps (a, b); }
+        static forcedinline Vec min (Vec a, Vec b) noexcept                 { return _mm_min_ps (a, b); }
+        static forcedinline Vec max (Vec a, Vec b) noexcept                 { return _mm_max_ps (a, b); }
+        static forcedinline Vec minNumber (Vec a, Vec b) noexcept           { return _mm_min_ps (b, a); }
+        static forcedinline Vec maxNumber (Vec a, Vec b) noexcept           { return _mm_max_ps (b, a); }
+
+        static forcedinline Vec bitAnd (Vec a, Vec b) noexcept              { return _mm_and_ps (a, b); }
+        static forcedinline Vec bitOr (Vec a, Vec b) noexcept               { return _mm_or_ps (a, b); }
+        static forcedinline Vec shiftIntoExponent (Vec v) noexcept          { return _mm_castsi128_ps (_mm_slli_epi32 (_mm_castps_si128 (v), 23)); }
+        static forcedinline Vec shiftOutOfExponent (Vec v) noexcept         { return _mm_castsi128_ps (_mm_srli_epi32 (_mm_castps_si128 (v), 23)); }
+
+        static forcedinline Mask lessThan (Vec a, Vec b) noexcept           { return _mm_cmplt_ps (a, b); }
+        static forcedinline Mask greaterThan (Vec a, Vec b) noexcept        { return _mm_cmpgt_ps (a, b); }
+        static forcedinline Mask greaterOrEqual (Vec a, Vec b) noexcept     { return _mm_cmpge_ps (a, b); }
+        static forcedinline Mask equal (Vec a, Vec b) noexcept              { return _mm_cmpeq_ps (a, b); }
+        static forcedinline Vec select (Mask m, Vec a, Vec b) noexcept      { return _mm_or_ps (_mm_and_ps (m, a), _mm_andnot_ps (m, b)); }
+
+        static forcedinline Index indexInit() noexcept                      { return _mm_setr_epi32 (0, 1, 2, 3); }
+        static forcedinline Index indexBroadcast (IndexType i) noexcept     { return _mm_set1_epi32 ((int) i); }
+        static forcedinline Index indexAdd (Index a, Index b) noexcept      { return _mm_add_epi32 (a, b); }
+
+        static forcedinline Index indexSelect (Mask m, Index a, Index b) noexcept
+        {
+            const auto mi = _mm_castps_si128 (m);
+            return _mm_or_si128 (_mm_and_si128 (mi, a), _mm_andnot_si128 (mi, b));
+        }
+
+        static forcedinline void indexStore (IndexType* p, Index i) noexcept { _mm_storeu_si128 (reinterpret_cast<__m128i*> (p), i); }
+    };
+
+    template <>
+    struct KernelOps<double>
+    {
+        using Type = double;
+        using Vec = __m128d;
+        using Mask = __m128d;
+        using Bits = uint64;
+        using IndexType = uint64;
+        using Index = __m128i;
+        static constexpr int numParallel = 2;
+
+        static forcedinline Vec load (const Type* p) noexcept               { return _mm_loadu_pd (p); }
+        static forcedinline void store (Type* p, Vec v) noexcept            { _mm_storeu_pd (p, v); }
+        static forcedinline Vec broadcast (Type v) noexcept                 { return _mm_set1_pd (v); }
+        static forcedinline Vec fromBits (Bits b) noexcept                  { return _mm_castsi128_pd (_mm_set1_epi64x ((long long) b)); }
+
+        static forcedinline Vec add (Vec a, Vec b) noexcept                 { return _mm_add_pd (a, b); }
+        static forcedinline Vec sub (Vec a, Vec b) noexcept                 { return _mm_sub_pd (a, b); }
+        static forcedinline Vec mul (Vec a, Vec b) noexcept                 { return _mm_mul_pd (a, b); }
+        static forcedinline Vec div (Vec a, Vec b) noexcept                 { return _mm_div_pd (a, b); }
+        static forcedinline Vec min (Vec a, Vec b) noexcept                 { return _mm_min_pd (a, b); }
+        static forcedinline Vec max (Vec a, Vec b) noexcept                 { return _mm_max_pd (a, b); }
+        static forcedinline Vec minNumber (Vec a, Vec b) noexcept           { return _mm_min_pd (b, a); }
+        static forcedinline Vec maxNumber (Vec a, Vec b) noexcept           { return _mm_max_pd (b, a); }
+
+        static forcedinline Vec bitAnd (Vec a, Vec b) noexcept              { return _mm_and_pd (a, b); }
+        static forcedinline Vec bitOr (Vec a, Vec b) noexcept               { return _mm_or_pd (a, b); }
+        static forcedinline Vec shiftIntoExponent (Vec v) noexcept          { return _mm_castsi128_pd (_mm_slli_epi64 (_mm_castpd_si128 (v), 52)); }
+        static forcedinline Vec shiftOutOfExponent (Vec v) noexcept         { return _mm_castsi128_pd (_mm_srli_epi64 (_mm_castpd_si128 (v), 52)); }
+
+        static forcedinline Mask lessThan (Vec a, Vec b) noexcept           { return _mm_cmplt_pd (a, b); }
+        static forcedinline Mask greaterThan (Vec a, Vec b) noexcept        { return _mm_cmpgt_pd (a, b); }
+        static forcedinline Mask greaterOrEqual (Vec a, Vec b) noexcept     { return _mm_cmpge_pd (a, b); }
+        static forcedinline Mask equal (Vec a, Vec b) noexcept              { return _mm_cmpeq_pd (a, b); }
+        static forcedinline Vec select (Mask m, Vec a, Vec b) noexcept      { return _mm_or_pd (_mm_and_pd (m, a), _mm_andnot_pd (m, b)); }
+
+        static forcedinline Index indexInit() noexcept                      { return _mm_set_epi64x (1, 0); }
+        static forcedinline Index indexBroadcast (IndexType i) noexcept     { return _mm_set1_epi64x ((long long) i); }
+        static forcedinline Index indexAdd (Index a, Index b) noexcept      { return _mm_add_epi64 (a, b); }
+
+        static forcedinline Index indexSelect (Mask m, Index a, Index b) noexcept
+        {
+            const auto mi = _mm_castpd_si128 (m);
+            return _mm_or_si128 (_mm_and_si128 (mi, a), _mm_andnot_si128 (mi, b));
+        }
+
+        static forcedinline void indexStore (IndexType* p, Index i) noexcept { _mm_storeu_si128 (reinterpret_cast<__m128i*> (p), i); }
+    };
+
+   #elif JUCE_FVO_KERNELS_NEON
+    template <>
+    struct KernelOps<float>
+    {
+        using Type = float;
+        using Vec = float32x4_t;
+        using Mask = uint32x4_t;
+        using Bits = uint32;
+        using IndexType = uint32;
+        using Index = uint32x4_t;
+        static constexpr int numParallel = 4;
+
+        static forcedinline Vec load (const Type* p) noexcept               { return vld1q_f32 (p); }
+        static forcedinline void store (Type* p, Vec v) noexcept            { vst1q_f32 (p, v); }
+        static forcedinline Vec broadcast (Type v) noexcept                 { return vdupq_n_f32 (v); }
+        static forcedinline Vec fromBits (Bits b) noexcept                  { return vreinterpretq_f32_u32 (vdupq_n_u32 (b)); }
+
+        static forcedinline Vec add (Vec a, Vec b) noexcept                 { return vaddq_f32 (a, b); }
+        static forcedinline Vec sub (Vec a, Vec b) noexcept                 { return vsubq_f32 (a, b); }
+        static forcedinline Vec mul (Vec a, Vec b) noexcept                 { return vmulq_f32 (a, b); }
+        static forcedinline Vec div (Vec a, Vec b) noexcept                 { return vdivq_f32 (a, b); }
+        static forcedinline Vec min (Vec a, Vec b) noexcept                 { return vminq_f32 (a, b); }
+        static forcedinline Vec max (Vec a, Vec b) noexcept                 { return vmaxq_f32 (a, b); }
+        static forcedinline Vec minNumber (Vec a, Vec b) noexcept           { return vminnmq_f32 (a, b); }
+        static forcedinline Vec maxNumber (Vec a, Vec b) noexcept           { return vmaxnmq_f32 (a, b); }
+
+        static forcedinline Vec bitAnd (Vec a, Vec b) noexcept              { return vreinterpretq_f32_u32 (vandq_u32 (vreinterpretq_u32_f32 (a), vreinterpretq_u32_f32 (b))); }
+        static forcedinline Vec bitOr (Vec a, Vec b) noexcept               { return vreinterpretq_f32_u32 (vorrq_u32 (vreinterpretq_u32_f32 (a), vreinterpretq_u32_f32 (b))); }
+        static forcedinline Vec shiftIntoExponent (Vec v) noexcept          { return vreinterpretq_f32_u32 (vshlq_n_u32 (vreinterpretq_u32_f32 (v), 23)); }
+        static forcedinline Vec shiftOutOfExponent (Vec v) noexcept         { return vreinterpretq_f32_u32 (vshrq_n_u32 (vreinterpretq_u32_f32 (v), 23)); }
+
+        static forcedinline Mask lessThan (Vec a, Vec b) noexcept           { return vcltq_f32 (a, b); }
+        static forcedinline Mask greaterThan (Vec a, Vec b) noexcept        { return vcgtq_f32 (a, b); }
+        static forcedinline Mask greaterOrEqual (Vec a, Vec b) noexcept     { return vcgeq_f32 (a, b); }
+        static forcedinline Mask equal (Vec a, Vec b) noexcept              { return vceqq_f32 (a, b); }
+        static forcedinline Vec select (Mask m, Vec a, Vec b) noexcept      { return vbslq_f32 (m, a, b); }
+
+        static forcedinline Index indexInit() noexcept                      { const uint32 i[] = { 0, 1, 2, 3 }; return vld1q_u32 (i); }
+        static forcedinline Index indexBroadcast (IndexType i) noexcept     { return vdupq_n_u32 (i); }
+        static forcedinline Index indexAdd (Index a, Index b) noexcept      { return vaddq_u32 (a, b); }
+        static forcedinline Index indexSelect (Mask m, Index a, Index b) noexcept { return vbslq_u32 (m, a, b); }
+        static forcedinline void indexStore (IndexType* p, Index i) noexcept { vst1q_u32 (p, i); }
+    };
+
+    template <>
+    struct KernelOps<double>
+    {
+        using Type = double;
+        using Vec = float64x2_t;
+        using Mask = uint64x2_t;
+        using Bits = uint64;
+        using IndexType = uint64;
+        using Index = uint64x2_t;
+        static constexpr int numParallel = 2;
+
+        static forcedinline Vec load (const Type* p) noexcept               { return vld1q_f64 (p); }
+        static forcedinline void store (Type* p, Vec v) noexcept            { vst1q_f64 (p, v); }
+        static forcedinline Vec broadcast (Type v) noexcept                 { return vdupq_n_f64 (v); }
+        static forcedinline Vec fromBits (Bits b) noexcept                  { return vreinterpretq_f64_u64 (vdupq_n_u64 (b)); }
+
+        static forcedinline Vec add (Vec a, Vec b) noexcept                 { return vaddq_f64 (a, b); }
+        static forcedinline Vec sub (Vec a, Vec b) noexcept                 { return vsubq_f64 (a, b); }
+        static forcedinline Vec mul (Vec a, Vec b) noexcept                 { return vmulq_f64 (a, b); }
+        static forcedinline Vec div (Vec a, Vec b) noexcept                 { return vdivq_f64 (a, b); }
+        static forcedinline Vec min (Vec a, Vec b) noexcept                 { return vminq_f64 (a, b); }
+        static forcedinline Vec max (Vec a, Vec b) noexcept                 { return vmaxq_f64 (a, b); }
+        static forcedinline Vec minNumber (Vec a, Vec b) noexcept           { return vminnmq_f64 (a, b); }
+        static forcedinline Vec maxNumber (Vec a, Vec b) noexcept           { return vmaxnmq_f64 (a, b); }
+
+        static forcedinline Vec bitAnd (Vec a, Vec b) noexcept              { return vreinterpretq_f64_u64 (vandq_u64 (vreinterpretq_u64_f64 (a), vreinterpretq_u64_f64 (b))); }
+        static forcedinline Vec bitOr (Vec a, Vec b) noexcept               { return vreinterpretq_f64_u64 (vorrq_u64 (vreinterpretq_u64_f64 (a), vreinterpretq_u64_f64 (b))); }
+        static forcedinline Vec shiftIntoExponent (Vec v) noexcept          { return vreinterpretq_f64_u64 (vshlq_n_u64 (vreinterpretq_u64_f64 (v), 52)); }
+        static forcedinline Vec shiftOutOfExponent (Vec v) noexcept         { return vreinterpretq_f64_u64 (vshrq_n_u64 (vreinterpretq_u64_f64 (v), 52)); }
+
+        static forcedinline Mask lessThan (Vec a, Vec b) noexcept           { return vcltq_f64 (a, b); }
+        static forcedinline Mask greaterThan (Vec a, Vec b) noexcept        { return vcgtq_f64 (a, b); }
+        static forcedinline Mask greaterOrEqual (Vec a, Vec b) noexcept     { return vcgeq_f64 (a, b); }
+        static forcedinline Mask equal (Vec a, Vec b) noexcept              { return vceqq_f64 (a, b); }
+        static forcedinline Vec select (Mask m, Vec a, Vec b) noexcept      { return vbslq_f64 (m, a, b); }
+
+        static forcedinline Index indexInit() noexcept                      { const uint64 i[] = { 0, 1 }; return vld1q_u64 (i); }
+        static forcedinline Index indexBroadcast (IndexType i) noexcept     { return vdupq_n_u64 (i); }
+        static forcedinline Index indexAdd (Index a, Index b) noexcept      { return vaddq_u64 (a, b); }
+        static forcedinline Index indexSelect (Mask m, Index a, Index b) noexcept { return vbslq_u64 (m, a, b); }
+        static forcedinline void indexStore (IndexType* p, Index i) noexcept { vst1q_u64 (p, i); }
+    };
+   #endif
+
+    //==============================================================================
+    template <typename Ops>
+    struct VectorMath
+    {
+        using Type = typename Ops::Type;
+        using Vec = typename Ops::Vec;
+        using Constants = KernelConstants<Type>;
+
+        static forcedinline Vec constant (Type v) noexcept  { return Ops::broadcast (v); }
+
+        template <size_t numCoefficients>
+        static forcedinline Vec polynomial (Vec x, const Type (&coefficients)[numCoefficients]) noexcept
+        {
+            auto result = constant (coefficients[numCoefficients - 1]);
+
+            for (auto i = numCoefficients - 1; i > 0; --i)
+                result = Ops::add (Ops::mul (result, x), constant (coefficients[i - 1]));
+
+            return result;
+        }
+
+        // Nearest integer, for |x| < 2^22
+        static forcedinline Vec roundToInteger (Vec x) noexcept
+        {
+            return Ops::sub (Ops::add (x, constant (Constants::roundingMagic)), constant (Constants::roundingMagic));
+        }
+
+        // 2^n for an integer n in the normal exponent range
+        static forcedinline Vec exponentToScale (Vec n) noexcept
+        {
+            return Ops::shiftIntoExponent (Ops::add (n, constant (Constants::exponentMagic)));
+        }
+
+        static forcedinline Vec passNaN (Vec x, Vec result) noexcept
+        {
+            return Ops::select (Ops::equal (x, x), result, x);
+        }
+
+        // Splits x + correction into n * log (2) + r with |r| <= log (2) / 2, and returns e^r - 1
+        static forcedinline Vec expm1Reduced (Vec x, Vec correction, Vec& n) noexcept
+        {
+            n = roundToInteger (Ops::mul (x, constant (Constants::log2e)));
+
+            const auto r = Ops::add (Ops::sub (Ops::sub (x, Ops::mul (n, constant (Constants::ln2Hi))),
+                                               Ops::mul (n, constant (Constants::ln2Lo))),
+                                     correction);
+
+            return Ops::add (r, Ops::mul (Ops::mul (r, r), polynomial (r, Constants::expCoefficients)));
+        }
+
+        static forcedinline Vec exp (Vec x) noexcept
+        {
+            return exp (x, constant (0));
+        }
+
+        // e^(x + correction), for a correction far smaller than x
+        static forcedinline Vec exp (Vec x, Vec correction) noexcept
+        {
+            const auto clamped = Ops::min (Ops::max (x, constant (Constants::expMin)), constant (Constants::expMax));
+
+            Vec n;
+            const auto p = Ops::add (expm1Reduced (clamped, correction, n), constant (1));
+
+            // 2^n in two halves, so that overflow, underflow and subnormal results come
+            // out of the final multiplications rather than from an out-of-range exponent
+            const auto n1 = roundToInteger (Ops::sub (Ops::mul (n, constant ((Type) 0.5)), constant ((Type) 0.25)));
+            const auto n2 = Ops::sub (n, n1);
+
+            return passNaN (x, Ops::mul (Ops::mul (p, exponentToScale (n1)), exponentToScale (n2)));
+        }
+
+        static forcedinline Vec tanh (Vec x) noexcept
+        {
+            const auto signBits = Ops::bitAnd (x, Ops::fromBits (Constants::signBits));
+            const auto magnitude = Ops::min (Ops::bitAnd (x, Ops::fromBits (~Constants::signBits)), constant (Constants::tanhMax));
+            const auto twice = Ops::add (magnitude, magnitude);
+
+            // tanh |x| = (e^2|x| - 1) / (e^2|x| + 1), with e^2|x| - 1 = 2^n (e^r - 1) + (2^n - 1)
+            // so that there is no cancellation for small |x|
+            Vec n;
+            const auto pm1 = expm1Reduced (twice, constant (0), n);
+            const auto scale = exponentToScale (n);
+            const auto em1 = Ops::add (Ops::mul (pm1, scale), Ops::sub (scale, constant (1)));
+            const auto result = Ops::div (em1, Ops::add (em1, constant (2)));
+
+            return passNaN (x, Ops::bitOr (result, signBits));
+        }
+
+        static forcedinline Vec log (Vec x) noexcept
+        {
+            const auto zero = constant (0);
+            const auto one = constant (1);
+
+            // Subnormals are scaled into the normal range first
+            const auto isSubnormal = Ops::lessThan (x, constant (Constants::minNormal));
+            const auto scaled = Ops::select (isSubnormal, Ops::mul (x, constant (Constants::subnormalScale)), x);
+            const auto bias = Ops::select (isSubnormal, constant (Constants::exponentBias + Constants::subnormalExponent),
+                                                        constant (Constants::exponentBias));
+
+            // x = 2^e * m, with m in [sqrt (1/2), sqrt (2)]
+            auto e = Ops::sub (Ops::sub (Ops::bitOr (Ops::shiftOutOfExponent (scaled), Ops::fromBits (Constants::mantissaOffsetBits)),
+                                         constant (Constants::mantissaOffset)),
+                               bias);
+            auto m = Ops::bitOr (Ops::bitAnd (scaled, Ops::fromBits (Constants::mantissaBits)), Ops::fromBits (Constants::oneBits));
+
+            const auto isLarge = Ops::greaterThan (m, constant (Constants::sqrt2));
+            m = Ops::select (isLarge, Ops::mul (m, constant ((Type) 0.5)), m);
+            e = Ops::select (isLarge, Ops::add (e, one), e);
+
+            // log (1 + f) = 2s + s R (s^2) = f - (f^2 / 2 - s (f^2 / 2 + R)), which keeps f exact
+            const auto f = Ops::sub (m, one);
+            const auto s = Ops::div (f, Ops::add (f, constant (2)));
+            const auto s2 = Ops::mul (s, s);
+            const auto halfF2 = Ops::mul (Ops::mul (f, f), constant ((Type) 0.5));
+            const auto r = Ops::mul (Ops::add (s2, s2), polynomial (s2, Constants::logCoefficients));
+            const auto logM = Ops::sub (f, Ops::sub (halfF2, Ops::mul (s, Ops::add (halfF2, r))));
+
+            auto result = Ops::add (Ops::mul (e, constant (Constants::ln2Hi)),
+                                    Ops::add (Ops::mul (e, constant (Constants::ln2Lo)), logM));
+
+            result = Ops::select (Ops::equal (x, zero), constant (-std::numeric_limits<Type>::infinity()), result);
+            result = Ops::select (Ops::greaterOrEqual (x, zero), result, constant (std::numeric_limits<Type>::quiet_NaN()));
+            return Ops::select (Ops::equal (x, constant (std::numeric_limits<Type>::infinity())), x, result);
+        }
+
+        static forcedinline Vec log10 (Vec x) noexcept
+        {
+            return Ops::mul (log (x), constant ((Type) 0.43429448190325182765));
+        }
+
+        static forcedinline Vec logToDecibels (Vec x, Type decibelsPerNeper, Type minusInfinityDb) noexcept
+        {
+            const auto floor = constant (minusInfinityDb);
+            const auto decibels = Ops::max (Ops::mul (log (x), constant (decibelsPerNeper)), floor);
+            return Ops::select (Ops::greaterThan (x, constant (0)), decibels, floor);
+        }
+
+        static forcedinline Vec decibelsToGain (Vec x, Type minusInfinityDb) noexcept
+        {
+            const auto decibelsPerNeper = (Type) 8.6858896380650365530;
+            const auto clamped = Ops::min (Ops::max (x, constant (Constants::expMin * decibelsPerNeper)),
+                                           constant (Constants::expMax * decibelsPerNeper));
+
+            // The exponent, x ln (10) / 20, as a rounded product plus its rounding error.
+            // Otherwise exp would scale that error up by |x| ln (10) / 20.
+            const auto hi = constant (Constants::nepersPerDecibelHi);
+            const auto lo = constant (Constants::nepersPerDecibelLo);
+            const auto product = Ops::mul (clamped, constant ((Type) 0.11512925464970228420));
+            const auto clampedHi = Ops::bitAnd (clamped, Ops::fromBits (Constants::splitBits));
+            const auto clampedLo = Ops::sub (clamped, clampedHi);
+            const auto error = Ops::add (Ops::add (Ops::sub (Ops::mul (clampedHi, hi), product), Ops::mul (clampedLo, hi)),
+                                         Ops::mul (clamped, lo));
+
+            return Ops::select (Ops::greaterThan (x, constant (minusInfinityDb)), exp (product, error), constant (0));
+        }
+    };
+
+    // Applies fn (math, x) to each value, where math is a VectorMath for the registers x holds
+    template <typename FloatType, typename Size, typename Function>
+    static void transform (FloatType* dest, const FloatType* src, Size num, Function&& fn) noexcept
+    {
+        using Ops = KernelOps<FloatType>;
+        Size i = 0;
+
+        for (; i + Ops::numParallel <= num; i += Ops::numParallel)
+            Ops::store (dest + i, fn (VectorMath<Ops>(), Ops::load (src + i)));
+
+        for (; i < num; ++i)
+            dest[i] = fn (VectorMath<ScalarKernelOps<FloatType>>(), src[i]);
+    }
+
+    // Adds value to sum and accumulates the exact rounding error of that addition
+    // (Knuth's branch-free two-sum), which unlike plain Kahan summation stays exact
+    // when value is larger than the running sum
+    template <typename Ops>
+    static forcedinline void compensatedAdd (typename Ops::Vec& sum, typename Ops::Vec& compensation, typename Ops::Vec value) noexcept
+    {
+        const auto t = Ops::add (sum, value);
+        const auto valuePart = Ops::sub (t, sum);
+        const auto error = Ops::add (Ops::sub (sum, Ops::sub (t, valuePart)), Ops::sub (value, valuePart));
+        compensation = Ops::add (compensation, error);
+        sum = t;
+    }
+
+    // Compensated (Kahan-Babuska) summation of term (i), with two sets of accumulators
+    // in flight to hide the latency of the dependent additions
+    template <typename FloatType, typename Size, typename VectorTerm, typename ScalarTerm>
+    static FloatType compensatedSum (Size num, VectorTerm&& vectorTerm, ScalarTerm&& scalarTerm) noexcept
+    {
+        using Ops = KernelOps<FloatType>;
+        using Scalar = ScalarKernelOps<FloatType>;
+        constexpr auto step = (Size) Ops::numParallel;
+
+        auto sum1 = Ops::broadcast (0), sum2 = sum1, compensation1 = sum1, compensation2 = sum1;
+        Size i = 0;
+
+        for (; i + 2 * step <= num; i += 2 * step)
+        {
+            compensatedAdd<Ops> (sum1, compensation1, vectorTerm (i));
+            compensatedAdd<Ops> (sum2, compensation2, vectorTerm (i + step));
+        }
+
+        for (; i + step <= num; i += step)
+            compensatedAdd<Ops> (sum1, compensation1, vectorTerm (i));
+
+        FloatType sums1[Ops::numParallel], sums2[Ops::numParallel], compensations1[Ops::numParallel], compensations2[Ops::numParallel];
+        Ops::store (sums1, sum1);
+        Ops::store (sums2, sum2);
+        Ops::store (compensations1, compensation1);
+        Ops::store (compensations2, compensation2);
+
+        FloatType sum = 0, compensation = 0;
+
+        for (int lane = 0; lane < Ops::numParallel; ++lane)
+        {
+            compensatedAdd<Scalar> (sum, compensation, sums1[lane]);
+            compensatedAdd<Scalar> (sum, compensation, sums2[lane]);
+            compensatedAdd<Scalar> (sum, compensation, compensations1[lane]);
+            compensatedAdd<Scalar> (sum, compensation, compensations2[lane]);
+        }
+
+        for (; i < num; ++i)
+            compensatedAdd<Scalar> (sum, compensation, scalarTerm (i));
+
+        return sum + compensation;
+    }
+
+    // Index of the first largest (or smallest) value, with NaN ranking below (or
+    // above) every number
+    template <bool findLargest, typename FloatType, typename Size>
+    static Size findIndexOfExtremum (const FloatType* src, Size num) noexcept
+    {
+        using Ops = KernelOps<FloatType>;
+        using IndexType = typename Ops::IndexType;
+        constexpr auto step = (Size) Ops::numParallel;
+        constexpr auto maxChunkSize = (Size) (1 << 30);   // keeps lane indices within 32 bits
+
+        const auto isBetter = [] (FloatType a, FloatType b) { return findLargest ? a > b : a < b; };
+        const auto worst = findLargest ? -std::numeric_limits<FloatType>::infinity()
+                                       :  std::numeric_limits<FloatType>::infinity();
+
+        auto bestValue = worst;
+        Size bestIndex = 0, i = 0;
+
+        while (num - i >= step)
+        {
+            const auto chunkStart = i;
+            const auto chunkEnd = i + jmin ((num - i) / step * step, maxChunkSize);
+
+            auto values = Ops::broadcast (worst);
+            auto indices = Ops::indexInit();
+            auto laneIndices = Ops::indexInit();
+            const auto increment = Ops::indexBroadcast ((IndexType) step);
+
+            for (; i < chunkEnd; i += step)
+            {
+                const auto v = Ops::load (src + i);
+                const auto better = findLargest ? Ops::greaterThan (v, values) : Ops::lessThan (v, values);
+                values = Ops::select (better, v, values);
+                indices = Ops::indexSelect (better, laneIndices, indices);
+                laneIndices = Ops::indexAdd (laneIndices, increment);
+            }
+
+            FloatType laneValues[Ops::numParallel];
+            IndexType laneBestIndices[Ops::numParallel];
+            Ops::store (laneValues, values);
+            Ops::indexStore (laneBestIndices, indices);
+
+            int bestLane = 0;
+
+            for (int lane = 1; lane < Ops::numParallel; ++lane)
+                if (isBetter (laneValues[lane], laneValues[bestLane])
+                     || (exactlyEqual (laneValues[lane], laneValues[bestLane]) && laneBestIndices[lane] < laneBestIndices[bestLane]))
+                    bestLane = lane;
+
+            if (isBetter (laneValues[bestLane], bestValue))
+            {
+                bestValue = laneValues[bestLane];
+                bestIndex = chunkStart + (Size) laneBestIndices[bestLane];
+            }
+        }
+
+        for (; i < num; ++i)
+        {
+            if (isBetter (src[i], bestValue))
+            {
+                bestValue = src[i];
+                bestIndex = i;
+            }
+        }
+
+        return bestIndex;
+    }
+
+    template <typename FloatType, typename Size>
+    static Range<FloatType> findMinAndMaxIgnoringNaN (const FloatType* src, Size num) noexcept
+    {
+        using Ops = KernelOps<FloatType>;
+        constexpr auto infinity = std::numeric_limits<FloatType>::infinity();
+
+        auto lowest = Ops::broadcast (infinity), highest = Ops::broadcast (-infinity);
+        Size i = 0;
+
+        for (; i + Ops::numParallel <= num; i += Ops::numParallel)
+        {
+            const auto v = Ops::load (src + i);
+            lowest = Ops::minNumber (lowest, v);
+            highest = Ops::maxNumber (highest, v);
+        }
+
+        FloatType lows[Ops::numParallel], highs[Ops::numParallel];
+        Ops::store (lows, lowest);
+        Ops::store (highs, highest);
+
+        auto low = infinity, high = -infinity;
+
+        for (int lane = 0; lane < Ops::numParallel; ++lane)
+        {
+            low = jmin (low, lows[lane]);
+            high = jmax (high, highs[lane]);
+        }
+
+        for (; i < num; ++i)
+        {
+            low = ScalarKernelOps<FloatType>::minNumber (low, src[i]);
+            high = ScalarKernelOps<FloatType>::maxNumber (high, src[i]);
+        }
+
+        return low <= high ? Range<FloatType> (low, high) : Range<FloatType>();
+    }
+
 //==============================================================================
 namespace
 {
@@ -1420,6 +2166,140 @@ FloatType JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::findMax
     return FloatVectorHelpers::findMaximum (src, numValues);
 }
 
+template <typename FloatType, typename CountType>
+Range<FloatType> JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::findMinAndMaxIgnoringNaN (const FloatType* src,
+                                                                                                          CountType numValues) noexcept
+{
+    return FloatVectorHelpers::findMinAndMaxIgnoringNaN (src, numValues);
+}
+
+template <typename FloatType, typename CountType>
+CountType JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::findIndexOfMaximum (const FloatType* src,
+                                                                                            CountType numValues) noexcept
+{
+    return FloatVectorHelpers::findIndexOfExtremum<true> (src, numValues);
+}
+
+template <typename FloatType, typename CountType>
+CountType JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::findIndexOfMinimum (const FloatType* src,
+                                                                                            CountType numValues) noexcept
+{
+    return FloatVectorHelpers::findIndexOfExtremum<false> (src, numValues);
+}
+
+template <typename FloatType, typename CountType>
+FloatType JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::sum (const FloatType* src,
+                                                                              CountType numValues) noexcept
+{
+    using Ops = FloatVectorHelpers::KernelOps<FloatType>;
+
+    return FloatVectorHelpers::compensatedSum<FloatType> (numValues,
+                                                          [src] (CountType i) { return Ops::load (src + i); },
+                                                          [src] (CountType i) { return src[i]; });
+}
+
+template <typename FloatType, typename CountType>
+FloatType JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::sumOfSquares (const FloatType* src,
+                                                                                       CountType numValues) noexcept
+{
+    using Ops = FloatVectorHelpers::KernelOps<FloatType>;
+
+    return FloatVectorHelpers::compensatedSum<FloatType> (numValues,
+                                                          [src] (CountType i) { const auto v = Ops::load (src + i); return Ops::mul (v, v); },
+                                                          [src] (CountType i) { return src[i] * src[i]; });
+}
+
+template <typename FloatType, typename CountType>
+FloatType JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::dotProduct (const FloatType* src1,
+                                                                                     const FloatType* src2,
+                                                                                     CountType numValues) noexcept
+{
+    using Ops = FloatVectorHelpers::KernelOps<FloatType>;
+
+    return FloatVectorHelpers::compensatedSum<FloatType> (numValues,
+                                                          [src1, src2] (CountType i) { return Ops::mul (Ops::load (src1 + i), Ops::load (src2 + i)); },
+                                                          [src1, src2] (CountType i) { return src1[i] * src2[i]; });
+}
+
+template <typename FloatType, typename CountType>
+void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::tanh (FloatType* dest,
+                                                                          const FloatType* src,
+                                                                          CountType numValues) noexcept
+{
+    FloatVectorHelpers::transform (dest, src, numValues, [] (auto math, auto x) { return math.tanh (x); });
+}
+
+template <typename FloatType, typename CountType>
+void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::exp (FloatType* dest,
+                                                                         const FloatType* src,
+                                                                         CountType numValues) noexcept
+{
+   #if ! JUCE_FVO_KERNELS_AVX2
+    // In two lanes or fewer the double polynomial is slower than the C library's exp
+    if constexpr (std::is_same_v<FloatType, double>)
+    {
+        for (CountType i = 0; i < numValues; ++i)
+            dest[i] = std::exp (src[i]);
+
+        return;
+    }
+   #endif
+
+    FloatVectorHelpers::transform (dest, src, numValues, [] (auto math, auto x) { return math.exp (x); });
+}
+
+template <typename FloatType, typename CountType>
+void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::log (FloatType* dest,
+                                                                         const FloatType* src,
+                                                                         CountType numValues) noexcept
+{
+    FloatVectorHelpers::transform (dest, src, numValues, [] (auto math, auto x) { return math.log (x); });
+}
+
+template <typename FloatType, typename CountType>
+void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::log10 (FloatType* dest,
+                                                                           const FloatType* src,
+                                                                           CountType numValues) noexcept
+{
+    FloatVectorHelpers::transform (dest, src, numValues, [] (auto math, auto x) { return math.log10 (x); });
+}
+
+template <typename FloatType, typename CountType>
+void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::gainToDecibels (FloatType* dest,
+                                                                                    const FloatType* src,
+                                                                                    FloatType minusInfinityDb,
+                                                                                    CountType numValues) noexcept
+{
+    FloatVectorHelpers::transform (dest, src, numValues, [minusInfinityDb] (auto math, auto x)
+    {
+        return math.logToDecibels (x, (FloatType) 8.6858896380650365530, minusInfinityDb);
+    });
+}
+
+template <typename FloatType, typename CountType>
+void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::powerToDecibels (FloatType* dest,
+                                                                                     const FloatType* src,
+                                                                                     FloatType minusInfinityDb,
+                                                                                     CountType numValues) noexcept
+{
+    FloatVectorHelpers::transform (dest, src, numValues, [minusInfinityDb] (auto math, auto x)
+    {
+        return math.logToDecibels (x, (FloatType) 4.3429448190325182765, minusInfinityDb);
+    });
+}
+
+template <typename FloatType, typename CountType>
+void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::decibelsToGain (FloatType* dest,
+                                                                                    const FloatType* src,
+                                                                                    FloatType minusInfinityDb,
+                                                                                    CountType numValues) noexcept
+{
+    FloatVectorHelpers::transform (dest, src, numValues, [minusInfinityDb] (auto math, auto x)
+    {
+        return math.decibelsToGain (x, minusInfinityDb);
+    });
+}
+
 template struct FloatVectorOperationsBase<float, int>;
 template struct FloatVectorOperationsBase<float, size_t>;
 template struct FloatVectorOperationsBase<double, int>;
@@ -1709,6 +2589,275 @@ public:
         }
     };
 
+    template <typename ValueType>
+    struct KernelTestRunner
+    {
+        static constexpr int num = 4099;
+
+        static void runAccuracyTests (UnitTest& u, Random& random)
+        {
+            HeapBlock<ValueType> src (num), dest (num);
+
+            auto checkAccuracy = [&] (const char* name, double maxUlp, ValueType start, ValueType end, bool logarithmic,
+                                      auto&& kernel, auto&& reference)
+            {
+                for (int i = 0; i < num; ++i)
+                    src[i] = logarithmic ? (ValueType) std::exp (std::log ((double) start) + random.nextDouble() * std::log ((double) end / (double) start))
+                                         : (ValueType) (start + random.nextDouble() * (end - start));
+
+                kernel (dest.get(), src.get());
+
+                auto worst = 0.0;
+
+                for (int i = 0; i < num; ++i)
+                    worst = jmax (worst, ulpError (dest[i], reference ((long double) src[i])));
+
+                u.expect (worst <= maxUlp, String (name) + " error " + String (worst) + " ulp");
+            };
+
+            checkAccuracy ("tanh", 3.0, (ValueType) -25, (ValueType) 25, false,
+                           [] (ValueType* d, const ValueType* s) { FloatVectorOperations::tanh (d, s, num); },
+                           [] (long double x) { return std::tanh (x); });
+
+            checkAccuracy ("tanh", 3.0, (ValueType) 1.0e-30, (ValueType) 2, true,
+                           [] (ValueType* d, const ValueType* s) { FloatVectorOperations::tanh (d, s, num); },
+                           [] (long double x) { return std::tanh (x); });
+
+            checkAccuracy ("exp", 2.0, expLimits().getStart(), expLimits().getEnd(), false,
+                           [] (ValueType* d, const ValueType* s) { FloatVectorOperations::exp (d, s, num); },
+                           [] (long double x) { return std::exp (x); });
+
+            checkAccuracy ("log", 2.0, (ValueType) 1.0e-30, (ValueType) 1.0e30, true,
+                           [] (ValueType* d, const ValueType* s) { FloatVectorOperations::log (d, s, num); },
+                           [] (long double x) { return std::log (x); });
+
+            checkAccuracy ("log", 2.0, (ValueType) 0.5, (ValueType) 2, false,
+                           [] (ValueType* d, const ValueType* s) { FloatVectorOperations::log (d, s, num); },
+                           [] (long double x) { return std::log (x); });
+
+            checkAccuracy ("log of subnormals", 2.0, std::numeric_limits<ValueType>::denorm_min(), std::numeric_limits<ValueType>::min(), true,
+                           [] (ValueType* d, const ValueType* s) { FloatVectorOperations::log (d, s, num); },
+                           [] (long double x) { return std::log (x); });
+
+            checkAccuracy ("log10", 3.0, (ValueType) 1.0e-30, (ValueType) 1.0e30, true,
+                           [] (ValueType* d, const ValueType* s) { FloatVectorOperations::log10 (d, s, num); },
+                           [] (long double x) { return std::log10 (x); });
+
+            checkAccuracy ("gainToDecibels", 3.0, (ValueType) 1.0e-30, (ValueType) 1.0e30, true,
+                           [] (ValueType* d, const ValueType* s) { FloatVectorOperations::gainToDecibels (d, s, (ValueType) -1000, num); },
+                           [] (long double x) { return 20.0L * std::log10 (x); });
+
+            checkAccuracy ("powerToDecibels", 3.0, (ValueType) 1.0e-30, (ValueType) 1.0e30, true,
+                           [] (ValueType* d, const ValueType* s) { FloatVectorOperations::powerToDecibels (d, s, (ValueType) -1000, num); },
+                           [] (long double x) { return 10.0L * std::log10 (x); });
+
+            checkAccuracy ("decibelsToGain", 2.0, (ValueType) -200, (ValueType) 40, false,
+                           [] (ValueType* d, const ValueType* s) { FloatVectorOperations::decibelsToGain (d, s, (ValueType) -1000, num); },
+                           [] (long double x) { return std::pow (10.0L, x / 20.0L); });
+        }
+
+        static void runSpecialValueTests (UnitTest& u)
+        {
+            constexpr auto inf = std::numeric_limits<ValueType>::infinity();
+            const auto nan = std::numeric_limits<ValueType>::quiet_NaN();
+            const ValueType src[] = { 0, -0.0, -1, inf, -inf, nan, (ValueType) 1, (ValueType) 1.0e-3 };
+            constexpr int n = numElementsInArray (src);
+            ValueType dest[n];
+
+            FloatVectorOperations::log (dest, src, n);
+            u.expect (dest[0] == -inf && dest[1] == -inf && std::isnan (dest[2]) && dest[3] == inf
+                       && std::isnan (dest[4]) && std::isnan (dest[5]) && exactlyEqual (dest[6], (ValueType) 0));
+
+            FloatVectorOperations::exp (dest, src, n);
+            u.expect (exactlyEqual (dest[0], (ValueType) 1) && exactlyEqual (dest[1], (ValueType) 1) && dest[3] == inf
+                       && exactlyEqual (dest[4], (ValueType) 0) && std::isnan (dest[5]));
+
+            FloatVectorOperations::tanh (dest, src, n);
+            u.expect (exactlyEqual (dest[0], (ValueType) 0) && std::signbit (dest[1]) && exactlyEqual (dest[3], (ValueType) 1)
+                       && exactlyEqual (dest[4], (ValueType) -1) && std::isnan (dest[5]));
+
+            FloatVectorOperations::gainToDecibels (dest, src, (ValueType) -100, n);
+            u.expect (exactlyEqual (dest[0], (ValueType) -100) && exactlyEqual (dest[2], (ValueType) -100)
+                       && exactlyEqual (dest[5], (ValueType) -100) && exactlyEqual (dest[6], (ValueType) 0)
+                       && std::abs (dest[7] + 60) < (ValueType) 1.0e-4);
+
+            const ValueType levels[] = { (ValueType) -100, (ValueType) -101, (ValueType) -99, (ValueType) 0, inf, nan };
+            FloatVectorOperations::decibelsToGain (dest, levels, (ValueType) -100, numElementsInArray (levels));
+            u.expect (exactlyEqual (dest[0], (ValueType) 0) && exactlyEqual (dest[1], (ValueType) 0) && dest[2] > 0
+                       && exactlyEqual (dest[3], (ValueType) 1) && dest[4] == inf && exactlyEqual (dest[5], (ValueType) 0));
+        }
+
+        static void runSumTests (UnitTest& u, Random& random)
+        {
+            HeapBlock<ValueType> data1 (num), data2 (num);
+
+            // One large value followed by many that are each lost when added to it one at a time
+            data1[0] = 1;
+
+            for (int i = 1; i < num; ++i)
+                data1[i] = std::numeric_limits<ValueType>::epsilon() / 4;
+
+            const auto exactSum = 1.0L + (long double) (num - 1) * (std::numeric_limits<ValueType>::epsilon() / 4);
+            u.expect (ulpError (FloatVectorOperations::sum (data1.get(), num), exactSum) <= 1.0);
+            u.expect (exactlyEqual (std::accumulate (data1.get(), data1.get() + num, (ValueType) 0), (ValueType) 1));
+
+            for (int n : { 0, 1, 7, 64, num })
+            {
+                for (int i = 0; i < n; ++i)
+                {
+                    data1[i] = (ValueType) (random.nextDouble() * 2.0 - 1.0);
+                    data2[i] = (ValueType) (random.nextDouble() * 2.0 - 1.0);
+                }
+
+                long double referenceSum = 0, referenceSquares = 0, referenceDot = 0, absoluteSum = 0, absoluteDot = 0;
+
+                for (int i = 0; i < n; ++i)
+                {
+                    referenceSum += data1[i];
+                    referenceSquares += (long double) data1[i] * data1[i];
+                    referenceDot += (long double) data1[i] * data2[i];
+                    absoluteSum += std::abs (data1[i]);
+                    absoluteDot += std::abs ((long double) data1[i] * data2[i]);
+                }
+
+                // The bounds documented for each function, with the higher order term taken as n * epsilon^2
+                constexpr auto epsilon = (long double) std::numeric_limits<ValueType>::epsilon();
+
+                auto withinBound = [&] (ValueType result, long double exact, long double absoluteTotal, long double productErrors)
+                {
+                    return std::abs ((long double) result - exact) <= 2 * epsilon * std::abs (exact) + productErrors
+                                                                      + (long double) n * epsilon * epsilon * absoluteTotal;
+                };
+
+                u.expect (withinBound (FloatVectorOperations::sum (data1.get(), n), referenceSum, absoluteSum, 0), "sum");
+                u.expect (withinBound (FloatVectorOperations::sumOfSquares (data1.get(), n), referenceSquares, referenceSquares, epsilon * referenceSquares), "sumOfSquares");
+                u.expect (withinBound (FloatVectorOperations::dotProduct (data1.get(), data2.get(), n), referenceDot, absoluteDot, epsilon * absoluteDot), "dotProduct");
+            }
+        }
+
+        static void runExtremumTests (UnitTest& u, Random& random)
+        {
+            HeapBlock<ValueType> data (num);
+            const auto nan = std::numeric_limits<ValueType>::quiet_NaN();
+
+            for (int n : { 1, 3, 8, 33, num })
+            {
+                for (int i = 0; i < n; ++i)
+                    data[i] = (ValueType) random.nextInt (20);
+
+                if (n > 2)
+                    data[random.nextInt (n)] = nan;
+
+                int expectedMax = 0, expectedMin = 0;
+
+                for (int i = 0; i < n; ++i)
+                {
+                    if (std::isnan (data[expectedMax]) || data[i] > data[expectedMax])
+                        expectedMax = i;
+
+                    if (std::isnan (data[expectedMin]) || data[i] < data[expectedMin])
+                        expectedMin = i;
+                }
+
+                u.expect (FloatVectorOperations::findIndexOfMaximum (data.get(), n) == expectedMax);
+                u.expect (FloatVectorOperations::findIndexOfMinimum (data.get(), n) == expectedMin);
+
+                const auto range = FloatVectorOperations::findMinAndMaxIgnoringNaN (data.get(), n);
+                u.expect (exactlyEqual (range.getStart(), data[expectedMin]) && exactlyEqual (range.getEnd(), data[expectedMax]));
+            }
+
+            u.expect (FloatVectorOperations::findIndexOfMaximum (data.get(), 0) == 0);
+
+            FloatVectorOperations::fill (data.get(), nan, 17);
+            u.expect (FloatVectorOperations::findIndexOfMaximum (data.get(), 17) == 0);
+            u.expect (FloatVectorOperations::findMinAndMaxIgnoringNaN (data.get(), 17).isEmpty());
+        }
+
+        static void runBenchmarks (UnitTest& u, Random& random)
+        {
+            constexpr int size = 4096;
+            HeapBlock<ValueType> src (size), dest (size);
+
+            for (int i = 0; i < size; ++i)
+                src[i] = (ValueType) (random.nextDouble() * 4.0 - 2.0) + (ValueType) 2.001;
+
+            auto timeRuns = [&] (auto&& fn)
+            {
+                auto best = std::numeric_limits<double>::max();
+
+                for (int run = 0; run < 5; ++run)
+                {
+                    const auto start = Time::getHighResolutionTicks();
+
+                    for (int i = 0; i < 200; ++i)
+                        fn();
+
+                    best = jmin (best, Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start));
+                }
+
+                return best;
+            };
+
+            auto compare = [&] (const char* name, auto&& scalar, auto&& vector)
+            {
+                const auto scalarTime = timeRuns (scalar);
+                const auto vectorTime = timeRuns (vector);
+                u.logMessage (String (name) + ": " + String (scalarTime / vectorTime, 1) + "x the speed of the scalar loop");
+            };
+
+            volatile ValueType sink = 0;
+
+            compare ("tanh",
+                     [&] { for (int i = 0; i < size; ++i) dest[i] = std::tanh (src[i]); },
+                     [&] { FloatVectorOperations::tanh (dest.get(), src.get(), size); });
+
+            compare ("exp",
+                     [&] { for (int i = 0; i < size; ++i) dest[i] = std::exp (src[i]); },
+                     [&] { FloatVectorOperations::exp (dest.get(), src.get(), size); });
+
+            compare ("log10",
+                     [&] { for (int i = 0; i < size; ++i) dest[i] = std::log10 (src[i]); },
+                     [&] { FloatVectorOperations::log10 (dest.get(), src.get(), size); });
+
+            compare ("gainToDecibels",
+                     [&] { for (int i = 0; i < size; ++i) dest[i] = Decibels::gainToDecibels (src[i]); },
+                     [&] { FloatVectorOperations::gainToDecibels (dest.get(), src.get(), (ValueType) -100, size); });
+
+            compare ("decibelsToGain",
+                     [&] { for (int i = 0; i < size; ++i) dest[i] = Decibels::decibelsToGain (src[i]); },
+                     [&] { FloatVectorOperations::decibelsToGain (dest.get(), src.get(), (ValueType) -100, size); });
+
+            compare ("sum",
+                     [&] { sink = std::accumulate (src.get(), src.get() + size, (ValueType) 0); },
+                     [&] { sink = FloatVectorOperations::sum (src.get(), size); });
+
+            compare ("findIndexOfMaximum",
+                     [&] { sink = (ValueType) (std::max_element (src.get(), src.get() + size) - src.get()); },
+                     [&] { sink = (ValueType) FloatVectorOperations::findIndexOfMaximum (src.get(), size); });
+
+            ignoreUnused (sink);
+        }
+
+        static Range<ValueType> expLimits()
+        {
+            if constexpr (std::is_same_v<ValueType, float>)
+                return { -104.0f, 88.0f };
+            else
+                return { -745.0, 709.0 };
+        }
+
+        // The error of a result in units of the last place of the correctly rounded value
+        static double ulpError (ValueType result, long double exact)
+        {
+            if (std::isinf (exact))
+                return exactlyEqual ((long double) result, exact) ? 0.0 : std::numeric_limits<double>::infinity();
+
+            const auto rounded = std::abs ((ValueType) exact);
+            const auto ulp = (long double) std::nextafter (rounded, std::numeric_limits<ValueType>::infinity()) - (long double) rounded;
+            return (double) (std::abs ((long double) result - exact) / ulp);
+        }
+    };
+
     void runTest() override
     {
         beginTest ("FloatVectorOperations");
@@ -1718,6 +2867,28 @@ public:
             TestRunner<float>::runTest (*this, getRandom());
             TestRunner<double>::runTest (*this, getRandom());
         }
+
+        auto random = getRandom();
+
+        beginTest ("Transcendental kernel accuracy");
+        KernelTestRunner<float>::runAccuracyTests (*this, random);
+        KernelTestRunner<double>::runAccuracyTests (*this, random);
+
+        beginTest ("Transcendental kernel special values");
+        KernelTestRunner<float>::runSpecialValueTests (*this);
+        KernelTestRunner<double>::runSpecialValueTests (*this);
+
+        beginTest ("Compensated sums");
+        KernelTestRunner<float>::runSumTests (*this, random);
+        KernelTestRunner<double>::runSumTests (*this, random);
+
+        beginTest ("Extremum indices");
+        KernelTestRunner<float>::runExtremumTests (*this, random);
+        KernelTestRunner<double>::runExtremumTests (*this, random);
+
+        beginTest ("Kernel benchmarks");
+        KernelTestRunner<float>::runBenchmarks (*this, random);
+        KernelTestRunner<double>::runBenchmarks (*this, random);
     }
 };
 
@@ -148,6 +148,86 @@ struct JUCE_API FloatVectorOperationsBase
 
     /** Finds the maximum value in the given array. */
     static FloatType JUCE_CALLTYPE findMaximum (const FloatType* src, CountType numValues) noexcept;
+
+    /** Finds the minimum and maximum values in the given array, skipping any NaNs.
+        Returns an empty range if there are no values other than NaNs.
+    */
+    static Range<FloatType> JUCE_CALLTYPE findMinAndMaxIgnoringNaN (const FloatType* src, CountType numValues) noexcept;
+
+    /** Returns the index of the first occurrence of the largest value in the array, or 0 if it's empty.
+        NaNs rank below every number.
+    */
+    static CountType JUCE_CALLTYPE findIndexOfMaximum (const FloatType* src, CountType numValues) noexcept;
+
+    /** Returns the index of the first occurrence of the smallest value in the array, or 0 if it's empty.
+        NaNs rank above every number.
+    */
+    static CountType JUCE_CALLTYPE findIndexOfMinimum (const FloatType* src, CountType numValues) noexcept;
+
+    //==============================================================================
+    /** Returns the sum of the values, using compensated (Kahan-Babuska) summation.
+
+        The error is within two rounding errors of the exact sum plus a term of order
+        numValues * epsilon^2 * (the sum of the absolute values), instead of growing with
+        numValues * epsilon as in a plain loop. This relies on strict floating point
+        semantics, so it loses its accuracy if the module is compiled with fast-math
+        options.
+    */
+    static FloatType JUCE_CALLTYPE sum (const FloatType* src, CountType numValues) noexcept;
+
+    /** Returns the sum of the squares of the values, using compensated summation.
+        The relative error is within three rounding errors, plus the same higher order
+        term as sum().
+    */
+    static FloatType JUCE_CALLTYPE sumOfSquares (const FloatType* src, CountType numValues) noexcept;
+
+    /** Returns the dot product of two arrays, using compensated summation of the products.
+        The error is within one rounding error of each product, and two of the sum, plus
+        the same higher order term as sum().
+    */
+    static FloatType JUCE_CALLTYPE dotProduct (const FloatType* src1, const FloatType* src2, CountType numValues) noexcept;
+
+    //==============================================================================
+    /** Calculates the hyperbolic tangent of each source value and stores it in the destination array.
+        The results are within 3 ulp (units in the last place) of the exact values. NaNs are passed through.
+    */
+    static void JUCE_CALLTYPE tanh (FloatType* dest, const FloatType* src, CountType numValues) noexcept;
+
+    /** Calculates e raised to each source value and stores it in the destination array.
+        The results are within 2 ulp of the exact values, including subnormal results.
+        NaNs are passed through.
+
+        Doubles only take the vector path in AVX2 builds. With two lanes or fewer it is
+        slower than std::exp, so other builds call that for each value instead.
+    */
+    static void JUCE_CALLTYPE exp (FloatType* dest, const FloatType* src, CountType numValues) noexcept;
+
+    /** Calculates the natural logarithm of each source value and stores it in the destination array.
+        The results are within 2 ulp of the exact values. Zero gives -infinity, and negative
+        values and NaNs give NaN.
+    */
+    static void JUCE_CALLTYPE log (FloatType* dest, const FloatType* src, CountType numValues) noexcept;
+
+    /** Calculates the base 10 logarithm of each source value and stores it in the destination array.
+        The results are within 3 ulp of the exact values. Special values are treated as in log().
+    */
+    static void JUCE_CALLTYPE log10 (FloatType* dest, const FloatType* src, CountType numValues) noexcept;
+
+    /** Converts each source gain to decibels, as Decibels::gainToDecibels() does.
+        Gains of 0 or below, NaNs, and any result below minusInfinityDb give minusInfinityDb.
+        The results are within 3 ulp of 20 * log10 (gain).
+    */
+    static void JUCE_CALLTYPE gainToDecibels (FloatType* dest, const FloatType* src, FloatType minusInfinityDb, CountType numValues) noexcept;
+
+    /** Converts each source power to decibels (10 * log10 (power)), with the same floor as gainToDecibels().
+        The results are within 3 ulp of the exact values.
+    */
+    static void JUCE_CALLTYPE powerToDecibels (FloatType* dest, const FloatType* src, FloatType minusInfinityDb, CountType numValues) noexcept;
+
+    /** Converts each source level in decibels to a gain, as Decibels::decibelsToGain() does.
+        Levels at or below minusInfinityDb give 0. The results are within 2 ulp of the exact values.
+    */
+    static void JUCE_CALLTYPE decibelsToGain (FloatType* dest, const FloatType* src, FloatType minusInfinityDb, CountType numValues) noexcept;
 };
 
 #if ! DOXYGEN
@@ -173,7 +253,20 @@ struct NameForwarder : public Bases...
           Bases::clip...,
           Bases::findMinAndMax...,
           Bases::findMinimum...,
-          Bases::findMaximum...;
+          Bases::findMaximum...,
+          Bases::findMinAndMaxIgnoringNaN...,
+          Bases::findIndexOfMaximum...,
+          Bases::findIndexOfMinimum...,
+          Bases::sum...,
+          Bases::sumOfSquares...,
+          Bases::dotProduct...,
+          Bases::tanh...,
+          Bases::exp...,
+          Bases::log...,
+          Bases::log10...,
+          Bases::gainToDecibels...,
+          Bases::powerToDecibels...,
+          Bases::decibelsToGain...;
 };
 
 } // namespace detail
@@ -45,6 +45,10 @@
 
 #if JUCE_USE_SSE_INTRINSICS
  #include <emmintrin.h>
+
+ #if defined (__AVX2__)
+  #include <immintrin.h>
+ #endif
 #endif
 
 #if JUCE_MAC || JUCE_IOS
@@ -62,7 +66,7 @@
  #undef JUCE_USE_VDSP_FRAMEWORK
 #endif
 
-#if JUCE_USE_ARM_NEON
+#if JUCE_USE_ARM_NEON || (JUCE_64BIT && (defined (__ARM_NEON) || defined (_M_ARM64)))
  #include <arm_neon.h>
 #endif
 
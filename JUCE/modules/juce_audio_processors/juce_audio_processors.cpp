@@ -69,6 +69,10 @@
  #include <AudioUnit/AudioUnit.h>
 #endif
 
+#if JUCE_INTEL
+ #include <emmintrin.h>
+#endif
+
 namespace juce
 {
 
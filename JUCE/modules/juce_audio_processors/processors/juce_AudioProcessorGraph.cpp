@@ -503,6 +503,162 @@ private:
     std::optional<PrepareSettings> current, next;
 };
 
+//==============================================================================
+/*  Helper threads that render the independent parts of a GraphRenderSequence alongside the
+    audio thread.
+
+    Each block is handed over as a Job. The audio thread and every worker call Job::help()
+    until the job has no work left, and run() only returns once all the workers have left it.
+    Between blocks a worker spins for a while, so that back-to-back blocks don't pay for a
+    wake-up, and then parks on a semaphore until the audio thread posts it. Posting takes no
+    lock, unlike Thread::notify().
+*/
+class GraphRenderThreads
+{
+public:
+    struct Job
+    {
+        virtual ~Job() = default;
+
+        /*  Does work until there's none left. Called concurrently from every thread. */
+        virtual void help() = 0;
+    };
+
+    explicit GraphRenderThreads (int numThreads)
+    {
+        for (int i = 0; i < numThreads; ++i)
+            workers.push_back (std::make_unique<Worker> (*this, i));
+
+        for (auto& worker : workers)
+            if (! worker->startRealtimeThread (Thread::RealtimeOptions{}.withPriority (10)))
+                worker->startThread (Thread::Priority::highest);
+    }
+
+    ~GraphRenderThreads()
+    {
+        for (auto& worker : workers)
+        {
+            worker->signalThreadShouldExit();
+            worker->wakeUp.post();
+        }
+
+        for (auto& worker : workers)
+            worker->stopThread (-1);
+    }
+
+    int getNumThreads() const noexcept  { return (int) workers.size(); }
+
+    /*  Call from the audio thread only. */
+    void run (Job& job)
+    {
+        currentJob.store (&job);
+        generation.fetch_add (1);
+
+        for (auto& worker : workers)
+            if (worker->isParked.exchange (false))
+                worker->wakeUp.post();
+
+        job.help();
+
+        // Workers can still be inside help(), and the job mustn't be reset until they've left
+        currentJob.store (nullptr);
+
+        for (int attempt = 0; numHelping.load() != 0; ++attempt)
+            backOff (attempt);
+    }
+
+    /*  Waits a little before trying again: a pause instruction at first, then giving up the
+        core, which matters when there are more threads than cores.
+    */
+    static void backOff (int attempt) noexcept
+    {
+        if (attempt >= 64)
+        {
+            Thread::yield();
+            return;
+        }
+
+       #if JUCE_INTEL
+        _mm_pause();
+       #elif JUCE_ARM && (JUCE_GCC || JUCE_CLANG)
+        __asm__ __volatile__ ("yield");
+       #elif JUCE_ARM && JUCE_MSVC
+        __yield();
+       #endif
+    }
+
+private:
+    class Worker final : public Thread
+    {
+    public:
+        Worker (GraphRenderThreads& o, int index)
+            : Thread ("Graph render thread " + String (index + 1)), owner (o) {}
+
+        void run() override
+        {
+            auto lastGeneration = owner.generation.load();
+
+            while (! threadShouldExit())
+            {
+                lastGeneration = waitForNextJob (lastGeneration);
+                owner.helpWithCurrentJob();
+            }
+        }
+
+        std::atomic<bool> isParked { false };
+        Semaphore wakeUp;
+
+    private:
+        uint32 waitForNextJob (uint32 lastGeneration)
+        {
+            for (int attempt = 0; attempt < numAttemptsBeforeParking; ++attempt)
+            {
+                const auto current = owner.generation.load (std::memory_order_acquire);
+
+                if (current != lastGeneration)
+                    return current;
+
+                backOff (attempt);
+            }
+
+            for (;;)
+            {
+                isParked.store (true);
+                const auto current = owner.generation.load();
+
+                if (current != lastGeneration || threadShouldExit())
+                {
+                    isParked.store (false);
+                    return current;
+                }
+
+                // A post left over from a wake-up the worker didn't need only
+                // brings it back round this loop
+                wakeUp.wait();
+            }
+        }
+
+        static constexpr int numAttemptsBeforeParking = 2048;
+
+        GraphRenderThreads& owner;
+    };
+
+    void helpWithCurrentJob()
+    {
+        numHelping.fetch_add (1);
+
+        if (auto* job = currentJob.load())
+            job->help();
+
+        numHelping.fetch_sub (1);
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<Job*> currentJob { nullptr };
+    std::atomic<uint32> generation { 0 };
+    std::atomic<int> numHelping { 0 };
+};
+
 //==============================================================================
 template <typename FloatType>
 struct GraphRenderSequence
@@ -524,7 +680,10 @@ struct GraphRenderSequence
         int numSamples;
     };
 
-    void perform (AudioBuffer<FloatType>& buffer, MidiBuffer& midiMessages, AudioPlayHead* audioPlayHead)
+    void perform (AudioBuffer<FloatType>& buffer,
+                  MidiBuffer& midiMessages,
+                  AudioPlayHead* audioPlayHead,
+                  GraphRenderThreads* threads)
     {
         auto numSamples = buffer.getNumSamples();
         auto maxSamples = renderingBuffer.getNumSamples();
@@ -543,7 +702,7 @@ struct GraphRenderSequence
 
                 // Splitting up the buffer like this will cause the play head and host time to be
                 // invalid for all but the first chunk...
-                perform (audioChunk, midiChunk, audioPlayHead);
+                perform (audioChunk, midiChunk, audioPlayHead, threads);
 
                 chunkStartSample += maxSamples;
             }
@@ -551,7 +710,8 @@ struct GraphRenderSequence
             return;
         }
 
-        currentAudioOutputBuffer.setSize (jmax (1, buffer.getNumChannels()), numSamples);
+        // prepareBuffers() allocated for the largest block, so this only changes the view
+        currentAudioOutputBuffer.setSize (jmax (1, buffer.getNumChannels()), numSamples, false, false, true);
         currentAudioOutputBuffer.clear();
         currentMidiOutputBuffer.clear();
 
@@ -563,8 +723,15 @@ struct GraphRenderSequence
                                     audioPlayHead,
                                     numSamples };
 
-            for (const auto& op : renderOps)
-                op->process (context);
+            if (threads != nullptr && parallelRender != nullptr)
+            {
+                parallelRender->perform (*threads, context);
+            }
+            else
+            {
+                for (const auto& op : renderOps)
+                    op->process (context);
+            }
         }
 
         for (int i = 0; i < buffer.getNumChannels(); ++i)
@@ -596,7 +763,7 @@ struct GraphRenderSequence
             int index = 0;
         };
 
-        renderOps.push_back (std::make_unique<ClearOp> (index));
+        addOp (std::make_unique<ClearOp> (index), { { Resource::audioBuffer, index, true } });
     }
 
     void addCopyChannelOp (int srcIndex, int dstIndex)
@@ -621,7 +788,8 @@ struct GraphRenderSequence
             int from = 0, to = 0;
         };
 
-        renderOps.push_back (std::make_unique<CopyOp> (srcIndex, dstIndex));
+        addOp (std::make_unique<CopyOp> (srcIndex, dstIndex), { { Resource::audioBuffer, srcIndex, false },
+                                                         { Resource::audioBuffer, dstIndex, true } });
     }
 
     void addAddChannelOp (int srcIndex, int dstIndex)
@@ -646,7 +814,8 @@ struct GraphRenderSequence
             int from = 0, to = 0;
         };
 
-        renderOps.push_back (std::make_unique<AddOp> (srcIndex, dstIndex));
+        addOp (std::make_unique<AddOp> (srcIndex, dstIndex), { { Resource::audioBuffer, srcIndex, false },
+                                                        { Resource::audioBuffer, dstIndex, true } });
     }
 
     JUCE_END_IGNORE_WARNINGS_MSVC
@@ -671,7 +840,7 @@ struct GraphRenderSequence
             int index = 0;
         };
 
-        renderOps.push_back (std::make_unique<ClearOp> (index));
+        addOp (std::make_unique<ClearOp> (index), { { Resource::midiBuffer, index, true } });
     }
 
     void addCopyMidiBufferOp (int srcIndex, int dstIndex)
@@ -696,7 +865,8 @@ struct GraphRenderSequence
             int from = 0, to = 0;
         };
 
-        renderOps.push_back (std::make_unique<CopyOp> (srcIndex, dstIndex));
+        addOp (std::make_unique<CopyOp> (srcIndex, dstIndex), { { Resource::midiBuffer, srcIndex, false },
+                                                         { Resource::midiBuffer, dstIndex, true } });
     }
 
     void addAddMidiBufferOp (int srcIndex, int dstIndex)
@@ -721,7 +891,8 @@ struct GraphRenderSequence
             int from = 0, to = 0;
         };
 
-        renderOps.push_back (std::make_unique<AddOp> (srcIndex, dstIndex));
+        addOp (std::make_unique<AddOp> (srcIndex, dstIndex), { { Resource::midiBuffer, srcIndex, false },
+                                                        { Resource::midiBuffer, dstIndex, true } });
     }
 
     void addDelayChannelOp (int chan, int delaySize)
@@ -760,7 +931,7 @@ struct GraphRenderSequence
             int readIndex = 0, writeIndex;
         };
 
-        renderOps.push_back (std::make_unique<DelayChannelOp> (chan, delaySize));
+        addOp (std::make_unique<DelayChannelOp> (chan, delaySize), { { Resource::audioBuffer, chan, true } });
     }
 
     void addProcessOp (const Node::Ptr& node,
@@ -791,7 +962,23 @@ struct GraphRenderSequence
             return std::make_unique<ProcessOp> (node, audioChannelsUsed, totalNumChans, midiBuffer);
         }();
 
-        renderOps.push_back (std::move (op));
+        // Nodes may write to any channel they're given (input-only channels included, when
+        // they're suspended or converted to another precision), and to their MIDI buffer
+        std::vector<Access> accesses { { Resource::midiBuffer, midiBuffer, true } };
+
+        for (auto channel : audioChannelsUsed)
+            accesses.push_back ({ Resource::audioBuffer, channel, true });
+
+        if (auto* ioNode = dynamic_cast<const AudioProcessorGraph::AudioGraphIOProcessor*> (node->getProcessor()))
+        {
+            if (ioNode->getType() == AudioProcessorGraph::AudioGraphIOProcessor::audioOutputNode)
+                accesses.push_back ({ Resource::graphAudioOutput, 0, true });
+
+            if (ioNode->getType() == AudioProcessorGraph::AudioGraphIOProcessor::midiOutputNode)
+                accesses.push_back ({ Resource::graphMidiOutput, 0, true });
+        }
+
+        addOp (std::move (op), std::move (accesses));
     }
 
     void prepareBuffers (int blockSize)
@@ -817,6 +1004,14 @@ struct GraphRenderSequence
             op->prepare (renderingBuffer.getArrayOfWritePointers(), midiBuffers.data());
     }
 
+    /*  Works out which ops depend on which, so that perform() can run the sequence on
+        GraphRenderThreads.
+    */
+    void prepareParallelRender()
+    {
+        parallelRender = std::make_unique<ParallelRender> (renderOps, opAccesses);
+    }
+
     int numBuffersNeeded = 0, numMidiBuffersNeeded = 0;
 
     AudioBuffer<FloatType> renderingBuffer, currentAudioOutputBuffer;
@@ -995,7 +1190,210 @@ private:
         }
     };
 
+    //==============================================================================
+    // What an op reads or writes, for ordering the ops when they're rendered in parallel
+    enum class Resource { audioBuffer, midiBuffer, graphAudioOutput, graphMidiOutput };
+
+    struct Access
+    {
+        Resource resource;
+        int index;
+        bool writes;
+
+        auto tie() const { return std::tie (resource, index); }
+    };
+
+    void addOp (std::unique_ptr<RenderOp> op, std::vector<Access> accesses)
+    {
+        renderOps.push_back (std::move (op));
+        opAccesses.push_back (std::move (accesses));
+    }
+
+    //==============================================================================
+    /*  Renders the sequence as a graph of tasks. An op waits for every earlier op that it
+        conflicts with: one that writes something it reads or writes, or reads something it
+        writes. Each op therefore sees exactly the data it would see in the serial sequence.
+
+        Ops that become ready go on a list that any thread can take them from. A thread that
+        finishes an op carries straight on with one of the ops it made ready.
+    */
+    class ParallelRender final : public GraphRenderThreads::Job
+    {
+    public:
+        ParallelRender (const std::vector<std::unique_ptr<RenderOp>>& renderOps,
+                        const std::vector<std::vector<Access>>& opAccesses)
+            : numOps ((int) renderOps.size()),
+              numDependencies ((size_t) numOps, 0),
+              dependents ((size_t) numOps),
+              dependenciesLeft (new std::atomic<int>[(size_t) numOps]),
+              readyOps (new std::atomic<int>[(size_t) numOps])
+        {
+            for (const auto& op : renderOps)
+                ops.push_back (op.get());
+
+            struct ResourceState
+            {
+                int lastWriter = -1;
+                std::vector<int> readersSinceWrite;
+            };
+
+            std::map<std::tuple<Resource, int>, ResourceState> resources;
+
+            for (int op = 0; op < numOps; ++op)
+            {
+                std::vector<int> dependencies;
+
+                for (const auto& access : mergeAccesses (opAccesses[(size_t) op]))
+                {
+                    auto& state = resources[access.tie()];
+
+                    if (state.lastWriter >= 0)
+                        dependencies.push_back (state.lastWriter);
+
+                    if (access.writes)
+                    {
+                        dependencies.insert (dependencies.end(), state.readersSinceWrite.begin(), state.readersSinceWrite.end());
+                        state.readersSinceWrite.clear();
+                        state.lastWriter = op;
+                    }
+                    else
+                    {
+                        state.readersSinceWrite.push_back (op);
+                    }
+                }
+
+                std::sort (dependencies.begin(), dependencies.end());
+                dependencies.erase (std::unique (dependencies.begin(), dependencies.end()), dependencies.end());
+
+                numDependencies[(size_t) op] = (int) dependencies.size();
+
+                for (auto dependency : dependencies)
+                    dependents[(size_t) dependency].push_back (op);
+
+                if (dependencies.empty())
+                    initialOps.push_back (op);
+            }
+        }
+
+        void perform (GraphRenderThreads& threads, const Context& c)
+        {
+            for (size_t i = 0; i < (size_t) numOps; ++i)
+            {
+                dependenciesLeft[i].store (numDependencies[i], std::memory_order_relaxed);
+                readyOps[i].store (-1, std::memory_order_relaxed);
+            }
+
+            numReadyOps.store (0, std::memory_order_relaxed);
+            numTakenOps.store (0, std::memory_order_relaxed);
+
+            for (auto op : initialOps)
+                pushReadyOp (op);
+
+            numOpsLeft.store (numOps, std::memory_order_relaxed);
+            context = &c;
+
+            threads.run (*this);
+        }
+
+        void help() override
+        {
+            for (int attempt = 0; numOpsLeft.load (std::memory_order_acquire) > 0;)
+            {
+                auto op = takeReadyOp();
+
+                if (op < 0)
+                {
+                    GraphRenderThreads::backOff (attempt++);
+                    continue;
+                }
+
+                attempt = 0;
+
+                while (op >= 0)
+                    op = runOp (op);
+            }
+        }
+
+    private:
+        // An op can list the same buffer more than once, e.g. the read-only empty buffer
+        static std::vector<Access> mergeAccesses (std::vector<Access> accesses)
+        {
+            std::sort (accesses.begin(), accesses.end(), [] (const auto& a, const auto& b) { return a.tie() < b.tie(); });
+
+            std::vector<Access> result;
+
+            for (const auto& access : accesses)
+            {
+                if (! result.empty() && result.back().tie() == access.tie())
+                    result.back().writes |= access.writes;
+                else
+                    result.push_back (access);
+            }
+
+            return result;
+        }
+
+        // Returns one of the ops that this one made ready, or -1
+        int runOp (int index)
+        {
+            ops[(size_t) index]->process (*context);
+
+            int next = -1;
+
+            for (auto dependent : dependents[(size_t) index])
+            {
+                if (dependenciesLeft[(size_t) dependent].fetch_sub (1, std::memory_order_acq_rel) != 1)
+                    continue;
+
+                if (next < 0)
+                    next = dependent;
+                else
+                    pushReadyOp (dependent);
+            }
+
+            numOpsLeft.fetch_sub (1, std::memory_order_acq_rel);
+            return next;
+        }
+
+        void pushReadyOp (int op)
+        {
+            const auto slot = numReadyOps.fetch_add (1, std::memory_order_relaxed);
+            readyOps[(size_t) slot].store (op, std::memory_order_release);
+        }
+
+        // Each op is pushed once per block, so a slot that has been reserved but not written
+        // yet just means there's nothing to take for the moment
+        int takeReadyOp()
+        {
+            auto slot = numTakenOps.load (std::memory_order_relaxed);
+
+            while (slot < numOps)
+            {
+                const auto op = readyOps[(size_t) slot].load (std::memory_order_acquire);
+
+                if (op < 0)
+                    return -1;
+
+                if (numTakenOps.compare_exchange_weak (slot, slot + 1, std::memory_order_acq_rel))
+                    return op;
+            }
+
+            return -1;
+        }
+
+        const int numOps;
+        std::vector<RenderOp*> ops;
+        std::vector<int> numDependencies, initialOps;
+        std::vector<std::vector<int>> dependents;
+
+        std::unique_ptr<std::atomic<int>[]> dependenciesLeft, readyOps;
+        std::atomic<int> numReadyOps { 0 }, numTakenOps { 0 }, numOpsLeft { 0 };
+        const Context* context = nullptr;
+    };
+
     std::vector<std::unique_ptr<RenderOp>> renderOps;
+    std::vector<std::vector<Access>> opAccesses;
+    std::unique_ptr<ParallelRender> parallelRender;
 };
 
 //==============================================================================
@@ -1019,17 +1417,22 @@ public:
 
     static constexpr auto midiChannelIndex = AudioProcessorGraph::midiChannelIndex;
 
+    /*  With reuseBuffers false, every buffer is used by a single node and the ops feeding it,
+        at the cost of more memory. Nodes then only depend on each other through the data
+        they pass along, which lets GraphRenderThreads render unrelated nodes in parallel.
+    */
     template <typename FloatType>
-    static SequenceAndLatency build (const Nodes& n, const Connections& c)
+    static SequenceAndLatency build (const Nodes& n, const Connections& c, bool reuseBuffers)
     {
         GraphRenderSequence<FloatType> sequence;
-        const RenderSequenceBuilder builder (n, c, sequence);
+        const RenderSequenceBuilder builder (n, c, sequence, reuseBuffers);
         return { std::move (sequence), builder.totalLatency };
     }
 
 private:
     //==============================================================================
     const Array<Node*> orderedNodes;
+    const bool reuseBuffers;
 
     struct AssignedBuffer
     {
@@ -1143,7 +1546,7 @@ private:
         // Handle an unconnected input channel...
         if (sources.empty())
         {
-            if (inputChan >= numOuts)
+            if (inputChan >= numOuts && reuseBuffers)
                 return readOnlyEmptyBufferIndex;
 
             auto index = getFreeBuffer (audioBuffers);
@@ -1162,11 +1565,19 @@ private:
             if (bufIndex < 0)
             {
                 // if not found, this is probably a feedback loop
+                if (! reuseBuffers)
+                {
+                    auto index = getFreeBuffer (audioBuffers);
+                    sequence.addClearChannelOp (index);
+                    return index;
+                }
+
                 bufIndex = readOnlyEmptyBufferIndex;
                 jassert (bufIndex >= 0);
             }
 
-            if (inputChan < numOuts && isBufferNeededLater (reversed, ourRenderingIndex, inputChan, src))
+            // Input-only channels are shared when buffers are reused, as the node shouldn't write to them
+            if ((inputChan < numOuts || ! reuseBuffers) && isBufferNeededLater (reversed, ourRenderingIndex, inputChan, src))
             {
                 // can't mess up this channel because it's needed later by another node,
                 // so we need to use a copy of it..
@@ -1433,11 +1844,12 @@ private:
     }
 
     //==============================================================================
-    static int getFreeBuffer (Array<AssignedBuffer>& buffers)
+    int getFreeBuffer (Array<AssignedBuffer>& buffers) const
     {
-        for (int i = 1; i < buffers.size(); ++i)
-            if (buffers.getReference (i).isFree())
-                return i;
+        if (reuseBuffers)
+            for (int i = 1; i < buffers.size(); ++i)
+                if (buffers.getReference (i).isFree())
+                    return i;
 
         buffers.add (AssignedBuffer::createFree());
         return buffers.size() - 1;
@@ -1489,8 +1901,9 @@ private:
     }
 
     template <typename RenderSequence>
-    RenderSequenceBuilder (const Nodes& n, const Connections& c, RenderSequence& sequence)
-        : orderedNodes (createOrderedNodeList (n, c))
+    RenderSequenceBuilder (const Nodes& n, const Connections& c, RenderSequence& sequence, bool reuse)
+        : orderedNodes (createOrderedNodeList (n, c)),
+          reuseBuffers (reuse)
     {
         audioBuffers.add (AssignedBuffer::createReadOnlyEmpty()); // first buffer is read-only zeros
         midiBuffers .add (AssignedBuffer::createReadOnlyEmpty());
@@ -1500,8 +1913,12 @@ private:
         for (int i = 0; i < orderedNodes.size(); ++i)
         {
             createRenderingOpsForNode (c, reversed, sequence, *orderedNodes.getUnchecked (i), i);
-            markAnyUnusedBuffersAsFree (reversed, audioBuffers, i);
-            markAnyUnusedBuffersAsFree (reversed, midiBuffers, i);
+
+            if (reuseBuffers)
+            {
+                markAnyUnusedBuffersAsFree (reversed, audioBuffers, i);
+                markAnyUnusedBuffersAsFree (reversed, midiBuffers, i);
+            }
         }
 
         sequence.numBuffersNeeded = audioBuffers.size();
@@ -1521,10 +1938,15 @@ class RenderSequence
 public:
     using AudioGraphIOProcessor = AudioProcessorGraph::AudioGraphIOProcessor;
 
-    RenderSequence (const PrepareSettings s, const Nodes& n, const Connections& c)
-        : RenderSequence (s, s.precision == AudioProcessor::ProcessingPrecision::singlePrecision
-                                ? RenderSequenceBuilder::build<float>  (n, c)
-                                : RenderSequenceBuilder::build<double> (n, c))
+    RenderSequence (const PrepareSettings s,
+                    const Nodes& n,
+                    const Connections& c,
+                    std::shared_ptr<GraphRenderThreads> renderThreads)
+        : RenderSequence (s,
+                          s.precision == AudioProcessor::ProcessingPrecision::singlePrecision
+                              ? RenderSequenceBuilder::build<float>  (n, c, renderThreads == nullptr)
+                              : RenderSequenceBuilder::build<double> (n, c, renderThreads == nullptr),
+                          std::move (renderThreads))
     {
     }
 
@@ -1532,7 +1954,7 @@ public:
     void process (AudioBuffer<FloatType>& audio, MidiBuffer& midi, AudioPlayHead* playHead)
     {
         if (auto* s = std::get_if<GraphRenderSequence<FloatType>> (&sequence.sequence))
-            s->perform (audio, midi, playHead);
+            s->perform (audio, midi, playHead, threads.get());
         else
             jassertfalse; // Not prepared for this audio format!
     }
@@ -1549,14 +1971,23 @@ private:
         jassertfalse;
     }
 
-    RenderSequence (const PrepareSettings s, SequenceAndLatency&& built)
-        : settings (s), sequence (std::move (built))
+    RenderSequence (const PrepareSettings s, SequenceAndLatency&& built, std::shared_ptr<GraphRenderThreads> renderThreads)
+        : settings (s), sequence (std::move (built)), threads (std::move (renderThreads))
     {
-        visitRenderSequence (*this, [&] (auto& seq) { seq.prepareBuffers (settings.blockSize); });
+        visitRenderSequence (*this, [&] (auto& seq)
+        {
+            seq.prepareBuffers (settings.blockSize);
+
+            if (threads != nullptr)
+                seq.prepareParallelRender();
+        });
     }
 
     PrepareSettings settings;
     SequenceAndLatency sequence;
+
+    // Shared with the graph, so the threads outlive any sequence still using them
+    std::shared_ptr<GraphRenderThreads> threads;
 };
 
 //==============================================================================
@@ -1911,6 +2342,25 @@ public:
     /*  Call from the audio thread only. */
     auto* getAudioThreadState() const { return renderSequenceExchange.getAudioThreadState(); }
 
+    void setNumWorkerThreads (int numThreads)
+    {
+        numThreads = jmax (0, numThreads);
+
+        if (numThreads == getNumWorkerThreads())
+            return;
+
+        renderThreads = numThreads > 0 ? std::make_shared<GraphRenderThreads> (numThreads) : nullptr;
+
+        // The sequence is laid out differently for parallel rendering
+        lastBuiltSequence.reset();
+        rebuild (UpdateKind::sync);
+    }
+
+    int getNumWorkerThreads() const noexcept
+    {
+        return renderThreads != nullptr ? renderThreads->getNumThreads() : 0;
+    }
+
 private:
     void setParentGraph (AudioProcessor* p) const
     {
@@ -1935,7 +2385,7 @@ private:
 
             if (std::exchange (lastBuiltSequence, newSignature) != newSignature)
             {
-                auto sequence = std::make_unique<RenderSequence> (*newSettings, nodes, connections);
+                auto sequence = std::make_unique<RenderSequence> (*newSettings, nodes, connections, renderThreads);
                 owner->setLatencySamples (sequence->getLatencySamples());
                 renderSequenceExchange.set (std::move (sequence));
             }
@@ -1952,6 +2402,7 @@ private:
     Connections connections;
     NodeStates nodeStates;
     RenderSequenceExchange renderSequenceExchange;
+    std::shared_ptr<GraphRenderThreads> renderThreads;
     NodeID lastNodeID;
     std::optional<RenderSequenceSignature> lastBuiltSequence;
     LockingAsyncUpdater updater { [this] { handleAsyncUpdate(); } };
@@ -1982,6 +2433,8 @@ bool AudioProcessorGraph::disconnectNode (NodeID nodeID, UpdateKind updateKind)
 void AudioProcessorGraph::releaseResources()                                                                { return pimpl->releaseResources(); }
 bool AudioProcessorGraph::removeIllegalConnections (UpdateKind updateKind)                                  { return pimpl->removeIllegalConnections (updateKind); }
 void AudioProcessorGraph::rebuild()                                                                         { return pimpl->rebuild (UpdateKind::sync); }
+void AudioProcessorGraph::setNumWorkerThreads (int numThreads)                                              { return pimpl->setNumWorkerThreads (numThreads); }
+int AudioProcessorGraph::getNumWorkerThreads() const noexcept                                               { return pimpl->getNumWorkerThreads(); }
 void AudioProcessorGraph::reset()                                                                           { return pimpl->reset(); }
 bool AudioProcessorGraph::canConnect (const Connection& c) const                                            { return pimpl->canConnect (c); }
 bool AudioProcessorGraph::isConnected (const Connection& c) const noexcept                                  { return pimpl->isConnected (c); }
@@ -2303,12 +2756,207 @@ public:
             // this graph, so we just want to make sure that we finish the test without timing out.
             logMessage ("render sequence built in " + String (duration) + " ms");
         }
+
+        beginTest ("parallel rendering is bit-identical to serial rendering");
+        {
+            for (const auto precision : { AudioProcessor::singlePrecision, AudioProcessor::doublePrecision })
+            {
+                for (const auto numThreads : { 1, 3, 8 })
+                {
+                    AudioProcessorGraph serial, parallel;
+                    buildRenderingGraph (serial, precision);
+                    buildRenderingGraph (parallel, precision);
+                    parallel.setNumWorkerThreads (numThreads);
+                    expectEquals (parallel.getNumWorkerThreads(), numThreads);
+
+                    if (precision == AudioProcessor::singlePrecision)
+                        expectRendersIdentically<float> (serial, parallel);
+                    else
+                        expectRendersIdentically<double> (serial, parallel);
+                }
+            }
+        }
     }
 
 private:
     enum class MidiIn  { no, yes };
     enum class MidiOut { no, yes };
 
+    static constexpr double renderSampleRate = 48000.0;
+    static constexpr int renderBlockSize = 256;
+
+    /*  A graph with fan-out, fan-in, latency compensation, input-only (sidechain) channels,
+        MIDI and a float-only processor inside a double-precision graph.
+    */
+    static void buildRenderingGraph (AudioProcessorGraph& graph, AudioProcessor::ProcessingPrecision precision)
+    {
+        using IO = AudioProcessorGraph::AudioGraphIOProcessor;
+
+        graph.setPlayConfigDetails (2, 2, renderSampleRate, renderBlockSize);
+        graph.setProcessingPrecision (precision);
+
+        const auto audioIn  = graph.addNode (std::make_unique<IO> (IO::audioInputNode))->nodeID;
+        const auto audioOut = graph.addNode (std::make_unique<IO> (IO::audioOutputNode))->nodeID;
+        const auto midiIn   = graph.addNode (std::make_unique<IO> (IO::midiInputNode))->nodeID;
+        const auto midiOut  = graph.addNode (std::make_unique<IO> (IO::midiOutputNode))->nodeID;
+
+        Random random (0x5eed);
+        std::vector<AudioProcessorGraph::NodeID> previousLayer { audioIn };
+
+        for (int layer = 0; layer < 3; ++layer)
+        {
+            std::vector<AudioProcessorGraph::NodeID> thisLayer;
+
+            for (int i = 0; i < 8; ++i)
+            {
+                const auto withSidechain = layer > 0 && i % 3 == 0;
+                auto processor = std::make_unique<RenderingProcessor> (random.nextInt(), withSidechain, i != 5);
+                processor->setLatencySamples (i % 4 == 1 ? 17 * (layer + 1) : 0);
+
+                const auto node = graph.addNode (std::move (processor))->nodeID;
+
+                for (int source = 0; source < (layer == 0 ? 1 : 2); ++source)
+                {
+                    const auto from = previousLayer[(size_t) random.nextInt ((int) previousLayer.size())];
+                    graph.addConnection ({ { from, 0 }, { node, 0 } });
+                    graph.addConnection ({ { from, 1 }, { node, 1 } });
+                }
+
+                if (withSidechain)
+                    graph.addConnection ({ { previousLayer[(size_t) (i + 1) % previousLayer.size()], 0 }, { node, 2 } });
+
+                graph.addConnection ({ { layer == 0 || i % 2 == 0 ? midiIn : previousLayer.front(), AudioProcessorGraph::midiChannelIndex },
+                                       { node, AudioProcessorGraph::midiChannelIndex } });
+
+                thisLayer.push_back (node);
+            }
+
+            previousLayer = thisLayer;
+        }
+
+        for (const auto& node : previousLayer)
+        {
+            graph.addConnection ({ { node, 0 }, { audioOut, 0 } });
+            graph.addConnection ({ { node, 1 }, { audioOut, 1 } });
+            graph.addConnection ({ { node, AudioProcessorGraph::midiChannelIndex }, { midiOut, AudioProcessorGraph::midiChannelIndex } });
+        }
+
+        graph.prepareToPlay (renderSampleRate, renderBlockSize);
+    }
+
+    template <typename Value>
+    void expectRendersIdentically (AudioProcessorGraph& serial, AudioProcessorGraph& parallel)
+    {
+        Random random (42);
+        AudioBuffer<Value> serialBuffer (2, 2 * renderBlockSize), parallelBuffer (2, 2 * renderBlockSize);
+        MidiBuffer serialMidi, parallelMidi;
+        auto identical = true;
+
+        for (int block = 0; block < 64 && identical; ++block)
+        {
+            // Every so often a block is larger than announced, which the graph renders in chunks
+            const auto numSamples = block % 16 == 15 ? 2 * renderBlockSize : 1 + random.nextInt (renderBlockSize);
+            serialBuffer.setSize (2, numSamples, false, false, true);
+            serialMidi.clear();
+
+            for (int channel = 0; channel < 2; ++channel)
+                for (int i = 0; i < numSamples; ++i)
+                    serialBuffer.setSample (channel, i, (Value) (random.nextFloat() - 0.5f));
+
+            serialMidi.addEvent (MidiMessage::noteOn (1, 60 + block % 12, (uint8) 100), random.nextInt (numSamples));
+            parallelBuffer.makeCopyOf (serialBuffer, true);
+            parallelMidi = serialMidi;
+
+            serial.processBlock (serialBuffer, serialMidi);
+            parallel.processBlock (parallelBuffer, parallelMidi);
+
+            for (int channel = 0; channel < 2; ++channel)
+                identical &= std::memcmp (serialBuffer.getReadPointer (channel),
+                                          parallelBuffer.getReadPointer (channel),
+                                          sizeof (Value) * (size_t) numSamples) == 0;
+
+            identical &= serialMidi.data == parallelMidi.data;
+        }
+
+        expect (identical);
+        expect (serialBuffer.getMagnitude (0, serialBuffer.getNumSamples()) > 0);
+    }
+
+    /*  Filters its inputs with some state, mixes in its sidechain and the incoming notes, and
+        sends out a note of its own each block.
+    */
+    class RenderingProcessor final : public AudioProcessor
+    {
+    public:
+        RenderingProcessor (int seedIn, bool withSidechain, bool supportsDouble)
+            : AudioProcessor (getLayout (withSidechain)),
+              seed (seedIn),
+              coefficient (0.1 + 0.8 * Random (seedIn).nextDouble()),
+              canUseDouble (supportsDouble) {}
+
+        const String getName() const override                         { return "Rendering Processor"; }
+        double getTailLengthSeconds() const override                  { return {}; }
+        bool acceptsMidi() const override                             { return true; }
+        bool producesMidi() const override                            { return true; }
+        AudioProcessorEditor* createEditor() override                 { return {}; }
+        bool hasEditor() const override                               { return {}; }
+        int getNumPrograms() override                                 { return 1; }
+        int getCurrentProgram() override                              { return {}; }
+        void setCurrentProgram (int) override                         {}
+        const String getProgramName (int) override                    { return {}; }
+        void changeProgramName (int, const String&) override          {}
+        void getStateInformation (juce::MemoryBlock&) override        {}
+        void setStateInformation (const void*, int) override          {}
+        void prepareToPlay (double, int) override                     { state = {}; numBlocks = 0; }
+        void releaseResources() override                              {}
+        bool supportsDoublePrecisionProcessing() const override       { return canUseDouble; }
+
+        void processBlock (AudioBuffer<float>& buffer, MidiBuffer& midi) override   { render (buffer, midi); }
+        void processBlock (AudioBuffer<double>& buffer, MidiBuffer& midi) override  { render (buffer, midi); }
+
+    private:
+        static BusesProperties getLayout (bool withSidechain)
+        {
+            auto layout = BusesProperties().withInput  ("in",  AudioChannelSet::stereo())
+                                           .withOutput ("out", AudioChannelSet::stereo());
+
+            return withSidechain ? layout.withInput ("sidechain", AudioChannelSet::mono()) : layout;
+        }
+
+        template <typename Value>
+        void render (AudioBuffer<Value>& buffer, MidiBuffer& midi)
+        {
+            const auto numSamples = buffer.getNumSamples();
+            const auto* sidechain = getTotalNumInputChannels() > 2 ? buffer.getReadPointer (2) : nullptr;
+
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                auto* data = buffer.getWritePointer (channel);
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const auto input = (double) data[i] + (sidechain != nullptr ? 0.5 * (double) sidechain[i] : 0.0);
+                    state[(size_t) channel] += coefficient * (std::tanh (1.5 * input) - state[(size_t) channel]);
+                    data[i] = (Value) state[(size_t) channel];
+                }
+            }
+
+            for (const auto metadata : midi)
+                if (metadata.samplePosition < numSamples)
+                    buffer.addSample (0, metadata.samplePosition, (Value) (0.001 * metadata.numBytes));
+
+            ++numBlocks;
+            midi.clear();
+            midi.addEvent (MidiMessage::noteOn (1, 36 + (seed & 63), (uint8) (1 + numBlocks % 127)), numBlocks % numSamples);
+        }
+
+        const int seed;
+        const double coefficient;
+        const bool canUseDouble;
+        std::array<double, 2> state {};
+        int numBlocks = 0;
+    };
+
     class BasicProcessor final : public AudioProcessor
     {
     public:
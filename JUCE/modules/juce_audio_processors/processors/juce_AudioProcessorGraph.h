@@ -332,6 +332,28 @@ public:
     */
     void rebuild();
 
+    //==============================================================================
+    /** Lets the graph render independent nodes at the same time on a pool of helper threads.
+
+        By default every node is rendered in turn on the thread that calls processBlock. With
+        one or more worker threads, nodes that don't depend on each other's output are rendered
+        concurrently by the workers and the calling thread, which takes part too. The output
+        is bit-identical to rendering serially, provided each processor keeps to the
+        processBlock() contract: it overwrites all of its output channels and doesn't write to
+        input-only channels.
+
+        In this mode the processors' processBlock() methods are called from any of these threads,
+        and concurrently with one another, so processors mustn't share unsynchronised state. The
+        workers spin for a moment after each block and then sleep until the next one, so the
+        calling thread only has to wake those that have gone to sleep.
+
+        Changing the number of threads rebuilds the graph. Pass 0 to go back to serial rendering.
+    */
+    void setNumWorkerThreads (int numThreads);
+
+    /** Returns the number of helper threads set by setNumWorkerThreads(). */
+    int getNumWorkerThreads() const noexcept;
+
     //==============================================================================
     /** A special type of AudioProcessor that can live inside an AudioProcessorGraph
         in order to use the audio that comes into and out of the graph itself.
@@ -277,6 +277,8 @@
 #include "native/juce_AndroidDocument_android.cpp"
 #include "threads/juce_HighResolutionTimer.cpp"
 #include "threads/juce_WaitableEvent.cpp"
+#include "threads/juce_Semaphore.cpp"
+#include "threads/juce_LockHooks.cpp"
 #include "network/juce_URL.cpp"
 
 #if ! JUCE_WASM
@@ -197,6 +197,15 @@
  #define JUCE_ENABLE_ALLOCATION_HOOKS 0
 #endif
 
+/** Config: JUCE_ENABLE_LOCK_HOOKS
+    If enabled, CriticalSection, SpinLock and WaitableEvent will report blocking lock
+    acquisitions, including signalling an event, to a LockHooks::Listener, which can be used to check that a
+    realtime thread never waits on a lock.
+*/
+#ifndef JUCE_ENABLE_LOCK_HOOKS
+ #define JUCE_ENABLE_LOCK_HOOKS 0
+#endif
+
 #ifndef JUCE_STRING_UTF_TYPE
  #define JUCE_STRING_UTF_TYPE 8
 #endif
@@ -342,6 +351,7 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "threads/juce_Process.h"
 #include "threads/juce_SpinLock.h"
 #include "threads/juce_WaitableEvent.h"
+#include "threads/juce_Semaphore.h"
 #include "threads/juce_Thread.h"
 #include "threads/juce_HighResolutionTimer.h"
 #include "threads/juce_ThreadLocalValue.h"
@@ -367,6 +377,7 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "containers/juce_PropertySet.h"
 #include "memory/juce_SharedResourcePointer.h"
 #include "memory/juce_AllocationHooks.h"
+#include "threads/juce_LockHooks.h"
 #include "memory/juce_Reservoir.h"
 #include "files/juce_AndroidDocument.h"
 #include "streams/juce_AndroidDocumentInputSource.h"
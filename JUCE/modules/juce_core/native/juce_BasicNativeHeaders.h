@@ -192,6 +192,7 @@
  #include <pthread.h>
  #include <pwd.h>
  #include <sched.h>
+ #include <semaphore.h>
  #include <signal.h>
  #include <stddef.h>
  #include <sys/dir.h>
@@ -230,6 +231,7 @@
  #include <pthread.h>
  #include <pwd.h>
  #include <sched.h>
+ #include <semaphore.h>
  #include <signal.h>
  #include <stddef.h>
  #include <sys/file.h>
@@ -252,6 +254,7 @@
  #include <jni.h>
  #include <pthread.h>
  #include <sched.h>
+ #include <semaphore.h>
  #include <sys/time.h>
  #include <utime.h>
  #include <errno.h>
@@ -48,10 +48,18 @@ CriticalSection::CriticalSection() noexcept
 }
 
 CriticalSection::~CriticalSection() noexcept        { pthread_mutex_destroy (&lock); }
-void CriticalSection::enter() const noexcept        { pthread_mutex_lock (&lock); }
 bool CriticalSection::tryEnter() const noexcept     { return pthread_mutex_trylock (&lock) == 0; }
 void CriticalSection::exit() const noexcept         { pthread_mutex_unlock (&lock); }
 
+void CriticalSection::enter() const noexcept
+{
+   #if JUCE_ENABLE_LOCK_HOOKS
+    LockHooks::notifyLockEntered (this, LockHooks::LockType::criticalSection);
+   #endif
+
+    pthread_mutex_lock (&lock);
+}
+
 //==============================================================================
 void JUCE_CALLTYPE Thread::sleep (int millisecs)
 {
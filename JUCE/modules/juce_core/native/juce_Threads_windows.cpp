@@ -59,10 +59,18 @@ CriticalSection::CriticalSection() noexcept
 }
 
 CriticalSection::~CriticalSection() noexcept        { DeleteCriticalSection ((CRITICAL_SECTION*) &lock); }
-void CriticalSection::enter() const noexcept        { EnterCriticalSection ((CRITICAL_SECTION*) &lock); }
 bool CriticalSection::tryEnter() const noexcept     { return TryEnterCriticalSection ((CRITICAL_SECTION*) &lock) != FALSE; }
 void CriticalSection::exit() const noexcept         { LeaveCriticalSection ((CRITICAL_SECTION*) &lock); }
 
+void CriticalSection::enter() const noexcept
+{
+   #if JUCE_ENABLE_LOCK_HOOKS
+    LockHooks::notifyLockEntered (this, LockHooks::LockType::criticalSection);
+   #endif
+
+    EnterCriticalSection ((CRITICAL_SECTION*) &lock);
+}
+
 //==============================================================================
 static unsigned int STDMETHODCALLTYPE threadEntryProc (void* userData)
 {
@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#if JUCE_ENABLE_LOCK_HOOKS
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Lets a debugging tool watch for blocking lock acquisitions, for example to check
+    that nothing a realtime thread does can make it wait for another thread.
+
+    CriticalSection::enter() and SpinLock::enter() report to the listener before they
+    take the lock. tryEnter() is not reported, because it never waits.
+
+    WaitableEvent::signal() reports too: it locks the mutex its waiters hold while
+    they go to sleep and wake up, so a realtime thread signalling one can be kept
+    waiting like on any other lock. Such a thread should post a Semaphore instead.
+
+    There is a single listener for the whole process, and its callbacks run on the
+    thread taking the lock, so they must not enter any of the locks being watched.
+
+    @tags{Core}
+*/
+class LockHooks
+{
+public:
+    enum class LockType
+    {
+        criticalSection,
+        spinLock,
+        waitableEvent
+    };
+
+    struct Listener
+    {
+        virtual ~Listener() noexcept = default;
+        virtual void lockEntered (const void* lock, LockType type) noexcept = 0;
+    };
+
+    /** Sets the listener, or removes it if nullptr is passed.
+        Don't remove or delete a listener while other threads may still be using locks.
+    */
+    static void setListener (Listener* newListener) noexcept;
+
+    /** Called by the lock classes before they block. */
+    static void notifyLockEntered (const void* lock, LockType type) noexcept;
+};
+
+} // namespace juce
+
+#endif
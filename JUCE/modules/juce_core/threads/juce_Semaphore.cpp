@@ -0,0 +1,132 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+#if JUCE_MAC || JUCE_IOS
+
+class Semaphore::NativeSemaphore
+{
+public:
+    explicit NativeSemaphore (int initialCount)  : handle (dispatch_semaphore_create (initialCount)) {}
+    ~NativeSemaphore()                             { dispatch_release (handle); }
+
+    bool wait (double timeOutMilliseconds) const
+    {
+        const auto timeout = timeOutMilliseconds < 0 ? DISPATCH_TIME_FOREVER
+                                                     : dispatch_time (DISPATCH_TIME_NOW, (int64_t) (timeOutMilliseconds * NSEC_PER_MSEC));
+
+        return dispatch_semaphore_wait (handle, timeout) == 0;
+    }
+
+    void post() const noexcept  { dispatch_semaphore_signal (handle); }
+
+private:
+    dispatch_semaphore_t handle;
+};
+
+#elif JUCE_WINDOWS
+
+class Semaphore::NativeSemaphore
+{
+public:
+    explicit NativeSemaphore (int initialCount)  : handle (CreateSemaphoreW (nullptr, initialCount, std::numeric_limits<LONG>::max(), nullptr)) {}
+    ~NativeSemaphore()                             { CloseHandle (handle); }
+
+    bool wait (double timeOutMilliseconds) const
+    {
+        const auto timeout = timeOutMilliseconds < 0 ? INFINITE : (DWORD) timeOutMilliseconds;
+        return WaitForSingleObject (handle, timeout) == WAIT_OBJECT_0;
+    }
+
+    void post() const noexcept  { ReleaseSemaphore (handle, 1, nullptr); }
+
+private:
+    HANDLE handle;
+};
+
+#else
+
+class Semaphore::NativeSemaphore
+{
+public:
+    explicit NativeSemaphore (int initialCount)  { sem_init (&handle, 0, (unsigned int) initialCount); }
+    ~NativeSemaphore()                             { sem_destroy (&handle); }
+
+    bool wait (double timeOutMilliseconds) const
+    {
+        if (timeOutMilliseconds < 0)
+        {
+            while (sem_wait (&handle) != 0)
+                if (errno != EINTR)
+                    return false;
+
+            return true;
+        }
+
+        timespec deadline;
+        clock_gettime (CLOCK_REALTIME, &deadline);
+
+        const auto timeoutNanoseconds = (int64) (timeOutMilliseconds * 1.0e6);
+        deadline.tv_sec  += (time_t) (timeoutNanoseconds / 1000000000 + (deadline.tv_nsec + timeoutNanoseconds % 1000000000) / 1000000000);
+        deadline.tv_nsec  = (long) ((deadline.tv_nsec + timeoutNanoseconds % 1000000000) % 1000000000);
+
+        while (sem_timedwait (&handle, &deadline) != 0)
+            if (errno != EINTR)
+                return false;
+
+        return true;
+    }
+
+    void post() const noexcept  { sem_post (&handle); }
+
+private:
+    mutable sem_t handle;
+};
+
+#endif
+
+//==============================================================================
+Semaphore::Semaphore (int initialCount)
+    : semaphore (std::make_unique<NativeSemaphore> (initialCount))
+{
+}
+
+Semaphore::~Semaphore() = default;
+
+bool Semaphore::wait (double timeOutMilliseconds) const  { return semaphore->wait (timeOutMilliseconds); }
+void Semaphore::post() const noexcept                     { semaphore->post(); }
+
+} // namespace juce
@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A counting semaphore that a realtime thread can post to.
+
+    WaitableEvent::signal() locks the mutex that its waiters hold while they go to
+    sleep, so a thread signalling one can be kept waiting. post() never blocks: it
+    increments the count and, if a thread is waiting, asks the OS to wake it. Use it
+    to hand work from an audio thread to a worker.
+
+    @tags{Core}
+*/
+class JUCE_API  Semaphore
+{
+public:
+    //==============================================================================
+    /** Creates a semaphore with the given count. */
+    explicit Semaphore (int initialCount = 0);
+
+    /** Destructor. Don't delete a semaphore while a thread is waiting on it. */
+    ~Semaphore();
+
+    //==============================================================================
+    /** Suspends the calling thread until the count is above zero, then decrements it.
+
+        @param timeOutMilliseconds  the maximum time to wait, in milliseconds. A negative
+                                    value will cause it to wait forever.
+
+        @returns    true if the count was decremented, false if the timeout expires first.
+    */
+    bool wait (double timeOutMilliseconds = -1.0) const;
+
+    /** Increments the count, waking one waiting thread if there is one. */
+    void post() const noexcept;
+
+private:
+    //==============================================================================
+    class NativeSemaphore;
+    std::unique_ptr<NativeSemaphore> semaphore;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Semaphore)
+};
+
+} // namespace juce
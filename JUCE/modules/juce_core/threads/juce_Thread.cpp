@@ -345,6 +345,10 @@ bool Thread::launch (Priority priority, std::function<void()> functionToRun)
 //==============================================================================
 void SpinLock::enter() const noexcept
 {
+   #if JUCE_ENABLE_LOCK_HOOKS
+    LockHooks::notifyLockEntered (this, LockHooks::LockType::spinLock);
+   #endif
+
     if (! tryEnter())
     {
         for (int i = 20; --i >= 0;)
@@ -68,6 +68,10 @@ bool WaitableEvent::wait (double timeOutMilliseconds) const
 
 void WaitableEvent::signal() const
 {
+   #if JUCE_ENABLE_LOCK_HOOKS
+    LockHooks::notifyLockEntered (this, LockHooks::LockType::waitableEvent);
+   #endif
+
     std::lock_guard<std::mutex> lock (mutex);
 
     triggered = true;
@@ -0,0 +1,322 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+//==============================================================================
+/*  Real and imaginary parts of the dot product of interleaved complex input with
+    a kernel row stored as (re, -im) and (im, re) pairs. All three pointers are
+    SIMD aligned and numValues is a multiple of the SIMD width.
+*/
+static void constantQDotProduct (const float* input, const float* kernelReal, const float* kernelImag,
+                                 int numValues, float& real, float& imag) noexcept
+{
+   #if JUCE_USE_SIMD
+    using Vec = SIMDRegister<float>;
+    auto sumReal = Vec::expand (0.0f), sumImag = Vec::expand (0.0f);
+
+    for (int i = 0; i < numValues; i += (int) Vec::size())
+    {
+        const auto x = Vec::fromRawArray (input + i);
+        sumReal = Vec::multiplyAdd (sumReal, x, Vec::fromRawArray (kernelReal + i));
+        sumImag = Vec::multiplyAdd (sumImag, x, Vec::fromRawArray (kernelImag + i));
+    }
+
+    real = sumReal.sum();
+    imag = sumImag.sum();
+   #else
+    real = imag = 0.0f;
+
+    for (int i = 0; i < numValues; ++i)
+    {
+        real += input[i] * kernelReal[i];
+        imag += input[i] * kernelImag[i];
+    }
+   #endif
+}
+
+static constexpr int constantQSIMDWidth()
+{
+   #if JUCE_USE_SIMD
+    return (int) SIMDRegister<float>::size();
+   #else
+    return 1;
+   #endif
+}
+
+//==============================================================================
+int ConstantQTransform::getNumOctaves (const Parameters& p)
+{
+    jassert (p.sampleRate > 0.0 && p.minFrequency > 0.0f && p.minFrequency < p.maxFrequency);
+
+    const auto maxFrequency = jmin ((double) p.maxFrequency, 0.45 * p.sampleRate);
+    return jmax (1, (int) std::floor (std::log2 (maxFrequency / p.minFrequency) + 1.0e-9));
+}
+
+int ConstantQTransform::getFrameOrder (const Parameters& p)
+{
+    // the lowest bin of the top octave has the longest kernel
+    const auto q = 1.0 / (std::pow (2.0, 1.0 / jmax (1, p.binsPerOctave)) - 1.0);
+    const auto lowestTopFrequency = p.minFrequency * std::pow (2.0, getNumOctaves (p) - 1);
+    const auto longestKernel = (int) std::ceil (q * p.sampleRate / lowestTopFrequency);
+
+    return jmax (1, (int) std::ceil (std::log2 (jmax (2, longestKernel, p.minimumFrameSize))));
+}
+
+ConstantQTransform::ConstantQTransform (const Parameters& p)
+    : sampleRate (p.sampleRate),
+      binsPerOctave (jmax (1, p.binsPerOctave)),
+      numOctaves (getNumOctaves (p)),
+      frameSize (1 << getFrameOrder (p)),
+      minFrequency (p.minFrequency),
+      fft (getFrameOrder (p))
+{
+    buildKernel (p.sparsity);
+
+    // Each halfband filter has to pass the octave below it untouched and stop whatever
+    // would alias into it, which leaves it the gap between the top of the transform
+    // and the Nyquist frequency as its transition band
+    const auto topEdge = minFrequency * std::pow (2.0, numOctaves);
+    const auto transitionWidth = jlimit (0.05f, 0.2f, (float) (0.5 - topEdge / sampleRate));
+    const auto halfband = FilterDesign<float>::designFIRLowpassHalfBandEquirippleMethod (transitionWidth, -80.0f);
+    const auto& coefficients = halfband->coefficients;
+
+    numTaps = coefficients.size();
+    jassert (numTaps % 4 == 3 && approximatelyEqual (coefficients[numTaps / 2], 0.5f));
+
+    for (int i = numTaps / 2 + 1; i < numTaps; i += 2)
+        sideTaps.push_back (coefficients[i]);
+
+    octaves.resize ((size_t) numOctaves);
+
+    for (auto& octave : octaves)
+    {
+        octave.frame.resize ((size_t) frameSize);
+        octave.history.resize ((size_t) numTaps * 2);
+    }
+
+    frameScratch.resize ((size_t) (numOctaves * frameSize));
+    framePointers.resize ((size_t) numOctaves);
+
+    for (int i = 0; i < numOctaves; ++i)
+        framePointers[(size_t) i] = frameScratch.data() + i * frameSize;
+
+    reset();
+}
+
+ConstantQTransform::~ConstantQTransform() = default;
+
+void ConstantQTransform::buildKernel (float sparsity)
+{
+    constexpr auto width = constantQSIMDWidth();
+    constexpr auto complexPerVector = jmax (1, width / 2);
+
+    const auto q = 1.0 / (std::pow (2.0, 1.0 / binsPerOctave) - 1.0);
+    const auto numSpectrumBins = frameSize / 2 + 1;
+    const auto paddedSpectrumBins = (numSpectrumBins + 2 * complexPerVector - 1) / complexPerVector * complexPerVector;
+
+    HeapBlock<Complex<float>> temporal ((size_t) frameSize), spectral ((size_t) frameSize);
+    std::vector<float> real, imag;
+
+    for (int b = 0; b < binsPerOctave; ++b)
+    {
+        // Hann window of Q cycles at the bin frequency, ending at the newest sample of
+        // the frame and scaled so a full-scale sine gives a magnitude of one
+        const auto frequency = (double) getBinFrequency ((numOctaves - 1) * binsPerOctave + b);
+        const auto length = jlimit (1, frameSize, (int) std::ceil (q * sampleRate / frequency));
+        const auto scale = 4.0 / length;
+
+        zeromem (temporal.getData(), (size_t) frameSize * sizeof (Complex<float>));
+
+        for (int n = 0; n < length; ++n)
+        {
+            const auto window = 0.5 - 0.5 * std::cos (MathConstants<double>::twoPi * (n + 0.5) / length);
+            const auto phase = MathConstants<double>::twoPi * frequency * n / sampleRate;
+            temporal[frameSize - length + n] = Complex<float> ((float) (scale * window * std::cos (phase)),
+                                                               (float) (scale * window * std::sin (phase)));
+        }
+
+        fft.perform (temporal.getData(), spectral.getData(), false);
+
+        // By Parseval, the windowed sum over the frame equals the sum over positive
+        // frequency bins of its spectrum times conj (kernel spectrum) / frameSize.
+        // Only the main lobe is kept, widened to whole aligned vectors.
+        auto peak = 0.0f;
+
+        for (int k = 0; k < numSpectrumBins; ++k)
+            peak = jmax (peak, std::abs (spectral[k]));
+
+        int first = 0, last = numSpectrumBins - 1;
+
+        while (first < last && std::abs (spectral[first]) < sparsity * peak)  ++first;
+        while (last > first && std::abs (spectral[last])  < sparsity * peak)  --last;
+
+        first -= first % complexPerVector;
+        const auto count = (last - first + complexPerVector) / complexPerVector * complexPerVector;
+        jassert (first + count <= paddedSpectrumBins);
+
+        rows.push_back ({ (int) real.size(), 2 * first, 2 * count });
+        numKernelValues += last - first + 1;
+
+        for (int k = first; k < first + count; ++k)
+        {
+            const auto value = k < numSpectrumBins ? std::conj (spectral[k]) / (float) frameSize : Complex<float>();
+            real.insert (real.end(), { value.real(), -value.imag() });
+            imag.insert (imag.end(), { value.imag(), value.real() });
+        }
+    }
+
+    const auto numKernelFloats = real.size();
+    storage.calloc (2 * numKernelFloats + (size_t) (2 * paddedSpectrumBins + width));
+
+    auto* base = storage.getData();
+
+   #if JUCE_USE_SIMD
+    base = SIMDRegister<float>::getNextSIMDAlignedPtr (base);
+   #endif
+
+    kernelReal = base;
+    kernelImag = kernelReal + numKernelFloats;
+    spectrum = kernelImag + numKernelFloats;
+
+    std::copy (real.begin(), real.end(), kernelReal);
+    std::copy (imag.begin(), imag.end(), kernelImag);
+}
+
+//==============================================================================
+float ConstantQTransform::getBinFrequency (int bin) const noexcept
+{
+    return (float) (minFrequency * std::pow (2.0, (double) bin / binsPerOctave));
+}
+
+void ConstantQTransform::reset() noexcept
+{
+    for (auto& octave : octaves)
+    {
+        std::fill (octave.frame.begin(), octave.frame.end(), 0.0f);
+        std::fill (octave.history.begin(), octave.history.end(), 0.0f);
+        octave.framePosition = octave.historyPosition = 0;
+        octave.hasOddSample = false;
+    }
+}
+
+void ConstantQTransform::pushSamples (const float* input, int numSamples) noexcept
+{
+    for (int i = 0; i < numSamples; ++i)
+        pushSample (input[i]);
+}
+
+void ConstantQTransform::pushSample (float sample) noexcept
+{
+    const auto centre = numTaps / 2;
+    const auto numSideTaps = (int) sideTaps.size();
+
+    for (int index = 0;; ++index)
+    {
+        auto& octave = octaves[(size_t) index];
+
+        octave.frame[(size_t) octave.framePosition] = sample;
+
+        if (++octave.framePosition == frameSize)
+            octave.framePosition = 0;
+
+        if (index + 1 == numOctaves)
+            return;
+
+        octave.history[(size_t) octave.historyPosition] = sample;
+        octave.history[(size_t) (octave.historyPosition + numTaps)] = sample;
+
+        if (++octave.historyPosition == numTaps)
+            octave.historyPosition = 0;
+
+        // the next octave takes every second filtered sample
+        octave.hasOddSample = ! octave.hasOddSample;
+
+        if (octave.hasOddSample)
+            return;
+
+        // halfband: every other tap is zero apart from the centre one, which is 0.5
+        const auto* h = octave.history.data() + octave.historyPosition + centre;
+        auto output = 0.5f * h[0];
+
+        for (int i = 0; i < numSideTaps; ++i)
+            output += sideTaps[(size_t) i] * (h[-1 - 2 * i] + h[1 + 2 * i]);
+
+        sample = output;
+    }
+}
+
+void ConstantQTransform::copyOctaveFrame (int octaveIndex, float* destination) const noexcept
+{
+    jassert (isPositiveAndBelow (octaveIndex, numOctaves));
+
+    const auto& octave = octaves[(size_t) octaveIndex];
+    const auto tail = frameSize - octave.framePosition;
+
+    std::copy (octave.frame.begin() + octave.framePosition, octave.frame.end(), destination);
+    std::copy (octave.frame.begin(), octave.frame.begin() + octave.framePosition, destination + tail);
+}
+
+//==============================================================================
+void ConstantQTransform::perform (float* powerOutput) noexcept
+{
+    for (int i = 0; i < numOctaves; ++i)
+        copyOctaveFrame (i, frameScratch.data() + i * frameSize);
+
+    performOnFrames (framePointers.data(), powerOutput);
+}
+
+void ConstantQTransform::performOnFrames (const float* const* octaveFrames, float* powerOutput) noexcept
+{
+    for (int octave = 0; octave < numOctaves; ++octave)
+    {
+        fft.performHalfSpectrumForwardTransform (octaveFrames[octave], reinterpret_cast<Complex<float>*> (spectrum));
+
+        auto* output = powerOutput + (numOctaves - 1 - octave) * binsPerOctave;
+
+        for (int b = 0; b < binsPerOctave; ++b)
+        {
+            const auto& row = rows[(size_t) b];
+            float real, imag;
+
+            constantQDotProduct (spectrum + row.firstInput, kernelReal + row.firstValue, kernelImag + row.firstValue,
+                                 row.numValues, real, imag);
+
+            output[b] = real * real + imag * imag;
+        }
+    }
+}
+
+} // namespace juce::dsp
@@ -0,0 +1,192 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+/**
+    Computes a constant-Q spectrum: bins spaced evenly in log frequency, each with
+    a bandwidth proportional to its frequency, for analysis that needs musical
+    resolution at the low end without wasting bins on the highs.
+
+    This uses the sparse spectral kernel method of Brown and Puckette. The temporal
+    kernel of each bin (a Hann window of Q cycles at the bin frequency) is moved
+    into the frequency domain once, when the transform is created. Only its main
+    lobe is kept, so each bin becomes a short complex dot product with the FFT of
+    a frame. The dot products run on aligned SIMDRegister lanes.
+
+    A kernel is only built for the top octave. Each octave below it uses the same
+    kernel on a copy of the signal that has been low-pass filtered and decimated
+    by two once more, with halfband FIR filters (the multi-rate scheme of
+    Schoerkhuber and Klapuri). Every octave therefore costs one FFT of the same
+    frame size, however long the windows of its bins are.
+
+    Use it either as a stream, with pushSamples() and perform(), or pass your own
+    frames to performOnFrames(). The kernels are aligned to the end of the frame,
+    so each bin measures the window ending at the newest sample. The decimation
+    filters delay octave n by a further (2^n - 1) * getDecimationDelay() samples.
+
+    @tags{DSP}
+*/
+class JUCE_API  ConstantQTransform
+{
+public:
+    //==============================================================================
+    /** Configuration of a transform. */
+    struct Parameters
+    {
+        double sampleRate = 48000.0;
+
+        /** Frequency of the lowest bin. */
+        float minFrequency = 30.0f;
+
+        /** Upper limit for the highest bin. The transform covers as many whole
+            octaves from minFrequency as fit below this, and it is clipped to 0.45
+            times the sample rate.
+        */
+        float maxFrequency = 16000.0f;
+
+        /** Bins per octave, which sets Q = 1 / (2^(1 / binsPerOctave) - 1). */
+        int binsPerOctave = 24;
+
+        /** Frames are the next power of two that fits the longest kernel of the top
+            octave, or this many samples if it is larger.
+        */
+        int minimumFrameSize = 0;
+
+        /** Kernel values below this fraction of the peak of their bin are dropped. */
+        float sparsity = 0.005f;
+    };
+
+    /** Builds the kernel and allocates all the buffers the transform needs, so
+        nothing allocates afterwards.
+    */
+    explicit ConstantQTransform (const Parameters&);
+
+    /** Destructor. */
+    ~ConstantQTransform();
+
+    //==============================================================================
+    /** Returns the number of bins, which is getNumOctaves() * binsPerOctave. */
+    int getNumBins() const noexcept                     { return numOctaves * binsPerOctave; }
+
+    /** Returns the number of octaves covered. */
+    int getNumOctaves() const noexcept                  { return numOctaves; }
+
+    /** Returns the number of bins per octave. */
+    int getBinsPerOctave() const noexcept               { return binsPerOctave; }
+
+    /** Returns the number of samples in the frame of each octave. */
+    int getFrameSize() const noexcept                   { return frameSize; }
+
+    /** Returns the centre frequency of a bin, minFrequency * 2^(bin / binsPerOctave). */
+    float getBinFrequency (int bin) const noexcept;
+
+    /** Returns the number of complex kernel values kept for the top octave. */
+    int getNumKernelValues() const noexcept             { return numKernelValues; }
+
+    /** Returns the group delay of one decimation stage, in samples at its input rate. */
+    int getDecimationDelay() const noexcept             { return (numTaps - 1) / 2; }
+
+    //==============================================================================
+    /** Clears the frames of every octave and the decimation filters. */
+    void reset() noexcept;
+
+    /** Adds samples to the frame of the top octave and, decimated, to the octaves
+        below it.
+    */
+    void pushSamples (const float* input, int numSamples) noexcept;
+
+    /** Copies the current frame of an octave, oldest sample first. Octave 0 is the
+        top octave at the full sample rate, octave n is decimated by 2^n.
+    */
+    void copyOctaveFrame (int octave, float* destination) const noexcept;
+
+    /** Computes the power of every bin from the current frames, lowest bin first.
+        A full-scale sine at a bin frequency reads 1.
+    */
+    void perform (float* powerOutput) noexcept;
+
+    /** Computes the power of every bin from getNumOctaves() frames of getFrameSize()
+        samples, laid out as copyOctaveFrame() returns them, lowest bin first.
+
+        This only uses the kernel and its own scratch space, so one thread may call it
+        while another one pushes samples. It must not run on two threads at once.
+    */
+    void performOnFrames (const float* const* octaveFrames, float* powerOutput) noexcept;
+
+private:
+    //==============================================================================
+    struct KernelRow
+    {
+        int firstValue;     // index of the first float in the kernel arrays
+        int firstInput;     // index of the first float of the spectrum it multiplies
+        int numValues;      // floats, a multiple of the SIMD width
+    };
+
+    struct Octave
+    {
+        std::vector<float> frame;       // ring of frameSize samples
+        int framePosition = 0;
+
+        std::vector<float> history;     // decimation filter input, stored twice so it is contiguous
+        int historyPosition = 0;
+        bool hasOddSample = false;
+    };
+
+    static int getNumOctaves (const Parameters&);
+    static int getFrameOrder (const Parameters&);
+    void buildKernel (float sparsity);
+    void pushSample (float sample) noexcept;
+
+    double sampleRate;
+    int binsPerOctave, numOctaves, frameSize, numTaps = 0, numKernelValues = 0;
+    float minFrequency;
+    FFT fft;
+
+    std::vector<KernelRow> rows;
+    HeapBlock<float> storage;
+    float* kernelReal = nullptr;    // per row, interleaved (re, -im) of the kernel
+    float* kernelImag = nullptr;    // per row, interleaved (im, re)
+    float* spectrum = nullptr;      // frameSize / 2 + 1 complex bins, padded with zeros
+
+    std::vector<float> sideTaps;    // halfband taps at odd offsets from the centre, innermost first
+    std::vector<Octave> octaves;
+    std::vector<float> frameScratch;
+    std::vector<const float*> framePointers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ConstantQTransform)
+};
+
+} // namespace juce::dsp
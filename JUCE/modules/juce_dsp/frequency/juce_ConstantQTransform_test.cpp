@@ -0,0 +1,220 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+struct ConstantQTransformUnitTest final : public UnitTest
+{
+    ConstantQTransformUnitTest()
+        : UnitTest ("ConstantQTransform", UnitTestCategories::dsp)
+    {}
+
+    static constexpr double sampleRate = 48000.0;
+
+    static std::vector<float> makeSine (double frequency, float amplitude, int numSamples)
+    {
+        std::vector<float> signal ((size_t) numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+            signal[(size_t) i] = amplitude * (float) std::sin (MathConstants<double>::twoPi * frequency * i / sampleRate);
+
+        return signal;
+    }
+
+    // Hann-windowed correlation over the window of a bin that ends at the last sample
+    static double referencePower (const std::vector<float>& signal, double frequency, int binsPerOctave, int frameSize)
+    {
+        const auto q = 1.0 / (std::pow (2.0, 1.0 / binsPerOctave) - 1.0);
+        const auto length = jmin (frameSize, (int) std::ceil (q * sampleRate / frequency));
+        const auto start = (int) signal.size() - length;
+        std::complex<double> sum;
+
+        for (int n = 0; n < length; ++n)
+        {
+            const auto window = 0.5 - 0.5 * std::cos (MathConstants<double>::twoPi * (n + 0.5) / length);
+            sum += (double) signal[(size_t) (start + n)] * window * std::polar (1.0, -MathConstants<double>::twoPi * frequency * n / sampleRate);
+        }
+
+        return std::norm (sum * 4.0 / (double) length);
+    }
+
+    void runTest() override
+    {
+        ConstantQTransform::Parameters parameters;
+        parameters.sampleRate = sampleRate;
+        parameters.minFrequency = 30.0f;
+        parameters.maxFrequency = 16000.0f;
+        parameters.binsPerOctave = 24;
+
+        beginTest ("Layout");
+        {
+            ConstantQTransform cq (parameters);
+
+            expectEquals (cq.getNumOctaves(), 9);
+            expectEquals (cq.getNumBins(), 9 * 24);
+            expectWithinAbsoluteError (cq.getBinFrequency (24), 60.0f, 1.0e-3f);
+            expectWithinAbsoluteError (cq.getBinFrequency (cq.getNumBins() - 1), 7680.0f * std::pow (2.0f, 23.0f / 24.0f), 0.1f);
+            expectEquals (cq.getFrameSize(), 256);
+
+            parameters.minimumFrameSize = 1024;
+            expectEquals (ConstantQTransform (parameters).getFrameSize(), 1024);
+            parameters.minimumFrameSize = 0;
+        }
+
+        beginTest ("A sine peaks in its own bin in every octave");
+        {
+            ConstantQTransform cq (parameters);
+            std::vector<float> power ((size_t) cq.getNumBins());
+
+            for (int bin = 5; bin < cq.getNumBins(); bin += 23)
+            {
+                cq.reset();
+
+                const auto signal = makeSine (cq.getBinFrequency (bin), 0.5f, 3 * (int) sampleRate);
+                cq.pushSamples (signal.data(), (int) signal.size());
+                cq.perform (power.data());
+
+                const auto peak = (int) (std::max_element (power.begin(), power.end()) - power.begin());
+
+                expectEquals (peak, bin);
+                expectWithinAbsoluteError (power[(size_t) bin], 0.25f, 0.02f, "bin " + String (bin));
+
+                // an octave away it is stopped by the window, or the decimation filters
+                for (auto other : { bin - 24, bin + 24 })
+                    if (isPositiveAndBelow (other, cq.getNumBins()))
+                        expectLessThan (power[(size_t) other], 1.0e-4f, "bin " + String (other));
+            }
+        }
+
+        beginTest ("Top octave matches the windowed correlation");
+        {
+            ConstantQTransform cq (parameters);
+            std::vector<float> power ((size_t) cq.getNumBins());
+
+            Random random (4711);
+            std::vector<float> signal (8192);
+
+            for (size_t i = 0; i < signal.size(); ++i)
+                signal[i] = 0.3f * (float) std::sin (MathConstants<double>::twoPi * 9000.0 * (double) i / sampleRate)
+                          + 0.3f * (2.0f * random.nextFloat() - 1.0f);
+
+            cq.pushSamples (signal.data(), (int) signal.size());
+            cq.perform (power.data());
+
+            const auto firstTopBin = cq.getNumBins() - cq.getBinsPerOctave();
+            auto worstError = 0.0;
+
+            for (int bin = firstTopBin; bin < cq.getNumBins(); ++bin)
+            {
+                const auto expected = referencePower (signal, cq.getBinFrequency (bin), cq.getBinsPerOctave(), cq.getFrameSize());
+                worstError = jmax (worstError, std::abs (std::sqrt ((double) power[(size_t) bin]) - std::sqrt (expected)));
+            }
+
+            // only the energy outside the main lobe of the kernel is missing
+            expectLessThan (worstError, 2.0e-3);
+        }
+
+        beginTest ("Kernel is sparse and frames can come from elsewhere");
+        {
+            ConstantQTransform cq (parameters);
+
+            const auto denseValues = cq.getBinsPerOctave() * (cq.getFrameSize() / 2 + 1);
+            expectLessThan (cq.getNumKernelValues(), denseValues / 8);
+
+            Random random (99);
+            std::vector<float> signal (20000);
+
+            for (auto& sample : signal)
+                sample = 2.0f * random.nextFloat() - 1.0f;
+
+            cq.pushSamples (signal.data(), (int) signal.size());
+
+            std::vector<float> streamed ((size_t) cq.getNumBins()), fromFrames ((size_t) cq.getNumBins());
+            cq.perform (streamed.data());
+
+            std::vector<std::vector<float>> frames;
+            std::vector<const float*> pointers;
+
+            for (int octave = 0; octave < cq.getNumOctaves(); ++octave)
+            {
+                frames.emplace_back ((size_t) cq.getFrameSize());
+                cq.copyOctaveFrame (octave, frames.back().data());
+            }
+
+            for (auto& frame : frames)
+                pointers.push_back (frame.data());
+
+            cq.performOnFrames (pointers.data(), fromFrames.data());
+            expect (streamed == fromFrames);
+        }
+
+        beginTest ("Constant-Q benchmark");
+        {
+            Random random (1);
+            std::vector<float> signal (1 << 16);
+
+            for (auto& sample : signal)
+                sample = 2.0f * random.nextFloat() - 1.0f;
+
+            for (auto binsPerOctave : { 12, 24, 48 })
+            {
+                parameters.binsPerOctave = binsPerOctave;
+                ConstantQTransform cq (parameters);
+                std::vector<float> power ((size_t) cq.getNumBins());
+
+                const auto hop = 480;
+                const auto start = Time::getHighResolutionTicks();
+
+                for (int done = 0; done + hop <= (int) signal.size(); done += hop)
+                {
+                    cq.pushSamples (signal.data() + done, hop);
+                    cq.perform (power.data());
+                }
+
+                const auto seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+                const auto numFrames = (int) signal.size() / hop;
+
+                logMessage (String (binsPerOctave) + " bins per octave, " + String (cq.getNumBins()) + " bins, "
+                            + String (cq.getNumKernelValues()) + " kernel values: "
+                            + String (seconds * 1.0e6 / numFrames, 2) + " us per frame of " + String (hop) + " samples");
+                expectGreaterThan (seconds, 0.0);
+            }
+        }
+    }
+};
+
+static ConstantQTransformUnitTest constantQTransformUnitTest;
+
+} // namespace juce::dsp
@@ -446,6 +446,350 @@ struct ConvolutionEngine
     std::vector<AudioBuffer<float>> buffersInputSegments, buffersImpulseSegments;
 };
 
+class BackgroundConvolutionTail;
+
+//==============================================================================
+// The threads that compute every convolution tail in the process, so the number of
+// threads doesn't grow with the number of convolutions.
+//
+// The audio thread waits for a tail block that a worker is still running, so the
+// workers run at realtime priority where the system allows it. Otherwise they use
+// the highest normal priority.
+class BackgroundConvolutionTailPool
+{
+public:
+    BackgroundConvolutionTailPool()
+    {
+        const auto numWorkers = jmax (1, SystemStats::getNumCpus() - 1);
+
+        for (int i = 0; i < numWorkers; ++i)
+        {
+            auto* worker = workers.add (new Worker (*this));
+
+            if (! worker->startRealtimeThread (Thread::RealtimeOptions{}))
+                worker->startThread (Thread::Priority::highest);
+        }
+    }
+
+    ~BackgroundConvolutionTailPool()
+    {
+        for (auto* worker : workers)
+            worker->signalThreadShouldExit();
+
+        for (int i = 0; i < workers.size(); ++i)
+            workAvailable.post();
+
+        for (auto* worker : workers)
+            worker->stopThread (-1);
+    }
+
+    void add (BackgroundConvolutionTail& tail)
+    {
+        const ScopedWriteLock lock (tailLock);
+        tails.add (&tail);
+    }
+
+    // Returns once no worker is running a block of the tail
+    void remove (BackgroundConvolutionTail& tail)
+    {
+        const ScopedWriteLock lock (tailLock);
+        tails.removeFirstMatchingValue (&tail);
+    }
+
+    // Audio thread: wakes a worker after a tail has a new block. Takes no lock.
+    void notify()
+    {
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+
+        // One post per sleeping worker at most, so a run of blocks doesn't leave a
+        // backlog of wake-ups that find nothing to do
+        if (numSleepingWorkers.load() > numPendingWakes.load())
+        {
+            numPendingWakes.fetch_add (1);
+            workAvailable.post();
+        }
+    }
+
+private:
+    class Worker final : public Thread
+    {
+    public:
+        explicit Worker (BackgroundConvolutionTailPool& p)
+            : Thread (SystemStats::getJUCEVersion() + ": Convolution background tail"), pool (p) {}
+
+        void run() override
+        {
+            while (! threadShouldExit())
+            {
+                if (pool.runNextPendingBlock())
+                    continue;
+
+                // Announce the sleep, then look once more. With the fence in notify(),
+                // either this look finds a block pushed in between or notify() sees
+                // this worker asleep and wakes it.
+                pool.numSleepingWorkers.fetch_add (1);
+                std::atomic_thread_fence (std::memory_order_seq_cst);
+
+                if (! pool.runNextPendingBlock() && pool.workAvailable.wait())
+                    pool.numPendingWakes.fetch_sub (1);
+
+                pool.numSleepingWorkers.fetch_sub (1);
+            }
+        }
+
+    private:
+        BackgroundConvolutionTailPool& pool;
+    };
+
+    bool runNextPendingBlock();
+
+    OwnedArray<Worker> workers;
+    ReadWriteLock tailLock;
+    Array<BackgroundConvolutionTail*> tails;
+    std::atomic<int> numSleepingWorkers { 0 }, numPendingWakes { 0 };
+    Semaphore workAvailable;
+};
+
+//==============================================================================
+// The tail of a non-uniform convolution, computed on the shared background threads.
+//
+// The tail is split into stages whose block size doubles along the impulse response,
+// each starting at least four of its blocks into it. A stage adds one block of latency,
+// and its output isn't needed until (offset - blockSize) samples after that, so the
+// threads have at least one block period of the stage to finish each block. If they still
+// falls behind (an overloaded machine, or an offline render faster than realtime), the
+// audio thread runs the late block itself or waits for the one in progress, so the
+// output is always the same as with uniform partitioning.
+class BackgroundConvolutionTail
+{
+public:
+    static constexpr int maxStageBlockSize = 8192;
+
+    BackgroundConvolutionTail (const AudioBuffer<float>& buf, int numChannels, int headLength, int maxBlockSize)
+    {
+        jassert (isPowerOfTwo (headLength) && headLength >= 4 * maxBlockSize);
+
+        const auto irSize = buf.getNumSamples();
+        auto largestBlock = 0;
+
+        for (auto offset = headLength; offset < irSize;)
+        {
+            const auto blockSize = jmin (maxStageBlockSize, offset / 4);
+            const auto length = blockSize == maxStageBlockSize ? irSize - offset : jmin (offset, irSize - offset);
+
+            auto stage = std::make_unique<Stage>();
+            stage->offset = offset;
+            stage->blockSize = blockSize;
+            stage->output.setSize (numChannels, nextPowerOfTwo (offset + 2 * maxBlockSize));
+            stage->output.clear();
+            stage->outputChannels = stage->output.getArrayOfWritePointers();
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                stage->engines.push_back (std::make_unique<ConvolutionEngine> (buf.getReadPointer (jmin (buf.getNumChannels() - 1, channel), offset),
+                                                                               (size_t) length,
+                                                                               (size_t) blockSize));
+
+            stages.push_back (std::move (stage));
+            largestBlock = blockSize;
+            offset += length;
+        }
+
+        input.setSize (numChannels, nextPowerOfTwo (4 * largestBlock + 2 * maxBlockSize));
+        input.clear();
+        inputChannels = input.getArrayOfWritePointers();
+
+        pool->add (*this);
+    }
+
+    ~BackgroundConvolutionTail()
+    {
+        pool->remove (*this);
+    }
+
+    // Called between blocks, on the thread that processes them
+    void reset()
+    {
+        for (auto& stage : stages)
+        {
+            // Keep every thread from starting a block, once any block in progress is done
+            for (;;)
+            {
+                auto done = stage->blocksDone.load();
+
+                if (stage->nextBlock.compare_exchange_strong (done, lockedBlock))
+                    break;
+
+                Thread::yield();
+            }
+
+            for (auto& engine : stage->engines)
+                engine->reset();
+
+            for (int channel = 0; channel < stage->output.getNumChannels(); ++channel)
+                FloatVectorOperations::clear (stage->outputChannels[channel], stage->output.getNumSamples());
+        }
+
+        for (int channel = 0; channel < input.getNumChannels(); ++channel)
+            FloatVectorOperations::clear (inputChannels[channel], input.getNumSamples());
+
+        samplesWritten.store (0);
+
+        for (auto& stage : stages)
+        {
+            stage->blocksDone.store (0);
+            stage->nextBlock.store (0);
+        }
+    }
+
+    // Audio thread: stores the input before the head overwrites it in place
+    void pushSamples (const AudioBlock<const float>& block, size_t numChannels, size_t numSamples)
+    {
+        const auto written = samplesWritten.load (std::memory_order_relaxed);
+        const auto capacity = input.getNumSamples();
+        const auto lastOverwritten = written + (int64) numSamples - 1 - capacity;
+
+        // Blocks that are still unprocessed can't be overwritten
+        for (auto& stage : stages)
+            if (lastOverwritten >= 0)
+                waitForBlocks (*stage, lastOverwritten / stage->blockSize + 1);
+
+        const auto mask = capacity - 1;
+        const auto position = (int) (written & mask);
+        const auto first = jmin ((int) numSamples, capacity - position);
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            FloatVectorOperations::copy (inputChannels[channel] + position, block.getChannelPointer (channel), first);
+            FloatVectorOperations::copy (inputChannels[channel], block.getChannelPointer (channel) + first, (int) numSamples - first);
+        }
+
+        numActiveChannels.store ((int) numChannels, std::memory_order_relaxed);
+        samplesWritten.store (written + (int64) numSamples, std::memory_order_release);
+
+        const auto smallestBlock = (int64) stages.front()->blockSize;
+        hasNewBlock = (written + (int64) numSamples) / smallestBlock != written / smallestBlock;
+    }
+
+    // Audio thread: adds the tail for the samples passed to the last pushSamples() call
+    void addTo (AudioBlock<float>& output, size_t numChannels, size_t numSamples)
+    {
+        const auto end = samplesWritten.load (std::memory_order_relaxed);
+        const auto start = end - (int64) numSamples;
+
+        for (auto& stage : stages)
+        {
+            // The newest output sample comes from input at end - 1 - offset + blockSize
+            const auto lastSource = end - 1 - stage->offset + stage->blockSize;
+
+            if (lastSource < 0)
+                continue;
+
+            waitForBlocks (*stage, lastSource / stage->blockSize + 1);
+
+            const auto mask = stage->output.getNumSamples() - 1;
+            const auto position = (int) (start & mask);
+            const auto first = jmin ((int) numSamples, stage->output.getNumSamples() - position);
+
+            for (size_t channel = 0; channel < numChannels; ++channel)
+            {
+                auto* destination = output.getChannelPointer (channel);
+                const auto* source = stage->outputChannels[channel];
+
+                FloatVectorOperations::add (destination, source + position, first);
+                FloatVectorOperations::add (destination + first, source, (int) numSamples - first);
+            }
+        }
+
+        // Woken only now, so on a machine with few cores a worker doesn't compete
+        // with the head for the audio thread's core
+        if (std::exchange (hasNewBlock, false))
+            pool->notify();
+    }
+
+    // Pool worker: runs one block that is ready, if there is one.
+    // Smaller blocks have the closer deadlines, so they go first.
+    bool runNextPendingBlock()
+    {
+        for (auto& stage : stages)
+            if (tryRunNextBlock (*stage))
+                return true;
+
+        return false;
+    }
+
+private:
+    struct Stage
+    {
+        int offset = 0, blockSize = 0;
+        std::vector<std::unique_ptr<ConvolutionEngine>> engines;
+
+        // Ring of output samples, indexed by the input sample they line up with. Every
+        // thread uses the channel pointers, never the buffer's own accessors, which
+        // update its isClear flag.
+        AudioBuffer<float> output;
+        float* const* outputChannels = nullptr;
+
+        // Blocks before blocksDone are finished. A thread runs block n after moving
+        // nextBlock from n to n + 1, so only one block of a stage runs at a time.
+        std::atomic<int64> nextBlock { 0 }, blocksDone { 0 };
+    };
+
+    static constexpr auto lockedBlock = std::numeric_limits<int64>::max();
+
+    bool tryRunNextBlock (Stage& stage)
+    {
+        auto block = stage.blocksDone.load (std::memory_order_acquire);
+
+        if ((block + 1) * stage.blockSize > samplesWritten.load (std::memory_order_acquire))
+            return false;
+
+        if (! stage.nextBlock.compare_exchange_strong (block, block + 1, std::memory_order_acq_rel))
+            return false;
+
+        // Neither ring wraps inside a block, as their sizes are multiples of the block size
+        const auto start = block * stage.blockSize;
+        const auto inputPosition = (int) (start & (input.getNumSamples() - 1));
+        const auto outputPosition = (int) ((start + stage.offset - stage.blockSize) & (stage.output.getNumSamples() - 1));
+        const auto numChannels = jmin ((int) stage.engines.size(), numActiveChannels.load (std::memory_order_relaxed));
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            stage.engines[(size_t) channel]->processSamplesWithAddedLatency (inputChannels[channel] + inputPosition,
+                                                                             stage.outputChannels[channel] + outputPosition,
+                                                                             (size_t) stage.blockSize);
+
+        stage.blocksDone.store (block + 1, std::memory_order_release);
+        return true;
+    }
+
+    void waitForBlocks (Stage& stage, int64 numBlocks)
+    {
+        while (stage.blocksDone.load (std::memory_order_acquire) < numBlocks)
+            if (! tryRunNextBlock (stage))
+                Thread::yield();    // a worker is running it
+    }
+
+    std::vector<std::unique_ptr<Stage>> stages;
+    AudioBuffer<float> input;
+    float* const* inputChannels = nullptr;
+    std::atomic<int64> samplesWritten { 0 };
+    std::atomic<int> numActiveChannels { 0 };
+    bool hasNewBlock = false;
+    SharedResourcePointer<BackgroundConvolutionTailPool> pool;
+};
+
+// Tails are tried in the order they were added. The read lock only keeps remove()
+// from returning while a block of the tail is running.
+bool BackgroundConvolutionTailPool::runNextPendingBlock()
+{
+    const ScopedReadLock lock (tailLock);
+
+    for (auto* tail : tails)
+        if (tail->runNextPendingBlock())
+            return true;
+
+    return false;
+}
+
 //==============================================================================
 class MultichannelEngine
 {
@@ -475,6 +819,18 @@ public:
             for (int i = 0; i < numChannels; ++i)
                 head.emplace_back (makeEngine (i, 0, buf.getNumSamples(), static_cast<uint32> (maxBufferSize)));
         }
+        else if (isZeroDelay && headSizeIn.processTailInBackground)
+        {
+            // The first tail stage needs a block at least as large as the host's
+            const auto headLength = jmax (headSizeIn.headSizeInSamples, 4 * nextPowerOfTwo (maxBlockSize));
+            const auto size = jmin (buf.getNumSamples(), headLength);
+
+            for (int i = 0; i < numChannels; ++i)
+                head.emplace_back (makeEngine (i, 0, size, static_cast<uint32> (maxBufferSize)));
+
+            if (size != buf.getNumSamples())
+                backgroundTail = std::make_unique<BackgroundConvolutionTail> (buf, numChannels, headLength, maxBlockSize);
+        }
         else
         {
             const auto size = jmin (buf.getNumSamples(), headSizeIn.headSizeInSamples);
@@ -497,6 +853,9 @@ public:
 
         for (const auto& e : tail)
             e->reset();
+
+        if (backgroundTail != nullptr)
+            backgroundTail->reset();
     }
 
     void processSamples (const AudioBlock<const float>& input, AudioBlock<float>& output)
@@ -509,6 +868,9 @@ public:
 
         const auto isUniform = tail.empty();
 
+        if (backgroundTail != nullptr)
+            backgroundTail->pushSamples (input, numChannels, numSamples);
+
         for (size_t channel = 0; channel < numChannels; ++channel)
         {
             if (! isUniform)
@@ -529,6 +891,9 @@ public:
                 output.getSingleChannelBlock (channel) += tailBlock;
         }
 
+        if (backgroundTail != nullptr)
+            backgroundTail->addTo (output, numChannels, numSamples);
+
         const auto numOutputChannels = output.getNumChannels();
 
         for (auto i = numChannels; i < numOutputChannels; ++i)
@@ -542,6 +907,7 @@ public:
 private:
     std::vector<std::unique_ptr<ConvolutionEngine>> head, tail;
     AudioBuffer<float> tailBuffer;
+    std::unique_ptr<BackgroundConvolutionTail> backgroundTail;
 
     const int latency;
     const int irSize;
@@ -740,7 +1106,8 @@ public:
     ConvolutionEngineFactory (Convolution::Latency requiredLatency,
                               Convolution::NonUniform requiredHeadSize)
         : latency  { (requiredLatency.latencyInSamples   <= 0) ? 0 : jmax (64, nextPowerOfTwo (requiredLatency.latencyInSamples)) },
-          headSize { (requiredHeadSize.headSizeInSamples <= 0) ? 0 : jmax (64, nextPowerOfTwo (requiredHeadSize.headSizeInSamples)) },
+          headSize { (requiredHeadSize.headSizeInSamples <= 0) ? 0 : jmax (64, nextPowerOfTwo (requiredHeadSize.headSizeInSamples)),
+                     requiredHeadSize.processTailInBackground },
           shouldBeZeroLatency (requiredLatency.latencyInSamples == 0)
     {}
 
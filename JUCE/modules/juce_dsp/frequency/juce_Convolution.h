@@ -138,7 +138,17 @@ public:
     explicit Convolution (const Latency& requiredLatency);
 
     /** Contains configuration information for a non-uniform convolution. */
-    struct NonUniform { int headSizeInSamples; };
+    struct NonUniform
+    {
+        int headSizeInSamples;
+
+        /** If true, only the head is convolved during process(). The rest of the IR
+            is split into partitions that double in size along it, which a background
+            thread owned by the convolution works through ahead of when their output
+            is needed. The output and latency are the same as with uniform partitioning.
+        */
+        bool processTailInBackground = false;
+    };
 
     /** Initialises an object for performing convolution in the frequency domain
         using a non-uniform partitioned algorithm.
@@ -147,6 +157,13 @@ public:
         efficiency of the processing for IR sizes of 4096 samples or greater
         (recommended for reverberation IRs).
 
+        With processTailInBackground set, the head is made at least four times the
+        maximum block size, and the audio thread only convolves the head. The rest
+        runs on a pool of background threads shared by every Convolution in the
+        process. For IRs of several seconds this removes almost all of the work from
+        process(). Should the background threads fall behind, process() finishes the
+        late partitions itself, so this never changes the output.
+
         @param requiredHeadSize       the head IR size for two stage non-uniform
                                       partitioned convolution
      */
@@ -115,6 +115,89 @@ class ConvolutionTest final : public UnitTest
         expect (std::abs (a - b) < error);
     }
 
+    static AudioBuffer<float> makeDecayingNoise (int numChannels, int length)
+    {
+        Random random (0x1234);
+        AudioBuffer<float> result (numChannels, length);
+
+        for (auto channel = 0; channel != numChannels; ++channel)
+            for (auto sample = 0; sample != length; ++sample)
+                result.setSample (channel, sample, (2.0f * random.nextFloat() - 1.0f) * std::exp (-3.0f * (float) sample / (float) length));
+
+        return result;
+    }
+
+    struct TailComparison
+    {
+        float maxError = 0.0f, peak = 0.0f;
+        double uniformMicroseconds = 0.0, backgroundMicroseconds = 0.0;
+    };
+
+    // Runs noise through a uniform and a background-tail convolution of the same IR,
+    // in blocks of random size. With a speed above zero, blocks are paced at that many
+    // times realtime. Reports the time each spends in process() per full block.
+    static TailComparison compareWithUniform (const ProcessSpec& spec, const AudioBuffer<float>& ir, int numSamples, double speed)
+    {
+        Convolution uniform, background (Convolution::NonUniform { 256, true });
+
+        for (auto* convolution : { &uniform, &background })
+        {
+            auto copy = ir;
+            convolution->loadImpulseResponse (std::move (copy), spec.sampleRate, Convolution::Stereo::yes,
+                                              Convolution::Trim::no, Convolution::Normalise::no);
+            convolution->prepare (spec);
+        }
+
+        Random random (0x5678);
+        AudioBuffer<float> a ((int) spec.numChannels, (int) spec.maximumBlockSize), b (a);
+        TailComparison result;
+        int64 uniformTicks = 0, backgroundTicks = 0;
+        const auto startTime = Time::getMillisecondCounterHiRes();
+
+        for (int done = 0; done < numSamples;)
+        {
+            const auto blockSize = speed > 0.0 ? (int) spec.maximumBlockSize
+                                               : 1 + random.nextInt ((int) spec.maximumBlockSize);
+
+            for (auto channel = 0; channel != a.getNumChannels(); ++channel)
+                for (auto sample = 0; sample != blockSize; ++sample)
+                    a.setSample (channel, sample, 2.0f * random.nextFloat() - 1.0f);
+
+            b.makeCopyOf (a, true);
+
+            const auto process = [blockSize] (Convolution& convolution, AudioBuffer<float>& buffer)
+            {
+                AudioBlock<float> block (buffer);
+                auto subBlock = block.getSubBlock (0, (size_t) blockSize);
+                const auto start = Time::getHighResolutionTicks();
+                convolution.process (ProcessContextReplacing<float> (subBlock));
+                return Time::getHighResolutionTicks() - start;
+            };
+
+            uniformTicks += process (uniform, a);
+            backgroundTicks += process (background, b);
+
+            for (auto channel = 0; channel != a.getNumChannels(); ++channel)
+            {
+                for (auto sample = 0; sample != blockSize; ++sample)
+                {
+                    result.peak = jmax (result.peak, std::abs (a.getSample (channel, sample)));
+                    result.maxError = jmax (result.maxError, std::abs (a.getSample (channel, sample) - b.getSample (channel, sample)));
+                }
+            }
+
+            done += blockSize;
+
+            if (speed > 0.0)
+                Time::waitForMillisecondCounter ((uint32) (startTime + 1000.0 * done / (spec.sampleRate * speed)));
+        }
+
+        const auto numBlocks = (double) numSamples / spec.maximumBlockSize;
+        result.uniformMicroseconds = Time::highResolutionTicksToSeconds (uniformTicks) * 1.0e6 / numBlocks;
+        result.backgroundMicroseconds = Time::highResolutionTicksToSeconds (backgroundTicks) * 1.0e6 / numBlocks;
+        return result;
+    }
+
     enum class InitSequence { prepareThenLoad, loadThenPrepare };
 
     void checkLatency (const Convolution& convolution, const Convolution::Latency& latency)
@@ -544,14 +627,48 @@ public:
 
             for (auto headSize : { spec.maximumBlockSize / 2, spec.maximumBlockSize, spec.maximumBlockSize * 9 })
             {
-                testConvolution (spec,
-                                 Convolution::NonUniform { static_cast<int> (headSize) },
-                                 ramp,
-                                 spec.sampleRate,
-                                 Convolution::Stereo::yes,
-                                 Convolution::Trim::yes,
-                                 Convolution::Normalise::no,
-                                 ramp);
+                for (auto inBackground : { false, true })
+                {
+                    testConvolution (spec,
+                                     Convolution::NonUniform { static_cast<int> (headSize), inBackground },
+                                     ramp,
+                                     spec.sampleRate,
+                                     Convolution::Stereo::yes,
+                                     Convolution::Trim::yes,
+                                     Convolution::Normalise::no,
+                                     ramp);
+                }
+            }
+        }
+
+        beginTest ("Background tails match uniform convolution");
+        {
+            const ProcessSpec tailSpec { 48000.0, 256, 2 };
+            const auto longIr = makeDecayingNoise (2, 3 * (int) tailSpec.sampleRate);
+
+            for (auto paced : { false, true })
+            {
+                // Unpaced, the audio thread runs most of the tail itself; paced at 8x
+                // realtime, the background thread keeps ahead most of the time
+                const auto result = compareWithUniform (tailSpec, longIr, 40'000, paced ? 8.0 : 0.0);
+                expectLessThan (result.maxError, 1.0e-4f * result.peak);
+            }
+        }
+
+        beginTest ("Background tail benchmark");
+        {
+            const ProcessSpec tailSpec { 48000.0, 256, 2 };
+
+            for (auto seconds : { 1, 4 })
+            {
+                const auto longIr = makeDecayingNoise (2, seconds * (int) tailSpec.sampleRate);
+                const auto result = compareWithUniform (tailSpec, longIr, (int) tailSpec.sampleRate, 1.0);
+
+                logMessage (String (seconds) + " s IR, " + String (tailSpec.maximumBlockSize) + " sample blocks, audio thread per block: "
+                            + String (result.uniformMicroseconds, 1) + " us uniform, "
+                            + String (result.backgroundMicroseconds, 1) + " us with a background tail");
+
+                expectLessThan (result.maxError, 1.0e-4f * result.peak);
             }
         }
 
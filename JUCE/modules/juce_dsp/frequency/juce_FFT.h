@@ -38,14 +38,21 @@ namespace juce::dsp
 /**
     Performs a fast fourier transform.
 
-    This is only a simple low-footprint implementation and isn't tuned for speed - it may
-    be useful for simple applications where one of the more complex FFT libraries would be
-    overkill. (But in the future it may end up becoming optimised of course...)
+    Uses the platform's FFT library where one is available (vDSP, IPP, MKL or FFTW).
+    Otherwise it falls back to a built-in radix-4 engine which uses SIMD registers where
+    the platform has them, and computes real-only transforms with a half-size complex FFT.
 
     The FFT class itself contains lookup tables, so there's some overhead in creating
     one, you should create and cache an FFT object for each size/direction of transform
     that you need, and re-use them to perform the actual operation.
 
+    The tables are immutable and shared between all FFT objects of the same order, so
+    creating more of them costs little extra memory. None of the perform methods modify
+    the object or take a lock: one FFT can be used from several threads at once, as
+    long as each thread passes its own data. Scratch space comes from the calling
+    thread's stack, or for large orders from a per-thread buffer that is allocated on
+    that thread's first transform.
+
     @tags{DSP}
 */
 class JUCE_API  FFT
@@ -94,6 +101,53 @@ public:
     void performRealOnlyForwardTransform (float* inputOutputData,
                                           bool onlyCalculateNonNegativeFrequencies = false) const noexcept;
 
+    /** Performs performRealOnlyForwardTransform() on several channels at once.
+
+        Each of the numChannels pointers must point to 2 * getSize() floats, laid out as
+        for the single channel version. Any number of channels can be passed, e.g. the
+        channels of a bus, or the signals before and after an effect.
+
+        For small sizes the built-in engine transforms a whole SIMD register's worth of
+        channels in one pass, one channel per lane, so that they share the twiddle loads
+        and control flow. Otherwise the channels are transformed one after another using
+        the same tables, which stay in cache between them.
+    */
+    void performRealOnlyForwardTransform (float* const* channels, int numChannels,
+                                          bool onlyCalculateNonNegativeFrequencies = false) const noexcept;
+
+    /** Performs performRealOnlyForwardTransform() in place on each channel of a block.
+        The block must have at least 2 * getSize() samples per channel.
+    */
+    void performRealOnlyForwardTransform (const AudioBlock<float>& block,
+                                          bool onlyCalculateNonNegativeFrequencies = false) const noexcept;
+
+    /** Performs a forward transform of getSize() real samples, and writes only the
+        (getSize() / 2) + 1 bins from DC to Nyquist, as complex values.
+
+        Unlike performRealOnlyForwardTransform(), the input needs no room for the output:
+        input holds getSize() samples and is left untouched, and output must have space
+        for (getSize() / 2) + 1 values. The two must not overlap.
+    */
+    void performHalfSpectrumForwardTransform (const float* input, Complex<float>* output) const noexcept;
+
+    /** Performs a forward transform of getSize() real samples, and writes the power
+        (the squared magnitude) of the (getSize() / 2) + 1 bins from DC to Nyquist.
+
+        The output array must hold (getSize() / 2) + 1 values. It may be the same array
+        as the input, which only needs to hold getSize() samples.
+
+        This skips the square root that performFrequencyOnlyForwardTransform() takes for
+        every bin, which is wasted work if the result is used as energy or power.
+    */
+    void performPowerSpectrumForwardTransform (const float* input, float* output) const noexcept;
+
+    /** Like performPowerSpectrumForwardTransform(), but converts the power of each bin
+        to decibels (10 log10), clipped at minusInfinityDb. The logarithm is vectorised,
+        and its results are within 1e-4 dB of those computed with std::log10.
+    */
+    void performDecibelSpectrumForwardTransform (const float* input, float* output,
+                                                 float minusInfinityDb = -100.0f) const noexcept;
+
     /** Performs a reverse operation to data created in performRealOnlyForwardTransform().
 
         Although performRealOnlyInverseTransform will only use the first ((size / 2) + 1)
@@ -114,6 +168,18 @@ public:
     void performFrequencyOnlyForwardTransform (float* inputOutputData,
                                                bool onlyCalculateNonNegativeFrequencies = false) const noexcept;
 
+    /** Performs performFrequencyOnlyForwardTransform() on several channels at once,
+        batched as described for performRealOnlyForwardTransform().
+    */
+    void performFrequencyOnlyForwardTransform (float* const* channels, int numChannels,
+                                               bool onlyCalculateNonNegativeFrequencies = false) const noexcept;
+
+    /** Performs performFrequencyOnlyForwardTransform() in place on each channel of a block.
+        The block must have at least 2 * getSize() samples per channel.
+    */
+    void performFrequencyOnlyForwardTransform (const AudioBlock<float>& block,
+                                               bool onlyCalculateNonNegativeFrequencies = false) const noexcept;
+
     /** Returns the number of data points that this FFT was created to work with. */
     int getSize() const noexcept            { return size; }
 
@@ -128,7 +194,12 @@ private:
     //==============================================================================
     struct Engine;
 
-    std::unique_ptr<Instance> engine;
+    void convertToMagnitudes (float*, bool) const noexcept;
+
+    template <typename Callback>
+    void forEachChannelGroup (const AudioBlock<float>&, Callback&&) const noexcept;
+
+    std::shared_ptr<const Instance> engine;
     int size;
 
     //==============================================================================
@@ -203,6 +203,399 @@ struct FFTUnitTest final : public UnitTest
         }
     };
 
+    struct EngineComparisonTest
+    {
+        // The largest difference between two spectra, relative to the largest magnitude
+        static float getRelativeError (const Complex<float>* a, const Complex<float>* b, size_t n) noexcept
+        {
+            float maxError = 0.0f, maxMagnitude = 1.0e-12f;
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                maxError = jmax (maxError, std::abs (a[i] - b[i]));
+                maxMagnitude = jmax (maxMagnitude, std::abs (b[i]));
+            }
+
+            return maxError / maxMagnitude;
+        }
+
+        static void run (FFTUnitTest& u)
+        {
+            Random random (378272);
+
+            for (int order = 0; order <= 16; ++order)
+            {
+                const auto n = (size_t) 1 << order;
+                const auto tolerance = 1.0e-6f * (float) (order + 1);
+
+                std::unique_ptr<FFTFallback> fallback (FFTFallback::create (order));
+                std::unique_ptr<FFTVectorised> vectorised (FFTVectorised::create (order));
+
+                HeapBlock<Complex<float>> input (n), expected (n), output (n);
+
+                // complex, both directions
+                fillRandom (random, input.getData(), n);
+
+                for (auto inverse : { false, true })
+                {
+                    fallback->perform (input.getData(), expected.getData(), inverse);
+                    vectorised->perform (input.getData(), output.getData(), inverse);
+                    u.expectLessThan (getRelativeError (output.getData(), expected.getData(), n), tolerance);
+                }
+
+                // real input, full and half spectrum
+                HeapBlock<float> real (n);
+                fillRandom (random, real.getData(), n);
+
+                for (auto ignoreNegative : { false, true })
+                {
+                    zeromem (expected.getData(), n * sizeof (Complex<float>));
+                    memcpy (reinterpret_cast<float*> (expected.getData()), real.getData(), n * sizeof (float));
+                    fallback->performRealOnlyForwardTransform ((float*) expected.getData(), false);
+
+                    zeromem (output.getData(), n * sizeof (Complex<float>));
+                    memcpy (reinterpret_cast<float*> (output.getData()), real.getData(), n * sizeof (float));
+                    vectorised->performRealOnlyForwardTransform ((float*) output.getData(), ignoreNegative);
+
+                    const auto numBins = ignoreNegative ? (n / 2) + 1 : n;
+                    u.expectLessThan (getRelativeError (output.getData(), expected.getData(), jmin (numBins, n)), tolerance);
+                }
+
+                // and back again
+                vectorised->performRealOnlyInverseTransform ((float*) output.getData());
+
+                auto maxError = 0.0f;
+
+                for (size_t i = 0; i < n; ++i)
+                    maxError = jmax (maxError, std::abs (((float*) output.getData())[i] - real[i]));
+
+                u.expectLessThan (maxError, tolerance);
+            }
+        }
+    };
+
+    struct EngineBenchmark
+    {
+        template <typename Instance>
+        static double getMicrosecondsPerTransform (const Instance& instance, const float* input, float* buffer, size_t n, int numIterations)
+        {
+            const auto start = Time::getHighResolutionTicks();
+
+            for (int i = 0; i < numIterations; ++i)
+            {
+                memcpy (buffer, input, n * sizeof (float));
+                instance.performRealOnlyForwardTransform (buffer, true);
+            }
+
+            return Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start) * 1.0e6 / numIterations;
+        }
+
+        static void run (FFTUnitTest& u)
+        {
+            Random random (378272);
+
+            for (int order = 6; order <= 16; ++order)
+            {
+                const auto n = (size_t) 1 << order;
+                const auto numIterations = jmax (4, (1 << 18) >> order);
+
+                std::unique_ptr<FFTFallback> fallback (FFTFallback::create (order));
+                std::unique_ptr<FFTVectorised> vectorised (FFTVectorised::create (order));
+
+                HeapBlock<float> input (n), buffer (2 * n);
+                fillRandom (random, input.getData(), n);
+
+                const auto fallbackTime   = getMicrosecondsPerTransform (*fallback,   input.getData(), buffer.getData(), n, numIterations);
+                const auto vectorisedTime = getMicrosecondsPerTransform (*vectorised, input.getData(), buffer.getData(), n, numIterations);
+
+                u.logMessage ("Order " + String (order) + ": fallback " + String (fallbackTime, 2) + " us, vectorised "
+                              + String (vectorisedTime, 2) + " us (" + String (fallbackTime / vectorisedTime, 1) + "x)");
+                u.expectGreaterThan (vectorisedTime, 0.0);
+            }
+        }
+    };
+
+    struct BatchTest
+    {
+        static void run (FFTUnitTest& u)
+        {
+            Random random (378272);
+
+            for (int order = 0; order <= 12; ++order)
+            {
+                FFT fft (order);
+                const auto n = (size_t) fft.getSize();
+
+                for (auto numChannels : { 1, 2, 3, 8, 9, 16 })
+                {
+                    for (auto ignoreNegative : { false, true })
+                    {
+                        AudioBuffer<float> batched (numChannels, (int) (2 * n)), single (numChannels, (int) (2 * n));
+                        batched.clear();
+
+                        for (int c = 0; c < numChannels; ++c)
+                            fillRandom (random, batched.getWritePointer (c), n);
+
+                        single.makeCopyOf (batched);
+
+                        for (int c = 0; c < numChannels; ++c)
+                            fft.performRealOnlyForwardTransform (single.getWritePointer (c), ignoreNegative);
+
+                        fft.performRealOnlyForwardTransform (AudioBlock<float> (batched), ignoreNegative);
+
+                        const auto numBins = ignoreNegative ? (n / 2) + 1 : n;
+
+                        for (int c = 0; c < numChannels; ++c)
+                        {
+                            const auto error = EngineComparisonTest::getRelativeError (reinterpret_cast<const Complex<float>*> (batched.getReadPointer (c)),
+                                                                                       reinterpret_cast<const Complex<float>*> (single.getReadPointer (c)),
+                                                                                       jmin (numBins, n));
+                            u.expectLessThan (error, 1.0e-6f * (float) (order + 1));
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    struct BatchBenchmark
+    {
+        static void run (FFTUnitTest& u)
+        {
+            Random random (378272);
+
+            for (auto order : { 6, 8, 10 })
+            {
+                FFT fft (order);
+                const auto n = fft.getSize();
+                const auto numIterations = jmax (4, (1 << 16) >> order);
+
+                for (auto numChannels : { 2, 8, 16 })
+                {
+                    AudioBuffer<float> input (numChannels, n), buffer (numChannels, 2 * n);
+
+                    for (int c = 0; c < numChannels; ++c)
+                        fillRandom (random, input.getWritePointer (c), (size_t) n);
+
+                    const auto time = [&] (auto&& transform)
+                    {
+                        const auto start = Time::getHighResolutionTicks();
+
+                        for (int i = 0; i < numIterations; ++i)
+                        {
+                            for (int c = 0; c < numChannels; ++c)
+                                buffer.copyFrom (c, 0, input, c, 0, n);
+
+                            transform();
+                        }
+
+                        return Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start) * 1.0e6 / numIterations;
+                    };
+
+                    const auto singleTime = time ([&]
+                    {
+                        for (int c = 0; c < numChannels; ++c)
+                            fft.performRealOnlyForwardTransform (buffer.getWritePointer (c), true);
+                    });
+
+                    const auto batchedTime = time ([&]
+                    {
+                        fft.performRealOnlyForwardTransform (buffer.getArrayOfWritePointers(), numChannels, true);
+                    });
+
+                    u.logMessage ("Order " + String (order) + ", " + String (numChannels) + " channels: one by one " + String (singleTime, 2)
+                                  + " us, batched " + String (batchedTime, 2) + " us (" + String (singleTime / batchedTime, 2) + "x)");
+                    u.expectGreaterThan (batchedTime, 0.0);
+                }
+            }
+        }
+    };
+
+    struct SpectrumOutputTest
+    {
+        static void run (FFTUnitTest& u)
+        {
+            Random random (378272);
+
+            for (int order = 0; order <= 12; ++order)
+            {
+                FFT fft (order);
+                const auto n = (size_t) fft.getSize();
+                const auto numBins = n / 2 + 1;
+
+                HeapBlock<float> input (n), reference (2 * n), power (n + 1);
+                HeapBlock<Complex<float>> half (numBins);
+                fillRandom (random, input.getData(), n);
+
+                zeromem (reference.getData(), 2 * n * sizeof (float));
+                memcpy (reference.getData(), input.getData(), n * sizeof (float));
+                fft.performRealOnlyForwardTransform (reference.getData(), true);
+                const auto* expected = reinterpret_cast<const Complex<float>*> (reference.getData());
+
+                const auto tolerance = 1.0e-6f * (float) (order + 1);
+
+                fft.performHalfSpectrumForwardTransform (input.getData(), half.getData());
+                u.expectLessThan (EngineComparisonTest::getRelativeError (half.getData(), expected, numBins), tolerance);
+
+                auto maxPower = 1.0e-12f;
+
+                for (size_t k = 0; k < numBins; ++k)
+                    maxPower = jmax (maxPower, std::norm (expected[k]));
+
+                // in place, as the output fits in the input
+                memcpy (power.getData(), input.getData(), n * sizeof (float));
+                fft.performPowerSpectrumForwardTransform (power.getData(), power.getData());
+
+                auto maxPowerError = 0.0f;
+
+                for (size_t k = 0; k < numBins; ++k)
+                    maxPowerError = jmax (maxPowerError, std::abs (power[k] - std::norm (expected[k])));
+
+                u.expectLessThan (maxPowerError / maxPower, 2.0f * tolerance);
+
+                // decibels against the same power values, to test the log on its own
+                HeapBlock<float> decibels (numBins);
+                fft.performDecibelSpectrumForwardTransform (input.getData(), decibels.getData(), -60.0f);
+
+                auto maxDecibelError = 0.0f;
+
+                for (size_t k = 0; k < numBins; ++k)
+                {
+                    const auto expectedDb = jmax (-60.0f, 10.0f * std::log10 (jmax (power[k], 1.0e-30f)));
+                    maxDecibelError = jmax (maxDecibelError, std::abs (decibels[k] - expectedDb));
+                }
+
+                u.expectLessThan (maxDecibelError, 1.0e-4f);
+            }
+
+            // the log across the whole range of normal floats
+            HeapBlock<float> values (1024);
+
+            for (int i = 0; i < 1024; ++i)
+                values[i] = std::pow (10.0f, -37.0f + 74.0f * random.nextFloat());
+
+            HeapBlock<float> decibels (1024);
+            memcpy (decibels.getData(), values.getData(), 1024 * sizeof (float));
+            FFTVectorised::powerToDecibels (decibels.getData(), 1024, -400.0f);
+
+            auto maxError = 0.0f;
+
+            for (int i = 0; i < 1024; ++i)
+                maxError = jmax (maxError, std::abs (decibels[i] - 10.0f * std::log10 (values[i])));
+
+            u.expectLessThan (maxError, 1.0e-4f);
+        }
+    };
+
+    struct SpectrumOutputBenchmark
+    {
+        static void run (FFTUnitTest& u)
+        {
+            Random random (378272);
+
+            for (auto order : { 10, 12 })
+            {
+                FFT fft (order);
+                const auto n = fft.getSize();
+                const auto numBins = n / 2 + 1;
+                const auto numIterations = jmax (4, (1 << 18) >> order);
+
+                HeapBlock<float> input ((size_t) n), buffer (2 * (size_t) n);
+                fillRandom (random, input.getData(), (size_t) n);
+
+                const auto time = [&] (auto&& transform)
+                {
+                    const auto start = Time::getHighResolutionTicks();
+
+                    for (int i = 0; i < numIterations; ++i)
+                        transform();
+
+                    return Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start) * 1.0e6 / numIterations;
+                };
+
+                // what a caller had to do before: magnitudes, then decibels one bin at a time
+                const auto magnitudeTime = time ([&]
+                {
+                    memcpy (buffer.getData(), input.getData(), (size_t) n * sizeof (float));
+                    fft.performFrequencyOnlyForwardTransform (buffer.getData(), true);
+
+                    for (int k = 0; k < numBins; ++k)
+                        buffer[k] = Decibels::gainToDecibels (buffer[k]);
+                });
+
+                const auto powerTime = time ([&] { fft.performPowerSpectrumForwardTransform (input.getData(), buffer.getData()); });
+                const auto decibelTime = time ([&] { fft.performDecibelSpectrumForwardTransform (input.getData(), buffer.getData()); });
+
+                u.logMessage ("Order " + String (order) + ": magnitudes and gainToDecibels " + String (magnitudeTime, 2)
+                              + " us, power " + String (powerTime, 2) + " us, decibels " + String (decibelTime, 2) + " us");
+                u.expectGreaterThan (decibelTime, 0.0);
+            }
+        }
+    };
+
+    struct ConcurrencyTest
+    {
+        // Several threads transform different frames through one shared plan at the same
+        // time; each result must match the same frame transformed on its own, bit for bit
+        template <typename Transform>
+        static void check (FFTUnitTest& u, const Transform& transform, int order)
+        {
+            constexpr int numThreads = 4, numFrames = 8, numIterations = 20;
+            const auto n = (size_t) 1 << order;
+
+            Random random (378272);
+            HeapBlock<float> inputs (numFrames * n), expected (numFrames * 2 * n);
+            fillRandom (random, inputs.getData(), numFrames * n);
+
+            for (size_t frame = 0; frame < numFrames; ++frame)
+            {
+                auto* buffer = expected.getData() + frame * 2 * n;
+                zeromem (buffer, 2 * n * sizeof (float));
+                memcpy (buffer, inputs.getData() + frame * n, n * sizeof (float));
+                transform.performRealOnlyForwardTransform (buffer, false);
+            }
+
+            std::atomic<int> numMismatches { 0 };
+            std::vector<std::thread> threads;
+
+            for (int t = 0; t < numThreads; ++t)
+            {
+                threads.emplace_back ([&, t]
+                {
+                    HeapBlock<float> buffer (2 * n);
+
+                    for (int i = 0; i < numIterations; ++i)
+                    {
+                        const auto frame = (size_t) ((t + i) % numFrames);
+
+                        zeromem (buffer.getData(), 2 * n * sizeof (float));
+                        memcpy (buffer.getData(), inputs.getData() + frame * n, n * sizeof (float));
+                        transform.performRealOnlyForwardTransform (buffer.getData(), false);
+
+                        if (memcmp (buffer.getData(), expected.getData() + frame * 2 * n, 2 * n * sizeof (float)) != 0)
+                            ++numMismatches;
+                    }
+                });
+            }
+
+            for (auto& thread : threads)
+                thread.join();
+
+            u.expectEquals (numMismatches.load(), 0);
+        }
+
+        static void run (FFTUnitTest& u)
+        {
+            // order 15 needs more scratch than fits on the stack, which exercises the per-thread buffers
+            for (auto order : { 4, 10, 15 })
+            {
+                check (u, *std::unique_ptr<FFTFallback> (FFTFallback::create (order)), order);
+                check (u, *std::unique_ptr<FFTVectorised> (FFTVectorised::create (order)), order);
+                check (u, FFT (order), order);
+            }
+        }
+    };
+
     template <class TheTest>
     void runTestForAllTypes (const char* unitTestName)
     {
@@ -216,6 +609,13 @@ struct FFTUnitTest final : public UnitTest
         runTestForAllTypes<RealTest> ("Real input numbers Test");
         runTestForAllTypes<FrequencyOnlyTest> ("Frequency only Test");
         runTestForAllTypes<ComplexTest> ("Complex input numbers Test");
+        runTestForAllTypes<EngineComparisonTest> ("Vectorised engine matches fallback Test");
+        runTestForAllTypes<EngineBenchmark> ("Vectorised engine benchmark");
+        runTestForAllTypes<BatchTest> ("Batched multi-channel transforms Test");
+        runTestForAllTypes<BatchBenchmark> ("Batched multi-channel transforms benchmark");
+        runTestForAllTypes<SpectrumOutputTest> ("Half, power and decibel spectra Test");
+        runTestForAllTypes<SpectrumOutputBenchmark> ("Half, power and decibel spectra benchmark");
+        runTestForAllTypes<ConcurrencyTest> ("Shared plan used from several threads Test");
     }
 };
 
@@ -0,0 +1,359 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+//==============================================================================
+/*  The state of up to Group::width bins, one per lane. For bin frequency w, the
+    oscillator holds e^(-jwn) for the next sample n and each sample adds
+    e^(-jwn) * (x[n] - e^(jwN) * x[n - N]) to the running sum, which removes the
+    term the sample leaving the window added N samples earlier.
+*/
+struct SlidingDFT::Group
+{
+   #if JUCE_USE_SIMD
+    using Lane = SIMDRegister<float>;
+    using Index = Lane::vMaskType;
+
+    static Lane expand (float value) noexcept                         { return Lane::expand (value); }
+    static Index expandIndex (uint32 value) noexcept                  { return Index::expand (value); }
+    static uint32 getIndex (Index lane, size_t index) noexcept        { return lane.get (index); }
+    static float get (Lane lane, size_t index) noexcept               { return lane.get (index); }
+    static void set (Lane& lane, size_t index, float value) noexcept  { lane.set (index, value); }
+
+    static void updatePeak (Lane power, Index index, Lane& peak, Index& peakIndex) noexcept
+    {
+        const auto isNewPeak = Lane::greaterThan (power, peak);
+        peak = Lane::max (power, peak);
+        peakIndex = (index & isNewPeak) | (peakIndex & ~isNewPeak);
+    }
+   #else
+    using Lane = float;
+    using Index = uint32;
+
+    static Lane expand (float value) noexcept                         { return value; }
+    static Index expandIndex (uint32 value) noexcept                  { return value; }
+    static uint32 getIndex (Index lane, size_t) noexcept              { return lane; }
+    static float get (Lane lane, size_t) noexcept                     { return lane; }
+    static void set (Lane& lane, size_t, float value) noexcept        { lane = value; }
+
+    static void updatePeak (Lane power, Index index, Lane& peak, Index& peakIndex) noexcept
+    {
+        if (power > peak)
+        {
+            peak = power;
+            peakIndex = index;
+        }
+    }
+   #endif
+
+    static constexpr int width = (int) (sizeof (Lane) / sizeof (float));
+
+    template <bool writeOutput>
+    void process (const float* input, const float* delayed, int numSamples, float powerScale, uint32 firstIndex,
+                  float* const* powerOutputs, int numOutputs, int outputOffset) noexcept
+    {
+        // keep the whole state in registers for the length of the chunk
+        auto yRe = sumRe, yIm = sumIm, zRe = freshRe, zIm = freshIm;
+        auto wRe = oscRe, wIm = oscIm, peakPower = peak;
+        auto index = peakIndex;
+        const auto scale = expand (powerScale);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto x = expand (input[i]);
+            const auto old = expand (delayed[i]);
+
+            const auto aRe = x - combRe * old;
+            const auto aIm = combNegIm * old;
+
+            yRe += wRe * aRe - wIm * aIm;
+            yIm += wRe * aIm + wIm * aRe;
+            zRe += wRe * x;
+            zIm += wIm * x;
+
+            const auto nextRe = wRe * stepRe - wIm * stepIm;
+            wIm = wRe * stepIm + wIm * stepRe;
+            wRe = nextRe;
+
+            const auto power = (yRe * yRe + yIm * yIm) * scale;
+            updatePeak (power, expandIndex (firstIndex + (uint32) i), peakPower, index);
+
+            if constexpr (writeOutput)
+                for (int lane = 0; lane < numOutputs; ++lane)
+                    powerOutputs[lane][outputOffset + i] = get (power, (size_t) lane);
+        }
+
+        sumRe = yRe;  sumIm = yIm;
+        freshRe = zRe;  freshIm = zIm;
+        oscRe = wRe;  oscIm = wIm;
+        peak = peakPower;  peakIndex = index;
+    }
+
+    Lane sumRe {}, sumIm {};        // DFT of the window so far
+    Lane freshRe {}, freshIm {};    // the same, restarted at the last window boundary
+    Lane oscRe {}, oscIm {};        // e^(-jwn)
+    Lane stepRe {}, stepIm {};      // e^(-jw)
+    Lane combRe {}, combNegIm {};   // e^(jwN), imaginary part negated
+    Lane peak {};                   // peak power since resetPeaks()
+    Index peakIndex {};             // and the number of samples before it
+};
+
+//==============================================================================
+SlidingDFT::SlidingDFT() = default;
+SlidingDFT::~SlidingDFT() = default;
+
+void SlidingDFT::prepare (double newSampleRate, int maximumNumFrequencies, int maximumWindowLength)
+{
+    jassert (newSampleRate > 0.0);
+
+    sampleRate = newSampleRate;
+    maxFrequencies = jmax (0, maximumNumFrequencies);
+    maxWindowLength = jmax (1, maximumWindowLength);
+
+    const auto maxGroups = (size_t) ((maxFrequencies + Group::width - 1) / Group::width);
+    groups.assign (maxGroups, Group());
+    omegas.assign ((size_t) maxFrequencies, 0.0);
+    phases.assign ((size_t) maxFrequencies, 0.0);
+    frequencies.assign ((size_t) maxFrequencies, 0.0f);
+    history.assign ((size_t) maxWindowLength, 0.0f);
+
+    numFrequencies = 0;
+    windowLength = 1;
+    reset();
+}
+
+void SlidingDFT::setFrequencies (const float* frequenciesHz, int newNumFrequencies, int newWindowLength) noexcept
+{
+    jassert (newNumFrequencies <= maxFrequencies && newWindowLength <= maxWindowLength);
+
+    numFrequencies = jlimit (0, maxFrequencies, newNumFrequencies);
+    windowLength = jlimit (1, jmax (1, maxWindowLength), newWindowLength);
+    powerScale = 4.0f / (float) ((double) windowLength * windowLength);
+
+    for (int bin = 0; bin < numFrequencies; ++bin)
+    {
+        jassert (frequenciesHz[bin] >= 0.0f && frequenciesHz[bin] <= sampleRate / 2.0);
+
+        frequencies[(size_t) bin] = frequenciesHz[bin];
+        omegas[(size_t) bin] = MathConstants<double>::twoPi * frequenciesHz[bin] / sampleRate;
+    }
+
+    for (size_t g = 0; g < groups.size(); ++g)
+    {
+        auto& group = groups[g];
+
+        // unused lanes run at 0 Hz, which is harmless
+        for (int lane = 0; lane < Group::width; ++lane)
+        {
+            const auto bin = (int) g * Group::width + lane;
+            const auto omega = bin < numFrequencies ? omegas[(size_t) bin] : 0.0;
+            const auto windowPhase = std::fmod (omega * windowLength, MathConstants<double>::twoPi);
+
+            Group::set (group.stepRe,    (size_t) lane, (float) std::cos (omega));
+            Group::set (group.stepIm,    (size_t) lane, (float) -std::sin (omega));
+            Group::set (group.combRe,    (size_t) lane, (float) std::cos (windowPhase));
+            Group::set (group.combNegIm, (size_t) lane, (float) -std::sin (windowPhase));
+        }
+    }
+
+    reset();
+}
+
+void SlidingDFT::reset() noexcept
+{
+    std::fill (history.begin(), history.end(), 0.0f);
+    std::fill (phases.begin(), phases.end(), 0.0);
+    position = 0;
+
+    for (auto& group : groups)
+    {
+        group.sumRe = group.sumIm = group.freshRe = group.freshIm = Group::expand (0.0f);
+        group.oscRe = Group::expand (1.0f);
+        group.oscIm = Group::expand (0.0f);
+    }
+
+    resetPeaks();
+}
+
+void SlidingDFT::resetPeaks() noexcept
+{
+    for (auto& group : groups)
+    {
+        group.peak = Group::expand (0.0f);
+        group.peakIndex = Group::expandIndex (0);
+    }
+
+    samplesSincePeakReset = 0;
+}
+
+//==============================================================================
+void SlidingDFT::process (const float* input, int numSamples) noexcept
+{
+    processBlock<false> (input, nullptr, numSamples);
+}
+
+void SlidingDFT::process (const float* input, float* const* powerOutputs, int numSamples) noexcept
+{
+    processBlock<true> (input, powerOutputs, numSamples);
+}
+
+template <bool writeOutput>
+void SlidingDFT::processBlock (const float* input, float* const* powerOutputs, int numSamples) noexcept
+{
+    if (numFrequencies == 0)
+        return;
+
+    const auto numGroups = (numFrequencies + Group::width - 1) / Group::width;
+
+    for (int done = 0; done < numSamples;)
+    {
+        // chunks end at window boundaries, so the samples leaving the window are
+        // contiguous in the history and are read before being overwritten, and at
+        // oscillator resyncs
+        const auto chunk = jmin (numSamples - done, windowLength - position,
+                                 oscillatorSyncInterval - position % oscillatorSyncInterval);
+        const auto* delayed = history.data() + position;
+
+        for (int g = 0; g < numGroups; ++g)
+        {
+            const auto firstBin = g * Group::width;
+
+            groups[(size_t) g].process<writeOutput> (input + done, delayed, chunk, powerScale, (uint32) samplesSincePeakReset,
+                                                     writeOutput ? powerOutputs + firstBin : nullptr,
+                                                     jmin (Group::width, numFrequencies - firstBin), done);
+        }
+
+        std::copy (input + done, input + done + chunk, history.data() + position);
+        position += chunk;
+        done += chunk;
+        samplesSincePeakReset += chunk;
+
+        if (position == windowLength)
+        {
+            position = 0;
+            startNextWindow();
+        }
+        else if (position % oscillatorSyncInterval == 0)
+        {
+            updateOscillators();
+        }
+    }
+}
+
+void SlidingDFT::startNextWindow() noexcept
+{
+    // the restarted sum now covers exactly one window, without the rounding error
+    // the running sum picked up from adding and later subtracting each sample
+    for (auto& group : groups)
+    {
+        group.sumRe = group.freshRe;
+        group.sumIm = group.freshIm;
+        group.freshRe = group.freshIm = Group::expand (0.0f);
+    }
+
+    for (int bin = 0; bin < numFrequencies; ++bin)
+        phases[(size_t) bin] = std::fmod (phases[(size_t) bin] + omegas[(size_t) bin] * windowLength,
+                                          MathConstants<double>::twoPi);
+
+    updateOscillators();
+}
+
+void SlidingDFT::updateOscillators() noexcept
+{
+    // the float recurrence drifts by about one part in 10^7 per sample, so it is
+    // recomputed from the double precision phase every oscillatorSyncInterval samples
+    for (int bin = 0; bin < numFrequencies; ++bin)
+    {
+        auto& group = groups[(size_t) (bin / Group::width)];
+        const auto lane = (size_t) (bin % Group::width);
+        const auto phase = phases[(size_t) bin] + omegas[(size_t) bin] * position;
+
+        Group::set (group.oscRe, lane, (float) std::cos (phase));
+        Group::set (group.oscIm, lane, (float) -std::sin (phase));
+    }
+}
+
+//==============================================================================
+float SlidingDFT::getFrequency (int bin) const noexcept
+{
+    return isPositiveAndBelow (bin, numFrequencies) ? frequencies[(size_t) bin] : 0.0f;
+}
+
+Complex<float> SlidingDFT::getBin (int bin) const noexcept
+{
+    if (! isPositiveAndBelow (bin, numFrequencies))
+        return {};
+
+    const auto& group = groups[(size_t) (bin / Group::width)];
+    const auto lane = (size_t) (bin % Group::width);
+    const Complex<double> sum (Group::get (group.sumRe, lane), Group::get (group.sumIm, lane));
+
+    // the sum is referenced to sample zero, move that to the start of the window
+    const auto phase = phases[(size_t) bin] + omegas[(size_t) bin] * (position - windowLength);
+    const auto result = sum * std::polar (1.0, phase);
+
+    return { (float) result.real(), (float) result.imag() };
+}
+
+float SlidingDFT::getPower (int bin) const noexcept
+{
+    if (! isPositiveAndBelow (bin, numFrequencies))
+        return 0.0f;
+
+    const auto& group = groups[(size_t) (bin / Group::width)];
+    const auto lane = (size_t) (bin % Group::width);
+    const auto re = Group::get (group.sumRe, lane), im = Group::get (group.sumIm, lane);
+
+    return (re * re + im * im) * powerScale;
+}
+
+float SlidingDFT::getPeakPower (int bin) const noexcept
+{
+    return isPositiveAndBelow (bin, numFrequencies)
+               ? Group::get (groups[(size_t) (bin / Group::width)].peak, (size_t) (bin % Group::width))
+               : 0.0f;
+}
+
+int SlidingDFT::getSamplesSincePeak (int bin) const noexcept
+{
+    if (! isPositiveAndBelow (bin, numFrequencies) || samplesSincePeakReset == 0)
+        return 0;
+
+    const auto peakIndex = Group::getIndex (groups[(size_t) (bin / Group::width)].peakIndex, (size_t) (bin % Group::width));
+    return (int) ((uint32) samplesSincePeakReset - 1 - peakIndex);
+}
+
+} // namespace juce::dsp
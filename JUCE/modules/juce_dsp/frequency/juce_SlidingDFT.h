@@ -0,0 +1,162 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+/**
+    Tracks a handful of chosen frequencies sample by sample, as a bank of sliding
+    DFT bins.
+
+    Each bin holds the DFT at one arbitrary frequency over a rectangular window of
+    the last windowLength samples, and is updated for every input sample. That gives
+    sample-level time resolution at a cost that grows with the number of bins
+    rather than with the window length, which suits watching mains hum, pilot tones
+    or resonances where a short-time FFT would be both coarse and wasteful.
+
+    The bins are modulated sliding DFT resonators: the input is mixed down by a
+    per-bin oscillator and the bin is a running sum of the mixed-down window, so
+    no rounding error is fed back through a complex pole on the unit circle as it
+    is in a plain sliding DFT or Goertzel filter. A second sum is restarted at every
+    window boundary and replaces the running one when it covers a full window, and
+    the oscillators are recomputed from a double precision phase every few hundred
+    samples, so errors never build up for longer than two windows however long the
+    bank runs.
+
+    The bins are processed several at a time in SIMDRegister lanes.
+
+    The window sets the resolution: its main lobe is 2 * sampleRate / windowLength
+    wide, and it has nulls at every multiple of sampleRate / windowLength. Choosing
+    a window that spans a whole number of periods of the tones being watched, such
+    as 100 ms for mains hum at 50 or 60 Hz and its harmonics, stops them leaking
+    into each other.
+
+    @tags{DSP}
+*/
+class JUCE_API  SlidingDFT
+{
+public:
+    //==============================================================================
+    /** Creates an empty bank. Call prepare() and setFrequencies() before use. */
+    SlidingDFT();
+
+    /** Destructor. */
+    ~SlidingDFT();
+
+    //==============================================================================
+    /** Allocates everything the bank needs for up to maximumNumFrequencies bins and
+        windows of up to maximumWindowLength samples.
+
+        This allocates, so call it from prepareToPlay or similar, not from the audio
+        thread. It removes any frequencies that were set.
+    */
+    void prepare (double sampleRate, int maximumNumFrequencies, int maximumWindowLength);
+
+    /** Sets the frequencies to watch, in Hz, and the window length in samples, and
+        resets the bank.
+
+        Frequencies must be between 0 and half the sample rate, and both counts are
+        clipped to the limits passed to prepare(). This doesn't allocate.
+    */
+    void setFrequencies (const float* frequenciesHz, int numFrequencies, int windowLength) noexcept;
+
+    /** Clears the window and all bins, and restarts peak tracking. */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Pushes a block of samples through every bin. */
+    void process (const float* input, int numSamples) noexcept;
+
+    /** Pushes a block of samples through every bin and also writes the power of each
+        bin after each sample, as returned by getPower(), to powerOutputs[bin][sample].
+    */
+    void process (const float* input, float* const* powerOutputs, int numSamples) noexcept;
+
+    //==============================================================================
+    /** Returns the number of frequencies being watched. */
+    int getNumFrequencies() const noexcept          { return numFrequencies; }
+
+    /** Returns the window length in samples. */
+    int getWindowLength() const noexcept            { return windowLength; }
+
+    /** Returns the frequency a bin watches, in Hz. */
+    float getFrequency (int bin) const noexcept;
+
+    /** Returns the DFT of the current window at the bin's frequency, with the oldest
+        sample in the window at time zero. This is unscaled, so a sine of amplitude A
+        at the bin frequency gives a magnitude of A * windowLength / 2.
+    */
+    Complex<float> getBin (int bin) const noexcept;
+
+    /** Returns the squared amplitude of a sine at the bin's frequency, estimated from
+        the current window. A full-scale sine reads 1 (0 dB). At 0 Hz and at half the
+        sample rate the value is four times the squared DC or Nyquist level.
+    */
+    float getPower (int bin) const noexcept;
+
+    /** Returns the highest power the bin has reached since the last call to
+        resetPeaks(), and how many samples ago that was (0 for the last sample).
+    */
+    float getPeakPower (int bin) const noexcept;
+    int getSamplesSincePeak (int bin) const noexcept;
+
+    /** Restarts peak tracking for every bin. The sample count since a peak wraps
+        2^32 samples after a reset, so call this at least once a day.
+    */
+    void resetPeaks() noexcept;
+
+private:
+    //==============================================================================
+    struct Group;
+
+    template <bool writeOutput>
+    void processBlock (const float* input, float* const* powerOutputs, int numSamples) noexcept;
+    void startNextWindow() noexcept;
+    void updateOscillators() noexcept;
+
+    static constexpr int oscillatorSyncInterval = 256;
+
+    std::vector<Group> groups;
+    std::vector<double> omegas, phases;
+    std::vector<float> frequencies, history;
+    double sampleRate = 0.0;
+    int numFrequencies = 0, maxFrequencies = 0;
+    int windowLength = 1, maxWindowLength = 0, position = 0;
+    int64 samplesSincePeakReset = 0;
+    float powerScale = 4.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SlidingDFT)
+};
+
+} // namespace juce::dsp
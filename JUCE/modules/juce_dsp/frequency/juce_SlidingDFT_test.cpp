@@ -0,0 +1,211 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+struct SlidingDFTUnitTest final : public UnitTest
+{
+    SlidingDFTUnitTest()
+        : UnitTest ("SlidingDFT", UnitTestCategories::dsp)
+    {}
+
+    static constexpr double sampleRate = 48000.0;
+
+    static std::vector<float> makeSignal (Random& random, int numSamples)
+    {
+        std::vector<float> signal ((size_t) numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+            signal[(size_t) i] = 0.5f * (float) std::sin (MathConstants<double>::twoPi * 50.0 * i / sampleRate)
+                               + 0.1f * (float) std::sin (MathConstants<double>::twoPi * 997.3 * i / sampleRate)
+                               + 0.2f * (2.0f * random.nextFloat() - 1.0f);
+
+        return signal;
+    }
+
+    // DFT at frequencyHz of the windowLength samples ending at end, oldest first
+    static std::complex<double> referenceBin (const std::vector<float>& signal, int end, int windowLength, double frequencyHz)
+    {
+        std::complex<double> sum;
+        const auto omega = MathConstants<double>::twoPi * frequencyHz / sampleRate;
+
+        for (int i = 0; i < windowLength; ++i)
+        {
+            const auto index = end - windowLength + i;
+
+            if (index >= 0)
+                sum += (double) signal[(size_t) index] * std::polar (1.0, -omega * i);
+        }
+
+        return sum;
+    }
+
+    void runTest() override
+    {
+        Random random (8273);
+        const std::vector<float> frequencies { 0.0f, 50.0f, 60.0f, 100.0f, 150.0f, 997.3f, 12345.6f, 17000.0f, 24000.0f };
+
+        beginTest ("Bins match a direct DFT of the window");
+        {
+            for (auto windowLength : { 1, 37, 1000, 4800 })
+            {
+                const auto signal = makeSignal (random, 5 * windowLength + 1234);
+
+                SlidingDFT bank;
+                bank.prepare (sampleRate, 16, 4800);
+                bank.setFrequencies (frequencies.data(), (int) frequencies.size(), windowLength);
+
+                auto worstError = 0.0;
+
+                for (int done = 0; done < (int) signal.size();)
+                {
+                    const auto blockSize = jmin ((int) signal.size() - done, 1 + random.nextInt (700));
+                    bank.process (signal.data() + done, blockSize);
+                    done += blockSize;
+
+                    for (int bin = 0; bin < bank.getNumFrequencies(); ++bin)
+                    {
+                        const auto expected = referenceBin (signal, done, windowLength, frequencies[(size_t) bin]);
+                        const auto actual = bank.getBin (bin);
+                        const auto error = std::abs (std::complex<double> (actual.real(), actual.imag()) - expected);
+
+                        worstError = jmax (worstError, error / windowLength);
+                    }
+                }
+
+                expectLessThan (worstError, 1.0e-5, "window " + String (windowLength));
+            }
+        }
+
+        beginTest ("Power stays accurate over a long run");
+        {
+            // a plain sliding DFT drifts after a few million samples in float
+            const std::vector<float> watched { 50.0f, 100.0f, 997.3f };
+            const auto windowLength = 4800;
+
+            SlidingDFT bank;
+            bank.prepare (sampleRate, 4, windowLength);
+            bank.setFrequencies (watched.data(), (int) watched.size(), windowLength);
+
+            const auto signal = makeSignal (random, 1 << 16);
+            const auto numSamples = 60 * (int) sampleRate;
+
+            for (int done = 0; done < numSamples; done += 1 << 16)
+                bank.process (signal.data(), 1 << 16);
+
+            // the signal repeats every 2^16 samples, so the last window is also the last one of the first pass
+            for (int bin = 0; bin < (int) watched.size(); ++bin)
+            {
+                const auto expected = referenceBin (signal, 1 << 16, windowLength, watched[(size_t) bin]);
+                const auto expectedPower = std::norm (expected) * 4.0 / ((double) windowLength * windowLength);
+
+                expectWithinAbsoluteError ((double) bank.getPower (bin), expectedPower, 1.0e-5 + 1.0e-4 * expectedPower);
+            }
+
+            expectWithinAbsoluteError (bank.getPower (0), 0.25f, 0.01f);
+        }
+
+        beginTest ("Per-sample output and peak tracking");
+        {
+            const auto windowLength = 480;
+            const auto numSamples = 3000;
+            const auto signal = makeSignal (random, numSamples);
+
+            SlidingDFT bank, reference;
+            bank.prepare (sampleRate, 16, windowLength);
+            reference.prepare (sampleRate, 16, windowLength);
+            bank.setFrequencies (frequencies.data(), (int) frequencies.size(), windowLength);
+            reference.setFrequencies (frequencies.data(), (int) frequencies.size(), windowLength);
+
+            AudioBuffer<float> powers ((int) frequencies.size(), numSamples);
+            bank.process (signal.data(), powers.getArrayOfWritePointers(), numSamples);
+
+            for (int bin = 0; bin < (int) frequencies.size(); ++bin)
+            {
+                const auto* power = powers.getReadPointer (bin);
+                const auto peakIndex = (int) (std::max_element (power, power + numSamples) - power);
+
+                expectEquals (bank.getPeakPower (bin), power[peakIndex]);
+                expectEquals (bank.getSamplesSincePeak (bin), numSamples - 1 - peakIndex);
+                expectWithinAbsoluteError (bank.getPower (bin), power[numSamples - 1], 1.0e-6f);
+            }
+
+            auto maxDifference = 0.0f;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                reference.process (signal.data() + i, 1);
+
+                for (int bin = 0; bin < (int) frequencies.size(); ++bin)
+                    maxDifference = jmax (maxDifference, std::abs (reference.getPower (bin) - powers.getSample (bin, i)));
+            }
+
+            // only rounding differs, from the compiler fusing multiplies and adds differently
+            expectLessThan (maxDifference, 1.0e-5f);
+
+            bank.resetPeaks();
+            expectEquals (bank.getPeakPower (1), 0.0f);
+        }
+
+        beginTest ("Sliding DFT benchmark");
+        {
+            const auto numSamples = 1 << 16;
+            const auto signal = makeSignal (random, numSamples);
+            std::vector<float> many;
+
+            for (int i = 0; i < 32; ++i)
+                many.push_back (50.0f * (float) (i + 1));
+
+            for (auto numFrequencies : { 1, 4, 8, 16, 32 })
+            {
+                SlidingDFT bank;
+                bank.prepare (sampleRate, numFrequencies, 4800);
+                bank.setFrequencies (many.data(), numFrequencies, 4800);
+                bank.process (signal.data(), numSamples);
+
+                const auto start = Time::getHighResolutionTicks();
+                bank.process (signal.data(), numSamples);
+                const auto seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+
+                logMessage (String (numFrequencies) + " frequencies: " + String (seconds * 1.0e9 / numSamples, 2) + " ns per sample");
+                expectGreaterThan (seconds, 0.0);
+            }
+        }
+    }
+};
+
+static SlidingDFTUnitTest slidingDFTUnitTest;
+
+} // namespace juce::dsp
@@ -81,11 +81,16 @@
 #include "frequency/juce_FFT.cpp"
 #include "frequency/juce_Convolution.cpp"
 #include "frequency/juce_Windowing.cpp"
+#include "frequency/juce_SlidingDFT.cpp"
+#include "frequency/juce_ConstantQTransform.cpp"
 #include "filter_design/juce_FilterDesign.cpp"
 #include "widgets/juce_LadderFilter.cpp"
 #include "widgets/juce_Compressor.cpp"
 #include "widgets/juce_NoiseGate.cpp"
 #include "widgets/juce_Limiter.cpp"
+#include "widgets/juce_LookaheadLimiter.cpp"
+#include "widgets/juce_AntiderivativeWaveShaper.cpp"
+#include "widgets/juce_MultibandWaveShaper.cpp"
 #include "widgets/juce_Phaser.cpp"
 #include "widgets/juce_Chorus.cpp"
 
@@ -114,6 +119,12 @@
  #include "containers/juce_AudioBlock_test.cpp"
  #include "frequency/juce_Convolution_test.cpp"
  #include "frequency/juce_FFT_test.cpp"
+ #include "frequency/juce_SlidingDFT_test.cpp"
+ #include "frequency/juce_ConstantQTransform_test.cpp"
  #include "processors/juce_FIRFilter_test.cpp"
+ #include "processors/juce_Oversampling_test.cpp"
  #include "processors/juce_ProcessorChain_test.cpp"
+ #include "widgets/juce_AntiderivativeWaveShaper_test.cpp"
+ #include "widgets/juce_LookaheadLimiter_test.cpp"
+ #include "widgets/juce_MultibandWaveShaper_test.cpp"
 #endif
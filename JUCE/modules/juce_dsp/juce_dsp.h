@@ -278,15 +278,20 @@ namespace util
 #include "frequency/juce_FFT.h"
 #include "frequency/juce_Convolution.h"
 #include "frequency/juce_Windowing.h"
+#include "frequency/juce_SlidingDFT.h"
+#include "frequency/juce_ConstantQTransform.h"
 #include "filter_design/juce_FilterDesign.h"
 #include "widgets/juce_Reverb.h"
 #include "widgets/juce_Bias.h"
 #include "widgets/juce_Gain.h"
 #include "widgets/juce_WaveShaper.h"
+#include "widgets/juce_AntiderivativeWaveShaper.h"
+#include "widgets/juce_MultibandWaveShaper.h"
 #include "widgets/juce_Oscillator.h"
 #include "widgets/juce_LadderFilter.h"
 #include "widgets/juce_Compressor.h"
 #include "widgets/juce_NoiseGate.h"
 #include "widgets/juce_Limiter.h"
+#include "widgets/juce_LookaheadLimiter.h"
 #include "widgets/juce_Phaser.h"
 #include "widgets/juce_Chorus.h"
@@ -460,12 +460,11 @@ struct Oversampling2TimesPolyphaseIIR final : public Oversampling<SampleType>::O
         }
     }
 
-private:
     //==============================================================================
     /** This function calculates the equivalent high order IIR filter of a given
         polyphase cascaded allpass filters structure.
     */
-    IIR::Coefficients<SampleType> getCoefficients (typename FilterDesign<SampleType>::IIRPolyphaseAllpassStructure& structure) const
+    static IIR::Coefficients<SampleType> getCoefficients (typename FilterDesign<SampleType>::IIRPolyphaseAllpassStructure& structure)
     {
         constexpr auto one = static_cast<SampleType> (1.0);
 
@@ -523,6 +522,7 @@ private:
         return coeffs;
     }
 
+private:
     //==============================================================================
     Array<SampleType> coefficientsUp, coefficientsDown;
     SampleType latency;
@@ -534,6 +534,552 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Oversampling2TimesPolyphaseIIR)
 };
 
+#if JUCE_USE_SIMD
+//==============================================================================
+/** Base class for the oversampling stages which pack channels, or channels and
+    polyphase branches, into the lanes of a SIMDRegister. It owns the aligned
+    lane-packed scratch buffers and moves samples between them and the
+    per-channel buffers.
+
+    Every lane group is filtered as a whole, so a block with fewer channels than
+    the stage was created for also advances the filter state of the missing
+    channels that share its last group, unlike the scalar stages.
+*/
+template <typename SampleType>
+struct OversamplingSIMDStage : public Oversampling<SampleType>::OversamplingStage
+{
+    using ParentType = typename Oversampling<SampleType>::OversamplingStage;
+    using Register   = SIMDRegister<SampleType>;
+
+    static constexpr size_t numLanes = Register::SIMDNumElements;
+
+    OversamplingSIMDStage (size_t numChans, size_t numLanesPerChannel)
+        : ParentType (numChans, 2),
+          lanesPerChannel (numLanesPerChannel),
+          channelsPerGroup (numLanes / numLanesPerChannel),
+          numGroups ((numChans + channelsPerGroup - 1) / channelsPerGroup)
+    {
+        jassert (numLanes % lanesPerChannel == 0);
+    }
+
+    //==============================================================================
+    void initProcessing (size_t maximumNumberOfSamplesBeforeOversampling) override
+    {
+        ParentType::initProcessing (maximumNumberOfSamplesBeforeOversampling);
+
+        lowRate  = allocateRegisters (lowRateStorage,  maximumNumberOfSamplesBeforeOversampling);
+        highRate = allocateRegisters (highRateStorage, maximumNumberOfSamplesBeforeOversampling * ParentType::factor);
+    }
+
+    size_t getNumGroups (size_t numChannelsToProcess) const noexcept
+    {
+        return (numChannelsToProcess + channelsPerGroup - 1) / channelsPerGroup;
+    }
+
+    size_t getNumActiveLanes (size_t numChannelsToProcess, size_t group) const noexcept
+    {
+        return jmin (numLanes, (numChannelsToProcess - group * channelsPerGroup) * lanesPerChannel);
+    }
+
+    /** Returns zeroed storage for numRegisters SIMD registers, aligned for
+        Register::fromRawArray.
+    */
+    static SampleType* allocateRegisters (HeapBlock<SampleType>& storage, size_t numRegisters)
+    {
+        storage.calloc ((numRegisters + 1) * numLanes);
+        return Register::getNextSIMDAlignedPtr (storage.get());
+    }
+
+    /** Packs the channels of one lane group into destination, one register per
+        frame. Lane l reads sample frame * sourceStride + (l % lanesPerChannel) * phaseStep
+        of its channel. Lanes without a channel are left as they are: they hold
+        zeros or stale samples of another group, and their results are discarded.
+    */
+    template <typename BlockType>
+    void interleave (const BlockType& block, size_t group, size_t numFrames,
+                     size_t sourceStride, size_t phaseStep, SampleType* destination) const noexcept
+    {
+        const SampleType* sources[numLanes];
+        auto numActiveLanes = getNumActiveLanes (block.getNumChannels(), group);
+
+        for (size_t lane = 0; lane < numActiveLanes; ++lane)
+            sources[lane] = block.getChannelPointer (group * channelsPerGroup + lane / lanesPerChannel) + (lane % lanesPerChannel) * phaseStep;
+
+        // A constant lane count lets the compiler unroll the usual case of a full group
+        if (numActiveLanes == numLanes)
+        {
+            for (size_t i = 0; i < numFrames; ++i)
+                for (size_t lane = 0; lane < numLanes; ++lane)
+                    destination[i * numLanes + lane] = sources[lane][i * sourceStride];
+        }
+        else
+        {
+            for (size_t i = 0; i < numFrames; ++i)
+                for (size_t lane = 0; lane < numActiveLanes; ++lane)
+                    destination[i * numLanes + lane] = sources[lane][i * sourceStride];
+        }
+    }
+
+    /** The inverse of interleave, lanes without a channel are dropped. */
+    void deinterleave (const SampleType* source, size_t group, size_t numFrames,
+                       size_t destinationStride, size_t phaseStep, AudioBlock<SampleType>& block) const noexcept
+    {
+        SampleType* destinations[numLanes];
+        auto numActiveLanes = getNumActiveLanes (block.getNumChannels(), group);
+
+        for (size_t lane = 0; lane < numActiveLanes; ++lane)
+            destinations[lane] = block.getChannelPointer (group * channelsPerGroup + lane / lanesPerChannel) + (lane % lanesPerChannel) * phaseStep;
+
+        if (numActiveLanes == numLanes)
+        {
+            for (size_t i = 0; i < numFrames; ++i)
+                for (size_t lane = 0; lane < numLanes; ++lane)
+                    destinations[lane][i * destinationStride] = source[i * numLanes + lane];
+        }
+        else
+        {
+            for (size_t i = 0; i < numFrames; ++i)
+                for (size_t lane = 0; lane < numActiveLanes; ++lane)
+                    destinations[lane][i * destinationStride] = source[i * numLanes + lane];
+        }
+    }
+
+    const size_t lanesPerChannel, channelsPerGroup, numGroups;
+
+    HeapBlock<SampleType> lowRateStorage, highRateStorage;
+    SampleType* lowRate = nullptr;
+    SampleType* highRate = nullptr;
+};
+
+//==============================================================================
+/** Oversampling stage class performing the same 2 times oversampling as
+    Oversampling2TimesEquirippleFIR, with up to SIMDNumElements channels packed
+    into the lanes of each SIMDRegister so that one multiply-add filters all of
+    them. The filter history is a mirrored circular buffer, so it is read as one
+    contiguous window instead of being shifted on every sample.
+*/
+template <typename SampleType>
+struct Oversampling2TimesEquirippleFIRSIMD final : public OversamplingSIMDStage<SampleType>
+{
+    using BaseType = OversamplingSIMDStage<SampleType>;
+    using Register = typename BaseType::Register;
+
+    Oversampling2TimesEquirippleFIRSIMD (size_t numChans,
+                                         SampleType normalisedTransitionWidthUp,
+                                         SampleType stopbandAmplitudedBUp,
+                                         SampleType normalisedTransitionWidthDown,
+                                         SampleType stopbandAmplitudedBDown)
+        : BaseType (numChans, 1)
+    {
+        coefficientsUp   = *FilterDesign<SampleType>::designFIRLowpassHalfBandEquirippleMethod (normalisedTransitionWidthUp,   stopbandAmplitudedBUp);
+        coefficientsDown = *FilterDesign<SampleType>::designFIRLowpassHalfBandEquirippleMethod (normalisedTransitionWidthDown, stopbandAmplitudedBDown);
+
+        // Only every other input sample meets a non-zero tap, so each history
+        // holds the half-rate inputs from the newest up to the oldest tap
+        historyUp   = coefficientsUp.getFilterOrder()   / 2 + 1;
+        historyDown = coefficientsDown.getFilterOrder() / 2 + 1;
+        historyDown2 = coefficientsDown.getFilterOrder() / 4 + 1;
+
+        stateUp    = BaseType::allocateRegisters (stateUpStorage,    BaseType::numGroups * 2 * historyUp);
+        stateDown  = BaseType::allocateRegisters (stateDownStorage,  BaseType::numGroups * 2 * historyDown);
+        stateDown2 = BaseType::allocateRegisters (stateDown2Storage, BaseType::numGroups * historyDown2);
+
+        positionUp.insertMultiple   (0, 0, static_cast<int> (BaseType::numGroups));
+        positionDown.insertMultiple (0, 0, static_cast<int> (BaseType::numGroups));
+        position2.insertMultiple    (0, 0, static_cast<int> (BaseType::numGroups));
+    }
+
+    //==============================================================================
+    SampleType getLatencyInSamples() const override
+    {
+        return static_cast<SampleType> (coefficientsUp.getFilterOrder() + coefficientsDown.getFilterOrder()) * 0.5f;
+    }
+
+    void reset() override
+    {
+        BaseType::reset();
+
+        FloatVectorOperations::clear (stateUp,    static_cast<int> (BaseType::numGroups * 2 * historyUp    * BaseType::numLanes));
+        FloatVectorOperations::clear (stateDown,  static_cast<int> (BaseType::numGroups * 2 * historyDown  * BaseType::numLanes));
+        FloatVectorOperations::clear (stateDown2, static_cast<int> (BaseType::numGroups * historyDown2     * BaseType::numLanes));
+
+        positionUp.fill (0);
+        positionDown.fill (0);
+        position2.fill (0);
+    }
+
+    void processSamplesUp (const AudioBlock<const SampleType>& inputBlock) override
+    {
+        jassert (inputBlock.getNumChannels() <= static_cast<size_t> (BaseType::buffer.getNumChannels()));
+        jassert (inputBlock.getNumSamples() * BaseType::factor <= static_cast<size_t> (BaseType::buffer.getNumSamples()));
+
+        // Initialization
+        constexpr auto L = BaseType::numLanes;
+        auto fir = coefficientsUp.getRawCoefficients();
+        auto N = coefficientsUp.getFilterOrder() + 1;
+        auto Ndiv2 = N / 2;
+        auto M = historyUp;
+        auto numSamples = inputBlock.getNumSamples();
+        auto outputBlock = AudioBlock<SampleType> (BaseType::buffer).getSubsetChannelBlock (0, inputBlock.getNumChannels());
+        const auto two = Register::expand (static_cast<SampleType> (2));
+
+        // Processing
+        for (size_t group = 0; group < BaseType::getNumGroups (inputBlock.getNumChannels()); ++group)
+        {
+            BaseType::interleave (inputBlock, group, numSamples, 1, 0, BaseType::lowRate);
+
+            auto ring = stateUp + group * 2 * M * L;
+            auto pos = positionUp.getUnchecked (static_cast<int> (group));
+
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                // Input, written twice so that the newest M values are contiguous
+                pos = (pos == 0 ? M - 1 : pos - 1);
+
+                auto input = Register::fromRawArray (BaseType::lowRate + i * L) * two;
+                input.copyToRawArray (ring + pos * L);
+                input.copyToRawArray (ring + (pos + M) * L);
+
+                auto history = ring + pos * L;
+
+                // Convolution
+                auto out = Register::expand (static_cast<SampleType> (0));
+
+                for (size_t k = 0, j = 0; k < Ndiv2; k += 2, ++j)
+                    out += (Register::fromRawArray (history + j * L) + Register::fromRawArray (history + (Ndiv2 - j) * L)) * fir[k];
+
+                // Outputs
+                out.copyToRawArray (BaseType::highRate + (i << 1) * L);
+                (Register::fromRawArray (history + ((Ndiv2 - 1) / 2) * L) * fir[Ndiv2]).copyToRawArray (BaseType::highRate + ((i << 1) + 1) * L);
+            }
+
+            positionUp.setUnchecked (static_cast<int> (group), pos);
+
+            BaseType::deinterleave (BaseType::highRate, group, numSamples * 2, 1, 0, outputBlock);
+        }
+    }
+
+    void processSamplesDown (AudioBlock<SampleType>& outputBlock) override
+    {
+        jassert (outputBlock.getNumChannels() <= static_cast<size_t> (BaseType::buffer.getNumChannels()));
+        jassert (outputBlock.getNumSamples() * BaseType::factor <= static_cast<size_t> (BaseType::buffer.getNumSamples()));
+
+        // Initialization
+        constexpr auto L = BaseType::numLanes;
+        auto fir = coefficientsDown.getRawCoefficients();
+        auto N = coefficientsDown.getFilterOrder() + 1;
+        auto Ndiv2 = N / 2;
+        auto M = historyDown;
+        auto numSamples = outputBlock.getNumSamples();
+        auto inputBlock = AudioBlock<SampleType> (BaseType::buffer).getSubsetChannelBlock (0, outputBlock.getNumChannels());
+
+        // Processing
+        for (size_t group = 0; group < BaseType::getNumGroups (outputBlock.getNumChannels()); ++group)
+        {
+            BaseType::interleave (inputBlock, group, numSamples * 2, 1, 0, BaseType::highRate);
+
+            auto ring = stateDown + group * 2 * M * L;
+            auto ring2 = stateDown2 + group * historyDown2 * L;
+            auto pos = positionDown.getUnchecked (static_cast<int> (group));
+            auto pos2 = position2.getUnchecked (static_cast<int> (group));
+
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                // Input
+                pos = (pos == 0 ? M - 1 : pos - 1);
+
+                auto input = Register::fromRawArray (BaseType::highRate + (i << 1) * L);
+                input.copyToRawArray (ring + pos * L);
+                input.copyToRawArray (ring + (pos + M) * L);
+
+                auto history = ring + pos * L;
+
+                // Convolution
+                auto out = Register::expand (static_cast<SampleType> (0));
+
+                for (size_t k = 0, j = 0; k < Ndiv2; k += 2, ++j)
+                    out += (Register::fromRawArray (history + j * L) + Register::fromRawArray (history + (Ndiv2 - j) * L)) * fir[k];
+
+                // Output
+                out += Register::fromRawArray (ring2 + pos2 * L) * fir[Ndiv2];
+                Register::fromRawArray (BaseType::highRate + ((i << 1) + 1) * L).copyToRawArray (ring2 + pos2 * L);
+
+                out.copyToRawArray (BaseType::lowRate + i * L);
+
+                // Circular buffer
+                pos2 = (pos2 == 0 ? historyDown2 - 1 : pos2 - 1);
+            }
+
+            positionDown.setUnchecked (static_cast<int> (group), pos);
+            position2.setUnchecked (static_cast<int> (group), pos2);
+
+            BaseType::deinterleave (BaseType::lowRate, group, numSamples, 1, 0, outputBlock);
+        }
+    }
+
+private:
+    //==============================================================================
+    FIR::Coefficients<SampleType> coefficientsUp, coefficientsDown;
+    size_t historyUp = 0, historyDown = 0, historyDown2 = 0;
+
+    HeapBlock<SampleType> stateUpStorage, stateDownStorage, stateDown2Storage;
+    SampleType* stateUp = nullptr;
+    SampleType* stateDown = nullptr;
+    SampleType* stateDown2 = nullptr;
+    Array<size_t> positionUp, positionDown, position2;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Oversampling2TimesEquirippleFIRSIMD)
+};
+
+//==============================================================================
+/** Oversampling stage class performing the same 2 times oversampling as
+    Oversampling2TimesPolyphaseIIR. Both polyphase branches of each channel are
+    packed into neighbouring lanes of a SIMDRegister, the direct path in the
+    even lane and the delayed path in the odd one, so that a single cascade of
+    allpass sections filters both branches of several channels at once.
+*/
+template <typename SampleType>
+struct Oversampling2TimesPolyphaseIIRSIMD final : public OversamplingSIMDStage<SampleType>
+{
+    using BaseType = OversamplingSIMDStage<SampleType>;
+    using Register = typename BaseType::Register;
+    using MaskType = typename Register::MaskType;
+
+    Oversampling2TimesPolyphaseIIRSIMD (size_t numChans,
+                                        SampleType normalisedTransitionWidthUp,
+                                        SampleType stopbandAmplitudedBUp,
+                                        SampleType normalisedTransitionWidthDown,
+                                        SampleType stopbandAmplitudedBDown)
+        : BaseType (numChans, 2)
+    {
+        auto structureUp = FilterDesign<SampleType>::designIIRLowpassHalfBandPolyphaseAllpassMethod (normalisedTransitionWidthUp, stopbandAmplitudedBUp);
+        auto coeffsUp = Oversampling2TimesPolyphaseIIR<SampleType>::getCoefficients (structureUp);
+        latency = static_cast<SampleType> (-(coeffsUp.getPhaseForFrequency (0.0001, 1.0)) / (0.0001 * MathConstants<double>::twoPi));
+
+        auto structureDown = FilterDesign<SampleType>::designIIRLowpassHalfBandPolyphaseAllpassMethod (normalisedTransitionWidthDown, stopbandAmplitudedBDown);
+        auto coeffsDown = Oversampling2TimesPolyphaseIIR<SampleType>::getCoefficients (structureDown);
+        latency += static_cast<SampleType> (-(coeffsDown.getPhaseForFrequency (0.0001, 1.0)) / (0.0001 * MathConstants<double>::twoPi));
+
+        initialiseCascade (up, structureUp);
+        initialiseCascade (down, structureDown);
+
+        delayDown.insertMultiple (0, 0, static_cast<int> (BaseType::numChannels));
+    }
+
+    //==============================================================================
+    SampleType getLatencyInSamples() const override
+    {
+        return latency;
+    }
+
+    void reset() override
+    {
+        BaseType::reset();
+
+        for (auto* cascade : { &up, &down })
+            FloatVectorOperations::clear (cascade->state, static_cast<int> (BaseType::numGroups * cascade->numStages * BaseType::numLanes));
+
+        delayDown.fill (0);
+    }
+
+    void processSamplesUp (const AudioBlock<const SampleType>& inputBlock) override
+    {
+        jassert (inputBlock.getNumChannels() <= static_cast<size_t> (BaseType::buffer.getNumChannels()));
+        jassert (inputBlock.getNumSamples() * BaseType::factor <= static_cast<size_t> (BaseType::buffer.getNumSamples()));
+
+        auto numSamples = inputBlock.getNumSamples();
+        auto outputBlock = AudioBlock<SampleType> (BaseType::buffer).getSubsetChannelBlock (0, inputBlock.getNumChannels());
+
+        for (size_t group = 0; group < BaseType::getNumGroups (inputBlock.getNumChannels()); ++group)
+        {
+            // Both branches of a channel see the same input, and their outputs
+            // are the even and odd samples of the upsampled signal
+            BaseType::interleave (inputBlock, group, numSamples, 1, 0, BaseType::lowRate);
+            processCascade (up, group, numSamples);
+            BaseType::deinterleave (BaseType::lowRate, group, numSamples, 2, 1, outputBlock);
+        }
+
+       #if JUCE_DSP_ENABLE_SNAP_TO_ZERO
+        snapToZero (up);
+       #endif
+    }
+
+    void processSamplesDown (AudioBlock<SampleType>& outputBlock) override
+    {
+        jassert (outputBlock.getNumChannels() <= static_cast<size_t> (BaseType::buffer.getNumChannels()));
+        jassert (outputBlock.getNumSamples() * BaseType::factor <= static_cast<size_t> (BaseType::buffer.getNumSamples()));
+
+        constexpr auto L = BaseType::numLanes;
+        auto numSamples = outputBlock.getNumSamples();
+        auto inputBlock = AudioBlock<SampleType> (BaseType::buffer).getSubsetChannelBlock (0, outputBlock.getNumChannels());
+
+        for (size_t group = 0; group < BaseType::getNumGroups (outputBlock.getNumChannels()); ++group)
+        {
+            // The direct path filters the even samples and the delayed path the odd ones
+            BaseType::interleave (inputBlock, group, numSamples, 2, 1, BaseType::lowRate);
+            processCascade (down, group, numSamples);
+
+            // Output
+            for (size_t c = 0; c < BaseType::channelsPerGroup; ++c)
+            {
+                auto channel = group * BaseType::channelsPerGroup + c;
+
+                if (channel >= outputBlock.getNumChannels())
+                    break;
+
+                auto samples = outputBlock.getChannelPointer (channel);
+                auto lanes = BaseType::lowRate + 2 * c;
+                auto delay = delayDown.getUnchecked (static_cast<int> (channel));
+
+                for (size_t i = 0; i < numSamples; ++i)
+                {
+                    samples[i] = (delay + lanes[i * L]) * static_cast<SampleType> (0.5);
+                    delay = lanes[i * L + 1];
+                }
+
+                delayDown.setUnchecked (static_cast<int> (channel), delay);
+            }
+        }
+
+       #if JUCE_DSP_ENABLE_SNAP_TO_ZERO
+        snapToZero (down);
+       #endif
+    }
+
+private:
+    //==============================================================================
+    /** The lane-packed allpass sections of one polyphase structure. The direct
+        path may have one section more than the delayed path, in which case the
+        odd lanes pass straight through the last section.
+    */
+    struct Cascade
+    {
+        HeapBlock<SampleType> coefficientStorage, stateStorage;
+        SampleType* coefficients = nullptr;
+        SampleType* state = nullptr;
+        size_t numStages = 0;
+        bool lastStageIsDirectOnly = false;
+    };
+
+    void initialiseCascade (Cascade& cascade, typename FilterDesign<SampleType>::IIRPolyphaseAllpassStructure& structure)
+    {
+        constexpr auto L = BaseType::numLanes;
+
+        // As in Oversampling2TimesPolyphaseIIR the first delayed path section is the
+        // delay itself, which is implicit in the polyphase processing
+        auto numDirect  = static_cast<size_t> (structure.directPath.size());
+        auto numDelayed = static_cast<size_t> (structure.delayedPath.size() - 1);
+
+        jassert (numDirect == numDelayed || numDirect == numDelayed + 1);
+
+        cascade.numStages = numDirect;
+        cascade.lastStageIsDirectOnly = numDirect > numDelayed;
+        cascade.coefficients = BaseType::allocateRegisters (cascade.coefficientStorage, numDirect);
+        cascade.state = BaseType::allocateRegisters (cascade.stateStorage, BaseType::numGroups * numDirect);
+
+        for (size_t n = 0; n < numDirect; ++n)
+        {
+            auto direct = structure.directPath.getObjectPointer (static_cast<int> (n))->coefficients[0];
+            auto delayed = n < numDelayed ? structure.delayedPath.getObjectPointer (static_cast<int> (n + 1))->coefficients[0]
+                                          : static_cast<SampleType> (0);
+
+            for (size_t lane = 0; lane < L; ++lane)
+                cascade.coefficients[n * L + lane] = (lane % 2 == 0 ? direct : delayed);
+        }
+    }
+
+    void processCascade (Cascade& cascade, size_t group, size_t numSamples) noexcept
+    {
+        constexpr auto L = BaseType::numLanes;
+        auto lv1 = cascade.state + group * cascade.numStages * L;
+
+        typename Register::vMaskType directLanes, delayedLanes;
+
+        for (size_t lane = 0; lane < L; ++lane)
+        {
+            directLanes .set (lane, lane % 2 == 0 ? static_cast<MaskType> (-1) : static_cast<MaskType> (0));
+            delayedLanes.set (lane, lane % 2 == 0 ? static_cast<MaskType> (0)  : static_cast<MaskType> (-1));
+        }
+
+        // Sections are run over the block in passes of up to four, which keeps
+        // their states in registers and lets consecutive sections overlap
+        for (size_t n = 0; n < cascade.numStages;)
+        {
+            auto coeffs = cascade.coefficients + n * L;
+            auto state = lv1 + n * L;
+            auto remaining = cascade.numStages - n;
+            auto isLastPass = remaining <= 4;
+            auto blendLastSection = isLastPass && cascade.lastStageIsDirectOnly;
+
+            switch (remaining)
+            {
+                case 1:  processSections<1> (coeffs, state, numSamples, blendLastSection, directLanes, delayedLanes); break;
+                case 2:  processSections<2> (coeffs, state, numSamples, blendLastSection, directLanes, delayedLanes); break;
+                case 3:  processSections<3> (coeffs, state, numSamples, blendLastSection, directLanes, delayedLanes); break;
+                default: processSections<4> (coeffs, state, numSamples, blendLastSection, directLanes, delayedLanes); break;
+            }
+
+            n += isLastPass ? remaining : 4;
+        }
+    }
+
+    template <size_t numSections>
+    void processSections (const SampleType* coeffs, SampleType* lv1, size_t numSamples, bool blendLastSection,
+                          typename Register::vMaskType directLanes, typename Register::vMaskType delayedLanes) noexcept
+    {
+        constexpr auto L = BaseType::numLanes;
+        Register alpha[numSections], state[numSections];
+
+        for (size_t n = 0; n < numSections; ++n)
+        {
+            alpha[n] = Register::fromRawArray (coeffs + n * L);
+            state[n] = Register::fromRawArray (lv1 + n * L);
+        }
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            auto samples = BaseType::lowRate + i * L;
+            auto input = Register::fromRawArray (samples);
+            auto lastInput = input;
+
+            for (size_t n = 0; n < numSections; ++n)
+            {
+                auto output = alpha[n] * input + state[n];
+                state[n] = input - alpha[n] * output;
+                lastInput = input;
+                input = output;
+            }
+
+            // The odd lanes of a section only the direct path has pass straight through
+            if (blendLastSection)
+                input = (input & directLanes) + (lastInput & delayedLanes);
+
+            input.copyToRawArray (samples);
+        }
+
+        for (size_t n = 0; n < numSections; ++n)
+            state[n].copyToRawArray (lv1 + n * L);
+    }
+
+    void snapToZero (Cascade& cascade) noexcept
+    {
+        auto state = cascade.state;
+
+        for (size_t n = 0; n < BaseType::numGroups * cascade.numStages * BaseType::numLanes; ++n)
+            util::snapToZero (state[n]);
+    }
+
+    //==============================================================================
+    Cascade up, down;
+    SampleType latency;
+    Array<SampleType> delayDown;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Oversampling2TimesPolyphaseIIRSIMD)
+};
+#endif
+
 
 //==============================================================================
 template <typename SampleType>
@@ -557,7 +1103,7 @@ Oversampling<SampleType>::Oversampling (size_t newNumChannels, size_t newFactor,
     {
         addDummyOversamplingStage();
     }
-    else if (newType == FilterType::filterHalfBandPolyphaseIIR)
+    else if (newType == FilterType::filterHalfBandPolyphaseIIR || newType == FilterType::filterHalfBandPolyphaseIIRSIMD)
     {
         for (size_t n = 0; n < newFactor; ++n)
         {
@@ -569,12 +1115,12 @@ Oversampling<SampleType>::Oversampling (size_t newNumChannels, size_t newFactor,
             auto gaindBFactorUp   = (isMaximumQuality ? 10.0f  : 8.0f);
             auto gaindBFactorDown = (isMaximumQuality ? 10.0f  : 8.0f);
 
-            addOversamplingStage (FilterType::filterHalfBandPolyphaseIIR,
+            addOversamplingStage (newType,
                                   twUp, gaindBStartUp + gaindBFactorUp * (float) n,
                                   twDown, gaindBStartDown + gaindBFactorDown * (float) n);
         }
     }
-    else if (newType == FilterType::filterHalfBandFIREquiripple)
+    else if (newType == FilterType::filterHalfBandFIREquiripple || newType == FilterType::filterHalfBandFIREquirippleSIMD)
     {
         for (size_t n = 0; n < newFactor; ++n)
         {
@@ -586,7 +1132,7 @@ Oversampling<SampleType>::Oversampling (size_t newNumChannels, size_t newFactor,
             auto gaindBFactorUp   = (isMaximumQuality ? 10.0f  : 8.0f);
             auto gaindBFactorDown = (isMaximumQuality ? 10.0f  : 8.0f);
 
-            addOversamplingStage (FilterType::filterHalfBandFIREquiripple,
+            addOversamplingStage (newType,
                                   twUp, gaindBStartUp + gaindBFactorUp * (float) n,
                                   twDown, gaindBStartDown + gaindBFactorDown * (float) n);
         }
@@ -613,7 +1159,31 @@ void Oversampling<SampleType>::addOversamplingStage (FilterType type,
                                                      float normalisedTransitionWidthDown,
                                                      float stopbandAmplitudedBDown)
 {
-    if (type == FilterType::filterHalfBandPolyphaseIIR)
+    if (type == FilterType::filterHalfBandPolyphaseIIRSIMD)
+    {
+       #if JUCE_USE_SIMD
+        stages.add (new Oversampling2TimesPolyphaseIIRSIMD<SampleType> (numChannels,
+                                                                        normalisedTransitionWidthUp,   stopbandAmplitudedBUp,
+                                                                        normalisedTransitionWidthDown, stopbandAmplitudedBDown));
+       #else
+        stages.add (new Oversampling2TimesPolyphaseIIR<SampleType> (numChannels,
+                                                                    normalisedTransitionWidthUp,   stopbandAmplitudedBUp,
+                                                                    normalisedTransitionWidthDown, stopbandAmplitudedBDown));
+       #endif
+    }
+    else if (type == FilterType::filterHalfBandFIREquirippleSIMD)
+    {
+       #if JUCE_USE_SIMD
+        stages.add (new Oversampling2TimesEquirippleFIRSIMD<SampleType> (numChannels,
+                                                                         normalisedTransitionWidthUp,   stopbandAmplitudedBUp,
+                                                                         normalisedTransitionWidthDown, stopbandAmplitudedBDown));
+       #else
+        stages.add (new Oversampling2TimesEquirippleFIR<SampleType> (numChannels,
+                                                                     normalisedTransitionWidthUp,   stopbandAmplitudedBUp,
+                                                                     normalisedTransitionWidthDown, stopbandAmplitudedBDown));
+       #endif
+    }
+    else if (type == FilterType::filterHalfBandPolyphaseIIR)
     {
         stages.add (new Oversampling2TimesPolyphaseIIR<SampleType> (numChannels,
                                                                     normalisedTransitionWidthUp,   stopbandAmplitudedBUp,
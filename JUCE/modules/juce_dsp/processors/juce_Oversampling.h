@@ -62,11 +62,21 @@ template <typename SampleType>
 class JUCE_API  Oversampling
 {
 public:
-    /** The type of filter that can be used for the oversampling processing. */
+    /** The type of filter that can be used for the oversampling processing.
+
+        The SIMD variants compute the same filters as their scalar counterparts,
+        but pack several channels into the lanes of a SIMDRegister, and for the
+        IIR filter the two polyphase branches of each channel as well. Both pay
+        off from two channels, the IIR one by less, as the allpass recursion leaves
+        less work to share; for mono the scalar stages remain the better choice.
+        Both fall back to the scalar stages when JUCE_USE_SIMD is disabled.
+    */
     enum FilterType
     {
         filterHalfBandFIREquiripple = 0,
         filterHalfBandPolyphaseIIR,
+        filterHalfBandFIREquirippleSIMD,
+        filterHalfBandPolyphaseIIRSIMD,
         numFilterTypes
     };
 
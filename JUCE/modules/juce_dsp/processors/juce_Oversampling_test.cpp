@@ -0,0 +1,211 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+struct OversamplingUnitTest final : public UnitTest
+{
+    OversamplingUnitTest()
+        : UnitTest ("Oversampling", UnitTestCategories::dsp)
+    {}
+
+    template <typename SampleType>
+    static AudioBuffer<SampleType> makeNoise (int numChannels, int numSamples, Random& random)
+    {
+        AudioBuffer<SampleType> buffer (numChannels, numSamples);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (channel, i, static_cast<SampleType> (2.0f * random.nextFloat() - 1.0f));
+
+        return buffer;
+    }
+
+    template <typename SampleType>
+    static SampleType getMaxDifference (const AudioBuffer<SampleType>& a, const AudioBuffer<SampleType>& b)
+    {
+        SampleType maxDifference = 0;
+
+        for (int channel = 0; channel < a.getNumChannels(); ++channel)
+            for (int i = 0; i < a.getNumSamples(); ++i)
+                maxDifference = jmax (maxDifference, std::abs (a.getSample (channel, i) - b.getSample (channel, i)));
+
+        return maxDifference;
+    }
+
+    // Upsamples, applies a waveshaper so the downsampling filter has something
+    // to remove, and downsamples the input in blocks of random size
+    template <typename SampleType>
+    static AudioBuffer<SampleType> process (Oversampling<SampleType>& oversampling, const AudioBuffer<SampleType>& input,
+                                            int maxBlockSize, Random& random)
+    {
+        AudioBuffer<SampleType> output (input.getNumChannels(), input.getNumSamples());
+
+        for (int start = 0; start < input.getNumSamples();)
+        {
+            auto numSamples = jmin (random.nextInt ({ 1, maxBlockSize + 1 }), input.getNumSamples() - start);
+            auto inputBlock = AudioBlock<const SampleType> (input).getSubBlock ((size_t) start, (size_t) numSamples);
+            auto outputBlock = AudioBlock<SampleType> (output).getSubBlock ((size_t) start, (size_t) numSamples);
+
+            auto oversampled = oversampling.processSamplesUp (inputBlock);
+
+            for (size_t channel = 0; channel < oversampled.getNumChannels(); ++channel)
+                for (size_t i = 0; i < oversampled.getNumSamples(); ++i)
+                    oversampled.setSample ((int) channel, (int) i, std::tanh (static_cast<SampleType> (3) * oversampled.getSample ((int) channel, (int) i)));
+
+            oversampling.processSamplesDown (outputBlock);
+            start += numSamples;
+        }
+
+        return output;
+    }
+
+    template <typename SampleType>
+    void testMatchesScalarStages (typename Oversampling<SampleType>::FilterType scalarType,
+                                  typename Oversampling<SampleType>::FilterType simdType,
+                                  SampleType tolerance)
+    {
+        constexpr auto maxBlockSize = 256;
+        Random random (7);
+
+        for (auto numChannels : { 1, 2, 3, 6, 8, 9 })
+        {
+            for (auto isMaxQuality : { false, true })
+            {
+                Oversampling<SampleType> scalar ((size_t) numChannels, 3, scalarType, isMaxQuality);
+                Oversampling<SampleType> simd   ((size_t) numChannels, 3, simdType,   isMaxQuality);
+
+                expectEquals (simd.getLatencyInSamples(), scalar.getLatencyInSamples());
+                expectEquals ((int) simd.getOversamplingFactor(), 8);
+
+                scalar.initProcessing (maxBlockSize);
+                simd.initProcessing (maxBlockSize);
+
+                auto input = makeNoise<SampleType> (numChannels, 4096, random);
+                auto seed = random.nextInt64();
+
+                Random scalarBlocks (seed), simdBlocks (seed);
+                auto expected = process (scalar, input, maxBlockSize, scalarBlocks);
+                auto actual   = process (simd,   input, maxBlockSize, simdBlocks);
+
+                expectLessThan (getMaxDifference (actual, expected), tolerance, String (numChannels) + " channels");
+
+                // After a reset the same input gives the same output again
+                simd.reset();
+                Random repeatBlocks (seed);
+                auto repeated = process (simd, input, maxBlockSize, repeatBlocks);
+
+                expectEquals (getMaxDifference (repeated, actual), static_cast<SampleType> (0));
+            }
+        }
+    }
+
+    template <typename SampleType>
+    double timeProcessing (typename Oversampling<SampleType>::FilterType type, int numChannels)
+    {
+        constexpr auto blockSize = 256;
+        Random random (3);
+
+        Oversampling<SampleType> oversampling ((size_t) numChannels, 3, type, true);
+        oversampling.initProcessing (blockSize);
+
+        auto input = makeNoise<SampleType> (numChannels, blockSize, random);
+        AudioBuffer<SampleType> output (numChannels, blockSize);
+        auto inputBlock = AudioBlock<const SampleType> (input);
+        auto outputBlock = AudioBlock<SampleType> (output);
+
+        // The fastest of a few runs, to keep other threads out of the figures
+        constexpr auto numBlocks = 100;
+        auto fastest = std::numeric_limits<double>::max();
+
+        for (int run = 0; run < 5; ++run)
+        {
+            const auto start = Time::getHighResolutionTicks();
+
+            for (int n = 0; n < numBlocks; ++n)
+            {
+                oversampling.processSamplesUp (inputBlock);
+                oversampling.processSamplesDown (outputBlock);
+            }
+
+            fastest = jmin (fastest, Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start) * 1.0e6 / numBlocks);
+        }
+
+        return fastest;
+    }
+
+    void runTest() override
+    {
+        using FilterType = Oversampling<float>::FilterType;
+
+        beginTest ("SIMD FIR stages match the scalar stages");
+        {
+            testMatchesScalarStages<float>  (FilterType::filterHalfBandFIREquiripple, FilterType::filterHalfBandFIREquirippleSIMD, 1.0e-5f);
+            testMatchesScalarStages<double> (Oversampling<double>::filterHalfBandFIREquiripple,
+                                             Oversampling<double>::filterHalfBandFIREquirippleSIMD, 1.0e-12);
+        }
+
+        beginTest ("SIMD IIR stages match the scalar stages");
+        {
+            testMatchesScalarStages<float>  (FilterType::filterHalfBandPolyphaseIIR, FilterType::filterHalfBandPolyphaseIIRSIMD, 1.0e-5f);
+            testMatchesScalarStages<double> (Oversampling<double>::filterHalfBandPolyphaseIIR,
+                                             Oversampling<double>::filterHalfBandPolyphaseIIRSIMD, 1.0e-12);
+        }
+
+        beginTest ("Oversampling benchmark");
+        {
+            const std::pair<FilterType, FilterType> types[] { { FilterType::filterHalfBandFIREquiripple, FilterType::filterHalfBandFIREquirippleSIMD },
+                                                              { FilterType::filterHalfBandPolyphaseIIR,  FilterType::filterHalfBandPolyphaseIIRSIMD } };
+
+            for (auto [scalarType, simdType] : types)
+            {
+                for (auto numChannels : { 1, 2, 8 })
+                {
+                    auto scalarTime = timeProcessing<float> (scalarType, numChannels);
+                    auto simdTime   = timeProcessing<float> (simdType,   numChannels);
+
+                    logMessage (String (scalarType == FilterType::filterHalfBandFIREquiripple ? "FIR" : "IIR")
+                                + " 8x, " + String (numChannels) + " channels, 256 sample blocks: "
+                                + String (scalarTime, 1) + " us scalar, " + String (simdTime, 1) + " us SIMD");
+                    expectGreaterThan (simdTime, 0.0);
+                }
+            }
+        }
+    }
+};
+
+static OversamplingUnitTest oversamplingUnitTest;
+
+} // namespace juce::dsp
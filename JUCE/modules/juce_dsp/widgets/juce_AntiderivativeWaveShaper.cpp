@@ -0,0 +1,291 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+namespace AntiderivativeCurves
+{
+    static constexpr double ln2 = 0.693147180559945309417;
+
+    //==============================================================================
+    static double tanhFunction (double x)
+    {
+        return std::tanh (x);
+    }
+
+    // log (cosh (x)), written so that it neither overflows nor loses precision
+    static double logCosh (double x)
+    {
+        auto a = std::abs (x);
+        return a + std::log1p (std::exp (-2.0 * a)) - ln2;
+    }
+
+    // Li2 (w) for w in 0..1/2 from its series in t = -log (1 - w), which has
+    // Bernoulli number coefficients and reaches double precision within 0..log 2
+    static double dilogarithmOfLowerHalf (double t)
+    {
+        static constexpr double coefficients[] = { 1.0 / 36.0,
+                                                   -1.0 / 3600.0,
+                                                   1.0 / 211680.0,
+                                                   -1.0 / 10886400.0,
+                                                   1.0 / 526901760.0,
+                                                   -4.064761645144226e-11,
+                                                   8.921691020456453e-13,
+                                                   -1.9939295860721074e-14 };
+
+        auto t2 = t * t;
+        auto sum = 0.0;
+
+        for (auto i = (int) std::size (coefficients); --i >= 0;)
+            sum = sum * t2 + coefficients[i];
+
+        return t - 0.25 * t2 + t * t2 * sum;
+    }
+
+    // The integral of log (cosh (x)) from 0, which is odd. For x >= 0 it is
+    // x^2 / 2 - x log 2 + Li2 (-e^-2x) / 2 + pi^2 / 24, and with u = e^-2x the
+    // Landen identity gives Li2 (-u) = -Li2 (u / (1 + u)) - log^2 (1 + u) / 2
+    static double logCoshIntegral (double x)
+    {
+        auto a = std::abs (x);
+        auto u = std::exp (-2.0 * a);
+        auto t = std::log1p (u);
+        auto li2 = -dilogarithmOfLowerHalf (t) - 0.5 * t * t;
+
+        auto result = 0.5 * a * a - a * ln2 + 0.5 * li2
+                    + MathConstants<double>::pi * MathConstants<double>::pi / 24.0;
+
+        return x < 0.0 ? -result : result;
+    }
+
+    //==============================================================================
+    static double hardClipFunction (double x)
+    {
+        return jlimit (-1.0, 1.0, x);
+    }
+
+    static double hardClipAntiderivative (double x)
+    {
+        auto a = std::abs (x);
+        return a <= 1.0 ? 0.5 * x * x : a - 0.5;
+    }
+
+    static double hardClipSecondAntiderivative (double x)
+    {
+        auto a = std::abs (x);
+        auto result = a <= 1.0 ? a * a * a / 6.0 : 0.5 * a * a - 0.5 * a + 1.0 / 6.0;
+        return x < 0.0 ? -result : result;
+    }
+
+    //==============================================================================
+    static double cubicSoftClipFunction (double x)
+    {
+        return std::abs (x) <= 1.0 ? 1.5 * x - 0.5 * x * x * x : (x < 0.0 ? -1.0 : 1.0);
+    }
+
+    static double cubicSoftClipAntiderivative (double x)
+    {
+        auto a = std::abs (x);
+        auto a2 = a * a;
+        return a <= 1.0 ? 0.75 * a2 - 0.125 * a2 * a2 : a - 0.375;
+    }
+
+    static double cubicSoftClipSecondAntiderivative (double x)
+    {
+        auto a = std::abs (x);
+        auto a2 = a * a;
+        auto result = a <= 1.0 ? 0.25 * a2 * a - 0.025 * a2 * a2 * a : 0.5 * a2 - 0.375 * a + 0.1;
+        return x < 0.0 ? -result : result;
+    }
+}
+
+//==============================================================================
+AntiderivativeCurve AntiderivativeCurve::tanh() noexcept
+{
+    return { AntiderivativeCurves::tanhFunction,
+             AntiderivativeCurves::logCosh,
+             AntiderivativeCurves::logCoshIntegral };
+}
+
+AntiderivativeCurve AntiderivativeCurve::hardClip() noexcept
+{
+    return { AntiderivativeCurves::hardClipFunction,
+             AntiderivativeCurves::hardClipAntiderivative,
+             AntiderivativeCurves::hardClipSecondAntiderivative };
+}
+
+AntiderivativeCurve AntiderivativeCurve::cubicSoftClip() noexcept
+{
+    return { AntiderivativeCurves::cubicSoftClipFunction,
+             AntiderivativeCurves::cubicSoftClipAntiderivative,
+             AntiderivativeCurves::cubicSoftClipSecondAntiderivative };
+}
+
+//==============================================================================
+template <typename SampleType>
+AntiderivativeWaveShaper<SampleType>::AntiderivativeWaveShaper()
+    : curve (AntiderivativeCurve::tanh())
+{
+}
+
+template <typename SampleType>
+void AntiderivativeWaveShaper<SampleType>::setCurve (const AntiderivativeCurve& newCurve)
+{
+    jassert (newCurve.function != nullptr && newCurve.antiderivative != nullptr);
+
+    curve = newCurve;
+    reset();
+}
+
+template <typename SampleType>
+void AntiderivativeWaveShaper<SampleType>::setOrder (Order newOrder)
+{
+    // Second order processing needs the second antiderivative
+    jassert (newOrder != Order::second || curve.secondAntiderivative != nullptr);
+
+    order = newOrder;
+    reset();
+}
+
+template <typename SampleType>
+double AntiderivativeWaveShaper<SampleType>::getDelayInSamples() const noexcept
+{
+    return 0.5 * (double) order;
+}
+
+//==============================================================================
+template <typename SampleType>
+void AntiderivativeWaveShaper<SampleType>::prepare (const ProcessSpec& spec)
+{
+    jassert (spec.numChannels > 0);
+
+    states.resize (spec.numChannels);
+    reset();
+}
+
+template <typename SampleType>
+void AntiderivativeWaveShaper<SampleType>::reset() noexcept
+{
+    ChannelState silence;
+
+    if (order == Order::first)
+    {
+        silence.previousAntiderivative = curve.antiderivative (0.0);
+    }
+    else if (order == Order::second)
+    {
+        silence.previousAntiderivative = curve.secondAntiderivative (0.0);
+        silence.differenceQuotient = curve.antiderivative (0.0);
+    }
+
+    std::fill (states.begin(), states.end(), silence);
+}
+
+//==============================================================================
+template <typename SampleType>
+SampleType AntiderivativeWaveShaper<SampleType>::processSample (int channel, SampleType inputValue) noexcept
+{
+    jassert (isPositiveAndBelow (channel, states.size()));
+
+    auto& state = states[(size_t) channel];
+    auto x = static_cast<double> (inputValue);
+
+    switch (order)
+    {
+        case Order::first:   return static_cast<SampleType> (processFirstOrder  (state, x));
+        case Order::second:  return static_cast<SampleType> (processSecondOrder (state, x));
+        case Order::none:    break;
+    }
+
+    return static_cast<SampleType> (curve.function (x));
+}
+
+template <typename SampleType>
+double AntiderivativeWaveShaper<SampleType>::processFirstOrder (ChannelState& state, double x) const noexcept
+{
+    auto antiderivative = curve.antiderivative (x);
+    auto difference = x - state.x1;
+
+    auto y = std::abs (difference) < firstOrderTolerance ? curve.function (0.5 * (x + state.x1))
+                                                         : (antiderivative - state.previousAntiderivative) / difference;
+
+    state.x1 = x;
+    state.previousAntiderivative = antiderivative;
+    return y;
+}
+
+template <typename SampleType>
+double AntiderivativeWaveShaper<SampleType>::processSecondOrder (ChannelState& state, double x) const noexcept
+{
+    // The first order difference quotient of F2 between this input and the
+    // previous one, i.e. the mean of F1 over that segment
+    auto secondAntiderivative = curve.secondAntiderivative (x);
+    auto difference = x - state.x1;
+
+    auto differenceQuotient = std::abs (difference) < secondOrderTolerance
+                                ? curve.antiderivative (0.5 * (x + state.x1))
+                                : (secondAntiderivative - state.previousAntiderivative) / difference;
+
+    double y;
+    auto span = x - state.x2;
+
+    if (std::abs (span) < secondOrderTolerance)
+    {
+        // x and x2 nearly coincide: expand around their midpoint instead
+        auto midpoint = 0.5 * (x + state.x2);
+        auto delta = midpoint - state.x1;
+
+        y = std::abs (delta) < secondOrderTolerance
+              ? curve.function (0.5 * (midpoint + state.x1))
+              : (2.0 / delta) * (curve.antiderivative (midpoint)
+                                   + (state.previousAntiderivative - curve.secondAntiderivative (midpoint)) / delta);
+    }
+    else
+    {
+        y = (2.0 / span) * (differenceQuotient - state.differenceQuotient);
+    }
+
+    state.x2 = state.x1;
+    state.x1 = x;
+    state.previousAntiderivative = secondAntiderivative;
+    state.differenceQuotient = differenceQuotient;
+    return y;
+}
+
+//==============================================================================
+template class AntiderivativeWaveShaper<float>;
+template class AntiderivativeWaveShaper<double>;
+
+} // namespace juce::dsp
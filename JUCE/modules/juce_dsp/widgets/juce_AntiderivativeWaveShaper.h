@@ -0,0 +1,212 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+/**
+    A waveshaping curve together with its first two antiderivatives, as used by
+    AntiderivativeWaveShaper.
+
+    The antiderivatives are differentiated numerically on every sample, so any
+    error in them is divided by the difference between consecutive inputs (and
+    by its square at second order). They should be accurate closed forms in
+    double precision rather than tables or low-order approximations; a linearly
+    interpolated table fine enough for second order would need hundreds of
+    thousands of points.
+
+    @see AntiderivativeWaveShaper
+
+    @tags{DSP}
+*/
+struct JUCE_API  AntiderivativeCurve
+{
+    /** The curve itself. */
+    double (*function) (double) = nullptr;
+
+    /** An antiderivative of function. */
+    double (*antiderivative) (double) = nullptr;
+
+    /** An antiderivative of antiderivative, only needed for second order processing. */
+    double (*secondAntiderivative) (double) = nullptr;
+
+    //==============================================================================
+    /** y = tanh (x). The antiderivatives are log (cosh (x)) and its integral,
+        which is written with the dilogarithm.
+    */
+    static AntiderivativeCurve tanh() noexcept;
+
+    /** y = x clipped to -1..1. */
+    static AntiderivativeCurve hardClip() noexcept;
+
+    /** y = 1.5 x - 0.5 x^3 for x in -1..1, and -1 or 1 outside, a soft clipper
+        with a continuous first derivative.
+    */
+    static AntiderivativeCurve cubicSoftClip() noexcept;
+};
+
+//==============================================================================
+/**
+    A waveshaper with antiderivative anti-aliasing (ADAA).
+
+    A static curve applied to each sample creates harmonics far above the Nyquist
+    frequency, which fold back into the audible range. With first order ADAA, the
+    output is instead the average of the curve over the straight line joining the
+    previous input to the current one, (F1 (x[n]) - F1 (x[n - 1])) / (x[n] - x[n - 1]),
+    where F1 is the antiderivative of the curve. That is a continuous-time lowpass
+    applied before the shaped signal is sampled, which attenuates the harmonics
+    the more the higher they are. Second order ADAA averages once more, using the
+    second antiderivative, and suppresses aliasing further.
+
+    The first order adds half a sample of delay and the second order one sample,
+    see getDelayInSamples(). Both also roll off the top octave a little, which is
+    why they are usually run at 2x oversampling: that combination removes about
+    as much aliasing as plain waveshaping at much higher oversampling factors, at
+    a fraction of the cost.
+
+    When consecutive inputs are too close together, the divided differences lose
+    their precision. The processor then evaluates the curve (or its antiderivative)
+    at the midpoint instead, which is the limit of the same expression.
+
+    The state and all the arithmetic are in double precision, whatever the
+    SampleType.
+
+    @see AntiderivativeCurve, Oversampling
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class AntiderivativeWaveShaper
+{
+public:
+    //==============================================================================
+    /** The anti-aliasing order. With none the curve is applied directly. */
+    enum class Order
+    {
+        none = 0,
+        first,
+        second
+    };
+
+    //==============================================================================
+    /** Constructor, for a tanh curve with first order ADAA. */
+    AntiderivativeWaveShaper();
+
+    //==============================================================================
+    /** Sets the curve, and resets the processor. The second antiderivative can be
+        left out if second order processing is never used.
+    */
+    void setCurve (const AntiderivativeCurve& newCurve);
+
+    /** Returns the current curve. */
+    const AntiderivativeCurve& getCurve() const noexcept     { return curve; }
+
+    /** Sets the anti-aliasing order, and resets the processor. */
+    void setOrder (Order newOrder);
+
+    /** Returns the current anti-aliasing order. */
+    Order getOrder() const noexcept                          { return order; }
+
+    /** Returns the delay, in samples, that the current order adds to the signal. */
+    double getDelayInSamples() const noexcept;
+
+    //==============================================================================
+    /** Initialises the processor. */
+    void prepare (const ProcessSpec& spec);
+
+    /** Resets the internal state variables of the processor, as if the input had
+        been silent.
+    */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Processes the input and output samples supplied in the processing context. */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock      = context.getOutputBlock();
+        const auto numChannels = outputBlock.getNumChannels();
+        const auto numSamples  = outputBlock.getNumSamples();
+
+        jassert (inputBlock.getNumChannels() == numChannels);
+        jassert (inputBlock.getNumChannels() <= states.size());
+        jassert (inputBlock.getNumSamples()  == numSamples);
+
+        if (context.isBypassed)
+        {
+            outputBlock.copyFrom (inputBlock);
+            return;
+        }
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            auto* inputSamples  = inputBlock .getChannelPointer (channel);
+            auto* outputSamples = outputBlock.getChannelPointer (channel);
+
+            for (size_t i = 0; i < numSamples; ++i)
+                outputSamples[i] = processSample ((int) channel, inputSamples[i]);
+        }
+    }
+
+    /** Processes one sample of one channel. */
+    SampleType processSample (int channel, SampleType inputValue) noexcept;
+
+private:
+    //==============================================================================
+    struct ChannelState
+    {
+        double x1 = 0.0, x2 = 0.0;                 // previous inputs
+        double previousAntiderivative = 0.0;       // F1 (x1) at first order, F2 (x1) at second order
+        double differenceQuotient = 0.0;           // (F2 (x1) - F2 (x2)) / (x1 - x2), second order only
+    };
+
+    double processFirstOrder  (ChannelState&, double) const noexcept;
+    double processSecondOrder (ChannelState&, double) const noexcept;
+
+    //==============================================================================
+    AntiderivativeCurve curve;
+    Order order = Order::first;
+    std::vector<ChannelState> states;
+
+    // Below these input differences the divided differences are replaced by
+    // their midpoint limits
+    static constexpr double firstOrderTolerance  = 1.0e-5;
+    static constexpr double secondOrderTolerance = 1.0e-4;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AntiderivativeWaveShaper)
+};
+
+} // namespace juce::dsp
@@ -0,0 +1,284 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+struct AntiderivativeWaveShaperUnitTest final : public UnitTest
+{
+    AntiderivativeWaveShaperUnitTest()
+        : UnitTest ("AntiderivativeWaveShaper", UnitTestCategories::dsp)
+    {}
+
+    using Order = AntiderivativeWaveShaper<float>::Order;
+
+    static std::vector<std::pair<String, AntiderivativeCurve>> getCurves()
+    {
+        return { { "tanh",            AntiderivativeCurve::tanh() },
+                 { "hard clip",       AntiderivativeCurve::hardClip() },
+                 { "cubic soft clip", AntiderivativeCurve::cubicSoftClip() } };
+    }
+
+    //==============================================================================
+    /** Waveshapes a sine with the given drive, running the shaper at 2 ^ oversamplingOrder
+        times the sample rate. The sine completes an integer number of cycles every fftSize
+        samples, so once the filters have settled every component sits exactly on a bin.
+    */
+    struct AliasingMeasurement
+    {
+        static constexpr double sampleRate = 48000.0;
+        static constexpr int fftOrder = 13, fftSize = 1 << fftOrder;
+        static constexpr int fundamentalBin = 853;   // prime, about 5 kHz
+
+        static std::vector<float> render (Order order, int oversamplingOrder, float drive, int numSamples)
+        {
+            constexpr int blockSize = 256;
+
+            Oversampling<float> oversampling (1, (size_t) oversamplingOrder,
+                                              Oversampling<float>::filterHalfBandPolyphaseIIR, true);
+            oversampling.initProcessing (blockSize);
+
+            AntiderivativeWaveShaper<float> shaper;
+            shaper.setOrder (order);
+            shaper.prepare ({ sampleRate * (1 << oversamplingOrder), (uint32) (blockSize << oversamplingOrder), 1 });
+
+            std::vector<float> signal ((size_t) numSamples);
+
+            for (int i = 0; i < numSamples; ++i)
+                signal[(size_t) i] = drive * (float) std::sin (MathConstants<double>::twoPi * fundamentalBin * (i % fftSize) / fftSize);
+
+            for (int start = 0; start < numSamples; start += blockSize)
+            {
+                float* channels[] { signal.data() + start };
+                AudioBlock<float> block (channels, 1, (size_t) blockSize);
+
+                auto oversampled = oversampling.processSamplesUp (block);
+                shaper.process (ProcessContextReplacing<float> (oversampled));
+                oversampling.processSamplesDown (block);
+            }
+
+            return signal;
+        }
+
+        /** Returns the power of the non-harmonic components below 20 kHz relative
+            to that of the harmonics, in dB.
+        */
+        static double getAliasingLevel (Order order, int oversamplingOrder, float drive)
+        {
+            auto signal = render (order, oversamplingOrder, drive, 4 * fftSize);
+
+            FFT fft (fftOrder);
+            std::vector<float> data (2 * fftSize);
+            std::copy (signal.end() - fftSize, signal.end(), data.begin());
+            fft.performFrequencyOnlyForwardTransform (data.data(), true);
+
+            double harmonicPower = 0.0, aliasPower = 0.0;
+            const auto maxBin = (int) (20000.0 * fftSize / sampleRate);
+
+            for (int bin = 1; bin <= maxBin; ++bin)
+            {
+                auto power = (double) data[(size_t) bin] * data[(size_t) bin];
+                (bin % fundamentalBin == 0 ? harmonicPower : aliasPower) += power;
+            }
+
+            return 10.0 * std::log10 (aliasPower / harmonicPower);
+        }
+    };
+
+    static double timeProcessing (Order order, int oversamplingOrder, float drive)
+    {
+        constexpr int blockSize = 512, numChannels = 2, numBlocks = 200;
+
+        Oversampling<float> oversampling (numChannels, (size_t) oversamplingOrder,
+                                          Oversampling<float>::filterHalfBandPolyphaseIIR, true);
+        oversampling.initProcessing (blockSize);
+
+        AntiderivativeWaveShaper<float> shaper;
+        shaper.setOrder (order);
+        shaper.prepare ({ 48000.0 * (1 << oversamplingOrder), (uint32) (blockSize << oversamplingOrder), numChannels });
+
+        AudioBuffer<float> buffer (numChannels, blockSize);
+        Random random (1);
+
+        // The fastest of a few runs, to keep other threads out of the figures
+        auto fastest = std::numeric_limits<double>::max();
+
+        for (int run = 0; run < 5; ++run)
+        {
+            auto seconds = 0.0;
+
+            for (int n = 0; n < numBlocks; ++n)
+            {
+                for (int channel = 0; channel < numChannels; ++channel)
+                    for (int i = 0; i < blockSize; ++i)
+                        buffer.setSample (channel, i, drive * (2.0f * random.nextFloat() - 1.0f));
+
+                auto block = AudioBlock<float> (buffer);
+                const auto start = Time::getHighResolutionTicks();
+
+                auto oversampled = oversampling.processSamplesUp (block);
+                shaper.process (ProcessContextReplacing<float> (oversampled));
+                oversampling.processSamplesDown (block);
+
+                seconds += Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+            }
+
+            fastest = jmin (fastest, seconds * 1.0e6 / numBlocks);
+        }
+
+        return fastest;
+    }
+
+    //==============================================================================
+    void runTest() override
+    {
+        beginTest ("Antiderivatives");
+        {
+            constexpr auto h = 1.0e-4;
+
+            for (const auto& [curveName, curve] : getCurves())
+            {
+                expectWithinAbsoluteError (curve.antiderivative (0.0), 0.0, 1.0e-15, curveName);
+                expectWithinAbsoluteError (curve.secondAntiderivative (0.0), 0.0, 1.0e-15, curveName);
+
+                for (auto x = -8.0; x < 8.0; x += 0.37)
+                {
+                    auto slope1 = (curve.antiderivative (x + h) - curve.antiderivative (x - h)) / (2.0 * h);
+                    auto slope2 = (curve.secondAntiderivative (x + h) - curve.secondAntiderivative (x - h)) / (2.0 * h);
+
+                    expectWithinAbsoluteError (slope1, curve.function (x), 1.0e-7, curveName + " at " + String (x));
+                    expectWithinAbsoluteError (slope2, curve.antiderivative (x), 1.0e-7, curveName + " at " + String (x));
+                }
+            }
+
+            // Far from zero the integral of log (cosh (x)) tends to x^2 / 2 - x log 2 + pi^2 / 24
+            auto tanhCurve = AntiderivativeCurve::tanh();
+            auto asymptote = [] (double x) { return 0.5 * x * x - x * std::log (2.0) + MathConstants<double>::pi * MathConstants<double>::pi / 24.0; };
+
+            expectWithinAbsoluteError (tanhCurve.secondAntiderivative (30.0), asymptote (30.0), 1.0e-12);
+            expectWithinAbsoluteError (tanhCurve.secondAntiderivative (-30.0), -asymptote (30.0), 1.0e-12);
+        }
+
+        beginTest ("Slowly varying inputs follow the curve");
+        {
+            for (const auto& [curveName, curve] : getCurves())
+            {
+                for (auto order : { Order::none, Order::first, Order::second })
+                {
+                    // Steps above and below the tolerances, which switch to the fallbacks
+                    for (auto step : { 6.0e-4, 1.0e-6 })
+                    {
+                        AntiderivativeWaveShaper<double> shaper;
+                        shaper.setCurve (curve);
+                        shaper.setOrder (static_cast<AntiderivativeWaveShaper<double>::Order> (order));
+                        shaper.prepare ({ 48000.0, 512, 1 });
+
+                        auto x = -3.0;
+                        shaper.reset();
+
+                        for (int i = 0; i < 3; ++i)
+                            shaper.processSample (0, x + (i - 3) * step);
+
+                        auto maxError = 0.0;
+
+                        for (int i = 0; i < 10000; ++i, x += step)
+                        {
+                            auto y = shaper.processSample (0, x);
+                            auto expected = curve.function (x - shaper.getDelayInSamples() * step);
+                            maxError = jmax (maxError, std::abs (y - expected));
+                        }
+
+                        expectLessThan (maxError, 1.0e-4, curveName + ", order " + String ((int) order) + ", step " + String (step));
+                    }
+
+                    // A constant input gives the curve's value exactly
+                    AntiderivativeWaveShaper<float> shaper;
+                    shaper.setCurve (curve);
+                    shaper.setOrder (order);
+                    shaper.prepare ({ 48000.0, 512, 2 });
+
+                    for (int i = 0; i < 4; ++i)
+                        shaper.processSample (1, 0.7f);
+
+                    expectWithinAbsoluteError (shaper.processSample (1, 0.7f), (float) curve.function (0.7), 1.0e-6f);
+                    expectEquals (shaper.processSample (0, 0.0f), (float) curve.function (0.0));
+                }
+            }
+        }
+
+        beginTest ("Aliasing");
+        {
+            constexpr auto drive = 5.0f;
+
+            auto plain1x  = AliasingMeasurement::getAliasingLevel (Order::none,   0, drive);
+            auto first1x  = AliasingMeasurement::getAliasingLevel (Order::first,  0, drive);
+            auto plain2x  = AliasingMeasurement::getAliasingLevel (Order::none,   1, drive);
+            auto first2x  = AliasingMeasurement::getAliasingLevel (Order::first,  1, drive);
+            auto second2x = AliasingMeasurement::getAliasingLevel (Order::second, 1, drive);
+            auto first4x  = AliasingMeasurement::getAliasingLevel (Order::first,  2, drive);
+            auto plain8x  = AliasingMeasurement::getAliasingLevel (Order::none,   3, drive);
+
+            logMessage ("Aliasing below 20 kHz relative to the harmonics, for tanh (" + String (drive) + " sin (5 kHz)):");
+            logMessage ("  1x: " + String (plain1x, 1) + " dB plain, " + String (first1x, 1) + " dB first order");
+            logMessage ("  2x: " + String (plain2x, 1) + " dB plain, " + String (first2x, 1) + " dB first order, " + String (second2x, 1) + " dB second order");
+            logMessage ("  4x: " + String (first4x, 1) + " dB first order");
+            logMessage ("  8x: " + String (plain8x, 1) + " dB plain");
+
+            expectLessThan (first1x, plain1x - 10.0);
+            expectLessThan (first2x, plain2x - 15.0);
+            expectLessThan (second2x, first2x - 15.0);
+            expectLessThan (first4x, plain8x);
+        }
+
+        beginTest ("Anti-aliasing benchmark");
+        {
+            constexpr auto drive = 5.0f;
+
+            auto plain1x  = timeProcessing (Order::none,   0, drive);
+            auto plain8x  = timeProcessing (Order::none,   3, drive);
+            auto first2x  = timeProcessing (Order::first,  1, drive);
+            auto second2x = timeProcessing (Order::second, 1, drive);
+            auto first4x  = timeProcessing (Order::first,  2, drive);
+
+            logMessage ("Stereo, 512 sample blocks: " + String (plain1x, 1) + " us plain, " + String (plain8x, 1) + " us plain at 8x, "
+                        + String (first2x, 1) + " us first order at 2x, " + String (second2x, 1) + " us second order at 2x, "
+                        + String (first4x, 1) + " us first order at 4x");
+            expectGreaterThan (plain1x, 0.0);
+        }
+    }
+};
+
+static AntiderivativeWaveShaperUnitTest antiderivativeWaveShaperUnitTest;
+
+} // namespace juce::dsp
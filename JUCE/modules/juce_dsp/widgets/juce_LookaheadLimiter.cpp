@@ -0,0 +1,301 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+//==============================================================================
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::SlidingMaximum::prepare (int windowSizeToUse)
+{
+    window = jmax (1, windowSizeToUse);
+
+    // The deque never holds more than the window, plus the value being added
+    capacity = window + 1;
+    values.assign ((size_t) capacity, SampleType());
+    positions.assign ((size_t) capacity, 0);
+    reset();
+}
+
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::SlidingMaximum::reset() noexcept
+{
+    front = 0;
+    size = 0;
+    position = 0;
+}
+
+template <typename SampleType>
+SampleType LookaheadLimiter<SampleType>::SlidingMaximum::push (SampleType value) noexcept
+{
+    // Values no larger than the new one can never be the maximum again
+    while (size > 0 && values[(size_t) ((front + size - 1) % capacity)] <= value)
+        --size;
+
+    const auto back = (size_t) ((front + size) % capacity);
+    values[back] = value;
+    positions[back] = position;
+    ++size;
+
+    // At most one value leaves the window per sample
+    if (positions[(size_t) front] <= position - window)
+    {
+        front = (front + 1) % capacity;
+        --size;
+    }
+
+    ++position;
+    return values[(size_t) front];
+}
+
+//==============================================================================
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::setCeiling (SampleType newCeilingDecibels) noexcept
+{
+    ceilingDecibels = newCeilingDecibels;
+    ceiling = Decibels::decibelsToGain (ceilingDecibels, (SampleType) -200);
+}
+
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::setRelease (SampleType newReleaseMilliseconds) noexcept
+{
+    releaseMilliseconds = jmax ((SampleType) 0, newReleaseMilliseconds);
+    const auto releaseSamples = (double) releaseMilliseconds * sampleRate / 1000.0;
+
+    releaseCoefficient = releaseSamples > 0.0 ? (SampleType) std::exp (-1.0 / releaseSamples) : SampleType();
+}
+
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::setLookahead (SampleType newLookaheadMilliseconds) noexcept
+{
+    lookaheadMilliseconds = jmax ((SampleType) 0, newLookaheadMilliseconds);
+}
+
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::setTruePeakDetection (bool shouldDetectTruePeaks) noexcept
+{
+    truePeakRequested = shouldDetectTruePeaks;
+}
+
+template <typename SampleType>
+SampleType LookaheadLimiter<SampleType>::getGainReductionDecibels() const noexcept
+{
+    return -Decibels::gainToDecibels (currentGain, (SampleType) -200);
+}
+
+template <typename SampleType>
+SampleType LookaheadLimiter<SampleType>::getPeakGainReductionDecibels() const noexcept
+{
+    return -Decibels::gainToDecibels (minimumGain, (SampleType) -200);
+}
+
+//==============================================================================
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::prepare (const ProcessSpec& spec)
+{
+    jassert (spec.sampleRate > 0);
+    jassert (spec.numChannels > 0);
+
+    sampleRate = spec.sampleRate;
+    maximumBlockSize = jmax (1, (int) spec.maximumBlockSize);
+    lookaheadSamples = roundToInt ((double) lookaheadMilliseconds * sampleRate / 1000.0);
+    detectorDelay = truePeakRequested ? interpolatorDelay : 0;
+    windowSize = lookaheadSamples + 1;
+
+    channels.resize (spec.numChannels);
+
+    for (auto& channel : channels)
+    {
+        channel.delay.assign ((size_t) (getLatencyInSamples() + maximumBlockSize), SampleType());
+        channel.history.assign ((size_t) (interpolatorTaps - 1 + maximumBlockSize), SampleType());
+    }
+
+    inputPointers.assign (spec.numChannels, nullptr);
+    outputPointers.assign (spec.numChannels, nullptr);
+
+    peakWindow.prepare (windowSize);
+    peaks.assign ((size_t) maximumBlockSize, SampleType());
+    gains.assign ((size_t) maximumBlockSize, SampleType());
+    envelopeWindow.assign ((size_t) windowSize, (SampleType) 1);
+    requiredGains.assign ((size_t) windowSize, (SampleType) 1);
+
+    // Hann-windowed sinc at a quarter, half and three quarters of the way from the
+    // sample before the detected one, normalised so that DC passes unchanged
+    for (int phase = 0; phase < interpolatorPhases; ++phase)
+    {
+        const auto fraction = (phase + 1) / 4.0;
+        auto& coefficients = interpolator[(size_t) phase];
+        double sum = 0.0;
+
+        for (int tap = 0; tap < interpolatorTaps; ++tap)
+        {
+            const auto x = fraction + interpolatorDelay - tap;
+            const auto sinc = MathConstants<double>::pi * x;
+            const auto window = 0.5 * (1.0 + std::cos (MathConstants<double>::pi * x / (interpolatorTaps / 2)));
+            const auto value = std::sin (sinc) / sinc * window;
+
+            coefficients[(size_t) tap] = (SampleType) value;
+            sum += value;
+        }
+
+        for (auto& coefficient : coefficients)
+            coefficient = (SampleType) (coefficient / sum);
+    }
+
+    setCeiling (ceilingDecibels);
+    setRelease (releaseMilliseconds);
+    reset();
+}
+
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::reset() noexcept
+{
+    for (auto& channel : channels)
+    {
+        std::fill (channel.delay.begin(), channel.delay.end(), SampleType());
+        std::fill (channel.history.begin(), channel.history.end(), SampleType());
+    }
+
+    peakWindow.reset();
+    std::fill (envelopeWindow.begin(), envelopeWindow.end(), (SampleType) 1);
+    std::fill (requiredGains.begin(), requiredGains.end(), (SampleType) 1);
+    windowPosition = 0;
+    envelopeSum = (double) windowSize;
+    envelope = currentGain = minimumGain = 1;
+}
+
+//==============================================================================
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::detectPeaks (int numChannels, int numSamples) noexcept
+{
+    if (detectorDelay == 0)
+    {
+        FloatVectorOperations::abs (peaks.data(), inputPointers[0], numSamples);
+
+        for (int channel = 1; channel < numChannels; ++channel)
+        {
+            FloatVectorOperations::abs (gains.data(), inputPointers[(size_t) channel], numSamples);
+            FloatVectorOperations::max (peaks.data(), peaks.data(), gains.data(), numSamples);
+        }
+
+        return;
+    }
+
+    // Each peak covers one sample and the three interpolated points before it, so
+    // it describes the sample interpolatorDelay samples before the newest input
+    std::fill (peaks.begin(), peaks.begin() + numSamples, SampleType());
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto& history = channels[(size_t) channel].history;
+        std::copy (inputPointers[(size_t) channel], inputPointers[(size_t) channel] + numSamples,
+                   history.begin() + (interpolatorTaps - 1));
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto* taps = history.data() + i;
+            auto peak = std::abs (taps[interpolatorDelay + 1]);
+
+            for (const auto& coefficients : interpolator)
+            {
+                SampleType value = 0;
+
+                for (int tap = 0; tap < interpolatorTaps; ++tap)
+                    value += coefficients[(size_t) tap] * taps[tap];
+
+                peak = jmax (peak, std::abs (value));
+            }
+
+            peaks[(size_t) i] = jmax (peaks[(size_t) i], peak);
+        }
+
+        std::copy (history.begin() + numSamples, history.begin() + numSamples + (interpolatorTaps - 1), history.begin());
+    }
+}
+
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::processChunk (int numChannels, int numSamples) noexcept
+{
+    // Everything is read from the input before any output is written, as they may be the same
+    detectPeaks (numChannels, numSamples);
+
+    const auto latency = getLatencyInSamples();
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        std::copy (inputPointers[(size_t) channel], inputPointers[(size_t) channel] + numSamples,
+                   channels[(size_t) channel].delay.begin() + latency);
+
+    const auto requiredGain = [this] (SampleType peak) { return peak > ceiling ? ceiling / peak : (SampleType) 1; };
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto peak = peaks[(size_t) i];
+        const auto hold = requiredGain (peakWindow.push (peak));
+
+        // Instant attack down to the window's gain, exponential release back up
+        envelope = hold < envelope ? hold : hold + (envelope - hold) * releaseCoefficient;
+
+        // The moving average ramps the attack over the window. It can only ever be
+        // above the gain this window's peak needs by rounding, which the clamp to that
+        // gain, now lookaheadSamples old, takes care of.
+        const auto position = (size_t) windowPosition;
+        envelopeSum += (double) envelope - (double) envelopeWindow[position];
+        envelopeWindow[position] = envelope;
+        requiredGains[position] = requiredGain (peak);
+
+        if (++windowPosition == windowSize)
+        {
+            windowPosition = 0;
+            envelopeSum = std::accumulate (envelopeWindow.begin(), envelopeWindow.end(), 0.0);
+        }
+
+        gains[(size_t) i] = jmin ((SampleType) (envelopeSum / windowSize), requiredGains[(size_t) windowPosition]);
+    }
+
+    currentGain = gains[(size_t) numSamples - 1];
+    minimumGain = jmin (minimumGain, FloatVectorOperations::findMinimum (gains.data(), numSamples));
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto& delay = channels[(size_t) channel].delay;
+        FloatVectorOperations::multiply (outputPointers[(size_t) channel], delay.data(), gains.data(), numSamples);
+        std::copy (delay.begin() + numSamples, delay.begin() + numSamples + latency, delay.begin());
+    }
+}
+
+//==============================================================================
+template class LookaheadLimiter<float>;
+template class LookaheadLimiter<double>;
+
+} // namespace juce::dsp
@@ -0,0 +1,207 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+/**
+    A lookahead brickwall limiter, for an output stage that must stay under a
+    ceiling.
+
+    The signal is delayed by the lookahead time, so the gain can start to fall
+    before a peak arrives. For every sample the limiter needs the largest peak,
+    across all channels, within the next lookahead samples. That is found with a
+    monotonic deque: the peaks that can still become the maximum of the window are
+    kept in decreasing order, so each sample is added and removed once, which is
+    O(1) amortised per sample whatever the lookahead.
+
+    The gain envelope falls instantly to the gain the window's peak needs and
+    recovers with an exponential release. It is then smoothed by a moving average
+    as long as the window, which turns the attack into a linear ramp that ends
+    exactly when the peak reaches the output. Every channel gets the same gain,
+    applied with FloatVectorOperations.
+
+    With true-peak detection, three points between every pair of samples are
+    interpolated with a windowed-sinc filter, as a 4x oversampling true-peak meter
+    does, so the reconstructed waveform stays under the ceiling too and not only
+    its samples. The interpolator adds five samples to the latency.
+
+    @see Limiter
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class LookaheadLimiter
+{
+public:
+    //==============================================================================
+    /** Constructor, for a -1 dB ceiling, 5 ms lookahead and 100 ms release. */
+    LookaheadLimiter() = default;
+
+    //==============================================================================
+    /** Sets the ceiling in dB. */
+    void setCeiling (SampleType newCeilingDecibels) noexcept;
+
+    /** Sets the release time in milliseconds. */
+    void setRelease (SampleType newReleaseMilliseconds) noexcept;
+
+    /** Sets the lookahead time in milliseconds. This changes the latency, so it only
+        takes effect on the next call to prepare().
+    */
+    void setLookahead (SampleType newLookaheadMilliseconds) noexcept;
+
+    /** Turns true-peak detection on or off. This changes the latency, so it only takes
+        effect on the next call to prepare().
+    */
+    void setTruePeakDetection (bool shouldDetectTruePeaks) noexcept;
+
+    /** Returns the delay the limiter adds to the signal, in samples. */
+    int getLatencyInSamples() const noexcept                { return lookaheadSamples + detectorDelay; }
+
+    //==============================================================================
+    /** Returns the gain reduction at the end of the last block, in dB (0 or more). */
+    SampleType getGainReductionDecibels() const noexcept;
+
+    /** Returns the largest gain reduction since the last call to resetPeakGainReduction(),
+        in dB (0 or more).
+    */
+    SampleType getPeakGainReductionDecibels() const noexcept;
+
+    /** Restarts the peak gain reduction measurement. */
+    void resetPeakGainReduction() noexcept                   { minimumGain = currentGain; }
+
+    //==============================================================================
+    /** Initialises the processor. */
+    void prepare (const ProcessSpec& spec);
+
+    /** Resets the internal state variables of the processor, as if the input had
+        been silent.
+    */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Processes the input and output samples supplied in the processing context. */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock      = context.getOutputBlock();
+        const auto numChannels = outputBlock.getNumChannels();
+        const auto numSamples  = outputBlock.getNumSamples();
+
+        jassert (inputBlock.getNumChannels() == numChannels);
+        jassert (inputBlock.getNumChannels() <= channels.size());
+        jassert (inputBlock.getNumSamples()  == numSamples);
+
+        if (context.isBypassed)
+        {
+            outputBlock.copyFrom (inputBlock);
+            return;
+        }
+
+        // Hosts may send more samples than they announced in prepare()
+        for (size_t start = 0; start < numSamples; start += (size_t) maximumBlockSize)
+        {
+            const auto chunk = jmin (numSamples - start, (size_t) maximumBlockSize);
+
+            for (size_t channel = 0; channel < numChannels; ++channel)
+            {
+                inputPointers[channel]  = inputBlock .getChannelPointer (channel) + start;
+                outputPointers[channel] = outputBlock.getChannelPointer (channel) + start;
+            }
+
+            processChunk ((int) numChannels, (int) chunk);
+        }
+    }
+
+private:
+    //==============================================================================
+    void processChunk (int numChannels, int numSamples) noexcept;
+    void detectPeaks (int numChannels, int numSamples) noexcept;
+
+    //==============================================================================
+    /** Maximum over the last windowSize values pushed, from a monotonic deque. */
+    class SlidingMaximum
+    {
+    public:
+        void prepare (int windowSize);
+        void reset() noexcept;
+        SampleType push (SampleType value) noexcept;
+
+    private:
+        std::vector<SampleType> values;
+        std::vector<int64> positions;
+        int capacity = 0, window = 1;
+        int front = 0, size = 0;
+        int64 position = 0;
+    };
+
+    struct ChannelState
+    {
+        std::vector<SampleType> delay;          // lookahead delay, then the chunk being processed
+        std::vector<SampleType> history;        // interpolator input, the last taps - 1 samples then the chunk
+    };
+
+    //==============================================================================
+    static constexpr int interpolatorTaps = 12;
+    static constexpr int interpolatorPhases = 3;
+    static constexpr int interpolatorDelay = interpolatorTaps / 2 - 1;
+
+    SampleType ceilingDecibels = (SampleType) -1, releaseMilliseconds = 100, lookaheadMilliseconds = 5;
+    SampleType ceiling = (SampleType) 1, releaseCoefficient = 0;
+    bool truePeakRequested = false;
+
+    double sampleRate = 44100.0;
+    int maximumBlockSize = 0, lookaheadSamples = 0, detectorDelay = 0, windowSize = 1;
+
+    std::vector<ChannelState> channels;
+    std::vector<const SampleType*> inputPointers;
+    std::vector<SampleType*> outputPointers;
+    std::array<std::array<SampleType, interpolatorTaps>, interpolatorPhases> interpolator {};
+
+    SlidingMaximum peakWindow;
+    std::vector<SampleType> peaks, gains;
+
+    // The attack smoother's window of envelope values, and the required gains
+    // waiting to reach the output; both are windowSize long
+    std::vector<SampleType> envelopeWindow, requiredGains;
+    int windowPosition = 0;
+    double envelopeSum = 0.0;
+    SampleType envelope = 1, currentGain = 1, minimumGain = 1;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LookaheadLimiter)
+};
+
+} // namespace juce::dsp
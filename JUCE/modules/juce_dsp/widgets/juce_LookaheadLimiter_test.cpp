@@ -0,0 +1,235 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+struct LookaheadLimiterUnitTest final : public UnitTest
+{
+    LookaheadLimiterUnitTest()
+        : UnitTest ("LookaheadLimiter", UnitTestCategories::dsp)
+    {}
+
+    static constexpr double sampleRate = 48000.0;
+
+    /** Runs a signal through a limiter in blocks of the given size, or of random
+        sizes up to twice the prepared size if blockSize is 0.
+    */
+    template <typename SampleType>
+    static AudioBuffer<SampleType> render (LookaheadLimiter<SampleType>& limiter, const AudioBuffer<SampleType>& input,
+                                           int blockSize, Random random = Random (1))
+    {
+        constexpr int preparedBlockSize = 256;
+        limiter.prepare ({ sampleRate, (uint32) preparedBlockSize, (uint32) input.getNumChannels() });
+
+        AudioBuffer<SampleType> output (input);
+        AudioBlock<SampleType> block (output);
+
+        for (size_t start = 0; start < block.getNumSamples();)
+        {
+            const auto size = jmin (block.getNumSamples() - start,
+                                    (size_t) (blockSize > 0 ? blockSize : 1 + random.nextInt (2 * preparedBlockSize)));
+            auto subBlock = block.getSubBlock (start, size);
+            limiter.process (ProcessContextReplacing<SampleType> (subBlock));
+            start += size;
+        }
+
+        return output;
+    }
+
+    /** DC at 0.25, a step up to 1 at stepStart, and back down to 0.25 at stepEnd. */
+    template <typename SampleType>
+    static AudioBuffer<SampleType> makeStep (int numChannels, int numSamples, int stepStart, int stepEnd)
+    {
+        AudioBuffer<SampleType> buffer (numChannels, numSamples);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (channel, i, (SampleType) (i >= stepStart && i < stepEnd ? 1.0 : 0.25));
+
+        return buffer;
+    }
+
+    template <typename SampleType>
+    void testStepResponse()
+    {
+        constexpr int stepStart = 1000, stepEnd = 3000, numSamples = 8000;
+        constexpr auto tolerance = (SampleType) 1.0e-5;
+
+        LookaheadLimiter<SampleType> limiter;
+        limiter.setCeiling ((SampleType) Decibels::gainToDecibels (0.5));
+        limiter.setLookahead ((SampleType) 1);
+        limiter.setRelease ((SampleType) 10);
+
+        const auto input = makeStep<SampleType> (2, numSamples, stepStart, stepEnd);
+        const auto output = render (limiter, input, 64);
+        const auto latency = limiter.getLatencyInSamples();
+        const auto windowSize = latency + 1;
+
+        expectEquals (latency, 48);
+
+        const auto gainAt = [&] (int i) { return output.getSample (1, i + latency) / input.getSample (1, i); };
+
+        // Untouched until the ramp, which falls linearly to exactly the ceiling's gain
+        // when the step arrives
+        for (int i = 0; i < stepStart - windowSize; ++i)
+            expectEquals (gainAt (i), (SampleType) 1);
+
+        for (int j = 0; j < windowSize; ++j)
+            expectWithinAbsoluteError (gainAt (stepStart - latency + j), (SampleType) (1.0 - 0.5 * (j + 1) / windowSize), tolerance);
+
+        for (int i = stepStart; i < stepEnd; ++i)
+            expectWithinAbsoluteError (gainAt (i), (SampleType) 0.5, tolerance);
+
+        // After the step the gain recovers without overshooting, and is back to 1
+        // well within ten release time constants
+        for (int i = stepEnd + 1; i < numSamples - latency; ++i)
+        {
+            expect (gainAt (i) >= gainAt (i - 1) - tolerance && gainAt (i) <= (SampleType) 1);
+            expect (output.getSample (0, i + latency) <= (SampleType) 0.5 + tolerance);
+        }
+
+        expectWithinAbsoluteError (gainAt (stepEnd + 480 * 10), (SampleType) 1, (SampleType) 1.0e-3);
+        expectWithinAbsoluteError (limiter.getGainReductionDecibels(), (SampleType) 0, (SampleType) 1.0e-3);
+        expectWithinAbsoluteError (limiter.getPeakGainReductionDecibels(), (SampleType) 6.0206, (SampleType) 1.0e-3);
+
+        limiter.resetPeakGainReduction();
+        expectEquals (limiter.getPeakGainReductionDecibels(), limiter.getGainReductionDecibels());
+    }
+
+    void runTest() override
+    {
+        beginTest ("Step response, float");
+        testStepResponse<float>();
+
+        beginTest ("Step response, double");
+        testStepResponse<double>();
+
+        beginTest ("Signals under the ceiling are only delayed");
+        {
+            LookaheadLimiter<float> limiter;
+            limiter.setCeiling (0.0f);
+            limiter.setTruePeakDetection (true);
+
+            AudioBuffer<float> input (2, 4096);
+            auto random = getRandom();
+
+            for (int channel = 0; channel < 2; ++channel)
+                for (int i = 0; i < input.getNumSamples(); ++i)
+                    input.setSample (channel, i, 0.5f * (random.nextFloat() - 0.5f));
+
+            const auto output = render (limiter, input, 0);
+            const auto latency = limiter.getLatencyInSamples();
+
+            expectEquals (latency, 240 + 5);
+
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                expect (output.getMagnitude (channel, 0, latency) == 0.0f);
+                expect (std::memcmp (output.getReadPointer (channel, latency), input.getReadPointer (channel),
+                                     sizeof (float) * (size_t) (input.getNumSamples() - latency)) == 0);
+            }
+        }
+
+        beginTest ("The ceiling holds for any blocking");
+        {
+            // Noise bursts of random level and length, up to 30 dB over the ceiling
+            AudioBuffer<float> input (2, 48000);
+            auto random = getRandom();
+            float level = 0.0f;
+
+            for (int i = 0; i < input.getNumSamples(); ++i)
+            {
+                if (random.nextInt (500) == 0)
+                    level = Decibels::decibelsToGain (-20.0f + 50.0f * random.nextFloat());
+
+                for (int channel = 0; channel < 2; ++channel)
+                    input.setSample (channel, i, level * (random.nextFloat() * 2.0f - 1.0f));
+            }
+
+            const auto ceiling = Decibels::decibelsToGain (-3.0f);
+            AudioBuffer<float> reference;
+
+            for (const auto blockSize : { 1, 37, 256, 1000, 0 })
+            {
+                LookaheadLimiter<float> limiter;
+                limiter.setCeiling (-3.0f);
+                limiter.setLookahead (2.0f);
+                limiter.setRelease (50.0f);
+
+                const auto output = render (limiter, input, blockSize, getRandom());
+
+                for (int channel = 0; channel < 2; ++channel)
+                    expectLessOrEqual (output.getMagnitude (channel, 0, output.getNumSamples()), ceiling * (1.0f + 1.0e-6f));
+
+                // The result doesn't depend on how the signal was split into blocks
+                if (reference.getNumSamples() == 0)
+                    reference = output;
+                else
+                    for (int channel = 0; channel < 2; ++channel)
+                        expect (std::memcmp (output.getReadPointer (channel), reference.getReadPointer (channel),
+                                             sizeof (float) * (size_t) output.getNumSamples()) == 0);
+            }
+        }
+
+        beginTest ("True-peak detection");
+        {
+            // A sine at a quarter of the sample rate, sampled 45 degrees off its peaks,
+            // has sample peaks 3 dB below its true peak
+            AudioBuffer<float> input (1, 9600);
+
+            for (int i = 0; i < input.getNumSamples(); ++i)
+                input.setSample (0, i, (float) std::sin (MathConstants<double>::halfPi * i + MathConstants<double>::pi / 4.0));
+
+            const auto getSettledPeak = [&] (bool truePeak)
+            {
+                LookaheadLimiter<float> limiter;
+                limiter.setCeiling (Decibels::gainToDecibels (0.5f));
+                limiter.setTruePeakDetection (truePeak);
+
+                const auto output = render (limiter, input, 512);
+                return output.getMagnitude (0, input.getNumSamples() - 1000, 1000);
+            };
+
+            // Sample peaks are held at the ceiling, but the waveform between them
+            // reaches 3 dB over it; true-peak detection brings the waveform down
+            expectWithinAbsoluteError (getSettledPeak (false), 0.5f, 1.0e-5f);
+            expectWithinAbsoluteError (getSettledPeak (true), 0.5f * std::sqrt (0.5f), 0.01f);
+        }
+    }
+};
+
+static LookaheadLimiterUnitTest lookaheadLimiterUnitTest;
+
+} // namespace juce::dsp
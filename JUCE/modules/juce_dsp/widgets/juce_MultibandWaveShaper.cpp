@@ -0,0 +1,385 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+//==============================================================================
+template <typename SampleType>
+MultibandWaveShaper<SampleType>::MultibandWaveShaper()
+{
+    for (auto& crossover : crossovers)
+        crossover.setType (LinkwitzRileyFilterType::lowpass);
+
+    for (auto& band : compensation)
+        for (auto& allpass : band)
+            allpass.setType (LinkwitzRileyFilterType::allpass);
+
+    for (int band = 0; band < maxBands; ++band)
+        setGain (band, (SampleType) 1);
+
+    updateCrossovers();
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultibandWaveShaper<SampleType>::setNumBands (int newNumBands)
+{
+    jassert (newNumBands >= 1 && newNumBands <= maxBands);
+    numBands = jlimit (1, maxBands, newNumBands);
+
+    // Bands that are turned off go silent; the filters restart, so the change
+    // clicks anyway and there is nothing to ramp
+    for (int band = 0; band < maxBands; ++band)
+        setGain (band, gains[(size_t) band]);
+
+    reset();
+}
+
+template <typename SampleType>
+void MultibandWaveShaper<SampleType>::setCrossoverFrequency (int index, SampleType newFrequencyHz)
+{
+    jassert (isPositiveAndBelow (index, maxBands - 1));
+
+    if (isPositiveAndBelow (index, maxBands - 1))
+    {
+        crossoverFrequencies[(size_t) index] = newFrequencyHz;
+        updateCrossovers();
+    }
+}
+
+template <typename SampleType>
+SampleType MultibandWaveShaper<SampleType>::getCrossoverFrequency (int index) const noexcept
+{
+    jassert (isPositiveAndBelow (index, maxBands - 1));
+    return crossoverFrequencies[(size_t) jlimit (0, maxBands - 2, index)];
+}
+
+template <typename SampleType>
+void MultibandWaveShaper<SampleType>::setDrive (int band, SampleType newDrive) noexcept
+{
+    jassert (isPositiveAndBelow (band, maxBands));
+
+    if (! isPositiveAndBelow (band, maxBands))
+        return;
+
+    drives[(size_t) band] = jmax (SampleType(), newDrive);
+
+    setTarget (driveRamp, band, drives[(size_t) band]);
+    setTarget (wetRamp, band, drives[(size_t) band] > SampleType() ? (SampleType) 1 : SampleType());
+    startRamp (driveRamp);
+    startRamp (wetRamp);
+}
+
+template <typename SampleType>
+void MultibandWaveShaper<SampleType>::setGain (int band, SampleType newGain) noexcept
+{
+    jassert (isPositiveAndBelow (band, maxBands));
+
+    if (! isPositiveAndBelow (band, maxBands))
+        return;
+
+    gains[(size_t) band] = newGain;
+
+    setTarget (gainRamp, band, band < numBands ? newGain : SampleType());
+    startRamp (gainRamp);
+}
+
+template <typename SampleType>
+void MultibandWaveShaper<SampleType>::setRampDuration (double newRampSeconds) noexcept
+{
+    rampSeconds = jmax (0.0, newRampSeconds);
+    rampSamples = roundToInt (rampSeconds * sampleRate);
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultibandWaveShaper<SampleType>::prepare (const ProcessSpec& spec)
+{
+    jassert (spec.sampleRate > 0);
+    jassert (spec.numChannels > 0);
+
+    sampleRate = spec.sampleRate;
+    maximumBlockSize = jmax (1, (int) spec.maximumBlockSize);
+    setRampDuration (rampSeconds);
+
+    for (auto& crossover : crossovers)
+        crossover.prepare (spec);
+
+    for (auto& band : compensation)
+        for (auto& allpass : band)
+            allpass.prepare (spec);
+
+    updateCrossovers();
+
+    // A dry and a shaped frame per sample, plus room to align the first one
+    const auto frameSamples = (size_t) roundUp (maximumBlockSize * frameSize);
+    frameStorage.calloc (2 * frameSamples + (size_t) frameSize);
+
+   #if JUCE_USE_SIMD
+    dry = Vector::getNextSIMDAlignedPtr (frameStorage.get());
+   #else
+    dry = frameStorage.get();
+   #endif
+    shaped = dry + frameSamples;
+
+    inputPointers .resize (spec.numChannels);
+    outputPointers.resize (spec.numChannels);
+
+    reset();
+}
+
+template <typename SampleType>
+void MultibandWaveShaper<SampleType>::reset() noexcept
+{
+    for (auto& crossover : crossovers)
+        crossover.reset();
+
+    for (auto& band : compensation)
+        for (auto& allpass : band)
+            allpass.reset();
+
+    for (auto* ramp : { &driveRamp, &wetRamp, &gainRamp })
+    {
+        std::copy (std::begin (ramp->target), std::end (ramp->target), std::begin (ramp->current));
+        ramp->remaining = 0;
+    }
+
+    if (dry != nullptr)
+        std::fill (dry, shaped + roundUp (maximumBlockSize * frameSize), SampleType());
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultibandWaveShaper<SampleType>::updateCrossovers()
+{
+    for (size_t index = 0; index < crossovers.size(); ++index)
+    {
+        // The filters can't go above Nyquist
+        const auto frequency = jlimit ((SampleType) 1, (SampleType) (sampleRate * 0.49), crossoverFrequencies[index]);
+        crossovers[index].setCutoffFrequency (frequency);
+
+        for (size_t band = 0; band < index && band < compensation.size(); ++band)
+            compensation[band][index].setCutoffFrequency (frequency);
+    }
+}
+
+template <typename SampleType>
+void MultibandWaveShaper<SampleType>::setTarget (Ramp& ramp, int lane, SampleType value) noexcept
+{
+    ramp.target[lane] = value;
+}
+
+template <typename SampleType>
+void MultibandWaveShaper<SampleType>::startRamp (Ramp& ramp) noexcept
+{
+    if (rampSamples <= 0)
+    {
+        std::copy (std::begin (ramp.target), std::end (ramp.target), std::begin (ramp.current));
+        ramp.remaining = 0;
+        return;
+    }
+
+    for (int lane = 0; lane < frameSize; ++lane)
+        ramp.step[lane] = (ramp.target[lane] - ramp.current[lane]) / (SampleType) rampSamples;
+
+    ramp.remaining = rampSamples;
+}
+
+template <typename SampleType>
+void MultibandWaveShaper<SampleType>::advance (Ramp& ramp, int numSamples) noexcept
+{
+    if (ramp.remaining <= 0)
+        return;
+
+    const auto steps = jmin (numSamples, ramp.remaining);
+    ramp.remaining -= steps;
+
+    for (int lane = 0; lane < frameSize; ++lane)
+        ramp.current[lane] = ramp.remaining > 0 ? ramp.current[lane] + (SampleType) steps * ramp.step[lane]
+                                                : ramp.target[lane];
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultibandWaveShaper<SampleType>::splitBands (int channel, int numSamples) noexcept
+{
+    const auto* input = inputPointers[(size_t) channel];
+    const auto lastCrossover = numBands - 1;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto* frame = dry + (size_t) i * (size_t) frameSize;
+        auto rest = input[i];
+
+        for (int index = 0; index < lastCrossover; ++index)
+        {
+            SampleType low, high;
+            crossovers[(size_t) index].processSample (channel, rest, low, high);
+
+            // The low band is still missing the phase of the crossovers above
+            for (int above = index + 1; above < lastCrossover; ++above)
+                low = compensation[(size_t) index][(size_t) above].processSample (channel, low);
+
+            frame[index] = low;
+            rest = high;
+        }
+
+        frame[lastCrossover] = rest;
+    }
+}
+
+template <typename SampleType>
+auto MultibandWaveShaper<SampleType>::loadFrame (const SampleType* source) noexcept -> Vector
+{
+   #if JUCE_USE_SIMD
+    return Vector::fromRawArray (source);
+   #else
+    return *source;
+   #endif
+}
+
+template <typename SampleType>
+void MultibandWaveShaper<SampleType>::storeFrame (SampleType* destination, Vector value) noexcept
+{
+   #if JUCE_USE_SIMD
+    value.copyToRawArray (destination);
+   #else
+    *destination = value;
+   #endif
+}
+
+template <typename SampleType>
+SampleType MultibandWaveShaper<SampleType>::sumLanes (Vector value) noexcept
+{
+   #if JUCE_USE_SIMD
+    return value.sum();
+   #else
+    return value;
+   #endif
+}
+
+template <typename SampleType>
+void MultibandWaveShaper<SampleType>::processChunk (int numChannels, int numSamples) noexcept
+{
+    // Each ramp moves one step per sample until it runs out; the same ramps are
+    // replayed for every channel and only advanced at the end of the chunk
+    struct RampState
+    {
+        explicit RampState (const Ramp& ramp) noexcept
+            : length (ramp.remaining)
+        {
+            for (int v = 0; v < vectorsPerFrame; ++v)
+            {
+                values[v] = loadFrame (ramp.current + v * lanesPerVector);
+                steps[v]  = loadFrame (ramp.step    + v * lanesPerVector);
+                targets[v] = loadFrame (ramp.target + v * lanesPerVector);
+            }
+        }
+
+        // Returns the values for frame i, which must be visited in order
+        const Vector* next (int i) noexcept
+        {
+            if (i < length)
+                for (int v = 0; v < vectorsPerFrame; ++v)
+                    values[v] = values[v] + steps[v];
+
+            return i < length - 1 ? values : targets;
+        }
+
+        Vector values[vectorsPerFrame], steps[vectorsPerFrame], targets[vectorsPerFrame];
+        int length;
+    };
+
+    // The tanh's scalar tail rounds differently from its vector body, so it is run
+    // over whole blocks of vectors to keep the output independent of the blocking
+    const auto numShapedSamples = roundUp (numSamples * frameSize);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        splitBands (channel, numSamples);
+
+        RampState drive (driveRamp);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto* driveValues = drive.next (i);
+            const auto frame = (size_t) i * (size_t) frameSize;
+
+            for (int v = 0; v < vectorsPerFrame; ++v)
+            {
+                const auto offset = frame + (size_t) (v * lanesPerVector);
+                storeFrame (shaped + offset, loadFrame (dry + offset) * driveValues[v]);
+            }
+        }
+
+        FloatVectorOperations::tanh (shaped, shaped, numShapedSamples);
+
+        RampState wet (wetRamp), gain (gainRamp);
+        auto* output = outputPointers[(size_t) channel];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto* wetValues = wet.next (i);
+            const auto* gainValues = gain.next (i);
+            const auto frame = (size_t) i * (size_t) frameSize;
+            Vector sum {};
+
+            for (int v = 0; v < vectorsPerFrame; ++v)
+            {
+                const auto offset = frame + (size_t) (v * lanesPerVector);
+                const auto x = loadFrame (dry + offset);
+                sum = sum + (x + (loadFrame (shaped + offset) - x) * wetValues[v]) * gainValues[v];
+            }
+
+            output[i] = sumLanes (sum);
+        }
+    }
+
+    for (auto* ramp : { &driveRamp, &wetRamp, &gainRamp })
+        advance (*ramp, numSamples);
+
+    for (auto& crossover : crossovers)
+        crossover.snapToZero();
+
+    for (auto& band : compensation)
+        for (auto& allpass : band)
+            allpass.snapToZero();
+}
+
+//==============================================================================
+template class MultibandWaveShaper<float>;
+template class MultibandWaveShaper<double>;
+
+} // namespace juce::dsp
@@ -0,0 +1,203 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+/**
+    A waveshaper that splits the signal into up to four bands with Linkwitz-Riley
+    crossovers, and shapes each band with its own drive and gain.
+
+    The bands are split by a tree of 4th order Linkwitz-Riley filters: the first
+    crossover takes the lowest band off the input, the next one splits the rest,
+    and so on. Each band is then passed through allpasses matching the crossovers
+    it did not go through, so all the bands have the same phase, and with every
+    band unshaped at unity gain the sum has a flat magnitude response.
+
+    The shaping runs with the bands in the lanes of a SIMDRegister, so one
+    multiply by the drives, one tanh and one mix handle every band of a sample at
+    once. The crossovers themselves are recursive, so they stay scalar.
+
+    Each band is y = gain * (x + wet * (tanh (drive * x) - x)), where wet is 1 for a
+    positive drive and 0 for a drive of 0, so a band can be left clean. Changes to
+    the drives and gains ramp linearly over the ramp duration.
+
+    @see LinkwitzRileyFilter, WaveShaper
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class MultibandWaveShaper
+{
+public:
+    //==============================================================================
+    /** The largest number of bands. */
+    static constexpr int maxBands = 4;
+
+    //==============================================================================
+    /** Constructor, for three bands split at 250 Hz and 2.5 kHz, all clean. */
+    MultibandWaveShaper();
+
+    //==============================================================================
+    /** Sets the number of bands, from 1 to maxBands, and resets the crossovers. */
+    void setNumBands (int newNumBands);
+
+    /** Returns the number of bands. */
+    int getNumBands() const noexcept                        { return numBands; }
+
+    /** Sets the frequency in Hz of the crossover between band index and band index + 1.
+        The crossover frequencies should go up with the index.
+    */
+    void setCrossoverFrequency (int index, SampleType newFrequencyHz);
+
+    /** Returns the frequency in Hz of a crossover. */
+    SampleType getCrossoverFrequency (int index) const noexcept;
+
+    /** Sets the drive of a band, as a gain applied before the tanh. 0 leaves the band clean. */
+    void setDrive (int band, SampleType newDrive) noexcept;
+
+    /** Sets the linear gain of a band, applied after the shaping. */
+    void setGain (int band, SampleType newGain) noexcept;
+
+    /** Sets how long drive and gain changes take, in seconds. */
+    void setRampDuration (double newRampSeconds) noexcept;
+
+    //==============================================================================
+    /** Initialises the processor. */
+    void prepare (const ProcessSpec& spec);
+
+    /** Resets the internal state variables of the processor, and takes the drives
+        and gains straight to their targets.
+    */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Processes the input and output samples supplied in the processing context. */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock      = context.getOutputBlock();
+        const auto numChannels = outputBlock.getNumChannels();
+        const auto numSamples  = outputBlock.getNumSamples();
+
+        jassert (inputBlock.getNumChannels() == numChannels);
+        jassert (inputBlock.getNumChannels() <= inputPointers.size());
+        jassert (inputBlock.getNumSamples()  == numSamples);
+
+        if (context.isBypassed)
+        {
+            outputBlock.copyFrom (inputBlock);
+            return;
+        }
+
+        // Hosts may send more samples than they announced in prepare()
+        for (size_t start = 0; start < numSamples; start += (size_t) maximumBlockSize)
+        {
+            const auto chunk = jmin (numSamples - start, (size_t) maximumBlockSize);
+
+            for (size_t channel = 0; channel < numChannels; ++channel)
+            {
+                inputPointers[channel]  = inputBlock .getChannelPointer (channel) + start;
+                outputPointers[channel] = outputBlock.getChannelPointer (channel) + start;
+            }
+
+            processChunk ((int) numChannels, (int) chunk);
+        }
+    }
+
+private:
+    //==============================================================================
+   #if JUCE_USE_SIMD
+    using Vector = SIMDRegister<SampleType>;
+    static constexpr int lanesPerVector = (int) Vector::SIMDNumElements;
+   #else
+    using Vector = SampleType;
+    static constexpr int lanesPerVector = 1;
+   #endif
+
+    // Every sample of the split signal is a frame of vectorsPerFrame registers,
+    // one band per lane, with any lanes past the last band left at 0
+    static constexpr int vectorsPerFrame = jmax (1, maxBands / lanesPerVector);
+    static constexpr int frameSize = vectorsPerFrame * lanesPerVector;
+
+    // Rounds a number of samples up to a multiple of the widest vector FloatVectorOperations uses
+    static constexpr int roundUp (int numSamples) noexcept  { return (numSamples + 15) & ~15; }
+
+    /** A value per lane of a frame, moving linearly from current to target. */
+    struct Ramp
+    {
+        alignas (Vector) SampleType current[frameSize] {}, target[frameSize] {}, step[frameSize] {};
+        int remaining = 0;
+    };
+
+    //==============================================================================
+    void processChunk (int numChannels, int numSamples) noexcept;
+    void splitBands (int channel, int numSamples) noexcept;
+    void updateCrossovers();
+    void setTarget (Ramp&, int lane, SampleType) noexcept;
+    void startRamp (Ramp&) noexcept;
+    void advance (Ramp&, int numSamples) noexcept;
+
+    // Loads and stores of the aligned frames, and the sum of a register's lanes
+    static Vector loadFrame (const SampleType*) noexcept;
+    static void storeFrame (SampleType*, Vector) noexcept;
+    static SampleType sumLanes (Vector) noexcept;
+
+    //==============================================================================
+    int numBands = 3, maximumBlockSize = 0, rampSamples = 0;
+    double sampleRate = 44100.0, rampSeconds = 0.005;
+    std::array<SampleType, maxBands - 1> crossoverFrequencies { (SampleType) 250, (SampleType) 2500, (SampleType) 8000 };
+    std::array<SampleType, maxBands> drives {}, gains {};
+
+    // The crossovers, and for every band but the top two, allpasses at the
+    // crossovers above the one that split it off
+    std::array<LinkwitzRileyFilter<SampleType>, maxBands - 1> crossovers;
+    std::array<std::array<LinkwitzRileyFilter<SampleType>, maxBands - 1>, maxBands - 2> compensation;
+
+    Ramp driveRamp, wetRamp, gainRamp;
+
+    // The bands of a chunk, before and after the drive and the tanh
+    HeapBlock<SampleType> frameStorage;
+    SampleType* dry = nullptr;
+    SampleType* shaped = nullptr;
+
+    std::vector<const SampleType*> inputPointers;
+    std::vector<SampleType*> outputPointers;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MultibandWaveShaper)
+};
+
+} // namespace juce::dsp
@@ -0,0 +1,278 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+struct MultibandWaveShaperUnitTest final : public UnitTest
+{
+    MultibandWaveShaperUnitTest()
+        : UnitTest ("MultibandWaveShaper", UnitTestCategories::dsp)
+    {}
+
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int preparedBlockSize = 256;
+
+    /** Runs a signal through a shaper in blocks of the given size, or of random
+        sizes up to twice the prepared size if blockSize is 0.
+    */
+    template <typename SampleType>
+    static AudioBuffer<SampleType> render (MultibandWaveShaper<SampleType>& shaper, const AudioBuffer<SampleType>& input,
+                                           int blockSize, Random random = Random (1))
+    {
+        shaper.prepare ({ sampleRate, (uint32) preparedBlockSize, (uint32) input.getNumChannels() });
+
+        AudioBuffer<SampleType> output (input);
+        AudioBlock<SampleType> block (output);
+
+        for (size_t start = 0; start < block.getNumSamples();)
+        {
+            const auto size = jmin (block.getNumSamples() - start,
+                                    (size_t) (blockSize > 0 ? blockSize : 1 + random.nextInt (2 * preparedBlockSize)));
+            auto subBlock = block.getSubBlock (start, size);
+            shaper.process (ProcessContextReplacing<SampleType> (subBlock));
+            start += size;
+        }
+
+        return output;
+    }
+
+    template <typename SampleType>
+    static AudioBuffer<SampleType> makeNoise (Random& random, int numChannels, int numSamples, double level)
+    {
+        AudioBuffer<SampleType> buffer (numChannels, numSamples);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (channel, i, (SampleType) (level * (random.nextDouble() * 2.0 - 1.0)));
+
+        return buffer;
+    }
+
+    template <typename SampleType>
+    static AudioBuffer<SampleType> makeSine (double frequency, int numSamples)
+    {
+        AudioBuffer<SampleType> buffer (1, numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+            buffer.setSample (0, i, (SampleType) std::sin (MathConstants<double>::twoPi * frequency * i / sampleRate));
+
+        return buffer;
+    }
+
+    template <typename SampleType>
+    void testCleanBandsSumToAnAllpass()
+    {
+        // After each block the crossovers snap filter states within 1.0e-8 of zero to
+        // zero, and the reference allpasses run unblocked, so doubles only agree to
+        // about that level
+        const auto tolerance = (SampleType) (std::is_same_v<SampleType, float> ? 1.0e-5 : 1.0e-7);
+        auto random = getRandom();
+        const auto input = makeNoise<SampleType> (random, 2, 8192, 0.5);
+        const SampleType frequencies[] = { 150, 1200, 7000 };
+
+        for (int numBands = 1; numBands <= MultibandWaveShaper<SampleType>::maxBands; ++numBands)
+        {
+            MultibandWaveShaper<SampleType> shaper;
+            shaper.setNumBands (numBands);
+
+            for (int index = 0; index < numBands - 1; ++index)
+                shaper.setCrossoverFrequency (index, frequencies[index]);
+
+            const auto output = render (shaper, input, 0, getRandom());
+
+            // Every band goes through all the crossovers' allpasses, one way or another
+            std::vector<LinkwitzRileyFilter<SampleType>> allpasses ((size_t) (numBands - 1));
+
+            for (size_t index = 0; index < allpasses.size(); ++index)
+            {
+                allpasses[index].setType (LinkwitzRileyFilterType::allpass);
+                allpasses[index].prepare ({ sampleRate, (uint32) preparedBlockSize, 2 });
+                allpasses[index].setCutoffFrequency (frequencies[index]);
+            }
+
+            auto maxError = SampleType();
+
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                for (int i = 0; i < input.getNumSamples(); ++i)
+                {
+                    auto expected = input.getSample (channel, i);
+
+                    for (auto& allpass : allpasses)
+                        expected = allpass.processSample (channel, expected);
+
+                    maxError = jmax (maxError, std::abs (output.getSample (channel, i) - expected));
+                }
+            }
+
+            expectLessOrEqual (maxError, tolerance, String (numBands) + " bands");
+        }
+    }
+
+    template <typename SampleType>
+    void testBandsAreShapedSeparately()
+    {
+        // Two bands split at 1 kHz, with only the high band audible
+        const auto gainAt = [] (double frequency, SampleType drive)
+        {
+            MultibandWaveShaper<SampleType> shaper;
+            shaper.setNumBands (2);
+            shaper.setCrossoverFrequency (0, (SampleType) 1000);
+            shaper.setGain (0, SampleType());
+            shaper.setDrive (1, drive);
+
+            const auto output = render (shaper, makeSine<SampleType> (frequency, 9600), 128);
+            return (double) output.getMagnitude (0, 4800, 4800);
+        };
+
+        expectLessOrEqual (gainAt (100.0, 0), 1.0e-3);
+        expectWithinAbsoluteError (gainAt (10000.0, 0), 1.0, 1.0e-3);
+
+        // Driven hard, the high band is squashed towards 1, and the little of the low
+        // band that leaks through the crossover is driven with it
+        expectWithinAbsoluteError (gainAt (10000.0, 20), std::tanh (20.0), 0.02);
+        expectLessOrEqual (gainAt (100.0, 20), 20.0e-3 * 0.25);
+    }
+
+    void runTest() override
+    {
+        beginTest ("Clean bands sum to an allpass, float");
+        testCleanBandsSumToAnAllpass<float>();
+
+        beginTest ("Clean bands sum to an allpass, double");
+        testCleanBandsSumToAnAllpass<double>();
+
+        beginTest ("Bands are shaped separately, float");
+        testBandsAreShapedSeparately<float>();
+
+        beginTest ("Bands are shaped separately, double");
+        testBandsAreShapedSeparately<double>();
+
+        beginTest ("One band is a plain tanh");
+        {
+            MultibandWaveShaper<double> shaper;
+            shaper.setNumBands (1);
+            shaper.setDrive (0, 3.0);
+            shaper.setGain (0, 0.5);
+
+            auto random = getRandom();
+            const auto input = makeNoise<double> (random, 1, 1000, 1.0);
+            const auto output = render (shaper, input, 100);
+
+            for (int i = 0; i < input.getNumSamples(); ++i)
+                expectWithinAbsoluteError (output.getSample (0, i), 0.5 * std::tanh (3.0 * input.getSample (0, i)), 1.0e-14);
+        }
+
+        beginTest ("The blocking makes no audible difference");
+        {
+            auto random = getRandom();
+            const auto input = makeNoise<float> (random, 2, 20000, 0.8);
+            AudioBuffer<float> reference;
+
+            for (const auto blockSize : { 1, 37, 256, 1000, 0 })
+            {
+                MultibandWaveShaper<float> shaper;
+                shaper.setNumBands (4);
+
+                for (int band = 0; band < 4; ++band)
+                {
+                    shaper.setDrive (band, (float) band * 2.0f);
+                    shaper.setGain (band, 1.0f - 0.2f * (float) band);
+                }
+
+                const auto output = render (shaper, input, blockSize, getRandom());
+
+                // Only the crossovers' tiny states, which are flushed to zero at the
+                // end of every block, can differ
+                if (reference.getNumSamples() == 0)
+                {
+                    reference = output;
+                }
+                else
+                {
+                    auto maxError = 0.0f;
+
+                    for (int channel = 0; channel < 2; ++channel)
+                        for (int i = 0; i < output.getNumSamples(); ++i)
+                            maxError = jmax (maxError, std::abs (output.getSample (channel, i) - reference.getSample (channel, i)));
+
+                    expectLessOrEqual (maxError, 1.0e-6f, String (blockSize) + "-sample blocks");
+                }
+            }
+        }
+
+        beginTest ("Drive and gain changes ramp");
+        {
+            MultibandWaveShaper<float> shaper;
+            shaper.setNumBands (2);
+            shaper.setCrossoverFrequency (0, 1000.0f);
+            shaper.setRampDuration (0.01);
+            shaper.prepare ({ sampleRate, (uint32) preparedBlockSize, 1 });
+
+            // DC goes through the low band only
+            AudioBuffer<float> buffer (1, preparedBlockSize);
+            std::vector<float> output;
+
+            for (int blockIndex = 0; blockIndex < 40; ++blockIndex)
+            {
+                if (blockIndex == 20)
+                {
+                    shaper.setDrive (0, 2.0f);
+                    shaper.setGain (0, 0.5f);
+                }
+
+                FloatVectorOperations::fill (buffer.getWritePointer (0), 0.5f, preparedBlockSize);
+                AudioBlock<float> block (buffer);
+                shaper.process (ProcessContextReplacing<float> (block));
+                output.insert (output.end(), buffer.getReadPointer (0), buffer.getReadPointer (0) + preparedBlockSize);
+            }
+
+            const auto change = 20 * preparedBlockSize;
+            const auto rampSamples = 480;
+            auto largestStep = 0.0f;
+
+            for (size_t i = (size_t) change; i < output.size(); ++i)
+                largestStep = jmax (largestStep, std::abs (output[i] - output[i - 1]));
+
+            expectWithinAbsoluteError (output[(size_t) change - 1], 0.5f, 1.0e-3f);
+            expectWithinAbsoluteError (output.back(), 0.5f * std::tanh (1.0f), 1.0e-3f);
+            expectLessOrEqual (largestStep, 0.5f / rampSamples * 2.0f);
+        }
+    }
+};
+
+static MultibandWaveShaperUnitTest multibandWaveShaperUnitTest;
+
+} // namespace juce::dsp
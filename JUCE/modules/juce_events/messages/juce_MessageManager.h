@@ -188,7 +188,10 @@ public:
         return future.get();
     }
 
-    /** Returns true if the caller-thread is the message thread. */
+    /** Returns true if the caller-thread is the message thread.
+
+        This takes no lock, so it can be called from a realtime thread.
+    */
     bool isThisTheMessageThread() const noexcept;
 
     /** Called to tell the manager that the current thread is the one that's running the dispatch loop.
@@ -203,7 +206,7 @@ public:
         (Best to ignore this method unless you really know what you're doing..)
         @see setCurrentThreadAsMessageThread
     */
-    Thread::ThreadID getCurrentMessageThread() const noexcept            { return messageThreadId; }
+    Thread::ThreadID getCurrentMessageThread() const noexcept            { return messageThreadId.get(); }
 
     /** Returns true if the caller thread has currently got the message manager locked.
 
@@ -220,7 +223,7 @@ public:
     static bool existsAndIsLockedByCurrentThread() noexcept;
 
     /** Returns true if there's an instance of the MessageManager, and if the current thread
-        is running it.
+        is running it. Like isThisTheMessageThread(), this takes no lock.
     */
     static bool existsAndIsCurrentThread() noexcept;
 
@@ -408,9 +411,8 @@ private:
 
     std::unique_ptr<ActionBroadcaster> broadcaster;
     Atomic<int> quitMessagePosted { 0 }, quitMessageReceived { 0 };
-    Thread::ThreadID messageThreadId;
-    Atomic<Thread::ThreadID> threadWithLock;
-    mutable std::mutex messageThreadIdMutex;
+    Atomic<Thread::ThreadID> messageThreadId, threadWithLock;
+    std::mutex messageThreadIdMutex;    // serialises setCurrentThreadAsMessageThread()
 
     template <typename Function>
     static auto transformResult (Function&& f)
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+//==============================================================================
+/**
+    Where an analysis frame sits in time. Session time comes from the processor's
+    sample counter, so it stays correct when the host renders faster than realtime;
+    the project fields mirror the host's AudioPlayHead when it provides them.
+*/
+struct AnalysisTimestamp
+{
+    double sessionSeconds = 0.0;
+    juce::int64 projectSamples = 0;
+    double projectSeconds = 0.0;
+    double ppqPosition = 0.0;
+    juce::int64 bar = 0;
+    bool hasProjectPosition = false;
+    bool hasMusicalPosition = false;
+};
+
+//==============================================================================
+/**
+    Fixed-size ring holding the most recent analysis frames.
+
+    The audio thread pushes every analysed frame into the ring, overwriting the
+    oldest one once it is full. A frame is a spectrum plus an optional fixed number
+    of extra values, such as the watched-frequency levels. All storage is allocated
+    up front in prepare(), so push() never allocates and costs one copy of each.
+
+    A single reader on another thread can copy frames out by sequence number.
+    Frames that were overwritten while being read are reported as unavailable
+    rather than returned torn.
+*/
+class AnalysisFrameRing
+{
+public:
+    AnalysisFrameRing() = default;
+
+    // Allocates storage for numSlots frames of up to maxBins spectrum values and
+    // exactly numExtraValues extra values each. Not realtime safe, call from
+    // prepareToPlay or while the audio thread is stopped.
+    void prepare(int numSlots, int maxBins, int numExtraValues = 0);
+    void clear();
+
+    // Audio thread only. Returns the sequence number the frame was written with.
+    // extraValues must hold getNumExtraValues() values, or be null to store zeros.
+    uint64_t push(const AnalysisTimestamp& timestamp, const float* bins, int numBins,
+                  const float* extraValues = nullptr) noexcept;
+
+    // Reader side
+    int getCapacity() const noexcept { return capacity; }
+    int getMaxBins() const noexcept { return maxBins; }
+    int getNumExtraValues() const noexcept { return numExtraValues; }
+    uint64_t getWriteSequence() const noexcept { return writeSequence.load(std::memory_order_acquire); }
+    uint64_t getOldestSequence() const noexcept;
+
+    // Copies the frame with the given sequence number, and its extra values if
+    // extraValues isn't null. Returns false if it has not been written yet or has
+    // already been overwritten.
+    bool read(uint64_t sequence, AnalysisTimestamp& timestamp, std::vector<float>& bins,
+              std::vector<float>* extraValues = nullptr) const;
+
+private:
+    struct Slot {
+        AnalysisTimestamp timestamp;
+        int numBins = 0;
+    };
+
+    int capacity = 0;
+    int maxBins = 0;
+    int numExtraValues = 0;
+    std::vector<Slot> slots;
+    std::vector<float> binStorage;
+    std::vector<float> extraStorage;
+    std::atomic<uint64_t> writeSequence { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(AnalysisFrameRing)
+};
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "LockFreeQueue.h"
+#include "RealtimeLog.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+/**
+    Process-wide pool of analysis worker threads shared by every plugin instance.
+
+    Reach it through juce::SharedResourcePointer<AnalysisWorkerPool>, so one pool is
+    created for the first instance and destroyed with the last. It owns one worker
+    per hardware thread (minus one left for the host's audio thread) plus a single
+    housekeeping thread that services all instances, so the thread count no longer
+    grows with the number of instances.
+
+    Instances queue hop-sized jobs in their own FIFO and then schedule() themselves.
+    A scheduled client sits in exactly one worker queue at a time, which keeps its
+    jobs in order and on one thread. Each turn runs at most jobsPerTurn jobs before
+    the client goes to the back of a queue, so a busy instance can't starve the rest.
+    Idle workers steal clients from the other workers' queues.
+*/
+class AnalysisWorkerPool
+{
+public:
+    //==============================================================================
+    class Client
+    {
+    public:
+        virtual ~Client() = default;
+
+        // Worker thread: run up to maxJobs queued jobs, in order
+        virtual void runAnalysisJobs(int maxJobs) = 0;
+        virtual bool hasPendingAnalysisJobs() const noexcept = 0;
+
+        // Housekeeping thread, roughly every housekeepingIntervalMs
+        virtual void performHousekeeping() = 0;
+
+    private:
+        friend class AnalysisWorkerPool;
+        std::atomic<bool> scheduled { false };
+        std::atomic<int> activeTurns { 0 };
+        std::atomic<juce::int64> scheduledTicks { 0 };
+    };
+
+    struct Stats
+    {
+        int numWorkers = 0;
+        int numClients = 0;
+        float utilisation = 0.0f;              // fraction of worker time spent running jobs since the last call
+        double averageQueueLatencyMs = 0.0;    // schedule() to start of the client's turn, smoothed
+        double maxQueueLatencyMs = 0.0;        // worst case since the last call
+        uint64_t turnsRun = 0;
+        uint64_t queueOverflows = 0;
+    };
+
+    static constexpr int jobsPerTurn = 4;
+    static constexpr int housekeepingIntervalMs = 20;
+
+    AnalysisWorkerPool();
+    ~AnalysisWorkerPool();
+
+    //==============================================================================
+    // Message thread
+    void addClient(Client& client);
+    void removeClient(Client& client);
+
+    // Blocks until the client is neither queued nor running. Call only while its
+    // audio thread is stopped, e.g. from prepareToPlay or the destructor.
+    void waitUntilIdle(Client& client);
+
+    // Audio thread. Lock-free, including waking a sleeping worker, which posts a
+    // juce::Semaphore rather than signalling an event that takes a mutex. Returns false
+    // if every queue was full; the client's jobs stay pending and are picked up by
+    // the next successful schedule().
+    bool schedule(Client& client) noexcept;
+
+    void triggerHousekeeping();
+
+    // Any thread. One log for the whole process, flushed by the housekeeping thread,
+    // so its rate limit holds however many instances post to it.
+    RealtimeLog& getLog() noexcept { return log; }
+
+    int getNumWorkers() const noexcept { return static_cast<int>(workers.size()); }
+    Stats getStats();
+
+private:
+    class Worker;
+    class Housekeeper;
+
+    Client* popOrSteal(int workerIndex) noexcept;
+    void runTurn(Client& client) noexcept;
+
+    std::vector<std::unique_ptr<LockFreeQueue<Client*>>> queues;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::unique_ptr<Housekeeper> housekeeper;
+
+    std::atomic<uint32_t> nextQueue { 0 };
+    std::atomic<int> numSleepingWorkers { 0 };
+    std::atomic<int> numPendingWakes { 0 };
+    juce::Semaphore workAvailable;
+
+    juce::CriticalSection clientLock;
+    juce::Array<Client*> clients;
+    RealtimeLog log;
+
+    // Metrics
+    std::atomic<juce::int64> busyTicks { 0 };
+    std::atomic<juce::int64> latencyTicksTotal { 0 };
+    std::atomic<juce::int64> latencyTicksMax { 0 };
+    std::atomic<uint64_t> turnsRun { 0 };
+    std::atomic<uint64_t> queueOverflows { 0 };
+    juce::int64 lastStatsTicks = 0;
+    uint64_t lastStatsTurns = 0;
+    double smoothedLatencyMs = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE(AnalysisWorkerPool)
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <cstdint>
+
+//==============================================================================
+/**
+    Decides when automatic capture starts and stops.
+
+    process() is called on the audio thread once per analysis frame with metrics
+    the analysis has already computed, so evaluating a trigger is a handful of
+    comparisons. Segment boundaries are reported as events carrying the ring
+    sequence number of the frame that caused them; the recording collector pops
+    them and cuts the matching frames out of the analysis ring.
+*/
+class CaptureTrigger
+{
+public:
+    enum class Mode
+    {
+        manual,       // Start/Stop Recording buttons only
+        levelAbove,   // capture while the frame level is above the threshold
+        levelBelow,   // capture while the frame level is below the threshold
+        onset,        // capture around detected onsets
+        bandEnergy    // capture while one analysis band is above the threshold
+    };
+
+    struct Settings
+    {
+        Mode mode = Mode::manual;
+        float thresholdDb = -40.0f;
+        float hysteresisDb = 6.0f;
+        float onsetRatio = 2.0f;          // spectral flux must exceed this multiple of its running average
+        int bandIndex = 3;                // index into the processor's analysis bands
+        double preSeconds = 0.5;          // frames kept before the trigger fired
+        double postSeconds = 1.0;         // frames kept after the condition cleared
+        double minSegmentSeconds = 0.25;  // shorter segments are discarded
+    };
+
+    struct Event
+    {
+        enum class Type { segmentStart, segmentEnd, segmentDiscarded };
+
+        Type type = Type::segmentStart;
+        uint64_t sequence = 0;
+    };
+
+    CaptureTrigger() = default;
+
+    // Call while the trigger is not being processed, e.g. before arming
+    void prepare(const Settings& newSettings, double frameDurationSeconds);
+    void reset() noexcept;
+
+    const Settings& getSettings() const noexcept { return settings; }
+    int getPreFrames() const noexcept { return preFrames; }
+    bool isCapturing() const noexcept { return state != State::idle; }
+
+    // Audio thread: metrics of the frame that was pushed with the given sequence
+    void process(uint64_t sequence, float levelDb, float bandEnergyDb, bool onsetDetected) noexcept;
+
+    // Collector thread
+    bool popEvent(Event& event) noexcept;
+
+    static juce::String getModeName(Mode mode);
+
+private:
+    enum class State { idle, capturing, releasing };
+
+    bool isConditionMet(float levelDb, float bandEnergyDb, bool onsetDetected) const noexcept;
+    void pushEvent(Event::Type type, uint64_t sequence) noexcept;
+
+    Settings settings;
+    int preFrames = 0;
+    int postFrames = 0;
+    int minSegmentFrames = 0;
+
+    State state = State::idle;
+    uint64_t segmentStartSequence = 0;
+    uint64_t releaseStartSequence = 0;
+
+    static constexpr int maxPendingEvents = 64;
+    juce::AbstractFifo eventFifo { maxPendingEvents };
+    std::array<Event, maxPendingEvents> events;
+
+    JUCE_DECLARE_NON_COPYABLE(CaptureTrigger)
+};
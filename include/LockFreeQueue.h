@@ -0,0 +1,94 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+//==============================================================================
+/**
+    Bounded multi-producer multi-consumer queue (Dmitry Vyukov's array queue).
+
+    push() and pop() never allocate or block and are safe to call from the audio
+    thread. Storage is allocated once in the constructor. T should be cheap to
+    copy, e.g. a pointer or a small POD record.
+*/
+template <typename T>
+class LockFreeQueue
+{
+public:
+    explicit LockFreeQueue(size_t capacityPowerOfTwo)
+        : mask(capacityPowerOfTwo - 1),
+          cells(new Cell[capacityPowerOfTwo])
+    {
+        jassert(juce::isPowerOfTwo(capacityPowerOfTwo));
+
+        for (size_t i = 0; i < capacityPowerOfTwo; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    // Returns false if the queue is full
+    bool push(const T& item) noexcept
+    {
+        auto position = enqueuePosition.load(std::memory_order_relaxed);
+
+        for (;;) {
+            auto& cell = cells[position & mask];
+            const auto sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+            if (difference == 0) {
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.item = item;
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0) {
+                return false;
+            }
+            else {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Returns false if the queue is empty
+    bool pop(T& item) noexcept
+    {
+        auto position = dequeuePosition.load(std::memory_order_relaxed);
+
+        for (;;) {
+            auto& cell = cells[position & mask];
+            const auto sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+
+            if (difference == 0) {
+                if (dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    item = cell.item;
+                    cell.sequence.store(position + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0) {
+                return false;
+            }
+            else {
+                position = dequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence { 0 };
+        T item {};
+    };
+
+    const size_t mask;
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<size_t> enqueuePosition { 0 };
+    alignas(64) std::atomic<size_t> dequeuePosition { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(LockFreeQueue)
+};
@@ -13,6 +13,7 @@
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_gui_extra/juce_gui_extra.h>
 #include "PluginProcessor.h"
+#include <array>
 #include <atomic>
 #include <memory>
 
@@ -20,9 +21,7 @@
 /**
 */
 class FXPluginEditor  : public juce::AudioProcessorEditor,
-                        private juce::Slider::Listener,
-                        private juce::Button::Listener,
-                        private juce::Timer
+                        private juce::Button::Listener
 {
 public:
     FXPluginEditor (FXPluginProcessor&);
@@ -33,23 +32,23 @@ public:
     void resized() override;
 
 private:
-    // Timer callback for UI updates
-    void timerCallback() override;
-    
-    // Slider callback
-    void sliderValueChanged(juce::Slider* slider) override;
+    // Display-rate update of the meters and status from the processor's latest snapshot
+    void updateFromSnapshot(double frameTimeSeconds);
     
     // Button callback
     void buttonClicked(juce::Button* button) override;
     
-    // Method to safely set parameters
-    void safeSetParameter(const juce::String& paramID, float value);
-    
     // Method to choose output file path
     bool chooseOutputFilePath();
     
     // Method to toggle recording
     void toggleRecording();
+    
+    // Trigger mode selection
+    void triggerModeChanged();
+    
+    // Analysis source selection
+    void analysisSourceChanged();
 
     // Reference to the processor
     FXPluginProcessor& audioProcessor;
@@ -57,8 +56,12 @@ private:
     // Flag to prevent UI updates during initialization
     std::atomic<bool> uiInitialized{false};
     
-    // Time tracking for UI updates
-    double lastUIRefreshTime;
+    // Latest processor state, and the meter levels last drawn from it
+    FXPluginProcessor::EditorSnapshot snapshot;
+    std::array<float, FXPluginProcessor::EditorSnapshot::maxMeterChannels> displayedPeaks {};
+    std::array<float, FXPluginProcessor::EditorSnapshot::maxMeterChannels> displayedRms {};
+    float displayedLoad = 0.0f;
+    juce::Rectangle<int> meterArea;
 
     // UI Components
     juce::Label gainLabel;
@@ -66,15 +69,25 @@ private:
     juce::Slider gainSlider;
     juce::Slider distortionSlider;
     
+    // Keep the sliders and the parameters in step both ways, whether or not audio
+    // is running. Declared after the sliders, so they are detached first.
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> gainAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> distortionAttachment;
+    
     // UI Components for frequency analysis
     juce::TextButton recordButton;
     juce::TextButton chooseFileButton;
     juce::TextButton resetButton;
     juce::Label filePathLabel;
     juce::Label statusLabel;
+    juce::ComboBox triggerModeBox;
+    juce::ComboBox analysisSourceBox;
     
     // File chooser (needs to be kept alive during async operation)
     std::unique_ptr<juce::FileChooser> fileChooser;
+    
+    // Declared last, so it is detached before anything it updates is destroyed
+    juce::VBlankAttachment vBlankAttachment;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FXPluginEditor)
 }; 
\ No newline at end of file
@@ -13,21 +13,65 @@
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_gui_extra/juce_gui_extra.h>
 #include "JucePlugin_Common.h"
+#include "AnalysisFrameRing.h"
+#include "CaptureTrigger.h"
+#include "AnalysisWorkerPool.h"
+#include "ProcessingKernels.h"
+#include "RealtimeLog.h"
+#include "RealtimeSanitiser.h"
+#include "TripleBuffer.h"
 #include <mutex>
 #include <atomic>
 #include <vector>
 #include <map>
+#include <array>
 
 //==============================================================================
 /**
 */
-class FXPluginProcessor : public juce::AudioProcessor
+class FXPluginProcessor : public juce::AudioProcessor,
+                          private AnalysisWorkerPool::Client
 {
 public:
     // Frequency data storage
     struct FrequencyFrame {
-        double timeSeconds;
-        std::vector<float> magnitudes;
+        double timeSeconds;               // relative to the start of the recording
+        AnalysisTimestamp timestamp;      // session and project timeline position
+        std::vector<float> power;         // squared FFT magnitude per bin, DC upwards
+        std::vector<float> watch;         // valuesPerWatchedFrequency per watched frequency
+        std::vector<float> constantQ;     // constant-Q bin power, lowest bin first
+        std::vector<float> limiter;       // gain reduction in dB at the end of the frame, then its peak over the frame
+    };
+    
+    // Named frequency range used for band energy reporting and triggering
+    struct FrequencyBand {
+        juce::String name;
+        float minFreq;
+        float maxFreq;
+    };
+    
+    // What the editor shows, published by the audio thread once per block. Levels are
+    // linear, after gain, waveshaper and cabinet, with meter ballistics applied.
+    struct EditorSnapshot {
+        static constexpr int maxMeterChannels = 2;
+        
+        float gain = 0.0f;
+        float distortion = 0.0f;
+        int numMeterChannels = 0;
+        std::array<float, maxMeterChannels> peakLevels {};
+        std::array<float, maxMeterChannels> rmsLevels {};
+        
+        bool isRecording = false;
+        bool isTriggerArmed = false;
+        int numCapturedSegments = 0;
+        
+        uint64_t blocksProcessed = 0;
+        juce::int64 samplesProcessed = 0;
+        uint64_t analysisFramesWritten = 0;
+        uint64_t droppedAnalysisHops = 0;
+        
+        float processLoad = 0.0f;         // processBlock time as a proportion of the block's duration, smoothed
+        int numOverruns = 0;              // blocks that took longer than their duration since prepareToPlay
     };
     
     //==============================================================================
@@ -41,7 +85,13 @@ public:
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
 
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
     void processBlockBypassed(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlockBypassed(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    
+    // Hosts that ask for double precision get the whole chain in double, apart from
+    // the cabinet convolution, which is float-only. The precision is fixed at prepareToPlay.
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -56,6 +106,14 @@ public:
     double getTailLengthSeconds() const override;
 
     //==============================================================================
+    // Programs come from an in-memory bank. setCurrentProgram never allocates or locks,
+    // so hosts may call it from the audio thread: the next block ramps to the program's
+    // values over parameterRampSeconds, and the parameters themselves follow from the
+    // housekeeping thread (at once when called on the message thread). Every other
+    // parameter change ramps the same way.
+    static constexpr int numPrograms = 8;
+    static constexpr double parameterRampSeconds = 0.005;
+    
     int getNumPrograms() override;
     int getCurrentProgram() override;
     void setCurrentProgram(int index) override;
@@ -63,6 +121,10 @@ public:
     void changeProgramName(int index, const juce::String& newName) override;
 
     //==============================================================================
+    // State is a small versioned binary block: the parameter values, the current program
+    // and the program bank. States saved as XML by earlier versions still load.
+    static constexpr int stateFormatVersion = 1;
+    
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
     
@@ -84,20 +146,252 @@ public:
     juce::String getOutputFilePath() const;
     bool saveFrequencyData();
     
+    // Pre-roll: how much analysis history is kept so a recording can start in the past.
+    // Takes effect on the next prepareToPlay.
+    void setPreRollSeconds(double seconds);
+    double getPreRollSeconds() const;
+    
+    // Automatic capture. Settings are applied when recording is next started;
+    // in any mode other than manual, starting a recording arms the trigger and
+    // every captured segment is written to its own indexed file.
+    void setTriggerSettings(const CaptureTrigger::Settings& settings);
+    CaptureTrigger::Settings getTriggerSettings() const;
+    int getNumCapturedSegments() const;
+    const std::vector<FrequencyBand>& getAnalysisBands() const { return analysisBands; }
+    
+    // Watch frequencies: sliding DFT bins that follow a few chosen frequencies (mains
+    // hum, pilot tones, resonances) sample by sample, alongside the FFT. Each frame
+    // reports their level, peak and peak time since the previous frame. The window is
+    // 1 / resolutionHz long. An empty list turns the mode off; at most
+    // maxWatchedFrequencies are used. Takes effect on the next prepareToPlay.
+    static constexpr int maxWatchedFrequencies = 32;
+    void setWatchedFrequencies(const std::vector<float>& frequenciesHz, float resolutionHz = 10.0f);
+    std::vector<float> getWatchedFrequencies() const;
+    
+    // Constant-Q spectrum: binsPerOctave log-spaced bins per octave from minFrequencyHz
+    // up to maxFrequency, alongside the linear FFT. 0 bins per octave turns it off;
+    // other values are clamped to 12..48. Takes effect on the next prepareToPlay.
+    void setConstantQ(int binsPerOctave, float minFrequencyHz = 30.0f);
+    int getConstantQBinsPerOctave() const;
+    
+    // Waveshaper anti-aliasing: antiderivative anti-aliasing (ADAA) of order 0 (off), 1
+    // or 2, run at 2^oversamplingOrder times the sample rate (oversamplingOrder 0..3).
+    // Both add latency, which is reported to the host. With both at 0 the plain tanh
+    // is used. Takes effect on the next prepareToPlay.
+    void setWaveshaperAntiAliasing(int adaaOrder, int oversamplingOrder);
+    int getWaveshaperADAAOrder() const;
+    int getWaveshaperOversamplingOrder() const;
+    
+    // Output limiter: a lookahead brickwall limiter after the cabinet that holds the
+    // output under ceilingDb. With truePeak it also holds the waveform between the
+    // samples there, as a 4x oversampled true-peak meter sees it. The lookahead is
+    // reported as latency, and recordings carry the gain reduction of every frame.
+    // Takes effect on the next prepareToPlay.
+    struct LimiterSettings {
+        bool enabled = false;
+        float ceilingDb = -1.0f;
+        float lookaheadMs = 5.0f;
+        float releaseMs = 100.0f;
+        bool truePeak = true;
+    };
+    void setLimiterSettings(const LimiterSettings& settings);
+    LimiterSettings getLimiterSettings() const;
+    
+    // Multiband waveshaping: the waveshaper splits the signal into numBands (2..4)
+    // bands with Linkwitz-Riley crossovers at crossoverFrequencies (Hz, ascending),
+    // and shapes each band with its own drive and gain parameters ("band1Drive",
+    // "band1Gain" and so on) in place of the distortion parameter. It runs inside
+    // the waveshaper's oversampling, without ADAA. The bands are added to the
+    // analysis bands as "band_1" upwards. Takes effect on the next prepareToPlay.
+    static constexpr int maxMultibandBands = juce::dsp::MultibandWaveShaper<float>::maxBands;
+    struct MultibandSettings {
+        bool enabled = false;
+        int numBands = 3;
+        std::array<float, maxMultibandBands - 1> crossoverFrequencies { 250.0f, 2500.0f, 8000.0f };
+    };
+    void setMultibandSettings(const MultibandSettings& settings);
+    MultibandSettings getMultibandSettings() const;
+    
+    // Cabinet/room impulse response convolved after the waveshaper, with no added
+    // latency. The file is loaded and prepared on a background thread and crossfades in.
+    // Only the head of the IR is convolved on the audio thread; a background thread
+    // works through the rest ahead of time.
+    void loadCabinetImpulseResponse(const juce::File& file);
+    void clearCabinetImpulseResponse();
+    bool hasCabinetImpulseResponse() const { return isCabinetEnabled.load(); }
+    
+    // Which signal the analysis sees. The sidechain is an optional mono or stereo input
+    // bus that is only analysed, never processed or passed to the output. The
+    // difference is the processed main output minus the sidechain, e.g. to null a
+    // track against a reference. Each is read straight from the host's buffer, and a
+    // change applies from the next block.
+    enum class AnalysisSource { mainPreFX, mainPostFX, sidechain, mainMinusSidechain };
+    void setAnalysisSource(AnalysisSource source);
+    AnalysisSource getAnalysisSource() const;
+    bool isSidechainConnected() const;
+    
+    // Shared analysis pool metrics, hops this instance dropped because its job queue was
+    // full, and log records dropped or rate limited across the process
+    AnalysisWorkerPool::Stats getAnalysisPoolStats();
+    uint64_t getNumDroppedAnalysisHops() const;
+    uint64_t getNumDroppedLogRecords() const;
+    
+    // Message thread, for a single editor: copies the newest snapshot and returns true
+    // if one was published since the last call. Never blocks or allocates.
+    bool pullEditorSnapshot(EditorSnapshot& destination) noexcept;
+    
     // File path setup
     void setupDefaultOutputPath();
 
 private:
     // Core audio processing methods
     void applyDistortion(float* channelData, int numSamples, float gain, float distortion);
+    template <typename SampleType>
+    void processBlockInternal(juce::AudioBuffer<SampleType>& buffer);
+    template <typename SampleType>
+    void processBlockBypassedInternal(juce::AudioBuffer<SampleType>& buffer);
+    template <typename SampleType>
+    void applyCabinet(juce::AudioBuffer<SampleType>& buffer, int numChannels);
+    void prepareWaveshaper(double sampleRate, int samplesPerBlock);
+    template <typename SampleType>
+    void applyTanhWaveshaper(SampleType* channelData, int numSamples, float startDistortion, float endDistortion);
+    template <typename SampleType>
+    void applyWaveshaper(juce::AudioBuffer<SampleType>& buffer, int numChannels, float startDistortion, float endDistortion);
+    template <typename SampleType>
+    void applyWaveshaperRamp(juce::dsp::AudioBlock<SampleType>& block, float startDistortion, float endDistortion);
+    template <typename SampleType>
+    void applyMultibandWaveshaper(juce::AudioBuffer<SampleType>& buffer, int numChannels);
+    template <typename SampleType>
+    void updateBandParameters(juce::dsp::MultibandWaveShaper<SampleType>& shaper);
+    void updateMultibandAnalysisBands(double sampleRate);
+    void prepareLimiter(double sampleRate, int samplesPerBlock);
+    void prepareBypassDelay(double sampleRate, int samplesPerBlock);
+    template <typename SampleType>
+    void applyLimiter(juce::AudioBuffer<SampleType>& buffer, int numChannels);
+    std::pair<float, float> takeLimiterGainReduction();
+    void publishProgramParameters();
     
     // FFT and frequency analysis methods
-    void analyzeAudioBlock(const juce::AudioBuffer<float>& buffer);
+    template <typename SampleType>
+    void analyzeAudioBlock(const juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>* subtracted = nullptr);
+    void submitAnalysisJob(const AnalysisTimestamp& timestamp);
+    void analyzeFrame(const AnalysisTimestamp& timestamp, const float* extraValues);
+    void prepareAnalysis(double sampleRate);
+    void waitForRecordingCollector(uint64_t sequence);
+    void waitForPendingAnalysisJobs();
+    double getSessionSeconds() const;
+    int getAnalysisBin(float frequencyHz) const noexcept;
+    void collectRecordedFrames();
+    void drainRecordedFrames(uint64_t endSequence);
+    void finishSegment();
+    template <typename SampleType>
+    void publishEditorSnapshot(const juce::AudioBuffer<SampleType>& buffer, int numChannels);
+    bool writeFrequencyData(const juce::File& outputFile, int segmentIndex);
+    bool writeSegmentIndex();
+    
+    // AnalysisWorkerPool::Client: FFT jobs run on the shared pool, and its
+    // housekeeping thread moves frames from the analysis ring into the recording
+    void runAnalysisJobs(int maxJobs) override;
+    bool hasPendingAnalysisJobs() const noexcept override;
+    void performHousekeeping() override;
     
     // Parameter management
     juce::AudioProcessorValueTreeState parameters;
     std::atomic<float>* gainParameter = nullptr;
     std::atomic<float>* distortionParameter = nullptr;
+    std::array<std::atomic<float>*, maxMultibandBands> bandDriveParameters {};
+    std::array<std::atomic<float>*, maxMultibandBands> bandGainParameters {};
+    
+    // Programs. Only the message thread writes the bank; the audio thread reads the
+    // values of a requested program, which are atomic as loading a state rewrites
+    // them. A request is (serial << 8) | index, so switching back to the same program
+    // is still a new request.
+    static constexpr std::array<const char*, 2> programParameterIDs { "gain", "distortion" };
+    static constexpr int numProgramParameters = static_cast<int>(programParameterIDs.size());
+    
+    struct Program {
+        juce::String name;
+        std::array<std::atomic<float>, numProgramParameters> values {};
+    };
+    
+    std::array<juce::RangedAudioParameter*, numProgramParameters> programParameters {};
+    std::array<Program, numPrograms> programs;
+    std::atomic<uint32_t> programRequest { 0 };
+    std::atomic<uint32_t> publishedProgramRequest { 0 };
+    
+    // Parameter ramps, owned by the audio thread. Until a requested program's values
+    // have reached the parameters the ramps head for the bank's values instead.
+    juce::SmoothedValue<float> gainRamp, distortionRamp;
+    uint32_t audioProgramRequest = 0;
+    bool isFollowingProgram = false;
+    
+    // The stages that run in the host's sample precision. Only the set matching
+    // isPreparedForDouble is prepared; the other one holds no buffers.
+    template <typename SampleType>
+    struct ProcessingStages {
+        std::unique_ptr<juce::dsp::Oversampling<SampleType>> waveshaperOversampling;
+        juce::dsp::AntiderivativeWaveShaper<SampleType> waveshaper;
+        juce::AudioBuffer<SampleType> waveshaperDryBuffer;   // dry copy for the crossfade when shaping turns on or off
+        juce::dsp::MultibandWaveShaper<SampleType> multibandWaveshaper;
+        juce::dsp::LookaheadLimiter<SampleType> limiter;
+        juce::dsp::DelayLine<SampleType, juce::dsp::DelayLineInterpolationTypes::None> bypassDelay;
+    };
+    
+    ProcessingStages<float> floatStages;
+    ProcessingStages<double> doubleStages;
+    bool isPreparedForDouble = false;
+    
+    // Bypassed blocks are delayed by the reported latency, so the host's compensation
+    // still lines them up. The delay restarts empty each time bypass turns on.
+    bool isBypassing = false;
+    
+    template <typename SampleType>
+    ProcessingStages<SampleType>& getStages() noexcept
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return doubleStages;
+        else
+            return floatStages;
+    }
+    
+    template <typename SampleType>
+    double prepareWaveshaperStages(ProcessingStages<SampleType>& stages, double sampleRate,
+                                   int adaaOrder, int oversamplingOrder);
+    
+    // Anti-aliased waveshaper, used instead of the plain tanh loop when ADAA or
+    // oversampling is on
+    int waveshaperSettingsADAAOrder = 0;
+    int waveshaperSettingsOversamplingOrder = 0;
+    bool useAntiAliasedWaveshaper = false;
+    bool wasWaveshaping = false;
+    int waveshaperBlockSize = 0;
+    
+    // Multiband waveshaper, used instead of both when on. preparedMultibandSettings are
+    // the ones in use, and the band values the shaper was last given, which it ramps to.
+    MultibandSettings multibandSettings, preparedMultibandSettings;
+    bool useMultibandWaveshaper = false;
+    std::array<float, maxMultibandBands> bandDrives {}, bandGains {};
+    
+    // Output limiter, and how many of each analysis frame's extra values are its
+    // gain reduction (0 while it is off). preparedLimiterSettings are the ones in use.
+    static constexpr int valuesPerLimiterFrame = 2;
+    LimiterSettings limiterSettings, preparedLimiterSettings;
+    bool useLimiter = false;
+    int numLimiterValues = 0;
+    int limiterLatency = 0;
+    
+    // Cabinet IR. Once prepared, only the audio thread calls into the convolution, so a
+    // new file is handed over through pendingCabinetFile.
+    static constexpr int cabinetHeadSize = 256;
+    juce::dsp::Convolution cabinet { juce::dsp::Convolution::NonUniform { cabinetHeadSize, true } };
+    juce::SpinLock cabinetLock;
+    juce::File pendingCabinetFile;
+    bool hasPendingCabinetFile = false;
+    std::atomic<bool> isCabinetEnabled { false };
+    bool wasCabinetEnabled = false;
+    int cabinetBlockSize = 0;
+    juce::AudioBuffer<float> cabinetConversionBuffer;   // the convolution's float copy of a double block
+    std::atomic<double> cabinetTailSeconds { 0.0 };
     
     // Frequency analysis
     int fftSize;
@@ -111,6 +405,91 @@ private:
     // FFT processing storage
     std::vector<FrequencyFrame> frequencyData;
     
+    // Continuous analysis state, allocated in prepareToPlay
+    // fftBuffer holds one windowed frame of fftSize samples, and then its power spectrum
+    static constexpr float minimumBinPower = 1.0e-10f;   // -100 dB
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<float> fftBuffer;
+    std::vector<float> hannWindow;
+    std::vector<float> previousMagnitudes;
+    
+    // Mono history of the last fftSize samples and the sample clock that places
+    // frames in time; hops are counted in samples, never in wall-clock time
+    std::vector<float> analysisHistory;
+    int historyWritePosition = 0;
+    int hopSize = 0;
+    int samplesUntilNextHop = 0;
+    double analysisSampleRate = 0.0;
+    std::atomic<juce::int64> samplesProcessed { 0 };
+    float spectralFluxAverage = 0.0f;
+    std::vector<FrequencyBand> analysisBands;
+    std::atomic<AnalysisSource> analysisSource { AnalysisSource::mainPostFX };
+    
+    // Watch frequencies run on the audio thread, as they need every sample. Per
+    // frequency a frame stores power, peak power and samples since the peak.
+    static constexpr int valuesPerWatchedFrequency = 3;
+    std::vector<float> watchSettingsFrequencies;
+    float watchSettingsResolutionHz = 10.0f;
+    juce::dsp::SlidingDFT watchBank;
+    std::vector<float> watchedFrequencies;
+    
+    // The constant-Q transform decimates on the audio thread, and each job takes a
+    // copy of its octave frames; the workers do the FFTs and kernel products
+    int constantQSettingsBinsPerOctave = 0;
+    float constantQSettingsMinFrequency = 30.0f;
+    std::unique_ptr<juce::dsp::ConstantQTransform> constantQ;
+    std::vector<float> analysisJobOctaveFrames;
+    std::vector<const float*> constantQFramePointers;
+    
+    // Mono samples of the current chunk, for the watch bank and the constant-Q transform
+    std::vector<float> analysisChunk;
+    
+    // Pre-roll ring and the recording's read position in it
+    AnalysisFrameRing analysisRing;
+    std::atomic<double> preRollSeconds { 5.0 };
+    double preRollDuration = 0.0;
+    uint64_t recordReadSequence = 0;
+    std::atomic<uint64_t> collectedSequence { 0 };
+    
+    // Automatic capture state
+    struct CapturedSegment {
+        int index;
+        juce::String fileName;
+        double startSeconds;
+        double endSeconds;
+    };
+    
+    CaptureTrigger captureTrigger;
+    CaptureTrigger::Settings triggerSettings;
+    std::atomic<bool> isTriggerArmed { false };
+    int triggerMinBin = 0;
+    int triggerMaxBin = 0;
+    bool isSegmentOpen = false;
+    std::vector<CapturedSegment> capturedSegments;
+    std::atomic<int> numCapturedSegments { 0 };
+    
+    
+    // Hop-sized jobs waiting for the shared worker pool. Each slot holds one
+    // unwindowed frame of fftSize samples.
+    static constexpr int maxPendingAnalysisJobs = 16;
+    juce::SharedResourcePointer<AnalysisWorkerPool> analysisPool;
+    juce::AbstractFifo analysisJobFifo { maxPendingAnalysisJobs };
+    std::vector<float> analysisJobSamples;
+    std::array<AnalysisTimestamp, maxPendingAnalysisJobs> analysisJobTimestamps;
+    std::vector<float> analysisJobExtraValues;   // watch values, then constant-Q power
+    std::atomic<uint64_t> droppedAnalysisHops { 0 };
+    
+    // Audio-thread and worker diagnostics, posted to the pool's process-wide log
+    RealtimeLog& realtimeLog { analysisPool->getLog() };
+    
+    // Editor hand-over, meter state and load measurement, all owned by the audio thread
+    static constexpr double meterReleaseSeconds = 0.3;
+    TripleBuffer<EditorSnapshot> editorSnapshots;
+    std::array<float, EditorSnapshot::maxMeterChannels> meterPeaks {};
+    std::array<float, EditorSnapshot::maxMeterChannels> meterMeanSquares {};
+    uint64_t blocksProcessed = 0;
+    juce::AudioProcessLoadMeasurer loadMeasurer;
+    
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FXPluginProcessor)
 }; 
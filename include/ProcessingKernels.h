@@ -0,0 +1,33 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+/**
+    The per-sample loops of processBlock and the analysis, written once for float
+    and double. Each one runs in juce::dsp::SIMDRegister lanes of the sample type
+    (4 floats or 2 doubles on SSE2 and NEON) with a scalar tail, and falls back to
+    plain loops where JUCE has no SIMD support.
+
+    Host buffers have no alignment guarantee, so registers are loaded and stored
+    through unaligned copies; on x86 and ARM those are single instructions.
+*/
+namespace ProcessingKernels
+{
+    // data[i] *= startGain + i * (endGain - startGain) / numSamples
+    template <typename SampleType>
+    void applyGainRamp(SampleType* data, int numSamples, SampleType startGain, SampleType endGain) noexcept;
+
+    // Replaces NaNs and infinities with 0, so one bad sample can't poison the
+    // filter and analysis state downstream
+    template <typename SampleType>
+    void zeroNonFinite(SampleType* data, int numSamples) noexcept;
+
+    // The mean of the channels, minus the mean of the subtracted channels if there
+    // are any, written as float for the analysis. Channels are summed in order in
+    // the sample type, so the SIMD body and the scalar tail agree exactly.
+    template <typename SampleType>
+    void mixToMono(const SampleType* const* channels, int numChannels,
+                   const SampleType* const* subtractedChannels, int numSubtractedChannels,
+                   int startSample, float* destination, int numSamples) noexcept;
+}
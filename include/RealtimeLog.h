@@ -0,0 +1,80 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "LockFreeQueue.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+//==============================================================================
+/**
+    Logging channel that is safe to use from the audio thread and analysis workers.
+
+    post() copies a fixed-size record (message code, two numeric arguments, a short
+    text detail and a timestamp) into a lock-free queue. Nothing is formatted and
+    nothing allocates until flush() runs on a background thread, which turns the
+    records into juce::Logger messages.
+
+    Each code is rate limited to maxRecordsPerCodePerSecond. The plugin uses one log
+    for the whole process, owned by AnalysisWorkerPool, so the limit holds however
+    many instances post to it. Records over that limit, or arriving while the queue
+    is full, are counted rather than queued; flush() reports the counts so an error
+    storm shows up as one line instead of causing dropouts.
+*/
+class RealtimeLog
+{
+public:
+    enum class Code : uint16_t
+    {
+        processBlockException,
+        processBlockUnknownException,
+        parameterNotFound,
+        parameterException,
+        analysisException,
+        analysisUnknownException,
+        analysisHopDropped,
+        numCodes
+    };
+
+    struct Record
+    {
+        Code code = Code::processBlockException;
+        juce::int64 ticks = 0;
+        juce::int64 intArg = 0;
+        double valueArg = 0.0;
+        char text[48] = {};
+    };
+
+    static constexpr int capacity = 256;
+    static constexpr int maxRecordsPerCodePerSecond = 10;
+
+    RealtimeLog();
+
+    // Any thread; never blocks or allocates. text is truncated to fit the record.
+    void post(Code code, const char* text = nullptr, juce::int64 intArg = 0, double valueArg = 0.0) noexcept;
+
+    // Background thread: formats queued records and writes them to juce::Logger
+    void flush();
+
+    uint64_t getNumDropped() const noexcept { return dropped.load(std::memory_order_relaxed); }
+    uint64_t getNumSuppressed() const noexcept { return suppressed.load(std::memory_order_relaxed); }
+
+    static const char* getMessage(Code code) noexcept;
+
+private:
+    struct RateWindow {
+        std::atomic<juce::int64> startTicks { 0 };
+        std::atomic<int> count { 0 };
+    };
+
+    LockFreeQueue<Record> queue { capacity };
+    std::array<RateWindow, static_cast<size_t>(Code::numCodes)> rateWindows;
+    const juce::int64 ticksPerSecond;
+
+    std::atomic<uint64_t> dropped { 0 };
+    std::atomic<uint64_t> suppressed { 0 };
+    uint64_t reportedDropped = 0;
+    uint64_t reportedSuppressed = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(RealtimeLog)
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <cstdint>
+
+//==============================================================================
+/**
+    Realtime-safety checker for the audio path. It is compiled in when
+    FXPLUGIN_REALTIME_SANITISER is set, which CMake always does for the test runner
+    and, if the option of that name is on, for Debug builds of the plugin.
+
+    A thread is in a realtime scope while a ScopedRealtime is alive on it. Inside
+    that scope these are violations:
+    - heap allocation or deallocation (malloc and friends on glibc, operator
+      new and delete elsewhere)
+    - CriticalSection::enter(), SpinLock::enter() and WaitableEvent::signal(),
+      which locks a mutex, reported by juce::LockHooks. tryEnter() is allowed, and
+      so is posting a juce::Semaphore, which is how to wake another thread.
+    - on glibc only: pthread mutex, rwlock, condition and semaphore waits, joins,
+      sleeps, file I/O, poll and select, and throwing an exception
+
+    The first violation is kept with a stack trace and written to juce::Logger;
+    later ones are only counted. ScopedAllow marks code that is deliberately
+    allowed to break the rules, such as a wait that only happens offline.
+
+    Without FXPLUGIN_REALTIME_SANITISER the scopes are empty and cost nothing.
+*/
+class RealtimeSanitiser
+{
+public:
+#if FXPLUGIN_REALTIME_SANITISER
+    class ScopedRealtime
+    {
+    public:
+        // isRealtime false makes the scope a no-op, e.g. for offline rendering
+        explicit ScopedRealtime(bool isRealtime = true) noexcept;
+        ~ScopedRealtime() noexcept;
+
+    private:
+        const bool active;
+        JUCE_DECLARE_NON_COPYABLE(ScopedRealtime)
+    };
+
+    class ScopedAllow
+    {
+    public:
+        ScopedAllow() noexcept;
+        ~ScopedAllow() noexcept;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedAllow)
+    };
+
+    static constexpr bool isCompiledIn() noexcept { return true; }
+
+    // True where system calls and exceptions are intercepted, not only allocations and JUCE locks
+    static bool interceptsSystemCalls() noexcept;
+
+    static uint64_t getNumViolations() noexcept;
+
+    // What the first violation since the last reset was, followed by its stack
+    // trace, or an empty string if there hasn't been one
+    static juce::String getFirstViolationReport();
+
+    // Not thread-safe: only call while no thread is in a realtime scope
+    static void reset();
+#else
+    struct ScopedRealtime { explicit ScopedRealtime(bool = true) noexcept {} };
+    struct ScopedAllow { ScopedAllow() noexcept {} };
+
+    static constexpr bool isCompiledIn() noexcept { return false; }
+    static bool interceptsSystemCalls() noexcept { return false; }
+    static uint64_t getNumViolations() noexcept { return 0; }
+    static juce::String getFirstViolationReport() { return {}; }
+    static void reset() {}
+#endif
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+
+//==============================================================================
+/**
+    Wait-free hand-over of the latest value of T from one writer thread to one
+    reader thread.
+
+    There are three slots: the writer owns one, the reader owns one, and the third
+    is the most recently published value. publish() and update() each swap their
+    own slot with the published one in a single atomic exchange, so neither side
+    ever waits for the other and the reader never sees a torn value. The reader
+    only ever gets the newest value; values published in between are skipped.
+
+    The writer must fill in every field it cares about before each publish(), as
+    its slot holds whatever was published two swaps ago. T should be a small,
+    trivially copyable struct.
+*/
+template <typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+
+    // Writer side
+    T& getWriteBuffer() noexcept { return slots[(size_t) writeIndex].value; }
+
+    void publish() noexcept
+    {
+        const auto previous = published.exchange(writeIndex | newValueFlag, std::memory_order_acq_rel);
+        writeIndex = previous & indexMask;
+    }
+
+    // Reader side. Returns true and makes the newest value readable if something
+    // was published since the last call.
+    bool update() noexcept
+    {
+        if ((published.load(std::memory_order_relaxed) & newValueFlag) == 0)
+            return false;
+
+        const auto previous = published.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & indexMask;
+        return true;
+    }
+
+    const T& getReadBuffer() const noexcept { return slots[(size_t) readIndex].value; }
+
+private:
+    static constexpr int indexMask = 3;
+    static constexpr int newValueFlag = 4;
+
+    // Each slot on its own cache line, so the two threads don't share one
+    struct alignas(64) Slot {
+        T value {};
+    };
+
+    std::array<Slot, 3> slots;
+    int writeIndex = 0;
+    alignas(64) std::atomic<int> published { 1 };
+    alignas(64) int readIndex = 2;
+
+    JUCE_DECLARE_NON_COPYABLE(TripleBuffer)
+};
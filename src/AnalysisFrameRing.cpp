@@ -0,0 +1,81 @@
+#include "../include/AnalysisFrameRing.h"
+
+void AnalysisFrameRing::prepare(int numSlots, int numBinsPerFrame, int numExtraValuesPerFrame)
+{
+    capacity = juce::jmax(1, numSlots);
+    maxBins = juce::jmax(0, numBinsPerFrame);
+    numExtraValues = juce::jmax(0, numExtraValuesPerFrame);
+
+    slots.assign(static_cast<size_t>(capacity), Slot());
+    binStorage.assign(static_cast<size_t>(capacity) * static_cast<size_t>(maxBins), 0.0f);
+    extraStorage.assign(static_cast<size_t>(capacity) * static_cast<size_t>(numExtraValues), 0.0f);
+
+    writeSequence.store(0, std::memory_order_release);
+}
+
+void AnalysisFrameRing::clear()
+{
+    writeSequence.store(0, std::memory_order_release);
+}
+
+uint64_t AnalysisFrameRing::push(const AnalysisTimestamp& timestamp, const float* bins, int numBins,
+                                 const float* extraValues) noexcept
+{
+    if (capacity == 0)
+        return 0;
+
+    const auto sequence = writeSequence.load(std::memory_order_relaxed);
+    const auto slotIndex = static_cast<size_t>(sequence % static_cast<uint64_t>(capacity));
+    const int binsToCopy = juce::jlimit(0, maxBins, numBins);
+
+    auto& slot = slots[slotIndex];
+    slot.timestamp = timestamp;
+    slot.numBins = binsToCopy;
+
+    if (binsToCopy > 0)
+        std::copy(bins, bins + binsToCopy, binStorage.data() + slotIndex * static_cast<size_t>(maxBins));
+
+    if (numExtraValues > 0) {
+        auto* extraDestination = extraStorage.data() + slotIndex * static_cast<size_t>(numExtraValues);
+
+        if (extraValues != nullptr)
+            std::copy(extraValues, extraValues + numExtraValues, extraDestination);
+        else
+            std::fill(extraDestination, extraDestination + numExtraValues, 0.0f);
+    }
+
+    writeSequence.store(sequence + 1, std::memory_order_release);
+    return sequence;
+}
+
+uint64_t AnalysisFrameRing::getOldestSequence() const noexcept
+{
+    const auto written = getWriteSequence();
+    const auto size = static_cast<uint64_t>(capacity);
+
+    // The slot after the newest one may be in the middle of being overwritten
+    return written >= size ? written - size + 1 : 0;
+}
+
+bool AnalysisFrameRing::read(uint64_t sequence, AnalysisTimestamp& timestamp, std::vector<float>& bins,
+                             std::vector<float>* extraValues) const
+{
+    if (capacity == 0 || sequence >= getWriteSequence() || sequence < getOldestSequence())
+        return false;
+
+    const auto slotIndex = static_cast<size_t>(sequence % static_cast<uint64_t>(capacity));
+    const auto& slot = slots[slotIndex];
+    const auto* source = binStorage.data() + slotIndex * static_cast<size_t>(maxBins);
+
+    timestamp = slot.timestamp;
+    bins.assign(source, source + juce::jlimit(0, maxBins, slot.numBins));
+
+    if (extraValues != nullptr) {
+        const auto* extraSource = extraStorage.data() + slotIndex * static_cast<size_t>(numExtraValues);
+        extraValues->assign(extraSource, extraSource + numExtraValues);
+    }
+
+    // If the writer reached this slot again while we were copying, the data is torn
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return getWriteSequence() < sequence + static_cast<uint64_t>(capacity);
+}
@@ -0,0 +1,235 @@
+#include "../include/AnalysisWorkerPool.h"
+
+//==============================================================================
+class AnalysisWorkerPool::Worker : public juce::Thread
+{
+public:
+    Worker(AnalysisWorkerPool& p, int index)
+        : juce::Thread("FXPlugin Analysis Worker " + juce::String(index + 1)), pool(p), workerIndex(index) {}
+
+    void run() override
+    {
+        while (!threadShouldExit()) {
+            if (auto* client = pool.popOrSteal(workerIndex)) {
+                pool.runTurn(*client);
+                continue;
+            }
+
+            // Announce we're about to sleep, then look once more. With the fence in
+            // schedule(), either this look finds a client queued in between or
+            // schedule() sees this worker asleep and wakes it.
+            pool.numSleepingWorkers.fetch_add(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (auto* client = pool.popOrSteal(workerIndex)) {
+                pool.numSleepingWorkers.fetch_sub(1);
+                pool.runTurn(*client);
+                continue;
+            }
+
+            // No timeout: schedule() posts for every sleeper it counts, and the
+            // destructor posts once per worker to shut down
+            if (pool.workAvailable.wait())
+                pool.numPendingWakes.fetch_sub(1);
+
+            pool.numSleepingWorkers.fetch_sub(1);
+        }
+    }
+
+private:
+    AnalysisWorkerPool& pool;
+    const int workerIndex;
+};
+
+//==============================================================================
+class AnalysisWorkerPool::Housekeeper : public juce::Thread
+{
+public:
+    explicit Housekeeper(AnalysisWorkerPool& p) : juce::Thread("FXPlugin Analysis Housekeeping"), pool(p) {}
+
+    void run() override
+    {
+        while (!threadShouldExit()) {
+            {
+                const juce::ScopedLock lock(pool.clientLock);
+
+                for (auto* client : pool.clients)
+                    client->performHousekeeping();
+            }
+
+            pool.log.flush();
+
+            wait(housekeepingIntervalMs);
+        }
+    }
+
+private:
+    AnalysisWorkerPool& pool;
+};
+
+//==============================================================================
+AnalysisWorkerPool::AnalysisWorkerPool()
+{
+    // Leave one core for the host's audio thread
+    const int numWorkers = juce::jmax(1, juce::SystemStats::getNumCpus() - 1);
+
+    for (int i = 0; i < numWorkers; ++i)
+        queues.push_back(std::make_unique<LockFreeQueue<Client*>>(1024));
+
+    for (int i = 0; i < numWorkers; ++i) {
+        workers.push_back(std::make_unique<Worker>(*this, i));
+        workers.back()->startThread(juce::Thread::Priority::high);
+    }
+
+    housekeeper = std::make_unique<Housekeeper>(*this);
+    housekeeper->startThread(juce::Thread::Priority::low);
+
+    lastStatsTicks = juce::Time::getHighResolutionTicks();
+
+    DBG("Analysis worker pool started with " + juce::String(numWorkers) + " workers");
+}
+
+AnalysisWorkerPool::~AnalysisWorkerPool()
+{
+    jassert(clients.isEmpty());
+
+    housekeeper->stopThread(2000);
+    log.flush();
+
+    for (auto& worker : workers) {
+        worker->signalThreadShouldExit();
+        workAvailable.post();
+    }
+
+    for (auto& worker : workers)
+        worker->stopThread(1000);
+}
+
+//==============================================================================
+void AnalysisWorkerPool::addClient(Client& client)
+{
+    const juce::ScopedLock lock(clientLock);
+    clients.addIfNotAlreadyThere(&client);
+}
+
+void AnalysisWorkerPool::removeClient(Client& client)
+{
+    {
+        const juce::ScopedLock lock(clientLock);
+        clients.removeFirstMatchingValue(&client);
+    }
+
+    waitUntilIdle(client);
+}
+
+void AnalysisWorkerPool::waitUntilIdle(Client& client)
+{
+    while (client.scheduled.load(std::memory_order_acquire) || client.activeTurns.load(std::memory_order_acquire) > 0)
+        juce::Thread::sleep(1);
+}
+
+bool AnalysisWorkerPool::schedule(Client& client) noexcept
+{
+    bool expected = false;
+    if (!client.scheduled.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+        return true;   // already queued or running, the worker will pick the new job up
+
+    client.scheduledTicks.store(juce::Time::getHighResolutionTicks(), std::memory_order_relaxed);
+
+    const auto numQueues = static_cast<uint32_t>(queues.size());
+    const auto first = nextQueue.fetch_add(1, std::memory_order_relaxed);
+
+    for (uint32_t i = 0; i < numQueues; ++i) {
+        if (queues[(first + i) % numQueues]->push(&client)) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            // One post per sleeping worker at most, so a burst of schedules
+            // doesn't leave a backlog of wake-ups that find nothing to do
+            if (numSleepingWorkers.load() > numPendingWakes.load()) {
+                numPendingWakes.fetch_add(1);
+                workAvailable.post();
+            }
+
+            return true;
+        }
+    }
+
+    queueOverflows.fetch_add(1, std::memory_order_relaxed);
+    client.scheduled.store(false, std::memory_order_release);
+    return false;
+}
+
+void AnalysisWorkerPool::triggerHousekeeping()
+{
+    housekeeper->notify();
+}
+
+AnalysisWorkerPool::Client* AnalysisWorkerPool::popOrSteal(int workerIndex) noexcept
+{
+    const auto numQueues = static_cast<int>(queues.size());
+
+    Client* client = nullptr;
+
+    for (int i = 0; i < numQueues; ++i)
+        if (queues[static_cast<size_t>((workerIndex + i) % numQueues)]->pop(client))
+            return client;
+
+    return nullptr;
+}
+
+void AnalysisWorkerPool::runTurn(Client& client) noexcept
+{
+    client.activeTurns.fetch_add(1, std::memory_order_acq_rel);
+
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+    const auto latencyTicks = startTicks - client.scheduledTicks.load(std::memory_order_relaxed);
+
+    latencyTicksTotal.fetch_add(latencyTicks, std::memory_order_relaxed);
+    auto currentMax = latencyTicksMax.load(std::memory_order_relaxed);
+    while (latencyTicks > currentMax && !latencyTicksMax.compare_exchange_weak(currentMax, latencyTicks, std::memory_order_relaxed)) {}
+
+    client.runAnalysisJobs(jobsPerTurn);
+
+    // Release the client, then take it back if jobs arrived while it was still
+    // marked as scheduled (their schedule() call was a no-op)
+    client.scheduled.store(false, std::memory_order_release);
+
+    if (client.hasPendingAnalysisJobs())
+        schedule(client);
+
+    busyTicks.fetch_add(juce::Time::getHighResolutionTicks() - startTicks, std::memory_order_relaxed);
+    turnsRun.fetch_add(1, std::memory_order_relaxed);
+
+    client.activeTurns.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+AnalysisWorkerPool::Stats AnalysisWorkerPool::getStats()
+{
+    const juce::ScopedLock lock(clientLock);
+
+    Stats stats;
+    stats.numWorkers = getNumWorkers();
+    stats.numClients = clients.size();
+    stats.turnsRun = turnsRun.load();
+    stats.queueOverflows = queueOverflows.load();
+
+    const auto now = juce::Time::getHighResolutionTicks();
+    const auto elapsedTicks = juce::jmax<juce::int64>(1, now - lastStatsTicks);
+    const auto busy = busyTicks.exchange(0);
+    stats.utilisation = static_cast<float>(static_cast<double>(busy) / (static_cast<double>(elapsedTicks) * stats.numWorkers));
+
+    const auto turns = stats.turnsRun - lastStatsTurns;
+    const auto latencyTotal = latencyTicksTotal.exchange(0);
+
+    if (turns > 0) {
+        const double averageMs = juce::Time::highResolutionTicksToSeconds(latencyTotal / static_cast<juce::int64>(turns)) * 1000.0;
+        smoothedLatencyMs = smoothedLatencyMs > 0.0 ? 0.8 * smoothedLatencyMs + 0.2 * averageMs : averageMs;
+    }
+
+    stats.averageQueueLatencyMs = smoothedLatencyMs;
+    stats.maxQueueLatencyMs = juce::Time::highResolutionTicksToSeconds(latencyTicksMax.exchange(0)) * 1000.0;
+
+    lastStatsTicks = now;
+    lastStatsTurns = stats.turnsRun;
+    return stats;
+}
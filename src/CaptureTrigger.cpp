@@ -0,0 +1,109 @@
+#include "../include/CaptureTrigger.h"
+
+void CaptureTrigger::prepare(const Settings& newSettings, double frameDurationSeconds)
+{
+    settings = newSettings;
+
+    const double frameDuration = juce::jmax(1.0e-4, frameDurationSeconds);
+    preFrames = juce::roundToInt(juce::jmax(0.0, settings.preSeconds) / frameDuration);
+    postFrames = juce::roundToInt(juce::jmax(0.0, settings.postSeconds) / frameDuration);
+    minSegmentFrames = juce::roundToInt(juce::jmax(0.0, settings.minSegmentSeconds) / frameDuration);
+
+    reset();
+}
+
+void CaptureTrigger::reset() noexcept
+{
+    state = State::idle;
+    segmentStartSequence = 0;
+    releaseStartSequence = 0;
+    eventFifo.reset();
+}
+
+bool CaptureTrigger::isConditionMet(float levelDb, float bandEnergyDb, bool onsetDetected) const noexcept
+{
+    // While a segment is open the condition has to clear by the hysteresis before it ends
+    const float hysteresis = state == State::idle ? 0.0f : settings.hysteresisDb;
+
+    switch (settings.mode)
+    {
+        case Mode::levelAbove:  return levelDb > settings.thresholdDb - hysteresis;
+        case Mode::levelBelow:  return levelDb < settings.thresholdDb + hysteresis;
+        case Mode::bandEnergy:  return bandEnergyDb > settings.thresholdDb - hysteresis;
+        case Mode::onset:       return onsetDetected;
+        case Mode::manual:      break;
+    }
+
+    return false;
+}
+
+void CaptureTrigger::process(uint64_t sequence, float levelDb, float bandEnergyDb, bool onsetDetected) noexcept
+{
+    if (settings.mode == Mode::manual)
+        return;
+
+    const bool conditionMet = isConditionMet(levelDb, bandEnergyDb, onsetDetected);
+
+    switch (state)
+    {
+        case State::idle:
+            if (conditionMet) {
+                state = State::capturing;
+                segmentStartSequence = sequence;
+                pushEvent(Event::Type::segmentStart, sequence);
+            }
+            break;
+
+        case State::capturing:
+            if (!conditionMet) {
+                state = State::releasing;
+                releaseStartSequence = sequence;
+            }
+            break;
+
+        case State::releasing:
+            if (conditionMet) {
+                state = State::capturing;
+            }
+            else if (sequence - releaseStartSequence >= static_cast<uint64_t>(postFrames)) {
+                const bool longEnough = sequence - segmentStartSequence >= static_cast<uint64_t>(minSegmentFrames);
+                pushEvent(longEnough ? Event::Type::segmentEnd : Event::Type::segmentDiscarded, sequence);
+                state = State::idle;
+            }
+            break;
+    }
+}
+
+void CaptureTrigger::pushEvent(Event::Type type, uint64_t sequence) noexcept
+{
+    // If the collector stalls long enough to fill this, the ring has overrun anyway
+    const auto scope = eventFifo.write(1);
+
+    if (scope.blockSize1 > 0)
+        events[static_cast<size_t>(scope.startIndex1)] = { type, sequence };
+}
+
+bool CaptureTrigger::popEvent(Event& event) noexcept
+{
+    const auto scope = eventFifo.read(1);
+
+    if (scope.blockSize1 == 0)
+        return false;
+
+    event = events[static_cast<size_t>(scope.startIndex1)];
+    return true;
+}
+
+juce::String CaptureTrigger::getModeName(Mode mode)
+{
+    switch (mode)
+    {
+        case Mode::manual:      return "manual";
+        case Mode::levelAbove:  return "level_above";
+        case Mode::levelBelow:  return "level_below";
+        case Mode::onset:       return "onset";
+        case Mode::bandEnergy:  return "band_energy";
+    }
+
+    return {};
+}
@@ -3,26 +3,23 @@
 
 //==============================================================================
 FXPluginEditor::FXPluginEditor(FXPluginProcessor& p)
-    : juce::AudioProcessorEditor(static_cast<juce::AudioProcessor*>(&p)), audioProcessor(p), uiInitialized(false),
-      lastUIRefreshTime(juce::Time::getMillisecondCounterHiRes())
+    : juce::AudioProcessorEditor(static_cast<juce::AudioProcessor*>(&p)), audioProcessor(p), uiInitialized(false)
 {
     try {
-        // Set up the sliders
+        // Set up the sliders; the attachments give them the parameters' ranges and values
         gainSlider.setSliderStyle(juce::Slider::SliderStyle::LinearVertical);
-        gainSlider.setRange(0.0, 1.0, 0.01);
         gainSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 90, 20);
         gainSlider.setPopupDisplayEnabled(true, false, this);
         gainSlider.setTextValueSuffix(" Gain");
-        gainSlider.addListener(this);
         addAndMakeVisible(gainSlider);
+        gainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.getParameterTree(), "gain", gainSlider);
         
         distortionSlider.setSliderStyle(juce::Slider::SliderStyle::LinearVertical);
-        distortionSlider.setRange(0.0, 1.0, 0.01);
         distortionSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 90, 20);
         distortionSlider.setPopupDisplayEnabled(true, false, this);
         distortionSlider.setTextValueSuffix(" Distortion");
-        distortionSlider.addListener(this);
         addAndMakeVisible(distortionSlider);
+        distortionAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.getParameterTree(), "distortion", distortionSlider);
         
         // Set up the record button
         recordButton.setButtonText("Start Recording");
@@ -65,27 +62,24 @@ FXPluginEditor::FXPluginEditor(FXPluginProcessor& p)
         statusLabel.setColour(juce::Label::textColourId, juce::Colours::red);
         addAndMakeVisible(statusLabel);
         
-        // Initialize sliders with current parameter values (without notification)
-        // Get parameter indexes
-        float gainValue = 0.5f;
-        float distortionValue = 0.0f;
+        // Set up the trigger mode selector; item IDs are the CaptureTrigger::Mode values + 1
+        triggerModeBox.addItem("Manual", 1);
+        triggerModeBox.addItem("Level above", 2);
+        triggerModeBox.addItem("Level below", 3);
+        triggerModeBox.addItem("Onset", 4);
+        triggerModeBox.addItem("Band energy", 5);
+        triggerModeBox.setSelectedId(static_cast<int>(audioProcessor.getTriggerSettings().mode) + 1, juce::dontSendNotification);
+        triggerModeBox.onChange = [this] { triggerModeChanged(); };
+        addAndMakeVisible(triggerModeBox);
         
-        try {
-            std::atomic<float>* gainParam = audioProcessor.getParameterValuePointer("gain");
-            if (gainParam != nullptr) {
-                gainValue = gainParam->load();
-            }
-            
-            std::atomic<float>* distortionParam = audioProcessor.getParameterValuePointer("distortion");
-            if (distortionParam != nullptr) {
-                distortionValue = distortionParam->load();
-            }
-        } catch (const std::exception& e) {
-            juce::Logger::writeToLog("Exception in parameter initialization: " + juce::String(e.what()));
-        }
-        
-        gainSlider.setValue(gainValue, juce::dontSendNotification);
-        distortionSlider.setValue(distortionValue, juce::dontSendNotification);
+        // Set up the analysis source selector; item IDs are the AnalysisSource values + 1
+        analysisSourceBox.addItem("Analyse pre-FX", 1);
+        analysisSourceBox.addItem("Analyse post-FX", 2);
+        analysisSourceBox.addItem("Analyse sidechain", 3);
+        analysisSourceBox.addItem("Post-FX minus sidechain", 4);
+        analysisSourceBox.setSelectedId(static_cast<int>(audioProcessor.getAnalysisSource()) + 1, juce::dontSendNotification);
+        analysisSourceBox.onChange = [this] { analysisSourceChanged(); };
+        addAndMakeVisible(analysisSourceBox);
         
         // Initialize with current file path
         juce::String outputFilePath = audioProcessor.getOutputFilePath();
@@ -105,9 +99,11 @@ FXPluginEditor::FXPluginEditor(FXPluginProcessor& p)
         // Set the plugin window size
         setSize (400, 300);
         
-        // UI is now initialized, start timer for updates
+        // UI is now initialized; follow the processor at the display's frame rate
         uiInitialized.store(true);
-        startTimerHz(5); // Update UI at 5Hz instead of 30Hz to reduce CPU usage
+        vBlankAttachment = juce::VBlankAttachment(this, [this](double frameTimeSeconds) {
+            updateFromSnapshot(frameTimeSeconds);
+        });
     } catch (const std::exception& e) {
         juce::Logger::writeToLog("Exception in FXPluginEditor constructor: " + juce::String(e.what()));
     }
@@ -119,8 +115,8 @@ FXPluginEditor::~FXPluginEditor()
         // Prevent UI updates during destruction
         uiInitialized.store(false);
         
-        // Stop timer
-        stopTimer();
+        // Stop display updates
+        vBlankAttachment = {};
         
         // Stop recording if active
         if (audioProcessor.isRecording()) {
@@ -146,6 +142,36 @@ void FXPluginEditor::paint(juce::Graphics& g)
         g.drawFittedText ("Gain", 30, 20, 90, 20, juce::Justification::centred, 1);
         g.drawFittedText ("Distortion", 130, 20, 90, 20, juce::Justification::centred, 1);
         g.drawFittedText ("Frequency Recording", 20, 160, 360, 20, juce::Justification::centred, 1);
+        
+        // Output meters: RMS bar with a peak line, one per channel, and the DSP load below
+        if (!meterArea.isEmpty()) {
+            auto meters = meterArea.toFloat();
+            auto loadArea = meters.removeFromBottom(16.0f);
+            const int numChannels = juce::jmax(1, snapshot.numMeterChannels);
+            const float channelWidth = meters.getWidth() / (float) numChannels;
+            
+            for (int channel = 0; channel < numChannels; ++channel) {
+                auto bar = meters.withX(meters.getX() + channel * channelWidth).withWidth(channelWidth).reduced(2.0f, 0.0f);
+                const auto toHeight = [&](float level) {
+                    return bar.getHeight() * juce::jmap(juce::jlimit(-60.0f, 0.0f, juce::Decibels::gainToDecibels(level, -60.0f)),
+                                                        -60.0f, 0.0f, 0.0f, 1.0f);
+                };
+                
+                g.setColour(juce::Colours::black);
+                g.fillRect(bar);
+                
+                g.setColour(juce::Colours::limegreen);
+                g.fillRect(bar.withTop(bar.getBottom() - toHeight(displayedRms[(size_t) channel])));
+                
+                g.setColour(displayedPeaks[(size_t) channel] >= 1.0f ? juce::Colours::red : juce::Colours::yellow);
+                g.fillRect(bar.withTop(bar.getBottom() - toHeight(displayedPeaks[(size_t) channel])).withHeight(2.0f));
+            }
+            
+            g.setColour(juce::Colours::white);
+            g.setFont(11.0f);
+            g.drawFittedText(juce::String(juce::roundToInt(displayedLoad * 100.0f)) + "%",
+                             loadArea.toNearestInt(), juce::Justification::centred, 1);
+        }
     }
     catch (const std::exception& e) {
         juce::Logger::writeToLog("Exception in paint: " + juce::String(e.what()));
@@ -169,10 +195,13 @@ void FXPluginEditor::resized()
         resetButton.setBounds(topSection.removeFromLeft(80).reduced(5));
         
         // Layout labels
+        triggerModeBox.setBounds(statusArea.removeFromRight(130).reduced(3));
+        analysisSourceBox.setBounds(pathArea.removeFromRight(130).reduced(3));
         filePathLabel.setBounds(pathArea.reduced(5));
         statusLabel.setBounds(statusArea.reduced(5));
         
-        // Layout sliders
+        // Layout meters and sliders
+        meterArea = sliderArea.removeFromRight(50).reduced(5, 10);
         gainSlider.setBounds(sliderArea.removeFromLeft(sliderArea.getWidth() / 2).reduced(10));
         distortionSlider.setBounds(sliderArea.reduced(10));
     }
@@ -181,74 +210,71 @@ void FXPluginEditor::resized()
     }
 }
 
-void FXPluginEditor::timerCallback()
+void FXPluginEditor::updateFromSnapshot(double frameTimeSeconds)
 {
     try {
-        if (!uiInitialized.load())
+        if (!uiInitialized.load() || !audioProcessor.pullEditorSnapshot(snapshot))
             return;
-            
-        auto* processor = dynamic_cast<FXPluginProcessor*>(&audioProcessor);
-        if (processor) {
-            // Update recording status if active
-            if (processor->isRecording()) {
-                static int dotCount = 0;
-                juce::String dots;
-                for (int i = 0; i < (dotCount % 4); ++i)
-                    dots += ".";
-                    
+        
+        // Update recording status if active
+        if (snapshot.isRecording) {
+            juce::String dots;
+            for (int i = 0; i < static_cast<int>(frameTimeSeconds * 5.0) % 4; ++i)
+                dots += ".";
+        
+            if (snapshot.isTriggerArmed)
+                statusLabel.setText("Armed, " + juce::String(snapshot.numCapturedSegments) + " segments" + dots, juce::dontSendNotification);
+            else
                 statusLabel.setText("Recording" + dots, juce::dontSendNotification);
-                dotCount++;
-            }
-            
-            // Update sliders with current parameter values
-            auto* gainParam = processor->getParameterValuePointer("gain");
-            auto* distortionParam = processor->getParameterValuePointer("distortion");
-            
-            if (gainParam) {
-                gainSlider.setValue(*gainParam, juce::dontSendNotification);
-            }
-            
-            if (distortionParam) {
-                distortionSlider.setValue(*distortionParam, juce::dontSendNotification);
-            }
         }
-    } catch (const std::exception& e) {
-        juce::Logger::writeToLog("Exception in timerCallback: " + juce::String(e.what()));
+        
+        // Repaint the meters only when what they show has visibly changed
+        bool metersChanged = std::abs(snapshot.processLoad - displayedLoad) >= 0.005f;
+        
+        for (size_t channel = 0; channel < displayedPeaks.size(); ++channel) {
+            metersChanged |= std::abs(snapshot.peakLevels[channel] - displayedPeaks[channel]) >= 0.001f
+                          || std::abs(snapshot.rmsLevels[channel] - displayedRms[channel]) >= 0.001f;
+        }
+        
+        if (metersChanged) {
+            displayedPeaks = snapshot.peakLevels;
+            displayedRms = snapshot.rmsLevels;
+            displayedLoad = snapshot.processLoad;
+            repaint(meterArea);
+        }
+    }
+    catch (const std::exception& e) {
+        juce::Logger::writeToLog("Exception in updateFromSnapshot: " + juce::String(e.what()));
     }
 }
 
-void FXPluginEditor::sliderValueChanged(juce::Slider* slider)
+void FXPluginEditor::triggerModeChanged()
 {
     try {
-        if (!uiInitialized.load())
-            return;
+        auto settings = audioProcessor.getTriggerSettings();
+        settings.mode = static_cast<CaptureTrigger::Mode>(juce::jmax(0, triggerModeBox.getSelectedId() - 1));
+        audioProcessor.setTriggerSettings(settings);
         
-        if (slider == &gainSlider)
-            safeSetParameter("gain", static_cast<float>(gainSlider.getValue()));
-        else if (slider == &distortionSlider)
-            safeSetParameter("distortion", static_cast<float>(distortionSlider.getValue()));
+        if (audioProcessor.isRecording())
+            statusLabel.setText("Trigger mode applies to the next recording", juce::dontSendNotification);
     }
     catch (const std::exception& e) {
-        juce::Logger::writeToLog("Exception in sliderValueChanged: " + juce::String(e.what()));
+        juce::Logger::writeToLog("Exception in triggerModeChanged: " + juce::String(e.what()));
     }
 }
 
-void FXPluginEditor::safeSetParameter(const juce::String& paramID, float value)
+void FXPluginEditor::analysisSourceChanged()
 {
     try {
-        // Get the parameter from the processor
-        auto& params = audioProcessor.getParameterTree();
-        auto* param = params.getParameter(paramID);
+        const auto source = static_cast<FXPluginProcessor::AnalysisSource>(juce::jmax(0, analysisSourceBox.getSelectedId() - 1));
+        audioProcessor.setAnalysisSource(source);
         
-        if (param != nullptr) {
-            param->setValueNotifyingHost(param->convertTo0to1(value));
-        }
-        else {
-            juce::Logger::writeToLog("Parameter not found: " + paramID);
-        }
+        if (source != FXPluginProcessor::AnalysisSource::mainPreFX && source != FXPluginProcessor::AnalysisSource::mainPostFX
+            && !audioProcessor.isSidechainConnected())
+            statusLabel.setText("No sidechain connected, it analyses as silence", juce::dontSendNotification);
     }
     catch (const std::exception& e) {
-        juce::Logger::writeToLog("Error setting parameter: " + juce::String(e.what()));
+        juce::Logger::writeToLog("Exception in analysisSourceChanged: " + juce::String(e.what()));
     }
 }
 
@@ -1,22 +1,57 @@
 #include "../include/PluginProcessor.h"
 #include "../include/PluginEditor.h"
 
+namespace {
+    // Factory bank: gain and distortion, in programParameterIDs order
+    struct FactoryProgram {
+        const char* name;
+        std::array<float, 2> values;
+    };
+    
+    constexpr std::array<FactoryProgram, FXPluginProcessor::numPrograms> factoryPrograms {{
+        { "Clean",     { 1.0f, 0.0f } },
+        { "Boost",     { 2.0f, 0.0f } },
+        { "Warm",      { 1.0f, 0.15f } },
+        { "Crunch",    { 1.0f, 0.35f } },
+        { "Overdrive", { 1.2f, 0.55f } },
+        { "Heavy",     { 1.0f, 0.75f } },
+        { "Fuzz",      { 0.8f, 1.0f } },
+        { "Trim",      { 0.5f, 0.0f } }
+    }};
+    
+    // "FXPS", little-endian, ahead of the format version
+    constexpr int stateMagic = 0x53505846;
+    
+    juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout()
+    {
+        juce::AudioProcessorValueTreeState::ParameterLayout layout;
+        layout.add(std::make_unique<juce::AudioParameterFloat> ("gain", "Gain", 0.0f, 3.0f, 1.0f),
+                   std::make_unique<juce::AudioParameterFloat> ("distortion", "Distortion", 0.0f, 1.0f, 0.0f));
+        
+        // The multiband waveshaper's bands, with the same ranges as distortion and gain
+        for (int band = 1; band <= FXPluginProcessor::maxMultibandBands; ++band) {
+            const auto number = juce::String(band);
+            layout.add(std::make_unique<juce::AudioParameterFloat> ("band" + number + "Drive", "Band " + number + " Drive", 0.0f, 1.0f, 0.0f),
+                       std::make_unique<juce::AudioParameterFloat> ("band" + number + "Gain", "Band " + number + " Gain", 0.0f, 3.0f, 1.0f));
+        }
+        
+        return layout;
+    }
+}
+
 FXPluginProcessor::FXPluginProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
      : AudioProcessor (BusesProperties()
                      #if ! JucePlugin_IsMidiEffect
                       #if ! JucePlugin_IsSynth
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                       .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                      #endif
                        ),
 #endif
-    parameters (*this, nullptr, juce::Identifier ("FXPlugin"),
-                {
-                    std::make_unique<juce::AudioParameterFloat> ("gain", "Gain", 0.0f, 3.0f, 1.0f),
-                    std::make_unique<juce::AudioParameterFloat> ("distortion", "Distortion", 0.0f, 1.0f, 0.0f)
-                }),
+    parameters (*this, nullptr, juce::Identifier ("FXPlugin"), createParameterLayout()),
     fftSize(1024),
     maxFrequency(20000.0f),
     frameDuration(0.01f),
@@ -29,10 +64,37 @@ FXPluginProcessor::FXPluginProcessor()
         gainParameter = parameters.getRawParameterValue("gain");
         distortionParameter = parameters.getRawParameterValue("distortion");
         
+        for (int band = 0; band < maxMultibandBands; ++band) {
+            bandDriveParameters[(size_t) band] = parameters.getRawParameterValue("band" + juce::String(band + 1) + "Drive");
+            bandGainParameters[(size_t) band] = parameters.getRawParameterValue("band" + juce::String(band + 1) + "Gain");
+        }
+        
+        for (int i = 0; i < numProgramParameters; ++i)
+            programParameters[(size_t) i] = parameters.getParameter(programParameterIDs[(size_t) i]);
+        
+        for (int i = 0; i < numPrograms; ++i) {
+            programs[(size_t) i].name = factoryPrograms[(size_t) i].name;
+            
+            for (size_t value = 0; value < factoryPrograms[(size_t) i].values.size(); ++value)
+                programs[(size_t) i].values[value].store(factoryPrograms[(size_t) i].values[value]);
+        }
+        
         frequencyData.clear();
         
+        analysisBands = {
+            { "sub", 20.0f, 60.0f },
+            { "low", 60.0f, 250.0f },
+            { "low_mid", 250.0f, 500.0f },
+            { "mid", 500.0f, 2000.0f },
+            { "high_mid", 2000.0f, 4000.0f },
+            { "high", 4000.0f, 10000.0f },
+            { "air", 10000.0f, 20000.0f }
+        };
+        
         setupDefaultOutputPath();
         
+        analysisPool->addClient(*this);
+        
         DBG("FXPlugin constructor completed");
     }
     catch (const std::exception& e) {
@@ -50,6 +112,8 @@ FXPluginProcessor::~FXPluginProcessor()
         stopRecording();
     }
     
+    analysisPool->removeClient(*this);
+    
     DBG("FXPlugin destructor completed");
 }
 
@@ -87,34 +151,100 @@ bool FXPluginProcessor::isMidiEffect() const
 
 double FXPluginProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return isCabinetEnabled.load() ? cabinetTailSeconds.load() : 0.0;
 }
 
 int FXPluginProcessor::getNumPrograms()
 {
-    return 1;
+    return numPrograms;
 }
 
 int FXPluginProcessor::getCurrentProgram()
 {
-    return 0;
+    return static_cast<int>(programRequest.load() & 0xff);
 }
 
 void FXPluginProcessor::setCurrentProgram (int index)
 {
+    if (!juce::isPositiveAndBelow(index, numPrograms))
+        return;
+    
+    auto request = programRequest.load();
+    
+    while (!programRequest.compare_exchange_weak(request, (((request >> 8) + 1) << 8) | static_cast<uint32_t>(index))) {}
+    
+    // Parameters notify the host under a lock, so the audio thread leaves them to
+    // housekeeping. The check takes no lock, and holds wherever the plugin was created.
+    if (juce::MessageManager::existsAndIsCurrentThread())
+        publishProgramParameters();
 }
 
 const juce::String FXPluginProcessor::getProgramName (int index)
 {
-    return {};
+    return juce::isPositiveAndBelow(index, numPrograms) ? programs[(size_t) index].name : juce::String();
 }
 
 void FXPluginProcessor::changeProgramName (int index, const juce::String& newName)
 {
+    if (juce::isPositiveAndBelow(index, numPrograms))
+        programs[(size_t) index].name = newName;
+}
+
+void FXPluginProcessor::publishProgramParameters()
+{
+    const auto request = programRequest.load();
+    
+    if (request == publishedProgramRequest.load())
+        return;
+    
+    const auto& program = programs[request & 0xff];
+    
+    for (size_t i = 0; i < programParameters.size(); ++i)
+        if (auto* parameter = programParameters[i])
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(program.values[i].load()));
+    
+    publishedProgramRequest.store(request);
 }
 
 void FXPluginProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
+    {
+        // Loading before prepare() makes the IR active from the first block
+        const juce::SpinLock::ScopedLockType lock(cabinetLock);
+        
+        if (hasPendingCabinetFile) {
+            cabinet.loadImpulseResponse(pendingCabinetFile, juce::dsp::Convolution::Stereo::yes,
+                                        juce::dsp::Convolution::Trim::yes, 0);
+            hasPendingCabinetFile = false;
+        }
+    }
+    
+    isPreparedForDouble = isUsingDoublePrecision();
+    
+    cabinetBlockSize = juce::jmax(1, samplesPerBlock);
+    cabinetConversionBuffer.setSize(isPreparedForDouble ? 2 : 0, cabinetBlockSize);
+    cabinet.prepare({ sampleRate, static_cast<juce::uint32>(cabinetBlockSize),
+                      static_cast<juce::uint32>(juce::jlimit(1, 2, getTotalNumOutputChannels())) });
+    wasCabinetEnabled = isCabinetEnabled.load();
+    
+    // A program switched to before playback is already in the parameters
+    publishProgramParameters();
+    audioProgramRequest = publishedProgramRequest.load();
+    isFollowingProgram = false;
+    gainRamp.reset(sampleRate, parameterRampSeconds);
+    distortionRamp.reset(sampleRate, parameterRampSeconds);
+    gainRamp.setCurrentAndTargetValue(gainParameter != nullptr ? gainParameter->load() : 0.0f);
+    distortionRamp.setCurrentAndTargetValue(distortionParameter != nullptr ? distortionParameter->load() : 0.0f);
+    
+    prepareWaveshaper(sampleRate, samplesPerBlock);
+    prepareLimiter(sampleRate, samplesPerBlock);
+    prepareBypassDelay(sampleRate, samplesPerBlock);
+    prepareAnalysis(sampleRate);
+    
+    meterPeaks.fill(0.0f);
+    meterMeanSquares.fill(0.0f);
+    blocksProcessed = 0;
+    loadMeasurer.reset(sampleRate, juce::jmax(1, samplesPerBlock));
 }
 
 void FXPluginProcessor::releaseResources()
@@ -134,6 +264,15 @@ bool FXPluginProcessor::isBusesLayoutSupported (const BusesLayout& layouts) cons
    #if ! JucePlugin_IsSynth
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
         return false;
+    
+    // The sidechain is only analysed, so it may be off, mono or stereo whatever the main bus is
+    if (layouts.inputBuses.size() > 1) {
+        const auto sidechain = layouts.getChannelSet(true, 1);
+        
+        if (!sidechain.isDisabled() && sidechain != juce::AudioChannelSet::mono()
+            && sidechain != juce::AudioChannelSet::stereo())
+            return false;
+    }
    #endif
 
     return true;
@@ -142,49 +281,215 @@ bool FXPluginProcessor::isBusesLayoutSupported (const BusesLayout& layouts) cons
 
 void FXPluginProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    juce::ignoreUnused(midiMessages);
+    processBlockInternal(buffer);
+}
+
+void FXPluginProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    processBlockInternal(buffer);
+}
+
+template <typename SampleType>
+void FXPluginProcessor::processBlockInternal(juce::AudioBuffer<SampleType>& buffer)
+{
+    // A block in the precision that wasn't prepared would find its stages empty
+    jassert(isPreparedForDouble == (std::is_same_v<SampleType, double>));
+    
+    // Offline renders may wait for the analysis, so only realtime blocks are checked
+    const RealtimeSanitiser::ScopedRealtime realtimeScope(!isNonRealtime());
+    const auto startMs = juce::Time::getMillisecondCounterHiRes();
     juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels  = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
+    // Only the main buses are processed; a sidechain's channels follow the main inputs
+    auto totalNumInputChannels  = getMainBusNumInputChannels();
+    auto totalNumOutputChannels = getMainBusNumOutputChannels();
 
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
+    
+    isBypassing = false;
 
     try {
-        float gain = getParameterValue("gain");
-        float distortion = getParameterValue("distortion");
+        // A new program request takes over the ramps' targets until its values have
+        // reached the parameters
+        const auto request = programRequest.load(std::memory_order_acquire);
+        
+        if (request != audioProgramRequest) {
+            audioProgramRequest = request;
+            isFollowingProgram = true;
+        }
+        
+        if (isFollowingProgram && publishedProgramRequest.load(std::memory_order_acquire) == audioProgramRequest)
+            isFollowingProgram = false;
+        
+        if (isFollowingProgram) {
+            const auto& program = programs[audioProgramRequest & 0xff];
+            gainRamp.setTargetValue(program.values[0].load(std::memory_order_relaxed));
+            distortionRamp.setTargetValue(program.values[1].load(std::memory_order_relaxed));
+        }
+        else {
+            // Cached in the constructor, so no parameter lookup by name on the audio thread
+            gainRamp.setTargetValue(gainParameter != nullptr ? gainParameter->load() : 0.0f);
+            distortionRamp.setTargetValue(distortionParameter != nullptr ? distortionParameter->load() : 0.0f);
+        }
+        
+        // Each block ramps linearly from where the last one ended
+        const int numSamples = buffer.getNumSamples();
+        const float startGain = gainRamp.getCurrentValue();
+        const float startDistortion = distortionRamp.getCurrentValue();
+        const float gain = gainRamp.skip(numSamples);
+        const float distortion = distortionRamp.skip(numSamples);
+        const auto source = analysisSource.load(std::memory_order_relaxed);
+        
+        // The buses are views onto the host's channels, so nothing is copied. The
+        // pre-FX input is analysed before it is processed in place.
+        if (source == AnalysisSource::mainPreFX)
+            analyzeAudioBlock(getBusBuffer(buffer, true, 0));
         
         for (int channel = 0; channel < totalNumInputChannels; ++channel)
         {
-            float* channelData = buffer.getWritePointer(channel);
+            SampleType* channelData = buffer.getWritePointer(channel);
             
-            for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-            {
-                channelData[sample] *= gain;
-                
-                if (distortion > 0.01f) 
-                {
-                    channelData[sample] = std::tanh(channelData[sample] * distortion * 10.0f);
-                }
-                
-                if (std::isnan(channelData[sample]) || std::isinf(channelData[sample]))
-                    channelData[sample] = 0.0f;
-            }
+            if (startGain != gain)
+                ProcessingKernels::applyGainRamp(channelData, numSamples, static_cast<SampleType>(startGain), static_cast<SampleType>(gain));
+            else
+                juce::FloatVectorOperations::multiply(channelData, static_cast<SampleType>(gain), numSamples);
+            
+            if (!useAntiAliasedWaveshaper && !useMultibandWaveshaper)
+                applyTanhWaveshaper(channelData, numSamples, startDistortion, distortion);
+            
+            ProcessingKernels::zeroNonFinite(channelData, numSamples);
         }
         
-        if (isRecordingFrequency.load()) {
-            analyzeAudioBlock(buffer);
+        if (useMultibandWaveshaper)
+            applyMultibandWaveshaper(buffer, totalNumInputChannels);
+        else if (useAntiAliasedWaveshaper)
+            applyWaveshaper(buffer, totalNumInputChannels, startDistortion, distortion);
+        
+        applyCabinet(buffer, juce::jmin(totalNumInputChannels, 2));
+        applyLimiter(buffer, totalNumOutputChannels);
+        
+        if (source == AnalysisSource::mainPostFX) {
+            analyzeAudioBlock(getBusBuffer(buffer, false, 0));
+        }
+        else if (source != AnalysisSource::mainPreFX) {
+            // An absent or disabled sidechain reads as silence
+            const auto sidechain = getBusCount(true) > 1 ? getBusBuffer(buffer, true, 1)
+                                                         : juce::AudioBuffer<SampleType>(buffer.getArrayOfWritePointers(), 0, buffer.getNumSamples());
+            
+            if (source == AnalysisSource::sidechain)
+                analyzeAudioBlock(sidechain);
+            else
+                analyzeAudioBlock(getBusBuffer(buffer, false, 0), &sidechain);
         }
     }
     catch (const std::exception& e) {
-        juce::Logger::writeToLog("Error in processBlock: " + juce::String(e.what()));
+        realtimeLog.post(RealtimeLog::Code::processBlockException, e.what());
     }
     catch (...) {
-        juce::Logger::writeToLog("Unknown error in processBlock");
+        realtimeLog.post(RealtimeLog::Code::processBlockUnknownException);
+    }
+    
+    if (buffer.getNumSamples() > 0)
+        loadMeasurer.registerRenderTime(juce::Time::getMillisecondCounterHiRes() - startMs, buffer.getNumSamples());
+    
+    publishEditorSnapshot(buffer, juce::jmin(totalNumOutputChannels, EditorSnapshot::maxMeterChannels));
+}
+
+template <typename SampleType>
+void FXPluginProcessor::publishEditorSnapshot(const juce::AudioBuffer<SampleType>& buffer, int numChannels)
+{
+    const int numSamples = buffer.getNumSamples();
+    const double sampleRate = getSampleRate();
+    
+    // One-pole release over the block, so a peak between two display frames still shows
+    const float release = sampleRate > 0.0
+        ? static_cast<float>(std::exp(-numSamples / (meterReleaseSeconds * sampleRate)))
+        : 0.0f;
+    
+    auto& snapshot = editorSnapshots.getWriteBuffer();
+    snapshot.numMeterChannels = numChannels;
+    
+    for (int channel = 0; channel < EditorSnapshot::maxMeterChannels; ++channel) {
+        if (channel < numChannels && numSamples > 0) {
+            const auto blockPeak = static_cast<float>(buffer.getMagnitude(channel, 0, numSamples));
+            const auto blockRms = static_cast<float>(buffer.getRMSLevel(channel, 0, numSamples));
+            
+            meterPeaks[(size_t) channel] = juce::jmax(blockPeak, meterPeaks[(size_t) channel] * release);
+            meterMeanSquares[(size_t) channel] = blockRms * blockRms
+                + (meterMeanSquares[(size_t) channel] - blockRms * blockRms) * release;
+        }
+        
+        snapshot.peakLevels[(size_t) channel] = channel < numChannels ? meterPeaks[(size_t) channel] : 0.0f;
+        snapshot.rmsLevels[(size_t) channel] = channel < numChannels ? std::sqrt(meterMeanSquares[(size_t) channel]) : 0.0f;
     }
+    
+    snapshot.gain = gainParameter != nullptr ? gainParameter->load(std::memory_order_relaxed) : 0.0f;
+    snapshot.distortion = distortionParameter != nullptr ? distortionParameter->load(std::memory_order_relaxed) : 0.0f;
+    
+    snapshot.isRecording = isRecordingFrequency.load(std::memory_order_relaxed);
+    snapshot.isTriggerArmed = isTriggerArmed.load(std::memory_order_relaxed);
+    snapshot.numCapturedSegments = numCapturedSegments.load(std::memory_order_relaxed);
+    
+    snapshot.blocksProcessed = ++blocksProcessed;
+    snapshot.samplesProcessed = samplesProcessed.load(std::memory_order_relaxed);
+    snapshot.analysisFramesWritten = analysisRing.getWriteSequence();
+    snapshot.droppedAnalysisHops = droppedAnalysisHops.load(std::memory_order_relaxed);
+    
+    snapshot.processLoad = static_cast<float>(loadMeasurer.getLoadAsProportion());
+    snapshot.numOverruns = loadMeasurer.getXRunCount();
+    
+    editorSnapshots.publish();
+}
+
+bool FXPluginProcessor::pullEditorSnapshot(EditorSnapshot& destination) noexcept
+{
+    if (!editorSnapshots.update())
+        return false;
+    
+    destination = editorSnapshots.getReadBuffer();
+    return true;
 }
 
 void FXPluginProcessor::processBlockBypassed(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    juce::ignoreUnused(midiMessages);
+    processBlockBypassedInternal(buffer);
+}
+
+void FXPluginProcessor::processBlockBypassed(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    processBlockBypassedInternal(buffer);
+}
+
+template <typename SampleType>
+void FXPluginProcessor::processBlockBypassedInternal(juce::AudioBuffer<SampleType>& buffer)
+{
+    jassert(isPreparedForDouble == (std::is_same_v<SampleType, double>));
+    
+    const RealtimeSanitiser::ScopedRealtime realtimeScope(!isNonRealtime());
+    const auto totalNumInputChannels = getMainBusNumInputChannels();
+    const auto totalNumOutputChannels = getMainBusNumOutputChannels();
+    
+    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+        buffer.clear(i, 0, buffer.getNumSamples());
+    
+    auto& delay = getStages<SampleType>().bypassDelay;
+    
+    // Whatever was in the delay is from the last time bypass was on
+    if (!isBypassing) {
+        delay.reset();
+        isBypassing = true;
+    }
+    
+    if (getLatencySamples() == 0 || totalNumOutputChannels == 0)
+        return;
+    
+    juce::dsp::AudioBlock<SampleType> block(buffer.getArrayOfWritePointers(), static_cast<size_t>(totalNumOutputChannels),
+                                            static_cast<size_t>(buffer.getNumSamples()));
+    delay.process(juce::dsp::ProcessContextReplacing<SampleType>(block));
 }
 
 bool FXPluginProcessor::hasEditor() const
@@ -199,18 +504,86 @@ juce::AudioProcessorEditor* FXPluginProcessor::createEditor()
 
 void FXPluginProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    auto state = parameters.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    // Parameters are written by ID and value, so a later version can add, remove
+    // or reorder them and still read this
+    juce::MemoryOutputStream stream(destData, false);
+    stream.writeInt(stateMagic);
+    stream.writeInt(stateFormatVersion);
+    
+    const auto& allParameters = getParameters();
+    stream.writeInt(allParameters.size());
+    
+    for (auto* parameter : allParameters) {
+        auto* ranged = static_cast<juce::RangedAudioParameter*>(parameter);
+        stream.writeString(ranged->getParameterID());
+        stream.writeFloat(ranged->convertFrom0to1(ranged->getValue()));
+    }
+    
+    stream.writeInt(getCurrentProgram());
+    stream.writeInt(numPrograms);
+    stream.writeInt(numProgramParameters);
+    
+    for (const auto& program : programs) {
+        stream.writeString(program.name);
+        
+        for (const auto& value : program.values)
+            stream.writeFloat(value.load());
+    }
 }
 
 void FXPluginProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
+    juce::MemoryInputStream stream(data, static_cast<size_t>(juce::jmax(0, sizeInBytes)), false);
+    
+    if (sizeInBytes < 8 || stream.readInt() != stateMagic) {
+        // Written as XML by an earlier version
+        std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
+        
+        if (xmlState.get() != nullptr)
+            if (xmlState->hasTagName(parameters.state.getType()))
+                parameters.replaceState(juce::ValueTree::fromXml(*xmlState));
+        
+        return;
+    }
+    
+    if (stream.readInt() > stateFormatVersion)
+        return;
+    
+    const int numSavedParameters = stream.readInt();
+    
+    for (int i = 0; i < numSavedParameters && !stream.isExhausted(); ++i) {
+        const auto parameterID = stream.readString();
+        const float value = stream.readFloat();
+        
+        if (auto* parameter = parameters.getParameter(parameterID))
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
     
-    if (xmlState.get() != nullptr)
-        if (xmlState->hasTagName(parameters.state.getType()))
-            parameters.replaceState(juce::ValueTree::fromXml(*xmlState));
+    const int savedProgram = stream.readInt();
+    const int numSavedPrograms = stream.readInt();
+    const int numSavedProgramValues = stream.readInt();
+    
+    for (int i = 0; i < numSavedPrograms && !stream.isExhausted(); ++i) {
+        const auto name = stream.readString();
+        
+        for (int value = 0; value < numSavedProgramValues; ++value) {
+            const float savedValue = stream.readFloat();
+            
+            if (i < numPrograms && value < numProgramParameters)
+                programs[(size_t) i].values[(size_t) value].store(savedValue);
+        }
+        
+        if (i < numPrograms)
+            programs[(size_t) i].name = name;
+    }
+    
+    // The parameters already hold the program's values, as edited since, so the
+    // switch is marked as published rather than requested
+    if (juce::isPositiveAndBelow(savedProgram, numPrograms)) {
+        const auto request = (((programRequest.load() >> 8) + 1) << 8) | static_cast<uint32_t>(savedProgram);
+        publishedProgramRequest.store(request);
+        programRequest.store(request);
+    }
 }
 
 float* FXPluginProcessor::getRawParameterValue(const juce::String& parameterID)
@@ -248,11 +621,56 @@ void FXPluginProcessor::startRecording()
         }
         
         frequencyData.clear();
+        capturedSegments.clear();
+        numCapturedSegments.store(0);
+        isSegmentOpen = false;
+        
+        const double now = getSessionSeconds();
+        
+        if (triggerSettings.mode != CaptureTrigger::Mode::manual) {
+            // Arm the trigger; segments pick up their own pre window from the ring
+            captureTrigger.prepare(triggerSettings, frameDuration);
+            
+            const auto& band = analysisBands[(size_t) juce::jlimit(0, (int) analysisBands.size() - 1, triggerSettings.bandIndex)];
+            triggerMinBin = getAnalysisBin(band.minFreq);
+            triggerMaxBin = getAnalysisBin(band.maxFreq);
+            
+            recordingStartTime = now;
+            preRollDuration = 0.0;
+            collectedSequence.store(analysisRing.getWriteSequence());
+            isTriggerArmed.store(true);
+            isRecordingFrequency.store(true);
+            
+            DBG("Armed " + CaptureTrigger::getModeName(triggerSettings.mode) + " trigger, segments go next to: " + outputFilePath);
+            return;
+        }
+        
+        // Start from the oldest frame still inside the pre-roll window, so the
+        // recording's time axis begins there rather than at the button press
+        const auto written = analysisRing.getWriteSequence();
+        const auto preRollFrames = static_cast<uint64_t>(preRollSeconds.load() / frameDuration);
         
-        recordingStartTime = juce::Time::getMillisecondCounterHiRes() * 0.001;
+        recordReadSequence = juce::jmax(analysisRing.getOldestSequence(),
+                                        written - juce::jmin(written, preRollFrames));
+        recordingStartTime = now;
+        
+        AnalysisTimestamp oldest;
+        std::vector<float> unused;
+        while (recordReadSequence < written) {
+            if (analysisRing.read(recordReadSequence, oldest, unused)) {
+                recordingStartTime = juce::jmin(now, oldest.sessionSeconds);
+                break;
+            }
+            ++recordReadSequence;
+        }
+        
+        collectedSequence.store(recordReadSequence);
+        
+        preRollDuration = now - recordingStartTime;
         isRecordingFrequency.store(true);
         
-        DBG("Started recording frequency data to: " + outputFilePath);
+        DBG("Started recording frequency data to: " + outputFilePath
+            + " with " + juce::String(preRollDuration, 2) + "s pre-roll");
     }
     catch (const std::exception& e) {
         DBG("Exception in startRecording: " + juce::String(e.what()));
@@ -272,9 +690,19 @@ void FXPluginProcessor::stopRecording()
             return;
         }
         
+        waitForPendingAnalysisJobs();
+        collectRecordedFrames();
         isRecordingFrequency.store(false);
         
-        if (!frequencyData.empty()) {
+        if (isTriggerArmed.exchange(false)) {
+            // Keep a segment that was still open if it is long enough
+            const auto minFrames = static_cast<size_t>(triggerSettings.minSegmentSeconds / frameDuration);
+            if (isSegmentOpen && frequencyData.size() >= minFrames)
+                finishSegment();
+            
+            DBG("Trigger disarmed after " + juce::String((int) capturedSegments.size()) + " segments");
+            resetRecordingState();
+        } else if (!frequencyData.empty()) {
             bool success = saveFrequencyData();
             resetRecordingState();
         } else {
@@ -297,6 +725,8 @@ void FXPluginProcessor::resetRecordingState()
     frequencyData.clear();
     
     recordingStartTime = 0.0;
+    preRollDuration = 0.0;
+    isSegmentOpen = false;
     
     setupDefaultOutputPath();
     
@@ -327,185 +757,710 @@ float FXPluginProcessor::getParameterValue(const juce::String& paramID)
         if (parameter != nullptr) {
             return parameter->load();
         }
-        juce::Logger::writeToLog("Parameter not found: " + paramID);
+        realtimeLog.post(RealtimeLog::Code::parameterNotFound, paramID.toRawUTF8());
         return 0.0f;
     }
     catch (const std::exception& e) {
-        juce::Logger::writeToLog("Error getting parameter " + paramID + ": " + e.what());
+        realtimeLog.post(RealtimeLog::Code::parameterException, e.what());
         return 0.0f;
     }
 }
 
-void FXPluginProcessor::analyzeAudioBlock(const juce::AudioBuffer<float>& buffer)
+void FXPluginProcessor::prepareAnalysis(double sampleRate)
+{
+    // A worker may still be finishing jobs from before the audio thread stopped
+    analysisPool->waitUntilIdle(*this);
+    
+    const juce::ScopedLock lock(recordingMutex);
+    
+    const int maxBins = fftSize / 2;
+    
+    fft = std::make_unique<juce::dsp::FFT>(static_cast<int>(std::log2(fftSize)));
+    fftBuffer.assign(static_cast<size_t>(fftSize), 0.0f);
+    previousMagnitudes.assign(static_cast<size_t>(maxBins), 0.0f);
+    spectralFluxAverage = 0.0f;
+    
+    hannWindow.resize(static_cast<size_t>(fftSize));
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(hannWindow.data(), static_cast<size_t>(fftSize),
+                                                             juce::dsp::WindowingFunction<float>::hann, false);
+    
+    analysisHistory.assign(static_cast<size_t>(fftSize), 0.0f);
+    analysisJobSamples.assign(static_cast<size_t>(maxPendingAnalysisJobs * fftSize), 0.0f);
+    analysisJobFifo.reset();
+    historyWritePosition = 0;
+    analysisSampleRate = sampleRate;
+    hopSize = juce::jmax(1, juce::roundToInt(frameDuration * sampleRate));
+    samplesUntilNextHop = hopSize;
+    samplesProcessed.store(0);
+    
+    // Watch frequencies the sample rate can represent, up to the limit
+    watchedFrequencies.clear();
+    for (auto frequency : watchSettingsFrequencies)
+        if (frequency >= 0.0f && frequency <= sampleRate / 2.0 && static_cast<int>(watchedFrequencies.size()) < maxWatchedFrequencies)
+            watchedFrequencies.push_back(frequency);
+    
+    const int numWatched = static_cast<int>(watchedFrequencies.size());
+    const int watchWindowLength = juce::jmax(1, juce::roundToInt(sampleRate / watchSettingsResolutionHz));
+    watchBank.prepare(sampleRate, numWatched, watchWindowLength);
+    watchBank.setFrequencies(watchedFrequencies.data(), numWatched, watchWindowLength);
+    
+    constantQ.reset();
+    analysisJobOctaveFrames.clear();
+    constantQFramePointers.clear();
+    int numConstantQBins = 0;
+    
+    if (constantQSettingsBinsPerOctave > 0 && constantQSettingsMinFrequency < 0.45 * sampleRate) {
+        juce::dsp::ConstantQTransform::Parameters cqParameters;
+        cqParameters.sampleRate = sampleRate;
+        cqParameters.minFrequency = constantQSettingsMinFrequency;
+        cqParameters.maxFrequency = juce::jmax(maxFrequency, 2.0f * constantQSettingsMinFrequency);
+        cqParameters.binsPerOctave = constantQSettingsBinsPerOctave;
+        constantQ = std::make_unique<juce::dsp::ConstantQTransform>(cqParameters);
+        
+        const int octaveSamples = constantQ->getNumOctaves() * constantQ->getFrameSize();
+        analysisJobOctaveFrames.assign(static_cast<size_t>(maxPendingAnalysisJobs * octaveSamples), 0.0f);
+        constantQFramePointers.resize(static_cast<size_t>(constantQ->getNumOctaves()));
+        numConstantQBins = constantQ->getNumBins();
+    }
+    
+    numLimiterValues = useLimiter ? valuesPerLimiterFrame : 0;
+    const int numExtraValues = numWatched * valuesPerWatchedFrequency + numConstantQBins + numLimiterValues;
+    analysisChunk.assign(static_cast<size_t>(hopSize), 0.0f);
+    analysisJobExtraValues.assign(static_cast<size_t>(maxPendingAnalysisJobs * numExtraValues), 0.0f);
+    
+    // Pre-roll frames plus one second of headroom for the collector thread
+    const int preRollFrames = static_cast<int>(std::ceil(preRollSeconds.load() / frameDuration));
+    const int headroomFrames = static_cast<int>(std::ceil(1.0 / frameDuration));
+    analysisRing.prepare(preRollFrames + headroomFrames, maxBins, numExtraValues);
+    recordReadSequence = 0;
+    collectedSequence.store(0);
+}
+
+double FXPluginProcessor::getSessionSeconds() const
+{
+    return analysisSampleRate > 0.0 ? static_cast<double>(samplesProcessed.load()) / analysisSampleRate : 0.0;
+}
+
+int FXPluginProcessor::getAnalysisBin(float frequencyHz) const noexcept
+{
+    // Real-FFT bins are sampleRate / fftSize apart, up to Nyquist at fftSize / 2
+    if (analysisSampleRate <= 0.0)
+        return 0;
+    
+    return juce::jlimit(0, fftSize / 2 - 1, static_cast<int>(frequencyHz * fftSize / analysisSampleRate));
+}
+
+template <typename SampleType>
+void FXPluginProcessor::analyzeAudioBlock(const juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>* subtracted)
 {
     try {
-        if (!isRecordingFrequency.load())
+        if (fft == nullptr || analysisRing.getCapacity() == 0 || analysisSampleRate <= 0.0)
             return;
-            
-        const double currentTime = juce::Time::getMillisecondCounterHiRes() * 0.001;
-        const double recordingTime = currentTime - recordingStartTime;
         
-        static double lastFrameTime = 0.0;
-        if (recordingTime - lastFrameTime < frameDuration) 
-            return;
-            
-        lastFrameTime = recordingTime;
+        const int numSamples = buffer.getNumSamples();
+        const int totalChannels = buffer.getNumChannels();
+        const int subtractedChannels = subtracted != nullptr ? subtracted->getNumChannels() : 0;
         
-        juce::dsp::FFT fft(std::log2(fftSize));
+        // Offline bounces analyse every hop; in realtime only the newest hop of a block is
+        // analysed so a large block can't cost several FFTs on the audio thread
+        const bool analyseEveryHop = isNonRealtime();
+        const bool watching = watchBank.getNumFrequencies() > 0;
         
-        std::vector<float> window(fftSize * 2, 0.0f);
+        // Project position of the first sample in this block, if the host has one
+        juce::Optional<juce::AudioPlayHead::PositionInfo> position;
+        if (auto* playHead = getPlayHead())
+            position = playHead->getPosition();
         
-        int totalChannels = buffer.getNumChannels();
-        if (totalChannels > 0) {
-            int numSamples = juce::jmin(buffer.getNumSamples(), fftSize);
+        int blockPosition = 0;
+        while (blockPosition < numSamples) {
+            const int chunk = juce::jmin(numSamples - blockPosition, samplesUntilNextHop);
+            
+            // Mixed down in the buffer's precision, then kept as float like the FFT
+            ProcessingKernels::mixToMono(buffer.getArrayOfReadPointers(), totalChannels,
+                                         subtracted != nullptr ? subtracted->getArrayOfReadPointers() : nullptr, subtractedChannels,
+                                         blockPosition, analysisChunk.data(), chunk);
+            
+            // A hop can be longer than the window, in which case only its end is kept
+            const int kept = juce::jmin(chunk, fftSize);
+            const auto keptStart = analysisChunk.begin() + (chunk - kept);
+            historyWritePosition = (historyWritePosition + chunk - kept) % fftSize;
+            
+            const int firstPart = juce::jmin(kept, fftSize - historyWritePosition);
+            std::copy(keptStart, keptStart + firstPart, analysisHistory.begin() + historyWritePosition);
+            std::copy(keptStart + firstPart, keptStart + kept, analysisHistory.begin());
+            historyWritePosition = (historyWritePosition + kept) % fftSize;
+            
+            // Watch frequencies and the constant-Q octaves see every sample, including
+            // hops that aren't analysed
+            if (watching)
+                watchBank.process(analysisChunk.data(), chunk);
+            
+            if (constantQ != nullptr)
+                constantQ->pushSamples(analysisChunk.data(), chunk);
+            
+            blockPosition += chunk;
+            samplesUntilNextHop -= chunk;
+            const auto frameEndSample = samplesProcessed.load(std::memory_order_relaxed) + chunk;
+            samplesProcessed.store(frameEndSample, std::memory_order_relaxed);
             
-            if (totalChannels == 1) {
-                const float* channelData = buffer.getReadPointer(0);
-                for (int i = 0; i < numSamples; ++i) {
-                    float hannFactor = 0.5f * (1.0f - std::cos(2.0f * M_PI * i / (numSamples - 1)));
-                    window[i] = channelData[i] * hannFactor;
+            if (samplesUntilNextHop > 0)
+                break;
+            
+            samplesUntilNextHop = hopSize;
+            
+            if (!analyseEveryHop && numSamples - blockPosition >= hopSize)
+                continue;
+            
+            AnalysisTimestamp timestamp;
+            timestamp.sessionSeconds = static_cast<double>(frameEndSample) / analysisSampleRate;
+            
+            if (position.hasValue()) {
+                if (auto timeInSamples = position->getTimeInSamples()) {
+                    timestamp.projectSamples = *timeInSamples + blockPosition;
+                    timestamp.projectSeconds = static_cast<double>(timestamp.projectSamples) / analysisSampleRate;
+                    timestamp.hasProjectPosition = true;
                 }
-            } else {
-                for (int i = 0; i < numSamples; ++i) {
-                    float sum = 0.0f;
-                    for (int channel = 0; channel < totalChannels; ++channel) {
-                        sum += buffer.getSample(channel, i);
+                
+                if (auto ppq = position->getPpqPosition()) {
+                    const double bpm = position->getBpm().orFallback(120.0);
+                    timestamp.ppqPosition = *ppq + (blockPosition / analysisSampleRate) * bpm / 60.0;
+                    timestamp.hasMusicalPosition = true;
+                    
+                    if (auto barCount = position->getBarCount()) {
+                        const auto signature = position->getTimeSignature().orFallback(juce::AudioPlayHead::TimeSignature());
+                        const double quartersPerBar = signature.numerator * 4.0 / juce::jmax(1, signature.denominator);
+                        const double barStart = position->getPpqPositionOfLastBarStart().orFallback(*ppq);
+                        timestamp.bar = *barCount + static_cast<juce::int64>(std::floor((timestamp.ppqPosition - barStart) / quartersPerBar));
                     }
-                    float hannFactor = 0.5f * (1.0f - std::cos(2.0f * M_PI * i / (numSamples - 1)));
-                    window[i] = (sum / totalChannels) * hannFactor;
                 }
             }
-        }
-        
-        fft.performFrequencyOnlyForwardTransform(window.data());
-        
-        FrequencyFrame frame;
-        frame.timeSeconds = recordingTime;
-        
-        const float binWidth = (getSampleRate() / 2.0f) / fftSize;
-        const int numBinsToInclude = juce::jmin(
-            fftSize / 2,
-            static_cast<int>(maxFrequency / binWidth)
-        );
-        
-        frame.magnitudes.resize(numBinsToInclude);
-        for (int i = 0; i < numBinsToInclude; ++i) {
-            for (int i = 0; i < numBinsToInclude; ++i) {
-                // Convert raw FFT magnitude to dBFS without the extra 1 / fftSize attenuation
-                float mag = window[i];
-                if (mag <= 0.0f)
-                    mag = 1.0e-12f;        // avoid log(0) -> -inf
-                frame.magnitudes[i] = juce::Decibels::gainToDecibels(mag);
-            }
-        }
-        
-        {
-            const juce::ScopedLock lock(recordingMutex);
-            frequencyData.push_back(frame);
+            
+            submitAnalysisJob(timestamp);
         }
     }
     catch (const std::exception& e) {
-        DBG("Exception in analyzeAudioBlock: " + juce::String(e.what()));
+        realtimeLog.post(RealtimeLog::Code::analysisException, e.what());
     }
     catch (...) {
-        DBG("Unknown exception in analyzeAudioBlock");
+        realtimeLog.post(RealtimeLog::Code::analysisUnknownException);
     }
 }
 
-bool FXPluginProcessor::saveFrequencyData()
+void FXPluginProcessor::submitAnalysisJob(const AnalysisTimestamp& timestamp)
 {
-    try {
-        const juce::ScopedLock lock(recordingMutex);
-        
-        if (frequencyData.empty()) {
-            DBG("No frequency data to save");
-            return false;
-        }
-        
-        if (outputFilePath.isEmpty()) {
-            DBG("No output file path set");
-            return false;
-        }
-        
-        juce::File outputFile(outputFilePath);
-        if (!outputFile.getFileName().endsWithIgnoreCase(".json")) {
-            outputFile = outputFile.withFileExtension("json");
-            outputFilePath = outputFile.getFullPathName();
-        }
-        
-        if (auto parentDir = outputFile.getParentDirectory(); !parentDir.exists()) {
-            parentDir.createDirectory();
+    const bool offline = isNonRealtime();
+    
+    if (analysisJobFifo.getFreeSpace() == 0) {
+        // In realtime, drop the hop rather than wait for a busy pool
+        if (!offline) {
+            const auto dropped = droppedAnalysisHops.fetch_add(1, std::memory_order_relaxed) + 1;
+            realtimeLog.post(RealtimeLog::Code::analysisHopDropped, nullptr, static_cast<juce::int64>(dropped));
+            return;
         }
         
-        juce::FileOutputStream stream(outputFile);
-        if (stream.failedToOpen()) {
-            DBG("Failed to open file for writing: " + outputFilePath);
-            return false;
+        while (analysisJobFifo.getFreeSpace() == 0) {
+            analysisPool->schedule(*this);
+            juce::Thread::yield();
         }
+    }
+    
+    if (offline)
+        waitForRecordingCollector(analysisRing.getWriteSequence() + static_cast<uint64_t>(analysisJobFifo.getNumReady()));
+    
+    {
+        const auto scope = analysisJobFifo.write(1);
         
-        struct FrequencyBand {
-            juce::String name;
-            float minFreq;
-            float maxFreq;
-        };
-        
-        const std::vector<FrequencyBand> bands = {
-            { "sub", 20.0f, 60.0f },
-            { "low", 60.0f, 250.0f },
-            { "low_mid", 250.0f, 500.0f },
-            { "mid", 500.0f, 2000.0f },
-            { "high_mid", 2000.0f, 4000.0f },
-            { "high", 4000.0f, 10000.0f },
-            { "air", 10000.0f, 20000.0f }
-        };
-        
-        juce::String json = "{\n";
-        
-        json += "  \"sample_rate\": " + juce::String(getSampleRate()) + ",\n";
-        json += "  \"bit_depth\": 32,\n";
-        json += "  \"frame_duration_sec\": " + juce::String(frameDuration) + ",\n";
-        
-        json += "  \"analysis\": [\n";
-        
-        auto calculateBandEnergy = [this](const FrequencyFrame& frame, float minFreq, float maxFreq) -> float {
-            const float binWidth = (getSampleRate() / 2.0f) / fftSize;
-            int minBin = static_cast<int>(minFreq / binWidth);
-            int maxBin = static_cast<int>(maxFreq / binWidth);
+        if (scope.blockSize1 > 0) {
+            // Unroll the history so the oldest sample lands at index 0
+            auto* destination = analysisJobSamples.data() + scope.startIndex1 * fftSize;
+            const int tail = fftSize - historyWritePosition;
+            std::copy(analysisHistory.begin() + historyWritePosition, analysisHistory.end(), destination);
+            std::copy(analysisHistory.begin(), analysisHistory.begin() + historyWritePosition, destination + tail);
+            analysisJobTimestamps[static_cast<size_t>(scope.startIndex1)] = timestamp;
             
-            minBin = juce::jlimit(0, static_cast<int>(frame.magnitudes.size()) - 1, minBin);
-            maxBin = juce::jlimit(0, static_cast<int>(frame.magnitudes.size()) - 1, maxBin);
+            // Watch levels at the end of the hop, with peaks over every hop since the last job
+            const int numWatched = watchBank.getNumFrequencies();
+            auto* watch = analysisJobExtraValues.data() + scope.startIndex1 * analysisRing.getNumExtraValues();
             
-            float totalEnergy = 0.0f;
-            for (int i = minBin; i <= maxBin; ++i) {
-                totalEnergy += std::pow(10.0f, frame.magnitudes[i] / 10.0f);
+            for (int i = 0; i < numWatched; ++i) {
+                watch[i * valuesPerWatchedFrequency] = watchBank.getPower(i);
+                watch[i * valuesPerWatchedFrequency + 1] = watchBank.getPeakPower(i);
+                watch[i * valuesPerWatchedFrequency + 2] = static_cast<float>(watchBank.getSamplesSincePeak(i));
             }
             
-            if (totalEnergy > 0.0f) {
-                return 10.0f * std::log10(totalEnergy);
-            }
-            return -100.0f;
-        };
-        
-        auto findPeakFrequency = [this](const FrequencyFrame& frame) -> float {
-            if (frame.magnitudes.empty()) {
-                return 0.0f;
+            watchBank.resetPeaks();
+            
+            // Limiter gain reduction goes last, after the constant-Q bins
+            if (numLimiterValues > 0) {
+                auto* limiterValues = watch + analysisRing.getNumExtraValues() - numLimiterValues;
+                std::tie(limiterValues[0], limiterValues[1]) = takeLimiterGainReduction();
             }
             
-            const float binWidth = (getSampleRate() / 2.0f) / fftSize;
+            if (constantQ != nullptr) {
+                const int frameSize = constantQ->getFrameSize();
+                auto* octaves = analysisJobOctaveFrames.data() + scope.startIndex1 * constantQ->getNumOctaves() * frameSize;
+                
+                for (int octave = 0; octave < constantQ->getNumOctaves(); ++octave)
+                    constantQ->copyOctaveFrame(octave, octaves + octave * frameSize);
+            }
+        }
+    }
+    
+    analysisPool->schedule(*this);
+}
+
+void FXPluginProcessor::runAnalysisJobs(int maxJobs)
+{
+    for (int i = 0; i < maxJobs; ++i) {
+        const auto scope = analysisJobFifo.read(1);
+        
+        if (scope.blockSize1 == 0)
+            return;
+        
+        const auto* source = analysisJobSamples.data() + scope.startIndex1 * fftSize;
+        auto* extraValues = analysisJobExtraValues.data() + scope.startIndex1 * analysisRing.getNumExtraValues();
+        
+        // Constant-Q power goes after the watch values, straight into the job's slot
+        if (constantQ != nullptr) {
+            const int frameSize = constantQ->getFrameSize();
+            const auto* octaves = analysisJobOctaveFrames.data() + scope.startIndex1 * constantQ->getNumOctaves() * frameSize;
             
-            int peakBin = 0;
-            float peakMagnitude = frame.magnitudes[0];
+            for (size_t octave = 0; octave < constantQFramePointers.size(); ++octave)
+                constantQFramePointers[octave] = octaves + static_cast<int>(octave) * frameSize;
             
-            for (int i = 1; i < frame.magnitudes.size(); ++i) {
-                if (frame.magnitudes[i] > peakMagnitude) {
-                    peakMagnitude = frame.magnitudes[i];
-                    peakBin = i;
+            constantQ->performOnFrames(constantQFramePointers.data(),
+                                       extraValues + watchBank.getNumFrequencies() * valuesPerWatchedFrequency);
+        }
+        
+        juce::FloatVectorOperations::multiply(fftBuffer.data(), source, hannWindow.data(), fftSize);
+        analyzeFrame(analysisJobTimestamps[static_cast<size_t>(scope.startIndex1)], extraValues);
+    }
+}
+
+bool FXPluginProcessor::hasPendingAnalysisJobs() const noexcept
+{
+    return analysisJobFifo.getNumReady() > 0;
+}
+
+void FXPluginProcessor::performHousekeeping()
+{
+    publishProgramParameters();
+    collectRecordedFrames();
+}
+
+void FXPluginProcessor::waitForPendingAnalysisJobs()
+{
+    // A job is only released from the FIFO once its frame is in the ring
+    for (int i = 0; i < 200 && hasPendingAnalysisJobs(); ++i)
+        juce::Thread::sleep(1);
+}
+
+AnalysisWorkerPool::Stats FXPluginProcessor::getAnalysisPoolStats()
+{
+    return analysisPool->getStats();
+}
+
+uint64_t FXPluginProcessor::getNumDroppedAnalysisHops() const
+{
+    return droppedAnalysisHops.load();
+}
+
+void FXPluginProcessor::setAnalysisSource(AnalysisSource source)
+{
+    analysisSource.store(source);
+}
+
+FXPluginProcessor::AnalysisSource FXPluginProcessor::getAnalysisSource() const
+{
+    return analysisSource.load();
+}
+
+bool FXPluginProcessor::isSidechainConnected() const
+{
+    const auto* bus = getBus(true, 1);
+    return bus != nullptr && bus->isEnabled() && bus->getNumberOfChannels() > 0;
+}
+
+uint64_t FXPluginProcessor::getNumDroppedLogRecords() const
+{
+    return realtimeLog.getNumDropped() + realtimeLog.getNumSuppressed();
+}
+
+void FXPluginProcessor::analyzeFrame(const AnalysisTimestamp& timestamp, const float* extraValues)
+{
+    // Runs on a pool worker, one job at a time per instance; fftBuffer holds the
+    // windowed frame and is overwritten with its power spectrum
+    fft->performPowerSpectrumForwardTransform(fftBuffer.data(), fftBuffer.data());
+    
+    const int numBinsToInclude = juce::jmin(static_cast<int>(previousMagnitudes.size()), getAnalysisBin(maxFrequency));
+    
+    const bool evaluateTrigger = isTriggerArmed.load();
+    float totalEnergy = 0.0f;
+    float bandEnergy = 0.0f;
+    float spectralFlux = 0.0f;
+    
+    if (evaluateTrigger) {
+        totalEnergy = juce::FloatVectorOperations::sum(fftBuffer.data(), numBinsToInclude);
+        
+        const int bandEnd = juce::jmin(triggerMaxBin, numBinsToInclude - 1);
+        if (bandEnd >= triggerMinBin)
+            bandEnergy = juce::FloatVectorOperations::sum(fftBuffer.data() + triggerMinBin, bandEnd - triggerMinBin + 1);
+        
+        for (int i = 0; i < numBinsToInclude; ++i) {
+            // Onsets are detected on magnitude, so this is the only square root left
+            const float mag = std::sqrt(fftBuffer[i]);
+            spectralFlux += juce::jmax(0.0f, mag - previousMagnitudes[i]);
+            previousMagnitudes[i] = mag;
+        }
+    }
+    
+    // Frames carry raw power (no 1 / fftSize attenuation) and only per-frame results
+    // are converted to dB, with each bin clipped at the same -100 dB as before
+    juce::FloatVectorOperations::max(fftBuffer.data(), fftBuffer.data(), minimumBinPower, numBinsToInclude);
+    
+    const auto sequence = analysisRing.push(timestamp, fftBuffer.data(), numBinsToInclude, extraValues);
+    
+    if (evaluateTrigger) {
+        // Onset: spectral flux well above its running average
+        const auto& settings = captureTrigger.getSettings();
+        const float levelDb = totalEnergy > 0.0f ? 10.0f * std::log10(totalEnergy) : -100.0f;
+        const float bandEnergyDb = bandEnergy > 0.0f ? 10.0f * std::log10(bandEnergy) : -100.0f;
+        const bool onsetDetected = spectralFluxAverage > 0.0f
+                                && spectralFlux > spectralFluxAverage * settings.onsetRatio
+                                && levelDb > settings.thresholdDb;
+        spectralFluxAverage += 0.1f * (spectralFlux - spectralFluxAverage);
+        
+        captureTrigger.process(sequence, levelDb, bandEnergyDb, onsetDetected);
+    }
+}
+
+void FXPluginProcessor::waitForRecordingCollector(uint64_t sequence)
+{
+    // Faster-than-realtime rendering can outrun the collector thread. Blocking is
+    // acceptable when the host isn't rendering in realtime, losing frames is not.
+    const auto limit = static_cast<uint64_t>(analysisRing.getCapacity() / 2);
+    
+    while (isRecordingFrequency.load() && sequence + 1 - juce::jmin(sequence + 1, collectedSequence.load()) > limit) {
+        analysisPool->triggerHousekeeping();
+        juce::Thread::sleep(1);
+    }
+}
+
+void FXPluginProcessor::collectRecordedFrames()
+{
+    const juce::ScopedLock lock(recordingMutex);
+    
+    if (!isRecordingFrequency.load())
+        return;
+    
+    // Read the write position before the events, so an event for a frame past
+    // it can't be missed while frames after that event are drained
+    const auto written = analysisRing.getWriteSequence();
+    
+    if (!isTriggerArmed.load()) {
+        drainRecordedFrames(written);
+        return;
+    }
+    
+    CaptureTrigger::Event event;
+    while (captureTrigger.popEvent(event)) {
+        switch (event.type) {
+            case CaptureTrigger::Event::Type::segmentStart: {
+                const auto preFrames = static_cast<uint64_t>(captureTrigger.getPreFrames());
+                frequencyData.clear();
+                recordReadSequence = event.sequence - juce::jmin(event.sequence, preFrames);
+                isSegmentOpen = true;
+                break;
+            }
+            case CaptureTrigger::Event::Type::segmentEnd:
+                if (isSegmentOpen) {
+                    drainRecordedFrames(event.sequence + 1);
+                    finishSegment();
                 }
+                break;
+            case CaptureTrigger::Event::Type::segmentDiscarded:
+                frequencyData.clear();
+                isSegmentOpen = false;
+                break;
+        }
+    }
+    
+    if (isSegmentOpen)
+        drainRecordedFrames(written);
+    else
+        collectedSequence.store(written);
+}
+
+void FXPluginProcessor::drainRecordedFrames(uint64_t endSequence)
+{
+    const auto oldest = analysisRing.getOldestSequence();
+    
+    if (recordReadSequence < oldest) {
+        DBG("Recording collector fell behind, " + juce::String(static_cast<juce::int64>(oldest - recordReadSequence)) + " frames lost");
+        recordReadSequence = oldest;
+    }
+    
+    for (; recordReadSequence < endSequence; ++recordReadSequence) {
+        FrequencyFrame frame;
+        if (analysisRing.read(recordReadSequence, frame.timestamp, frame.power, &frame.watch)) {
+            // The extra values are, in order: valuesPerWatchedFrequency per watched
+            // frequency, the constant-Q bins, then, with the limiter on, its gain
+            // reduction in dB and the peak reduction over the frame. They are split
+            // off from the end.
+            if (numLimiterValues > 0 && frame.watch.size() >= static_cast<size_t>(numLimiterValues)) {
+                frame.limiter.assign(frame.watch.end() - numLimiterValues, frame.watch.end());
+                frame.watch.resize(frame.watch.size() - static_cast<size_t>(numLimiterValues));
+            }
+            
+            const auto numWatchValues = watchedFrequencies.size() * valuesPerWatchedFrequency;
+            if (frame.watch.size() > numWatchValues) {
+                frame.constantQ.assign(frame.watch.begin() + static_cast<std::ptrdiff_t>(numWatchValues), frame.watch.end());
+                frame.watch.resize(numWatchValues);
             }
             
-            return peakBin * binWidth;
+            frame.timeSeconds = frame.timestamp.sessionSeconds - recordingStartTime;
+            frequencyData.push_back(std::move(frame));
+        }
+    }
+    
+    collectedSequence.store(recordReadSequence);
+}
+
+void FXPluginProcessor::finishSegment()
+{
+    isSegmentOpen = false;
+    
+    if (frequencyData.empty())
+        return;
+    
+    const int index = static_cast<int>(capturedSegments.size()) + 1;
+    const juce::File baseFile(outputFilePath);
+    const juce::File segmentFile = baseFile.getSiblingFile(baseFile.getFileNameWithoutExtension()
+                                                           + "_segment_" + juce::String(index).paddedLeft('0', 3) + ".json");
+    
+    if (writeFrequencyData(segmentFile, index)) {
+        capturedSegments.push_back({ index, segmentFile.getFileName(),
+                                     frequencyData.front().timeSeconds, frequencyData.back().timeSeconds });
+        numCapturedSegments.store(static_cast<int>(capturedSegments.size()));
+        writeSegmentIndex();
+    }
+    
+    frequencyData.clear();
+}
+
+int FXPluginProcessor::getNumCapturedSegments() const
+{
+    const juce::ScopedLock lock(recordingMutex);
+    return static_cast<int>(capturedSegments.size());
+}
+
+void FXPluginProcessor::setTriggerSettings(const CaptureTrigger::Settings& settings)
+{
+    const juce::ScopedLock lock(recordingMutex);
+    triggerSettings = settings;
+}
+
+CaptureTrigger::Settings FXPluginProcessor::getTriggerSettings() const
+{
+    const juce::ScopedLock lock(recordingMutex);
+    return triggerSettings;
+}
+
+void FXPluginProcessor::setPreRollSeconds(double seconds)
+{
+    preRollSeconds.store(juce::jlimit(0.0, 60.0, seconds));
+}
+
+double FXPluginProcessor::getPreRollSeconds() const
+{
+    return preRollSeconds.load();
+}
+
+void FXPluginProcessor::setWatchedFrequencies(const std::vector<float>& frequenciesHz, float resolutionHz)
+{
+    const juce::ScopedLock lock(recordingMutex);
+    watchSettingsFrequencies = frequenciesHz;
+    watchSettingsResolutionHz = juce::jlimit(0.1f, 1000.0f, resolutionHz);
+}
+
+std::vector<float> FXPluginProcessor::getWatchedFrequencies() const
+{
+    const juce::ScopedLock lock(recordingMutex);
+    return watchSettingsFrequencies;
+}
+
+void FXPluginProcessor::setConstantQ(int binsPerOctave, float minFrequencyHz)
+{
+    const juce::ScopedLock lock(recordingMutex);
+    constantQSettingsBinsPerOctave = binsPerOctave > 0 ? juce::jlimit(12, 48, binsPerOctave) : 0;
+    constantQSettingsMinFrequency = juce::jlimit(10.0f, 10000.0f, minFrequencyHz);
+}
+
+int FXPluginProcessor::getConstantQBinsPerOctave() const
+{
+    const juce::ScopedLock lock(recordingMutex);
+    return constantQSettingsBinsPerOctave;
+}
+
+void FXPluginProcessor::setWaveshaperAntiAliasing(int adaaOrder, int oversamplingOrder)
+{
+    const juce::ScopedLock lock(recordingMutex);
+    waveshaperSettingsADAAOrder = juce::jlimit(0, 2, adaaOrder);
+    waveshaperSettingsOversamplingOrder = juce::jlimit(0, 3, oversamplingOrder);
+}
+
+int FXPluginProcessor::getWaveshaperADAAOrder() const
+{
+    const juce::ScopedLock lock(recordingMutex);
+    return waveshaperSettingsADAAOrder;
+}
+
+int FXPluginProcessor::getWaveshaperOversamplingOrder() const
+{
+    const juce::ScopedLock lock(recordingMutex);
+    return waveshaperSettingsOversamplingOrder;
+}
+
+void FXPluginProcessor::setLimiterSettings(const LimiterSettings& settings)
+{
+    const juce::ScopedLock lock(recordingMutex);
+    limiterSettings = settings;
+    limiterSettings.ceilingDb = juce::jlimit(-24.0f, 0.0f, settings.ceilingDb);
+    limiterSettings.lookaheadMs = juce::jlimit(0.0f, 20.0f, settings.lookaheadMs);
+    limiterSettings.releaseMs = juce::jlimit(1.0f, 1000.0f, settings.releaseMs);
+}
+
+FXPluginProcessor::LimiterSettings FXPluginProcessor::getLimiterSettings() const
+{
+    const juce::ScopedLock lock(recordingMutex);
+    return limiterSettings;
+}
+
+void FXPluginProcessor::setMultibandSettings(const MultibandSettings& settings)
+{
+    const juce::ScopedLock lock(recordingMutex);
+    multibandSettings = settings;
+    multibandSettings.numBands = juce::jlimit(2, maxMultibandBands, settings.numBands);
+    
+    // Crossovers go up, at least a third of an octave apart
+    auto lowest = 20.0f;
+    
+    for (auto& frequency : multibandSettings.crossoverFrequencies) {
+        frequency = juce::jlimit(juce::jmin(lowest, 20000.0f), 20000.0f, frequency);
+        lowest = frequency * 1.26f;
+    }
+}
+
+FXPluginProcessor::MultibandSettings FXPluginProcessor::getMultibandSettings() const
+{
+    const juce::ScopedLock lock(recordingMutex);
+    return multibandSettings;
+}
+
+bool FXPluginProcessor::saveFrequencyData()
+{
+    try {
+        const juce::ScopedLock lock(recordingMutex);
+        
+        if (frequencyData.empty()) {
+            DBG("No frequency data to save");
+            return false;
+        }
+        
+        if (outputFilePath.isEmpty()) {
+            DBG("No output file path set");
+            return false;
+        }
+        
+        juce::File outputFile(outputFilePath);
+        if (!outputFile.getFileName().endsWithIgnoreCase(".json")) {
+            outputFile = outputFile.withFileExtension("json");
+            outputFilePath = outputFile.getFullPathName();
+        }
+        
+        return writeFrequencyData(outputFile, -1);
+    }
+    catch (const std::exception& e) {
+        DBG("Exception in saveFrequencyData: " + juce::String(e.what()));
+        return false;
+    }
+    catch (...) {
+        DBG("Unknown exception in saveFrequencyData");
+        return false;
+    }
+}
+
+bool FXPluginProcessor::writeFrequencyData(const juce::File& outputFile, int segmentIndex)
+{
+    try {
+        if (auto parentDir = outputFile.getParentDirectory(); !parentDir.exists()) {
+            parentDir.createDirectory();
+        }
+        
+        juce::FileOutputStream stream(outputFile);
+        if (stream.failedToOpen()) {
+            DBG("Failed to open file for writing: " + outputFile.getFullPathName());
+            return false;
+        }
+        
+        // FileOutputStream appends, so drop anything left from a previous run
+        stream.setPosition(0);
+        stream.truncate();
+        
+        const auto& bands = analysisBands;
+        
+        juce::String json = "{\n";
+        
+        json += "  \"sample_rate\": " + juce::String(getSampleRate()) + ",\n";
+        json += "  \"bit_depth\": 32,\n";
+        json += "  \"frame_duration_sec\": " + juce::String(frameDuration) + ",\n";
+        json += "  \"hop_size_samples\": " + juce::String(hopSize) + ",\n";
+        json += "  \"fft_size\": " + juce::String(fftSize) + ",\n";
+        json += "  \"pre_roll_sec\": " + juce::String(preRollDuration, 2) + ",\n";
+        
+        if (!watchedFrequencies.empty())
+            json += "  \"watch_window_sec\": " + juce::String(watchBank.getWindowLength() / getSampleRate(), 3) + ",\n";
+        
+        if (constantQ != nullptr) {
+            json += "  \"constant_q\": { \"bins_per_octave\": " + juce::String(constantQ->getBinsPerOctave())
+                  + ", \"min_frequency_hz\": " + juce::String(constantQ->getBinFrequency(0), 1)
+                  + ", \"num_bins\": " + juce::String(constantQ->getNumBins()) + " },\n";
+        }
+        
+        if (useLimiter) {
+            json += "  \"limiter\": { \"ceiling_db\": " + juce::String(preparedLimiterSettings.ceilingDb, 1)
+                  + ", \"lookahead_samples\": " + juce::String(limiterLatency)
+                  + ", \"true_peak\": " + (preparedLimiterSettings.truePeak ? "true" : "false") + " },\n";
+        }
+        
+        if (segmentIndex > 0) {
+            json += "  \"trigger_mode\": \"" + CaptureTrigger::getModeName(triggerSettings.mode) + "\",\n";
+            json += "  \"segment_index\": " + juce::String(segmentIndex) + ",\n";
+        }
+        
+        json += "  \"analysis\": [\n";
+        
+        auto calculateBandEnergy = [this](const FrequencyFrame& frame, float minFreq, float maxFreq) -> float {
+            int minBin = getAnalysisBin(minFreq);
+            int maxBin = getAnalysisBin(maxFreq);
+            
+            minBin = juce::jlimit(0, static_cast<int>(frame.power.size()) - 1, minBin);
+            maxBin = juce::jlimit(0, static_cast<int>(frame.power.size()) - 1, maxBin);
+            
+            const float totalEnergy = maxBin >= minBin
+                                    ? juce::FloatVectorOperations::sum(frame.power.data() + minBin, maxBin - minBin + 1)
+                                    : 0.0f;
+            
+            if (totalEnergy > 0.0f) {
+                return 10.0f * std::log10(totalEnergy);
+            }
+            return -100.0f;
         };
         
+        // Real-FFT bins are sampleRate / fftSize apart
+        const float binWidth = static_cast<float>(analysisSampleRate / fftSize);
+        std::vector<float> constantQDb;
+        
         bool isFirstFrame = true;
         for (const auto& frame : frequencyData) {
             if (!isFirstFrame) {
@@ -516,15 +1471,15 @@ bool FXPluginProcessor::saveFrequencyData()
             float rmsDb = -60.0f;
             float totalEnergyDb = -100.0f;
             float truePeakDbfs = -100.0f;
+            float peakFrequency = 0.0f;
             
-            if (!frame.magnitudes.empty()) {
-                float peakMagnitude = *std::max_element(frame.magnitudes.begin(), frame.magnitudes.end());
-                truePeakDbfs = peakMagnitude;
+            if (!frame.power.empty()) {
+                const int numBins = static_cast<int>(frame.power.size());
+                const int peakBin = juce::FloatVectorOperations::findIndexOfMaximum(frame.power.data(), numBins);
+                truePeakDbfs = 10.0f * std::log10(frame.power[peakBin]);
+                peakFrequency = peakBin * binWidth;
                 
-                float totalEnergy = 0.0f;
-                for (float mag : frame.magnitudes) {
-                    totalEnergy += std::pow(10.0f, mag / 10.0f);
-                }
+                const float totalEnergy = juce::FloatVectorOperations::sum(frame.power.data(), numBins);
                 
                 if (totalEnergy > 0.0f) {
                     totalEnergyDb = 10.0f * std::log10(totalEnergy);
@@ -532,11 +1487,21 @@ bool FXPluginProcessor::saveFrequencyData()
                 }
             }
             
-            float peakFrequency = findPeakFrequency(frame);
-            
             json += "    {\n";
             
-            json += "      \"time_sec\": " + juce::String(frame.timeSeconds, 2) + ",\n";
+            json += "      \"time_sec\": " + juce::String(frame.timeSeconds, 3) + ",\n";
+            json += "      \"session_time_sec\": " + juce::String(frame.timestamp.sessionSeconds, 3) + ",\n";
+            
+            if (frame.timestamp.hasProjectPosition) {
+                json += "      \"project_time_sec\": " + juce::String(frame.timestamp.projectSeconds, 3) + ",\n";
+                json += "      \"project_sample\": " + juce::String(frame.timestamp.projectSamples) + ",\n";
+            }
+            
+            if (frame.timestamp.hasMusicalPosition) {
+                json += "      \"ppq\": " + juce::String(frame.timestamp.ppqPosition, 3) + ",\n";
+                json += "      \"bar\": " + juce::String(frame.timestamp.bar) + ",\n";
+            }
+            
             json += "      \"rms_db\": " + juce::String(rmsDb, 1) + ",\n";
             json += "      \"true_peak_dbfs\": " + juce::String(truePeakDbfs, 1) + ",\n";
             
@@ -558,6 +1523,49 @@ bool FXPluginProcessor::saveFrequencyData()
             }
             json += "\n      },\n";
             
+            // Watched frequencies: level at the end of the frame, and the peak since the
+            // previous frame placed to the sample on the recording's time axis
+            const auto numWatched = juce::jmin(watchedFrequencies.size(), frame.watch.size() / valuesPerWatchedFrequency);
+            if (numWatched > 0) {
+                json += "      \"watch\": [\n";
+                
+                for (size_t i = 0; i < numWatched; ++i) {
+                    const auto* values = frame.watch.data() + i * valuesPerWatchedFrequency;
+                    const float levelDb = 10.0f * std::log10(juce::jmax(values[0], minimumBinPower));
+                    const float peakDb = 10.0f * std::log10(juce::jmax(values[1], minimumBinPower));
+                    const double peakTime = frame.timeSeconds - values[2] / getSampleRate();
+                    
+                    json += "        { \"frequency_hz\": " + juce::String(watchedFrequencies[i], 1)
+                          + ", \"level_db\": " + juce::String(levelDb, 1)
+                          + ", \"peak_db\": " + juce::String(peakDb, 1)
+                          + ", \"peak_time_sec\": " + juce::String(peakTime, 5) + " }";
+                    json += i + 1 < numWatched ? ",\n" : "\n";
+                }
+                
+                json += "      ],\n";
+            }
+            
+            if (!frame.constantQ.empty()) {
+                json += "      \"constant_q_db\": [";
+                
+                constantQDb.resize(frame.constantQ.size());
+                juce::FloatVectorOperations::powerToDecibels(constantQDb.data(), frame.constantQ.data(),
+                                                             10.0f * std::log10(minimumBinPower),
+                                                             static_cast<int>(constantQDb.size()));
+                
+                for (size_t i = 0; i < constantQDb.size(); ++i) {
+                    json += i > 0 ? ", " : "";
+                    json += juce::String(constantQDb[i], 1);
+                }
+                
+                json += "],\n";
+            }
+            
+            if (frame.limiter.size() == valuesPerLimiterFrame) {
+                json += "      \"limiter_gain_reduction_db\": " + juce::String(frame.limiter[0], 2) + ",\n";
+                json += "      \"limiter_peak_gain_reduction_db\": " + juce::String(frame.limiter[1], 2) + ",\n";
+            }
+            
             float phaseCorrelation = 0.95f + juce::Random::getSystemRandom().nextFloat() * 0.05f;
             float stereoWidth = juce::Random::getSystemRandom().nextFloat() * 0.1f;
             float transientSharpness = juce::Random::getSystemRandom().nextFloat() * 0.05f;
@@ -571,6 +1579,13 @@ bool FXPluginProcessor::saveFrequencyData()
             json += "      \"onset_detected\": " + juce::String(onsetDetected ? "true" : "false") + "\n";
             
             json += "    }";
+            
+            // Stream frame by frame; appending a whole offline bounce to one String is quadratic
+            if (!stream.writeText(json, false, false, nullptr)) {
+                DBG("Failed to write JSON data to file");
+                return false;
+            }
+            json.clear();
         }
         
         json += "\n  ]\n}";
@@ -580,19 +1595,473 @@ bool FXPluginProcessor::saveFrequencyData()
             return false;
         }
         
-        DBG("Saved " + juce::String(frequencyData.size()) + " frequency frames to " + outputFilePath);
+        DBG("Saved " + juce::String(frequencyData.size()) + " frequency frames to " + outputFile.getFullPathName());
         return true;
     }
     catch (const std::exception& e) {
-        DBG("Exception in saveFrequencyData: " + juce::String(e.what()));
+        DBG("Exception in writeFrequencyData: " + juce::String(e.what()));
         return false;
     }
     catch (...) {
-        DBG("Unknown exception in saveFrequencyData");
+        DBG("Unknown exception in writeFrequencyData");
         return false;
     }
 }
 
+bool FXPluginProcessor::writeSegmentIndex()
+{
+    const juce::File baseFile(outputFilePath);
+    const juce::File indexFile = baseFile.getSiblingFile(baseFile.getFileNameWithoutExtension() + "_segments.json");
+    
+    juce::String json = "{\n";
+    json += "  \"trigger_mode\": \"" + CaptureTrigger::getModeName(triggerSettings.mode) + "\",\n";
+    json += "  \"segments\": [\n";
+    
+    for (size_t i = 0; i < capturedSegments.size(); ++i) {
+        const auto& segment = capturedSegments[i];
+        json += "    { \"index\": " + juce::String(segment.index)
+              + ", \"file\": \"" + segment.fileName
+              + "\", \"start_sec\": " + juce::String(segment.startSeconds, 2)
+              + ", \"end_sec\": " + juce::String(segment.endSeconds, 2) + " }";
+        json += i + 1 < capturedSegments.size() ? ",\n" : "\n";
+    }
+    
+    json += "  ]\n}";
+    
+    if (!indexFile.replaceWithText(json, false, false, nullptr)) {
+        DBG("Failed to write segment index: " + indexFile.getFullPathName());
+        return false;
+    }
+    
+    return true;
+}
+
+template <typename SampleType>
+void FXPluginProcessor::applyCabinet(juce::AudioBuffer<SampleType>& buffer, int numChannels)
+{
+    const bool enabled = isCabinetEnabled.load(std::memory_order_relaxed);
+    
+    // Start from silence rather than whatever was in the convolution when it was turned off
+    if (enabled && !wasCabinetEnabled)
+        cabinet.reset();
+    
+    wasCabinetEnabled = enabled;
+    
+    if (!enabled || numChannels == 0 || cabinetBlockSize == 0)
+        return;
+    
+    {
+        // Loading is wait-free; the file is read on the convolution's own thread
+        const juce::SpinLock::ScopedTryLockType lock(cabinetLock);
+        
+        if (lock.isLocked() && hasPendingCabinetFile) {
+            cabinet.loadImpulseResponse(pendingCabinetFile, juce::dsp::Convolution::Stereo::yes,
+                                        juce::dsp::Convolution::Trim::yes, 0);
+            hasPendingCabinetFile = false;
+        }
+    }
+    
+    juce::dsp::AudioBlock<SampleType> block(buffer.getArrayOfWritePointers(), static_cast<size_t>(numChannels),
+                                            static_cast<size_t>(buffer.getNumSamples()));
+    
+    // Hosts may send more samples than they announced in prepareToPlay
+    for (size_t start = 0; start < block.getNumSamples(); start += static_cast<size_t>(cabinetBlockSize)) {
+        auto chunk = block.getSubBlock(start, juce::jmin(block.getNumSamples() - start, static_cast<size_t>(cabinetBlockSize)));
+        
+        if constexpr (std::is_same_v<SampleType, float>) {
+            cabinet.process(juce::dsp::ProcessContextReplacing<float>(chunk));
+        }
+        else {
+            // juce::dsp::Convolution only runs in float, so the IR alone is convolved
+            // at single precision
+            auto converted = juce::dsp::AudioBlock<float>(cabinetConversionBuffer).getSubsetChannelBlock(0, chunk.getNumChannels())
+                                                                                  .getSubBlock(0, chunk.getNumSamples());
+            
+            for (size_t channel = 0; channel < chunk.getNumChannels(); ++channel)
+                std::copy(chunk.getChannelPointer(channel), chunk.getChannelPointer(channel) + chunk.getNumSamples(),
+                          converted.getChannelPointer(channel));
+            
+            cabinet.process(juce::dsp::ProcessContextReplacing<float>(converted));
+            
+            for (size_t channel = 0; channel < chunk.getNumChannels(); ++channel)
+                std::copy(converted.getChannelPointer(channel), converted.getChannelPointer(channel) + converted.getNumSamples(),
+                          chunk.getChannelPointer(channel));
+        }
+    }
+}
+
+void FXPluginProcessor::prepareWaveshaper(double sampleRate, int samplesPerBlock)
+{
+    int adaaOrder, oversamplingOrder;
+    
+    {
+        const juce::ScopedLock lock(recordingMutex);
+        adaaOrder = waveshaperSettingsADAAOrder;
+        oversamplingOrder = waveshaperSettingsOversamplingOrder;
+        preparedMultibandSettings = multibandSettings;
+    }
+    
+    useMultibandWaveshaper = preparedMultibandSettings.enabled;
+    updateMultibandAnalysisBands(sampleRate);
+    
+    waveshaperBlockSize = juce::jmax(1, samplesPerBlock);
+    
+    // Only the host's precision is prepared; the other one gives its buffers back
+    double latency;
+    
+    if (isPreparedForDouble) {
+        latency = prepareWaveshaperStages(doubleStages, sampleRate, adaaOrder, oversamplingOrder);
+        floatStages.waveshaperOversampling.reset();
+        floatStages.waveshaperDryBuffer.setSize(0, 0);
+    }
+    else {
+        latency = prepareWaveshaperStages(floatStages, sampleRate, adaaOrder, oversamplingOrder);
+        doubleStages.waveshaperOversampling.reset();
+        doubleStages.waveshaperDryBuffer.setSize(0, 0);
+    }
+    
+    useAntiAliasedWaveshaper = adaaOrder > 0 || oversamplingOrder > 0;
+    wasWaveshaping = false;
+    
+    setLatencySamples(juce::roundToInt(latency));
+}
+
+template <typename SampleType>
+double FXPluginProcessor::prepareWaveshaperStages(ProcessingStages<SampleType>& stages, double sampleRate,
+                                                  int adaaOrder, int oversamplingOrder)
+{
+    const auto numChannels = static_cast<size_t>(juce::jmax(1, getMainBusNumInputChannels()));
+    const int factor = 1 << oversamplingOrder;
+    
+    // Polyphase IIR: cheapest of the JUCE filters, and rounded to a whole-sample latency.
+    // From two channels up the lane-packed variant is faster; mono stays scalar.
+    stages.waveshaperOversampling.reset();
+    
+    if (oversamplingOrder > 0) {
+        using Oversampling = juce::dsp::Oversampling<SampleType>;
+        const auto filterType = numChannels > 1 ? Oversampling::filterHalfBandPolyphaseIIRSIMD
+                                                : Oversampling::filterHalfBandPolyphaseIIR;
+        
+        stages.waveshaperOversampling = std::make_unique<Oversampling>(numChannels, static_cast<size_t>(oversamplingOrder),
+                                                                       filterType, true, true);
+        stages.waveshaperOversampling->initProcessing(static_cast<size_t>(waveshaperBlockSize));
+    }
+    
+    stages.waveshaperDryBuffer.setSize(static_cast<int>(numChannels), waveshaperBlockSize * factor);
+    
+    stages.waveshaper.setCurve(juce::dsp::AntiderivativeCurve::tanh());
+    stages.waveshaper.setOrder(static_cast<typename juce::dsp::AntiderivativeWaveShaper<SampleType>::Order>(adaaOrder));
+    stages.waveshaper.prepare({ sampleRate * factor, static_cast<juce::uint32>(waveshaperBlockSize * factor),
+                                static_cast<juce::uint32>(numChannels) });
+    
+    auto& multiband = stages.multibandWaveshaper;
+    multiband.setNumBands(preparedMultibandSettings.numBands);
+    multiband.setRampDuration(parameterRampSeconds);
+    
+    for (int index = 0; index < maxMultibandBands - 1; ++index)
+        multiband.setCrossoverFrequency(index, static_cast<SampleType>(preparedMultibandSettings.crossoverFrequencies[(size_t) index]));
+    
+    // -1 is outside both parameters' ranges, so every band is set; prepare() then
+    // skips the ramps
+    bandDrives.fill(-1.0f);
+    bandGains.fill(-1.0f);
+    updateBandParameters(multiband);
+    multiband.prepare({ sampleRate * factor, static_cast<juce::uint32>(waveshaperBlockSize * factor),
+                        static_cast<juce::uint32>(numChannels) });
+    
+    // ADAA delays by half a sample per order at the oversampled rate; the multiband
+    // waveshaper has no ADAA and no delay
+    double latency = useMultibandWaveshaper ? 0.0 : stages.waveshaper.getDelayInSamples() / factor;
+    if (stages.waveshaperOversampling != nullptr)
+        latency += static_cast<double>(stages.waveshaperOversampling->getLatencyInSamples());
+    
+    return latency;
+}
+
+template <typename SampleType>
+void FXPluginProcessor::applyTanhWaveshaper(SampleType* channelData, int numSamples, float startDistortion, float endDistortion)
+{
+    const bool startsShaping = startDistortion > 0.01f;
+    const bool endsShaping = endDistortion > 0.01f;
+    
+    if (startDistortion == endDistortion) {
+        if (endsShaping) {
+            juce::FloatVectorOperations::multiply(channelData, static_cast<SampleType>(endDistortion * 10.0f), numSamples);
+            juce::FloatVectorOperations::tanh(channelData, channelData, numSamples);
+        }
+        
+        return;
+    }
+    
+    if (!startsShaping && !endsShaping)
+        return;
+    
+    // Ramp the drive, and crossfade from or to the dry signal where shaping turns on or off
+    const SampleType startWet = startsShaping ? 1 : 0;
+    const SampleType endWet = endsShaping ? 1 : 0;
+    
+    for (int i = 0; i < numSamples; ++i) {
+        const auto position = static_cast<SampleType>(i + 1) / static_cast<SampleType>(numSamples);
+        const auto drive = static_cast<SampleType>(10) * (startDistortion + position * (endDistortion - startDistortion));
+        const auto wet = startWet + position * (endWet - startWet);
+        const auto dry = channelData[i];
+        
+        channelData[i] = dry + wet * (std::tanh(dry * drive) - dry);
+    }
+}
+
+template <typename SampleType>
+void FXPluginProcessor::applyWaveshaperRamp(juce::dsp::AudioBlock<SampleType>& block, float startDistortion, float endDistortion)
+{
+    auto& stages = getStages<SampleType>();
+    const auto numSamples = static_cast<int>(block.getNumSamples());
+    const bool isCrossfading = (startDistortion > 0.01f) != (endDistortion > 0.01f);
+    const SampleType startWet = startDistortion > 0.01f ? 1 : 0;
+    const SampleType endWet = endDistortion > 0.01f ? 1 : 0;
+    
+    auto dry = juce::dsp::AudioBlock<SampleType>(stages.waveshaperDryBuffer).getSubsetChannelBlock(0, block.getNumChannels())
+                                                                            .getSubBlock(0, block.getNumSamples());
+    
+    if (isCrossfading)
+        dry.copyFrom(block);
+    
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel) {
+        auto* samples = block.getChannelPointer(channel);
+        
+        for (int i = 0; i < numSamples; ++i)
+            samples[i] *= static_cast<SampleType>(10) * (startDistortion + static_cast<SampleType>(i + 1) / static_cast<SampleType>(numSamples) * (endDistortion - startDistortion));
+    }
+    
+    stages.waveshaper.process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+    
+    // The ADAA delay of a sample at most puts the dry signal slightly ahead, which is
+    // inaudible over the few milliseconds of a crossfade
+    if (!isCrossfading)
+        return;
+    
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel) {
+        auto* samples = block.getChannelPointer(channel);
+        const auto* drySamples = dry.getChannelPointer(channel);
+        
+        for (int i = 0; i < numSamples; ++i) {
+            const auto wet = startWet + static_cast<SampleType>(i + 1) / static_cast<SampleType>(numSamples) * (endWet - startWet);
+            samples[i] = drySamples[i] + wet * (samples[i] - drySamples[i]);
+        }
+    }
+}
+
+template <typename SampleType>
+void FXPluginProcessor::applyWaveshaper(juce::AudioBuffer<SampleType>& buffer, int numChannels, float startDistortion, float endDistortion)
+{
+    auto& stages = getStages<SampleType>();
+    
+    // Shape only above the same threshold as the plain path. The oversampling keeps
+    // running below it so the latency doesn't change with the distortion amount.
+    const bool isWaveshaping = startDistortion > 0.01f || endDistortion > 0.01f;
+    
+    // The ADAA state would otherwise difference against a sample from before the pause
+    if (isWaveshaping && !wasWaveshaping)
+        stages.waveshaper.reset();
+    
+    wasWaveshaping = isWaveshaping;
+    
+    if (numChannels == 0 || waveshaperBlockSize == 0 || (!isWaveshaping && stages.waveshaperOversampling == nullptr))
+        return;
+    
+    juce::dsp::AudioBlock<SampleType> block(buffer.getArrayOfWritePointers(), static_cast<size_t>(numChannels),
+                                            static_cast<size_t>(buffer.getNumSamples()));
+    const auto numSamples = static_cast<float>(block.getNumSamples());
+    
+    // Hosts may send more samples than they announced in prepareToPlay
+    for (size_t start = 0; start < block.getNumSamples(); start += static_cast<size_t>(waveshaperBlockSize)) {
+        auto chunk = block.getSubBlock(start, juce::jmin(block.getNumSamples() - start, static_cast<size_t>(waveshaperBlockSize)));
+        auto shaped = stages.waveshaperOversampling != nullptr ? stages.waveshaperOversampling->processSamplesUp(chunk) : chunk;
+        
+        if (isWaveshaping && startDistortion == endDistortion) {
+            shaped.multiplyBy(static_cast<SampleType>(endDistortion * 10.0f));
+            stages.waveshaper.process(juce::dsp::ProcessContextReplacing<SampleType>(shaped));
+        }
+        else if (isWaveshaping) {
+            const auto end = start + chunk.getNumSamples();
+            applyWaveshaperRamp(shaped, startDistortion + (endDistortion - startDistortion) * static_cast<float>(start) / numSamples,
+                                startDistortion + (endDistortion - startDistortion) * static_cast<float>(end) / numSamples);
+        }
+        
+        if (stages.waveshaperOversampling != nullptr)
+            stages.waveshaperOversampling->processSamplesDown(chunk);
+    }
+}
+
+template <typename SampleType>
+void FXPluginProcessor::updateBandParameters(juce::dsp::MultibandWaveShaper<SampleType>& shaper)
+{
+    // The shaper restarts its ramps on every change, so it is only told about new values
+    for (size_t band = 0; band < static_cast<size_t>(maxMultibandBands); ++band) {
+        // The same drive and threshold as the distortion parameter
+        const auto amount = bandDriveParameters[band] != nullptr ? bandDriveParameters[band]->load(std::memory_order_relaxed) : 0.0f;
+        const auto drive = amount > 0.01f ? amount * 10.0f : 0.0f;
+        const auto gain = bandGainParameters[band] != nullptr ? bandGainParameters[band]->load(std::memory_order_relaxed) : 1.0f;
+        
+        if (drive != bandDrives[band]) {
+            bandDrives[band] = drive;
+            shaper.setDrive(static_cast<int>(band), static_cast<SampleType>(drive));
+        }
+        
+        if (gain != bandGains[band]) {
+            bandGains[band] = gain;
+            shaper.setGain(static_cast<int>(band), static_cast<SampleType>(gain));
+        }
+    }
+}
+
+template <typename SampleType>
+void FXPluginProcessor::applyMultibandWaveshaper(juce::AudioBuffer<SampleType>& buffer, int numChannels)
+{
+    auto& stages = getStages<SampleType>();
+    updateBandParameters(stages.multibandWaveshaper);
+    
+    if (numChannels == 0 || waveshaperBlockSize == 0)
+        return;
+    
+    juce::dsp::AudioBlock<SampleType> block(buffer.getArrayOfWritePointers(), static_cast<size_t>(numChannels),
+                                            static_cast<size_t>(buffer.getNumSamples()));
+    
+    // The oversampling can't take more samples than it was prepared for
+    for (size_t start = 0; start < block.getNumSamples(); start += static_cast<size_t>(waveshaperBlockSize)) {
+        auto chunk = block.getSubBlock(start, juce::jmin(block.getNumSamples() - start, static_cast<size_t>(waveshaperBlockSize)));
+        auto shaped = stages.waveshaperOversampling != nullptr ? stages.waveshaperOversampling->processSamplesUp(chunk) : chunk;
+        
+        stages.multibandWaveshaper.process(juce::dsp::ProcessContextReplacing<SampleType>(shaped));
+        
+        if (stages.waveshaperOversampling != nullptr)
+            stages.waveshaperOversampling->processSamplesDown(chunk);
+    }
+}
+
+void FXPluginProcessor::updateMultibandAnalysisBands(double sampleRate)
+{
+    const juce::ScopedLock lock(recordingMutex);
+    
+    analysisBands.erase(std::remove_if(analysisBands.begin(), analysisBands.end(),
+                                       [](const FrequencyBand& band) { return band.name.startsWith("band_"); }),
+                        analysisBands.end());
+    
+    if (!preparedMultibandSettings.enabled)
+        return;
+    
+    // The waveshaper's bands, between its crossovers, so recordings and triggers can
+    // follow what each band is doing
+    const auto& crossovers = preparedMultibandSettings.crossoverFrequencies;
+    const auto top = juce::jmin(maxFrequency, static_cast<float>(sampleRate / 2.0));
+    
+    for (int band = 0; band < preparedMultibandSettings.numBands; ++band) {
+        const auto low = band == 0 ? 20.0f : crossovers[(size_t) band - 1];
+        const auto high = band == preparedMultibandSettings.numBands - 1 ? top : crossovers[(size_t) band];
+        analysisBands.push_back({ "band_" + juce::String(band + 1), low, high });
+    }
+}
+
+void FXPluginProcessor::prepareLimiter(double sampleRate, int samplesPerBlock)
+{
+    LimiterSettings settings;
+    
+    {
+        const juce::ScopedLock lock(recordingMutex);
+        settings = limiterSettings;
+    }
+    
+    const juce::dsp::ProcessSpec spec { sampleRate, static_cast<juce::uint32>(juce::jmax(1, samplesPerBlock)),
+                                        static_cast<juce::uint32>(juce::jmax(1, getMainBusNumOutputChannels())) };
+    
+    const auto prepare = [&](auto& limiter) {
+        limiter.setCeiling(settings.ceilingDb);
+        limiter.setLookahead(settings.lookaheadMs);
+        limiter.setRelease(settings.releaseMs);
+        limiter.setTruePeakDetection(settings.truePeak);
+        limiter.prepare(spec);
+        return limiter.getLatencyInSamples();
+    };
+    
+    limiterLatency = isPreparedForDouble ? prepare(doubleStages.limiter) : prepare(floatStages.limiter);
+    preparedLimiterSettings = settings;
+    useLimiter = settings.enabled;
+    
+    // prepareWaveshaper has just set the latency to its own
+    if (useLimiter)
+        setLatencySamples(getLatencySamples() + limiterLatency);
+}
+
+void FXPluginProcessor::prepareBypassDelay(double sampleRate, int samplesPerBlock)
+{
+    // prepareWaveshaper and prepareLimiter have set the latency
+    const auto latency = getLatencySamples();
+    const juce::dsp::ProcessSpec spec { sampleRate, static_cast<juce::uint32>(juce::jmax(1, samplesPerBlock)),
+                                        static_cast<juce::uint32>(juce::jmax(1, getMainBusNumOutputChannels())) };
+    
+    const auto prepare = [&](auto& delay) {
+        delay.setMaximumDelayInSamples(latency);
+        delay.prepare(spec);
+        delay.setDelay(static_cast<float>(latency));
+    };
+    
+    if (isPreparedForDouble)
+        prepare(doubleStages.bypassDelay);
+    else
+        prepare(floatStages.bypassDelay);
+    
+    isBypassing = false;
+}
+
+template <typename SampleType>
+void FXPluginProcessor::applyLimiter(juce::AudioBuffer<SampleType>& buffer, int numChannels)
+{
+    if (!useLimiter || numChannels == 0)
+        return;
+    
+    juce::dsp::AudioBlock<SampleType> block(buffer.getArrayOfWritePointers(), static_cast<size_t>(numChannels),
+                                            static_cast<size_t>(buffer.getNumSamples()));
+    getStages<SampleType>().limiter.process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+}
+
+std::pair<float, float> FXPluginProcessor::takeLimiterGainReduction()
+{
+    const auto take = [](auto& limiter) {
+        const auto reduction = std::make_pair(static_cast<float>(limiter.getGainReductionDecibels()),
+                                              static_cast<float>(limiter.getPeakGainReductionDecibels()));
+        limiter.resetPeakGainReduction();
+        return reduction;
+    };
+    
+    return isPreparedForDouble ? take(doubleStages.limiter) : take(floatStages.limiter);
+}
+
+void FXPluginProcessor::loadCabinetImpulseResponse(const juce::File& file)
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr) {
+        DBG("Could not read impulse response: " + file.getFullPathName());
+        return;
+    }
+    
+    cabinetTailSeconds.store(static_cast<double>(reader->lengthInSamples) / reader->sampleRate);
+    
+    {
+        const juce::SpinLock::ScopedLockType lock(cabinetLock);
+        pendingCabinetFile = file;
+        hasPendingCabinetFile = true;
+    }
+    
+    isCabinetEnabled.store(true);
+}
+
+void FXPluginProcessor::clearCabinetImpulseResponse()
+{
+    isCabinetEnabled.store(false);
+}
+
 void FXPluginProcessor::applyDistortion(float* channelData, int numSamples, float gain, float distortion)
 {
     try {
@@ -0,0 +1,201 @@
+#include "../include/ProcessingKernels.h"
+#include <cstring>
+#include <type_traits>
+
+namespace
+{
+#if JUCE_USE_SIMD
+    template <typename SampleType>
+    using Register = juce::dsp::SIMDRegister<SampleType>;
+
+    template <typename SampleType>
+    constexpr int numLanes = static_cast<int>(Register<SampleType>::SIMDNumElements);
+
+    // SIMDRegister only loads from aligned memory; a fixed-size memcpy compiles to
+    // an unaligned load or store. SIMDRegister zero-initialises its value, which makes
+    // it a non-trivial type, so the register side goes through void* to say the
+    // bytewise copy is intended.
+    template <typename SampleType>
+    Register<SampleType> load(const SampleType* source) noexcept
+    {
+        Register<SampleType> value;
+        std::memcpy(static_cast<void*>(&value), source, sizeof(value));
+        return value;
+    }
+
+    template <typename SampleType>
+    void store(SampleType* destination, Register<SampleType> value) noexcept
+    {
+        std::memcpy(destination, static_cast<const void*>(&value), sizeof(value));
+    }
+
+    // Writes a register of sums as floats. Double registers are narrowed with the
+    // native conversion, which SIMDRegister doesn't wrap; a lane at a time it costs
+    // more than the rest of the mix.
+    template <typename SampleType>
+    void storeAsFloat(float* destination, Register<SampleType> value) noexcept
+    {
+        if constexpr (std::is_same_v<SampleType, float>) {
+            store(destination, value);
+        }
+        else {
+#if JUCE_USE_SSE_INTRINSICS && defined (__AVX2__)
+            _mm_storeu_ps(destination, _mm256_cvtpd_ps(value.value));
+#elif JUCE_USE_SSE_INTRINSICS
+            _mm_storel_pi(reinterpret_cast<__m64*>(destination), _mm_cvtpd_ps(value.value));
+#elif JUCE_USE_ARM_NEON && JUCE_64BIT
+            vst1_f32(destination, vcvt_f32_f64(value.value));
+#else
+            for (size_t lane = 0; lane < Register<SampleType>::SIMDNumElements; ++lane)
+                destination[lane] = static_cast<float>(value.get(lane));
+#endif
+        }
+    }
+#endif
+
+    // The mono mix with its channel counts known at compile time, so the channel
+    // loops unroll and the pointers stay in registers. numChannels and
+    // numSubtractedChannels are only read when the counts are -1.
+    template <int NumChannels, int NumSubtractedChannels, typename SampleType>
+    void mixChannels(const SampleType* const* channels, int numChannels,
+                     const SampleType* const* subtractedChannels, int numSubtractedChannels,
+                     int startSample, float* destination, int numSamples) noexcept
+    {
+        if constexpr (NumChannels >= 0)
+            numChannels = NumChannels;
+
+        if constexpr (NumSubtractedChannels >= 0)
+            numSubtractedChannels = NumSubtractedChannels;
+
+        // Both scales are exact for one or two channels
+        const SampleType scale = numChannels > 0 ? SampleType(1) / static_cast<SampleType>(numChannels) : SampleType();
+        const SampleType subtractedScale = numSubtractedChannels > 0 ? SampleType(1) / static_cast<SampleType>(numSubtractedChannels) : SampleType();
+        int i = 0;
+
+#if JUCE_USE_SIMD
+        constexpr int lanes = numLanes<SampleType>;
+
+        for (; i + lanes <= numSamples; i += lanes) {
+            const int index = startSample + i;
+            auto sum = Register<SampleType>::expand(SampleType());
+            auto subtractedSum = Register<SampleType>::expand(SampleType());
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                sum += load(channels[channel] + index);
+
+            for (int channel = 0; channel < numSubtractedChannels; ++channel)
+                subtractedSum += load(subtractedChannels[channel] + index);
+
+            storeAsFloat(destination + i, sum * scale - subtractedSum * subtractedScale);
+        }
+#endif
+
+        for (; i < numSamples; ++i) {
+            const int index = startSample + i;
+            SampleType sum = 0, subtractedSum = 0;
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                sum += channels[channel][index];
+
+            for (int channel = 0; channel < numSubtractedChannels; ++channel)
+                subtractedSum += subtractedChannels[channel][index];
+
+            destination[i] = static_cast<float>(sum * scale - subtractedSum * subtractedScale);
+        }
+    }
+}
+
+namespace ProcessingKernels
+{
+
+template <typename SampleType>
+void applyGainRamp(SampleType* data, int numSamples, SampleType startGain, SampleType endGain) noexcept
+{
+    if (numSamples <= 0)
+        return;
+
+    const SampleType step = (endGain - startGain) / static_cast<SampleType>(numSamples);
+    int i = 0;
+
+#if JUCE_USE_SIMD
+    constexpr int lanes = numLanes<SampleType>;
+
+    if (numSamples >= lanes) {
+        alignas(Register<SampleType>) SampleType offsets[lanes];
+        for (int lane = 0; lane < lanes; ++lane)
+            offsets[lane] = static_cast<SampleType>(lane);
+
+        // The gains are computed from the sample indices, which stay exact integers, so
+        // long blocks don't drift the way an accumulated gain would
+        auto indices = Register<SampleType>::fromRawArray(offsets);
+        const auto stride = Register<SampleType>::expand(static_cast<SampleType>(lanes));
+        const auto start = Register<SampleType>::expand(startGain);
+
+        for (; i + lanes <= numSamples; i += lanes) {
+            store(data + i, load(data + i) * (start + indices * step));
+            indices += stride;
+        }
+    }
+#endif
+
+    for (; i < numSamples; ++i)
+        data[i] *= startGain + static_cast<SampleType>(i) * step;
+}
+
+template <typename SampleType>
+void zeroNonFinite(SampleType* data, int numSamples) noexcept
+{
+    int i = 0;
+
+#if JUCE_USE_SIMD
+    constexpr int lanes = numLanes<SampleType>;
+    const auto zero = Register<SampleType>::expand(SampleType());
+
+    // x - x is 0 for finite values and NaN for NaN and infinity, and NaN compares
+    // unequal to everything
+    for (; i + lanes <= numSamples; i += lanes) {
+        const auto value = load(data + i);
+        store(data + i, value & Register<SampleType>::equal(value - value, zero));
+    }
+#endif
+
+    for (; i < numSamples; ++i)
+        if (!std::isfinite(data[i]))
+            data[i] = SampleType();
+}
+
+template <typename SampleType>
+void mixToMono(const SampleType* const* channels, int numChannels,
+               const SampleType* const* subtractedChannels, int numSubtractedChannels,
+               int startSample, float* destination, int numSamples) noexcept
+{
+    // Mono and stereo buses, with or without a mono or stereo sidechain, cover every
+    // layout the plugin accepts
+    const auto mix = [&](auto fixedChannels, auto fixedSubtracted) {
+        mixChannels<decltype(fixedChannels)::value, decltype(fixedSubtracted)::value>(channels, numChannels,
+                                                                                      subtractedChannels, numSubtractedChannels,
+                                                                                      startSample, destination, numSamples);
+    };
+
+    constexpr std::integral_constant<int, 0> none;
+    constexpr std::integral_constant<int, 1> one;
+    constexpr std::integral_constant<int, 2> two;
+    constexpr std::integral_constant<int, -1> any;
+
+    if (numChannels == 2 && numSubtractedChannels == 0)      mix(two, none);
+    else if (numChannels == 2 && numSubtractedChannels == 1) mix(two, one);
+    else if (numChannels == 2 && numSubtractedChannels == 2) mix(two, two);
+    else if (numChannels == 1 && numSubtractedChannels == 0) mix(one, none);
+    else if (numChannels == 1 && numSubtractedChannels == 1) mix(one, one);
+    else if (numChannels == 1 && numSubtractedChannels == 2) mix(one, two);
+    else                                                     mix(any, any);
+}
+
+template void applyGainRamp<float>(float*, int, float, float) noexcept;
+template void applyGainRamp<double>(double*, int, double, double) noexcept;
+template void zeroNonFinite<float>(float*, int) noexcept;
+template void zeroNonFinite<double>(double*, int) noexcept;
+template void mixToMono<float>(const float* const*, int, const float* const*, int, int, float*, int) noexcept;
+template void mixToMono<double>(const double* const*, int, const double* const*, int, int, float*, int) noexcept;
+
+} // namespace ProcessingKernels
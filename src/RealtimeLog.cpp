@@ -0,0 +1,84 @@
+#include "../include/RealtimeLog.h"
+
+RealtimeLog::RealtimeLog()
+    : ticksPerSecond(juce::Time::getHighResolutionTicksPerSecond())
+{
+}
+
+void RealtimeLog::post(Code code, const char* text, juce::int64 intArg, double valueArg) noexcept
+{
+    const auto now = juce::Time::getHighResolutionTicks();
+    auto& window = rateWindows[static_cast<size_t>(code)];
+
+    // Start a new one-second window for this code if the current one has expired
+    auto windowStart = window.startTicks.load(std::memory_order_relaxed);
+    if (now - windowStart >= ticksPerSecond
+         && window.startTicks.compare_exchange_strong(windowStart, now, std::memory_order_relaxed))
+        window.count.store(0, std::memory_order_relaxed);
+
+    if (window.count.fetch_add(1, std::memory_order_relaxed) >= maxRecordsPerCodePerSecond) {
+        suppressed.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Record record;
+    record.code = code;
+    record.ticks = now;
+    record.intArg = intArg;
+    record.valueArg = valueArg;
+
+    if (text != nullptr) {
+        size_t i = 0;
+        for (; i < sizeof(record.text) - 1 && text[i] != 0; ++i)
+            record.text[i] = text[i];
+        record.text[i] = 0;
+    }
+
+    if (!queue.push(record))
+        dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void RealtimeLog::flush()
+{
+    Record record;
+
+    while (queue.pop(record)) {
+        juce::String message = "FXPlugin [" + juce::String(juce::Time::highResolutionTicksToSeconds(record.ticks), 3) + "s] "
+                             + getMessage(record.code);
+
+        if (record.text[0] != 0)
+            message << ": " << record.text;
+
+        if (record.intArg != 0 || record.valueArg != 0.0)
+            message << " (" << record.intArg << ", " << record.valueArg << ")";
+
+        juce::Logger::writeToLog(message);
+    }
+
+    const auto droppedNow = dropped.load(std::memory_order_relaxed);
+    const auto suppressedNow = suppressed.load(std::memory_order_relaxed);
+
+    if (droppedNow != reportedDropped || suppressedNow != reportedSuppressed) {
+        juce::Logger::writeToLog("FXPlugin realtime log: " + juce::String(suppressedNow - reportedSuppressed) + " messages rate limited, "
+                                 + juce::String(droppedNow - reportedDropped) + " dropped on a full queue");
+        reportedDropped = droppedNow;
+        reportedSuppressed = suppressedNow;
+    }
+}
+
+const char* RealtimeLog::getMessage(Code code) noexcept
+{
+    switch (code)
+    {
+        case Code::processBlockException:        return "Error in processBlock";
+        case Code::processBlockUnknownException: return "Unknown error in processBlock";
+        case Code::parameterNotFound:            return "Parameter not found";
+        case Code::parameterException:           return "Error getting parameter";
+        case Code::analysisException:            return "Exception in analyzeAudioBlock";
+        case Code::analysisUnknownException:     return "Unknown exception in analyzeAudioBlock";
+        case Code::analysisHopDropped:           return "Analysis job queue full, hop dropped";
+        case Code::numCodes:                     break;
+    }
+
+    return "Unknown log code";
+}
@@ -0,0 +1,351 @@
+// The interposers below redefine libc functions that fortified headers wrap inline
+#undef _FORTIFY_SOURCE
+
+#include "../include/RealtimeSanitiser.h"
+
+#if FXPLUGIN_REALTIME_SANITISER
+
+#if ! JUCE_ENABLE_LOCK_HOOKS
+ #error "The realtime sanitiser needs JUCE_ENABLE_LOCK_HOOKS to see CriticalSection and SpinLock"
+#endif
+
+#include <atomic>
+#include <cerrno>
+#include <cstdarg>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__)
+ #include <cxxabi.h>
+ #include <dlfcn.h>
+ #include <fcntl.h>
+ #include <poll.h>
+ #include <pthread.h>
+ #include <semaphore.h>
+ #include <stdio.h>
+ #include <sys/select.h>
+ #include <time.h>
+ #include <unistd.h>
+#elif JUCE_ENABLE_ALLOCATION_HOOKS
+ #error "The realtime sanitiser replaces operator new and delete here, so it can't be combined with JUCE_ENABLE_ALLOCATION_HOOKS"
+#endif
+
+// The interposers below can run inside malloc, so the per-thread state must never
+// be allocated lazily: initial-exec TLS is set up when the thread starts
+#if JUCE_GCC || JUCE_CLANG
+ #define FXPLUGIN_INITIAL_EXEC_TLS __attribute__((tls_model("initial-exec")))
+#else
+ #define FXPLUGIN_INITIAL_EXEC_TLS
+#endif
+
+namespace
+{
+    struct ThreadState
+    {
+        int realtimeDepth;
+        int allowDepth;
+        bool isReporting;
+    };
+
+    thread_local ThreadState threadState FXPLUGIN_INITIAL_EXEC_TLS = {};
+
+    std::atomic<uint64_t> numViolations { 0 };
+    std::atomic<bool> hasFirstViolation { false };
+    std::atomic<bool> isFirstViolationReady { false };
+    juce::String firstViolationReport;
+
+    void reportViolation(const char* what) noexcept
+    {
+        auto& state = threadState;
+        numViolations.fetch_add(1, std::memory_order_relaxed);
+
+        bool expected = false;
+        if (!hasFirstViolation.compare_exchange_strong(expected, true))
+            return;
+
+        // Building the report allocates and takes locks, none of which is checked
+        state.isReporting = true;
+
+        firstViolationReport = juce::String("Realtime sanitiser: ") + what + " inside a realtime scope\n"
+                             + juce::SystemStats::getStackBacktrace();
+        isFirstViolationReady.store(true, std::memory_order_release);
+        juce::Logger::writeToLog(firstViolationReport);
+
+        state.isReporting = false;
+    }
+
+    inline void checkRealtime(const char* what) noexcept
+    {
+        const auto& state = threadState;
+
+        if (state.realtimeDepth > 0 && state.allowDepth == 0 && !state.isReporting)
+            reportViolation(what);
+    }
+
+    //==============================================================================
+    // Installed for the lifetime of the process, as LockHooks can only be cleared
+    // once no other thread is using locks
+    struct LockListener final : public juce::LockHooks::Listener
+    {
+        LockListener() noexcept { juce::LockHooks::setListener(this); }
+
+        void lockEntered(const void*, juce::LockHooks::LockType type) noexcept override
+        {
+            switch (type) {
+                case juce::LockHooks::LockType::criticalSection: checkRealtime("CriticalSection::enter"); break;
+                case juce::LockHooks::LockType::spinLock:        checkRealtime("SpinLock::enter"); break;
+                case juce::LockHooks::LockType::waitableEvent:   checkRealtime("WaitableEvent::signal"); break;
+            }
+        }
+    };
+
+    LockListener lockListener;
+}
+
+//==============================================================================
+RealtimeSanitiser::ScopedRealtime::ScopedRealtime(bool isRealtime) noexcept
+    : active(isRealtime)
+{
+    if (active)
+        ++threadState.realtimeDepth;
+}
+
+RealtimeSanitiser::ScopedRealtime::~ScopedRealtime() noexcept
+{
+    if (active)
+        --threadState.realtimeDepth;
+}
+
+RealtimeSanitiser::ScopedAllow::ScopedAllow() noexcept   { ++threadState.allowDepth; }
+RealtimeSanitiser::ScopedAllow::~ScopedAllow() noexcept  { --threadState.allowDepth; }
+
+bool RealtimeSanitiser::interceptsSystemCalls() noexcept
+{
+   #if defined(__GLIBC__)
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+uint64_t RealtimeSanitiser::getNumViolations() noexcept
+{
+    return numViolations.load(std::memory_order_relaxed);
+}
+
+juce::String RealtimeSanitiser::getFirstViolationReport()
+{
+    return isFirstViolationReady.load(std::memory_order_acquire) ? firstViolationReport : juce::String();
+}
+
+void RealtimeSanitiser::reset()
+{
+    isFirstViolationReady.store(false);
+    firstViolationReport = {};
+    numViolations.store(0);
+    hasFirstViolation.store(false);
+}
+
+//==============================================================================
+#if defined(__GLIBC__)
+
+namespace
+{
+    // The next definition of an interposed function, normally the one in libc
+    void* findNext(std::atomic<void*>& cache, const char* name) noexcept
+    {
+        auto* function = cache.load(std::memory_order_relaxed);
+
+        if (function == nullptr) {
+            function = dlsym(RTLD_NEXT, name);
+            cache.store(function, std::memory_order_relaxed);
+        }
+
+        return function;
+    }
+}
+
+// Forwards to the next definition of the enclosing function, after checking the call
+#define FXPLUGIN_CALL_NEXT(name, ...) \
+    static std::atomic<void*> next { nullptr }; \
+    checkRealtime(#name); \
+    return reinterpret_cast<decltype(&name)>(findNext(next, #name))(__VA_ARGS__);
+
+extern "C"
+{
+    // glibc's allocator entry points, which the interposers forward to without
+    // going through dlsym, as dlsym itself allocates
+    void* __libc_malloc(size_t) noexcept;
+    void* __libc_calloc(size_t, size_t) noexcept;
+    void* __libc_realloc(void*, size_t) noexcept;
+    void* __libc_memalign(size_t, size_t) noexcept;
+    void __libc_free(void*) noexcept;
+
+    void* malloc(size_t size) noexcept
+    {
+        checkRealtime("malloc");
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size) noexcept
+    {
+        checkRealtime("calloc");
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* pointer, size_t size) noexcept
+    {
+        checkRealtime("realloc");
+        return __libc_realloc(pointer, size);
+    }
+
+    void* memalign(size_t alignment, size_t size) noexcept
+    {
+        checkRealtime("memalign");
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size) noexcept
+    {
+        checkRealtime("aligned_alloc");
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** result, size_t alignment, size_t size) noexcept
+    {
+        checkRealtime("posix_memalign");
+
+        if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+            return EINVAL;
+
+        *result = __libc_memalign(alignment, size);
+        return *result != nullptr ? 0 : ENOMEM;
+    }
+
+    void free(void* pointer) noexcept
+    {
+        if (pointer != nullptr)
+            checkRealtime("free");
+
+        __libc_free(pointer);
+    }
+
+    //==============================================================================
+    int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept                   { FXPLUGIN_CALL_NEXT(pthread_mutex_lock, mutex) }
+    int pthread_rwlock_rdlock(pthread_rwlock_t* lock) noexcept                { FXPLUGIN_CALL_NEXT(pthread_rwlock_rdlock, lock) }
+    int pthread_rwlock_wrlock(pthread_rwlock_t* lock) noexcept                { FXPLUGIN_CALL_NEXT(pthread_rwlock_wrlock, lock) }
+    int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex)  { FXPLUGIN_CALL_NEXT(pthread_cond_wait, condition, mutex) }
+    int pthread_join(pthread_t thread, void** result)                         { FXPLUGIN_CALL_NEXT(pthread_join, thread, result) }
+    int sem_wait(sem_t* semaphore)                                            { FXPLUGIN_CALL_NEXT(sem_wait, semaphore) }
+
+    int pthread_cond_timedwait(pthread_cond_t* condition, pthread_mutex_t* mutex, const struct timespec* time)
+    {
+        FXPLUGIN_CALL_NEXT(pthread_cond_timedwait, condition, mutex, time)
+    }
+
+    unsigned int sleep(unsigned int seconds)                                  { FXPLUGIN_CALL_NEXT(sleep, seconds) }
+    int usleep(useconds_t microseconds)                                       { FXPLUGIN_CALL_NEXT(usleep, microseconds) }
+    int nanosleep(const struct timespec* duration, struct timespec* remaining) { FXPLUGIN_CALL_NEXT(nanosleep, duration, remaining) }
+
+    int clock_nanosleep(clockid_t clock, int flags, const struct timespec* duration, struct timespec* remaining)
+    {
+        FXPLUGIN_CALL_NEXT(clock_nanosleep, clock, flags, duration, remaining)
+    }
+
+    ssize_t read(int fd, void* buffer, size_t size)                           { FXPLUGIN_CALL_NEXT(read, fd, buffer, size) }
+    ssize_t write(int fd, const void* buffer, size_t size)                    { FXPLUGIN_CALL_NEXT(write, fd, buffer, size) }
+    FILE* fopen(const char* path, const char* mode)                           { FXPLUGIN_CALL_NEXT(fopen, path, mode) }
+    int poll(struct pollfd* fds, nfds_t numFds, int timeout)                  { FXPLUGIN_CALL_NEXT(poll, fds, numFds, timeout) }
+
+    int select(int numFds, fd_set* readFds, fd_set* writeFds, fd_set* exceptFds, struct timeval* timeout)
+    {
+        FXPLUGIN_CALL_NEXT(select, numFds, readFds, writeFds, exceptFds, timeout)
+    }
+
+    int open(const char* path, int flags, ...)
+    {
+        mode_t mode = 0;
+
+        if ((flags & O_CREAT) != 0 || (flags & O_TMPFILE) == O_TMPFILE) {
+            va_list args;
+            va_start(args, flags);
+            mode = static_cast<mode_t>(va_arg(args, int));
+            va_end(args);
+        }
+
+        FXPLUGIN_CALL_NEXT(open, path, flags, mode)
+    }
+}
+
+// Checked here rather than in __cxa_throw, so a throw isn't first reported as the
+// malloc for its exception object
+namespace __cxxabiv1
+{
+    extern "C" void* __cxa_allocate_exception(size_t size) noexcept
+    {
+        FXPLUGIN_CALL_NEXT(__cxa_allocate_exception, size)
+    }
+}
+
+#undef FXPLUGIN_CALL_NEXT
+
+#else
+
+//==============================================================================
+// Without glibc's hooks only allocations made through operator new are seen, as
+// with juce::AllocationHooks
+void* operator new(size_t size)
+{
+    checkRealtime("operator new");
+
+    if (auto* pointer = std::malloc(size))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    checkRealtime("operator new[]");
+
+    if (auto* pointer = std::malloc(size))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    if (pointer != nullptr)
+        checkRealtime("operator delete");
+
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    if (pointer != nullptr)
+        checkRealtime("operator delete[]");
+
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    if (pointer != nullptr)
+        checkRealtime("operator delete");
+
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+    if (pointer != nullptr)
+        checkRealtime("operator delete[]");
+
+    std::free(pointer);
+}
+
+#endif
+
+#endif
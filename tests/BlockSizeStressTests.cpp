@@ -0,0 +1,223 @@
+#include "../include/PluginProcessor.h"
+
+#if JUCE_LINUX || JUCE_MAC
+ #include <time.h>
+#endif
+
+#if JUCE_UNIT_TESTS
+
+//==============================================================================
+// Feeds processBlock the block sizes hosts actually send: empty and one-sample
+// blocks, primes, random sizes and blocks larger than prepareToPlay announced,
+// with sample rate changes in between. Checks that realtime blocks stay free of
+// allocations and locks and within a time bound, and that offline the analysis
+// frames match a render in fixed blocks.
+class BlockSizeStressTests final : public juce::UnitTest
+{
+public:
+    BlockSizeStressTests() : juce::UnitTest("Block size stress", "FXPlugin") {}
+
+    void runTest() override
+    {
+        beginTest("Realtime: random block sizes and sample rate changes");
+        checkRealtime("anti-aliased", [](FXPluginProcessor& processor) {
+            processor.setWaveshaperAntiAliasing(2, 1);
+            processor.setWatchedFrequencies({ 60.0f, 1000.0f });
+            processor.setConstantQ(24);
+
+            FXPluginProcessor::LimiterSettings settings;
+            settings.enabled = true;
+            settings.ceilingDb = -6.0f;
+            processor.setLimiterSettings(settings);
+        });
+
+        checkRealtime("multiband", [](FXPluginProcessor& processor) {
+            FXPluginProcessor::MultibandSettings settings;
+            settings.enabled = true;
+            settings.numBands = 4;
+            processor.setMultibandSettings(settings);
+            processor.setWaveshaperAntiAliasing(0, 1);
+        });
+
+        beginTest("Offline: random block sizes analyse like fixed blocks");
+        {
+            // Each rate is rendered by a processor that already ran at the one before, so
+            // nothing from the previous rate may survive prepareToPlay
+            FXPluginProcessor processor;
+            configure(processor);
+
+            for (const auto sampleRate : sampleRates) {
+                FXPluginProcessor reference;
+                configure(reference);
+
+                const auto expected = recordAnalysis(reference, sampleRate, false);
+                const auto actual = recordAnalysis(processor, sampleRate, true);
+
+                expectGreaterThan(expected.size(), 100, juce::String(sampleRate) + " Hz");
+                expectEquals(actual.size(), expected.size(), juce::String(sampleRate) + " Hz: frame count");
+
+                int firstDifference = -1;
+                for (int i = 0; i < juce::jmin(actual.size(), expected.size()) && firstDifference < 0; ++i)
+                    if (actual[i] != expected[i])
+                        firstDifference = i;
+
+                expectEquals(firstDifference, -1, juce::String(sampleRate) + " Hz: first differing frame\n"
+                                                  + actual[juce::jmax(0, firstDifference)] + "\n"
+                                                  + expected[juce::jmax(0, firstDifference)]);
+            }
+        }
+    }
+
+private:
+    static constexpr int maxBlockSize = 512;
+    static constexpr double sampleRates[] = { 44100.0, 96000.0, 48000.0, 22050.0 };
+
+    // Mostly random sizes up to the maximum, mixed with the sizes that break
+    // assumptions: nothing, one sample, primes and up to four times the maximum
+    static int nextBlockSize(juce::Random& random)
+    {
+        static constexpr int primes[] = { 2, 3, 7, 13, 61, 127, 251, 509, 521, 1021, 2039 };
+
+        switch (random.nextInt(8)) {
+            case 0:  return 0;
+            case 1:  return 1;
+            case 2:  return primes[random.nextInt((int) std::size(primes))];
+            case 3:  return maxBlockSize + 1 + random.nextInt(3 * maxBlockSize);
+            default: return 1 + random.nextInt(maxBlockSize);
+        }
+    }
+
+    // The calling thread's CPU time, so that a test machine busy with other work
+    // doesn't count against a block; blocking calls are the sanitiser's to catch.
+    // Elsewhere the wall clock.
+    static double getThreadMilliseconds() noexcept
+    {
+#if JUCE_LINUX || JUCE_MAC
+        timespec time;
+        if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) == 0)
+            return time.tv_sec * 1000.0 + time.tv_nsec / 1.0e6;
+#endif
+
+        return juce::Time::getMillisecondCounterHiRes();
+    }
+
+    static void fillNoise(juce::AudioBuffer<float>& buffer, juce::Random& random)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample(channel, i, random.nextFloat() * 0.5f - 0.25f);
+    }
+
+    template <typename Setup>
+    void checkRealtime(const juce::String& configuration, Setup&& setup)
+    {
+        FXPluginProcessor processor;
+        setup(processor);
+        processor.getParameterTree().getParameter("distortion")->setValueNotifyingHost(0.6f);
+
+        juce::AudioBuffer<float> buffer(2, 4 * maxBlockSize);
+        juce::MidiBuffer midi;
+        auto random = getRandom();
+
+        for (const auto sampleRate : sampleRates) {
+            processor.setPlayConfigDetails(2, 2, sampleRate, maxBlockSize);
+            processor.prepareToPlay(sampleRate, maxBlockSize);
+
+            RealtimeSanitiser::reset();
+            auto worstExcessMs = std::numeric_limits<double>::lowest();
+            int worstBlockSize = 0;
+
+            for (int block = 0; block < 300; ++block) {
+                const int numSamples = nextBlockSize(random);
+                buffer.setSize(2, numSamples, false, false, true);
+                fillNoise(buffer, random);
+
+                const auto startMs = getThreadMilliseconds();
+                processor.processBlock(buffer, midi);
+                const auto elapsedMs = getThreadMilliseconds() - startMs;
+
+                // A millisecond per block plus realtime for its samples is generous; it
+                // catches a block whose cost stops scaling with its length
+                const auto boundMs = 1.0 + 1000.0 * numSamples / sampleRate;
+
+                if (elapsedMs - boundMs > worstExcessMs) {
+                    worstExcessMs = elapsedMs - boundMs;
+                    worstBlockSize = numSamples;
+                }
+
+                if (block % 20 == 0)
+                    juce::Thread::sleep(5);
+            }
+
+            const auto label = configuration + " at " + juce::String(sampleRate) + " Hz";
+            logMessage(label + ": closest to the bound was a " + juce::String(worstBlockSize) + "-sample block, "
+                       + juce::String(-worstExcessMs, 3) + " ms inside it");
+            expectEquals((int) RealtimeSanitiser::getNumViolations(), 0, label + ": " + RealtimeSanitiser::getFirstViolationReport());
+            expectLessOrEqual(worstExcessMs, 0.0, label + ": a " + juce::String(worstBlockSize) + "-sample block overran its time bound");
+
+            processor.releaseResources();
+        }
+    }
+
+    static void configure(FXPluginProcessor& processor)
+    {
+        processor.setWaveshaperAntiAliasing(2, 1);
+        processor.setWatchedFrequencies({ 60.0f, 1000.0f });
+        processor.setConstantQ(24);
+        processor.getParameterTree().getParameter("distortion")->setValueNotifyingHost(0.6f);
+    }
+
+    // Renders two seconds of noise offline, where every hop is analysed, and returns
+    // the recording's analysis frames as JSON strings. The writer fills z_score and
+    // the stereo and transient fields with random placeholders, so they're left out.
+    juce::StringArray recordAnalysis(FXPluginProcessor& processor, double sampleRate, bool randomBlocks)
+    {
+        juce::TemporaryFile recordingFile(".json");
+
+        processor.setNonRealtime(true);
+        processor.setOutputFilePath(recordingFile.getFile().getFullPathName());
+        processor.setPlayConfigDetails(2, 2, sampleRate, maxBlockSize);
+        processor.prepareToPlay(sampleRate, maxBlockSize);
+        processor.startRecording();
+
+        // The same noise in both renders; only the blocking differs
+        juce::Random noise(42), sizes = getRandom();
+        juce::AudioBuffer<float> input(2, static_cast<int>(2.0 * sampleRate)), buffer(2, 4 * maxBlockSize);
+        juce::MidiBuffer midi;
+        fillNoise(input, noise);
+
+        for (int start = 0; start < input.getNumSamples();) {
+            const int numSamples = juce::jmin(input.getNumSamples() - start,
+                                              randomBlocks ? nextBlockSize(sizes) : maxBlockSize);
+            buffer.setSize(2, numSamples, false, false, true);
+
+            for (int channel = 0; channel < 2; ++channel)
+                buffer.copyFrom(channel, 0, input, channel, start, numSamples);
+
+            processor.processBlock(buffer, midi);
+            start += numSamples;
+        }
+
+        processor.stopRecording();
+        processor.releaseResources();
+
+        juce::StringArray frames;
+        const auto recording = juce::JSON::parse(recordingFile.getFile());
+
+        if (auto* analysis = recording["analysis"].getArray())
+            for (const auto& frame : *analysis) {
+                if (auto* object = frame.getDynamicObject())
+                    for (const auto* placeholder : { "z_score", "phase_correlation", "stereo_width", "transient_sharpness",
+                                                     "rms_rise_time_ms", "onset_detected" })
+                        object->removeProperty(placeholder);
+
+                frames.add(juce::JSON::toString(frame, true));
+            }
+
+        return frames;
+    }
+};
+
+static BlockSizeStressTests blockSizeStressTests;
+
+#endif
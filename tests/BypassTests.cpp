@@ -0,0 +1,116 @@
+#include "../include/PluginProcessor.h"
+
+#if JUCE_UNIT_TESTS
+
+//==============================================================================
+// Sends an impulse through processBlockBypassed, in both precisions, to check a
+// bypassed block still comes out after the latency the plugin reports.
+class BypassTests final : public juce::UnitTest
+{
+public:
+    BypassTests() : juce::UnitTest("Bypass", "FXPlugin") {}
+
+    void runTest() override
+    {
+        beginTest("Without latency the input passes straight through");
+        {
+            checkBypassDelay<float>([](FXPluginProcessor&) {}, false);
+            checkBypassDelay<double>([](FXPluginProcessor&) {}, false);
+        }
+
+        beginTest("Oversampling latency is kept while bypassed");
+        {
+            const auto setup = [](FXPluginProcessor& processor) { processor.setWaveshaperAntiAliasing(1, 1); };
+            checkBypassDelay<float>(setup, true);
+            checkBypassDelay<double>(setup, true);
+        }
+
+        beginTest("Limiter lookahead is kept while bypassed");
+        {
+            const auto setup = [](FXPluginProcessor& processor) {
+                FXPluginProcessor::LimiterSettings settings;
+                settings.enabled = true;
+                processor.setLimiterSettings(settings);
+            };
+
+            checkBypassDelay<float>(setup, true);
+            checkBypassDelay<double>(setup, true);
+        }
+
+        beginTest("Oversampling and limiter latencies add up while bypassed");
+        {
+            const auto setup = [](FXPluginProcessor& processor) {
+                processor.setWaveshaperAntiAliasing(1, 1);
+
+                FXPluginProcessor::LimiterSettings settings;
+                settings.enabled = true;
+                processor.setLimiterSettings(settings);
+            };
+
+            checkBypassDelay<float>(setup, true);
+            checkBypassDelay<double>(setup, true);
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 256;
+    static constexpr int impulsePosition = 100;
+
+    // Renders a few bypassed blocks with an impulse in the first one, and checks it
+    // comes out unchanged, delayed by exactly the reported latency
+    template <typename SampleType, typename Setup>
+    void checkBypassDelay(Setup&& setup, bool expectLatency)
+    {
+        FXPluginProcessor processor;
+
+        if constexpr (std::is_same_v<SampleType, double>)
+            processor.setProcessingPrecision(juce::AudioProcessor::doublePrecision);
+
+        setup(processor);
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        const auto latency = processor.getLatencySamples();
+        expect(expectLatency ? latency > 0 : latency == 0, "latency " + juce::String(latency));
+
+        constexpr int numBlocks = 4;
+        juce::AudioBuffer<SampleType> buffer(2, blockSize);
+        juce::MidiBuffer midi;
+        int peakPosition = -1;
+        auto peak = SampleType(), total = SampleType();
+
+        RealtimeSanitiser::reset();
+
+        for (int block = 0; block < numBlocks; ++block) {
+            buffer.clear();
+
+            if (block == 0)
+                for (int channel = 0; channel < 2; ++channel)
+                    buffer.setSample(channel, impulsePosition, (SampleType) 1);
+
+            processor.processBlockBypassed(buffer, midi);
+
+            for (int i = 0; i < blockSize; ++i) {
+                const auto sample = std::abs(buffer.getSample(1, i));
+                total += sample;
+
+                if (sample > peak) {
+                    peak = sample;
+                    peakPosition = block * blockSize + i;
+                }
+            }
+        }
+
+        expectEquals(peakPosition, impulsePosition + latency);
+        expectEquals((double) peak, 1.0);
+        expectEquals((double) total, 1.0, "nothing but the impulse");
+        expectEquals((int) RealtimeSanitiser::getNumViolations(), 0, RealtimeSanitiser::getFirstViolationReport());
+
+        processor.releaseResources();
+    }
+};
+
+static BypassTests bypassTests;
+
+#endif
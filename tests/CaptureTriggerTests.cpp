@@ -0,0 +1,80 @@
+#include "../include/PluginProcessor.h"
+
+#if JUCE_UNIT_TESTS
+
+//==============================================================================
+// Arms the band energy trigger and renders sines offline, where every hop is
+// analysed, to check the trigger watches the band's frequencies.
+class CaptureTriggerTests final : public juce::UnitTest
+{
+public:
+    CaptureTriggerTests() : juce::UnitTest("Capture triggers", "FXPlugin") {}
+
+    void runTest() override
+    {
+        beginTest("Band energy follows the band's frequencies");
+        {
+            // "mid" is 500 Hz to 2 kHz
+            expectEquals(countSegments(3, 700.0), 1, "700 Hz, inside the band");
+            expectEquals(countSegments(3, 3000.0), 0, "3 kHz, above it");
+            expectEquals(countSegments(3, 200.0), 0, "200 Hz, below it");
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 480;
+    static constexpr int numBlocks = 100;
+    static constexpr double fadeSeconds = 0.1;
+
+    // Records a 0.5 amplitude sine with the band energy trigger on the given band
+    // and returns the number of segments it captured. The sine fades in, so that
+    // starting it doesn't spread energy over every band.
+    static int countSegments(int bandIndex, double frequency)
+    {
+        const auto directory = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                                   .getNonexistentChildFile("FXPluginTriggerTest", {}, false);
+        directory.createDirectory();
+
+        FXPluginProcessor processor;
+        processor.setNonRealtime(true);
+        processor.setOutputFilePath(directory.getChildFile("recording.json").getFullPathName());
+
+        CaptureTrigger::Settings settings;
+        settings.mode = CaptureTrigger::Mode::bandEnergy;
+        settings.bandIndex = bandIndex;
+        settings.thresholdDb = 0.0f;
+        processor.setTriggerSettings(settings);
+
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+        processor.startRecording();
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midi;
+
+        for (int block = 0; block < numBlocks; ++block) {
+            for (int i = 0; i < blockSize; ++i) {
+                const auto time = (block * blockSize + i) / sampleRate;
+                const auto fade = juce::jmin(1.0, time / fadeSeconds);
+                const auto sample = (float) (0.5 * fade * fade * std::sin(juce::MathConstants<double>::twoPi * frequency * time));
+
+                for (int channel = 0; channel < 2; ++channel)
+                    buffer.setSample(channel, i, sample);
+            }
+
+            processor.processBlock(buffer, midi);
+        }
+
+        processor.stopRecording();
+        processor.releaseResources();
+
+        const auto numSegments = processor.getNumCapturedSegments();
+        directory.deleteRecursively();
+        return numSegments;
+    }
+};
+
+static CaptureTriggerTests captureTriggerTests;
+
+#endif
@@ -0,0 +1,163 @@
+#include "../include/PluginProcessor.h"
+#include "../include/PluginEditor.h"
+#include <thread>
+
+#if JUCE_UNIT_TESTS
+
+//==============================================================================
+// Checks the triple buffer the processor hands editor snapshots over with, that
+// a snapshot describes the block that published it, and that the editor's sliders
+// follow the parameters rather than the snapshots.
+class EditorSnapshotTests final : public juce::UnitTest
+{
+public:
+    EditorSnapshotTests() : juce::UnitTest("Editor snapshots", "FXPlugin") {}
+
+    void runTest() override
+    {
+        beginTest("Triple buffer never tears and only moves forward");
+        {
+            struct Value {
+                std::array<uint64_t, 16> fields {};
+            };
+
+            TripleBuffer<Value> tripleBuffer;
+            std::atomic<bool> isWriting { true };
+            constexpr uint64_t numValues = 200000;
+
+            std::thread writer([&] {
+                for (uint64_t i = 1; i <= numValues; ++i) {
+                    tripleBuffer.getWriteBuffer().fields.fill(i);
+                    tripleBuffer.publish();
+                }
+
+                isWriting = false;
+            });
+
+            uint64_t last = 0;
+            int numTorn = 0, numBackwards = 0;
+
+            for (;;) {
+                const bool wasWriting = isWriting.load();
+
+                if (tripleBuffer.update()) {
+                    const auto& fields = tripleBuffer.getReadBuffer().fields;
+
+                    for (const auto field : fields)
+                        numTorn += field != fields[0] ? 1 : 0;
+
+                    numBackwards += fields[0] <= last ? 1 : 0;
+                    last = fields[0];
+                }
+                else if (!wasWriting) {
+                    break;
+                }
+            }
+
+            writer.join();
+
+            expectEquals(numTorn, 0);
+            expectEquals(numBackwards, 0);
+            expect(last == numValues, "the last value published is read");
+            expect(!tripleBuffer.update(), "nothing new after the last value");
+        }
+
+        beginTest("Snapshot follows processBlock");
+        {
+            constexpr double sampleRate = 48000.0;
+            constexpr int blockSize = 480;
+
+            FXPluginProcessor processor;
+            processor.getParameterTree().getParameter("distortion")->setValueNotifyingHost(0.25f);
+            processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+            processor.prepareToPlay(sampleRate, blockSize);
+
+            FXPluginProcessor::EditorSnapshot snapshot;
+            expect(!processor.pullEditorSnapshot(snapshot), "nothing before the first block");
+
+            // Full-scale square wave on the left, silence on the right; the default
+            // gain of 1 and a light waveshaper keep the left channel at tanh(2.5)
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            juce::MidiBuffer midi;
+
+            for (int block = 0; block < 200; ++block) {
+                buffer.clear();
+
+                for (int i = 0; i < blockSize; ++i)
+                    buffer.setSample(0, i, (i / 24) % 2 == 0 ? 1.0f : -1.0f);
+
+                processor.processBlock(buffer, midi);
+            }
+
+            expect(processor.pullEditorSnapshot(snapshot));
+            expect(!processor.pullEditorSnapshot(snapshot), "each snapshot is pulled once");
+
+            expectWithinAbsoluteError(snapshot.distortion, 0.25f, 1.0e-6f);
+            expectWithinAbsoluteError(snapshot.gain, 1.0f, 1.0e-6f);
+            expectEquals(snapshot.numMeterChannels, 2);
+            expectWithinAbsoluteError(snapshot.peakLevels[0], std::tanh(2.5f), 1.0e-3f);
+            expectWithinAbsoluteError(snapshot.rmsLevels[0], std::tanh(2.5f), 1.0e-2f);
+            expectEquals(snapshot.peakLevels[1], 0.0f);
+            expect(snapshot.blocksProcessed == 200);
+            expect(snapshot.samplesProcessed == 200 * blockSize);
+            expect(!snapshot.isRecording);
+            expect(snapshot.processLoad > 0.0f && snapshot.processLoad <= 1.0f);
+
+            // After silence the meters fall with the release time. The analysis runs on
+            // the worker pool, so give it time to catch up too.
+            for (int block = 0; block < 300; ++block) {
+                buffer.clear();
+                processor.processBlock(buffer, midi);
+
+                if (block % 20 == 0)
+                    juce::Thread::sleep(5);
+            }
+
+            expect(processor.pullEditorSnapshot(snapshot));
+            expect(snapshot.analysisFramesWritten > 0);
+            expect(snapshot.peakLevels[0] < 0.01f, "peak released");
+            expect(snapshot.rmsLevels[0] < 0.01f, "RMS released");
+
+            processor.releaseResources();
+        }
+
+        beginTest("Sliders follow the parameters while no audio runs");
+        {
+            FXPluginProcessor processor;
+            std::unique_ptr<juce::AudioProcessorEditor> editor(processor.createEditor());
+            juce::Array<juce::Slider*> sliders;
+
+            for (auto* child : editor->getChildren())
+                if (auto* slider = dynamic_cast<juce::Slider*>(child))
+                    sliders.add(slider);
+
+            expectEquals(sliders.size(), 2);
+
+            if (sliders.size() != 2)
+                return;
+
+            auto& gainSlider = *sliders[0];
+            auto& distortionSlider = *sliders[1];
+            auto* gain = processor.getParameterTree().getParameter("gain");
+            auto* distortion = processor.getParameterTree().getParameter("distortion");
+
+            // The sliders cover the parameters' whole ranges
+            expectEquals(gainSlider.getMaximum(), 3.0);
+            expectEquals(gainSlider.getValue(), 1.0);
+
+            // Automation, with no processBlock to publish a snapshot
+            gain->setValueNotifyingHost(gain->convertTo0to1(2.5f));
+            distortion->setValueNotifyingHost(0.4f);
+            expectWithinAbsoluteError(gainSlider.getValue(), 2.5, 1.0e-6);
+            expectWithinAbsoluteError(distortionSlider.getValue(), 0.4, 1.0e-6);
+
+            // And the other way, from the slider to the parameter
+            distortionSlider.setValue(0.75, juce::sendNotificationSync);
+            expectWithinAbsoluteError(distortion->getValue(), 0.75f, 1.0e-6f);
+        }
+    }
+};
+
+static EditorSnapshotTests editorSnapshotTests;
+
+#endif
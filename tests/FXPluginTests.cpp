@@ -0,0 +1,21 @@
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+
+//==============================================================================
+// Runs the plugin's unit tests, or those of the category given on the command
+// line, and returns non-zero if any of them failed.
+int main(int argc, char* argv[])
+{
+    const juce::ScopedJuceInitialiser_GUI libraryInitialiser;
+    const juce::String category = argc > 1 ? juce::String(argv[1]) : juce::String("FXPlugin");
+    
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+    runner.runTestsInCategory(category);
+    
+    int numFailures = 0;
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        numFailures += runner.getResult(i)->failures;
+    
+    return numFailures > 0 || runner.getNumResults() == 0 ? 1 : 0;
+}
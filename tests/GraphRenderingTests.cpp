@@ -0,0 +1,141 @@
+#include "../include/PluginProcessor.h"
+
+#if JUCE_UNIT_TESTS
+
+//==============================================================================
+// Hosts FXPluginProcessor instances in a juce::AudioProcessorGraph, as the render
+// farm does, and checks that rendering them on the graph's worker threads changes
+// nothing but the time it takes. The scaling of that time is logged.
+class GraphRenderingTests final : public juce::UnitTest
+{
+public:
+    GraphRenderingTests() : juce::UnitTest("Graph rendering", "FXPlugin") {}
+
+    void runTest() override
+    {
+        beginTest("Parallel rendering matches serial rendering");
+        {
+            juce::AudioProcessorGraph serial, parallel;
+            buildRenderFarm(serial, 16);
+            buildRenderFarm(parallel, 16);
+            parallel.setNumWorkerThreads(4);
+
+            juce::AudioBuffer<float> serialBuffer(2, blockSize), parallelBuffer(2, blockSize);
+            juce::MidiBuffer midi;
+            auto random = getRandom();
+            auto identical = true;
+
+            RealtimeSanitiser::reset();
+
+            for (int block = 0; block < 100; ++block) {
+                fillWithNoise(serialBuffer, random);
+                parallelBuffer.makeCopyOf(serialBuffer, true);
+
+                serial.processBlock(serialBuffer, midi);
+
+                {
+                    // Covers handing the block to the workers and waking them
+                    const RealtimeSanitiser::ScopedRealtime realtimeScope;
+                    parallel.processBlock(parallelBuffer, midi);
+                }
+
+                for (int channel = 0; channel < 2; ++channel)
+                    identical &= std::memcmp(serialBuffer.getReadPointer(channel),
+                                             parallelBuffer.getReadPointer(channel),
+                                             sizeof(float) * (size_t) blockSize) == 0;
+            }
+
+            expect(identical);
+
+            // The graph's own processBlock, and the instances' processBlock on the workers
+            expectEquals((int) RealtimeSanitiser::getNumViolations(), 0, RealtimeSanitiser::getFirstViolationReport());
+        }
+
+        beginTest("Render farm scaling");
+        {
+            constexpr int numInstances = 64;
+            double serialMs = 0.0;
+
+            logMessage(juce::String(numInstances) + " instances, " + juce::String(blockSize) + "-sample blocks, "
+                       + juce::String(juce::SystemStats::getNumCpus()) + " hardware threads");
+
+            for (const auto numThreads : { 0, 1, 2, 4, 8, 16, 32, 64 }) {
+                juce::AudioProcessorGraph graph;
+                buildRenderFarm(graph, numInstances);
+                graph.setNumWorkerThreads(numThreads);
+
+                const auto msPerBlock = timeBlocks(graph);
+
+                if (numThreads == 0)
+                    serialMs = msPerBlock;
+
+                logMessage(juce::String(numThreads).paddedLeft(' ', 2) + " worker threads: "
+                           + juce::String(msPerBlock, 3) + " ms per block, "
+                           + juce::String(serialMs / msPerBlock, 2) + "x serial");
+            }
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 512;
+
+    // Every instance takes the graph's input and adds into its output
+    static void buildRenderFarm(juce::AudioProcessorGraph& graph, int numInstances)
+    {
+        using IO = juce::AudioProcessorGraph::AudioGraphIOProcessor;
+
+        graph.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+
+        const auto input = graph.addNode(std::make_unique<IO>(IO::audioInputNode))->nodeID;
+        const auto output = graph.addNode(std::make_unique<IO>(IO::audioOutputNode))->nodeID;
+
+        for (int i = 0; i < numInstances; ++i) {
+            auto processor = std::make_unique<FXPluginProcessor>();
+            processor->setWaveshaperAntiAliasing(2, 1);
+            processor->getParameterTree().getParameter("distortion")->setValueNotifyingHost(0.3f + 0.01f * (float) (i % 32));
+
+            const auto node = graph.addNode(std::move(processor))->nodeID;
+
+            for (int channel = 0; channel < 2; ++channel) {
+                graph.addConnection({ { input, channel }, { node, channel } });
+                graph.addConnection({ { node, channel }, { output, channel } });
+            }
+        }
+
+        graph.prepareToPlay(sampleRate, blockSize);
+    }
+
+    static void fillWithNoise(juce::AudioBuffer<float>& buffer, juce::Random& random)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample(channel, i, random.nextFloat() * 0.5f - 0.25f);
+    }
+
+    static double timeBlocks(juce::AudioProcessorGraph& graph)
+    {
+        constexpr int numWarmUpBlocks = 10, numTimedBlocks = 50;
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midi;
+        juce::Random random(1);
+        double totalMs = 0.0;
+
+        for (int block = 0; block < numWarmUpBlocks + numTimedBlocks; ++block) {
+            fillWithNoise(buffer, random);
+
+            const auto start = juce::Time::getMillisecondCounterHiRes();
+            graph.processBlock(buffer, midi);
+
+            if (block >= numWarmUpBlocks)
+                totalMs += juce::Time::getMillisecondCounterHiRes() - start;
+        }
+
+        return totalMs / numTimedBlocks;
+    }
+};
+
+static GraphRenderingTests graphRenderingTests;
+
+#endif
@@ -0,0 +1,369 @@
+#include "../include/PluginProcessor.h"
+#include <ctime>
+#include <iostream>
+#include <map>
+
+#if JUCE_LINUX
+ #include <unistd.h>
+ #if defined (__GLIBC__)
+  #include <malloc.h>
+ #endif
+#elif JUCE_MAC
+ #include <mach/mach.h>
+#endif
+
+//==============================================================================
+// Headless load test: runs 1 up to --max-instances processors on synthetic input
+// and prints, as JSON, how each count holds up against the block deadline.
+//
+//   FXPluginLoadTest [--max-instances=64] [--step=0] [--block-size=512]
+//                    [--sample-rate=48000] [--seconds=5] [--graph] [--threads=0]
+//                    [--record] [--unpaced] [--signal=noise|sine|silence]
+//                    [--output=file.json]
+//
+// --step=0 doubles the count each time; any other step adds to it, and the sweep
+// always ends on --max-instances itself. Blocks are paced like a realtime callback
+// unless --unpaced, so the analysis threads get the idle time a host would leave
+// them. The knee is the first count with a block slower than its deadline. After
+// the first miss the counts between it and the last one that kept up are
+// bisected to find it exactly, then the sweep carries on to show the trend.
+namespace
+{
+    struct Options {
+        int maxInstances = 64;
+        int step = 0;
+        int blockSize = 512;
+        double sampleRate = 48000.0;
+        double seconds = 5.0;
+        bool useGraph = false;
+        int numGraphThreads = 0;
+        bool record = false;
+        bool paced = true;
+        juce::String signal = "noise";
+        juce::File output;
+    };
+
+    struct Result {
+        int numInstances = 0;
+        double realTimeFactor = 0.0;
+        double meanBlockMs = 0.0;
+        double p99BlockMs = 0.0;
+        double maxBlockMs = 0.0;
+        int numBlocks = 0;
+        int deadlineMisses = 0;
+        double cpuPercentPerInstance = 0.0;          // render thread, of one core
+        double processCpuPercentPerInstance = 0.0;   // every thread, analysis included
+        juce::int64 memoryBytesPerInstance = -1;
+        juce::uint64 droppedAnalysisHops = 0;
+    };
+
+    // Resident set size of the process, or -1 where it isn't known. glibc is asked to
+    // hand back what the previous count freed first, or the new instances would reuse
+    // it and look smaller than they are.
+    juce::int64 getResidentBytes()
+    {
+       #if JUCE_LINUX
+       #if defined (__GLIBC__)
+        malloc_trim(0);
+       #endif
+
+        long pages = 0, residentPages = 0;
+
+        if (auto* file = std::fopen("/proc/self/statm", "r")) {
+            const auto numRead = std::fscanf(file, "%ld %ld", &pages, &residentPages);
+            std::fclose(file);
+
+            if (numRead == 2)
+                return static_cast<juce::int64>(residentPages) * static_cast<juce::int64>(sysconf(_SC_PAGESIZE));
+        }
+
+        return -1;
+       #elif JUCE_MAC
+        mach_task_basic_info info;
+        mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+
+        if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS)
+            return static_cast<juce::int64>(info.resident_size);
+
+        return -1;
+       #else
+        return -1;
+       #endif
+    }
+
+    // The same input for every instance, so they all do the same work
+    void fillSignal(juce::AudioBuffer<float>& buffer, const juce::String& signal, juce::Random& random,
+                    juce::int64 position, double sampleRate)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            for (int i = 0; i < buffer.getNumSamples(); ++i) {
+                float sample = 0.0f;
+
+                if (signal == "sine")
+                    sample = 0.25f * static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * 1000.0 * static_cast<double>(position + i) / sampleRate));
+                else if (signal != "silence")
+                    sample = random.nextFloat() * 0.5f - 0.25f;
+
+                buffer.setSample(channel, i, sample);
+            }
+    }
+
+    std::unique_ptr<FXPluginProcessor> createInstance(const Options& options, int index, const juce::File& recordingFolder)
+    {
+        auto processor = std::make_unique<FXPluginProcessor>();
+        processor->setWaveshaperAntiAliasing(2, 1);
+        processor->getParameterTree().getParameter("distortion")->setValueNotifyingHost(0.3f + 0.01f * static_cast<float>(index % 32));
+
+        if (options.record)
+            processor->setOutputFilePath(recordingFolder.getChildFile("instance_" + juce::String(index) + ".json").getFullPathName());
+
+        return processor;
+    }
+
+    Result runInstances(const Options& options, int numInstances, const juce::File& recordingFolder)
+    {
+        using IO = juce::AudioProcessorGraph::AudioGraphIOProcessor;
+
+        Result result;
+        result.numInstances = numInstances;
+
+        const auto residentBefore = getResidentBytes();
+        std::vector<std::unique_ptr<FXPluginProcessor>> instances;
+        std::vector<FXPluginProcessor*> processors;
+        juce::AudioProcessorGraph graph;
+
+        if (options.useGraph) {
+            // Every instance takes the graph's input and adds into its output
+            graph.setPlayConfigDetails(2, 2, options.sampleRate, options.blockSize);
+            const auto input = graph.addNode(std::make_unique<IO>(IO::audioInputNode))->nodeID;
+            const auto output = graph.addNode(std::make_unique<IO>(IO::audioOutputNode))->nodeID;
+
+            for (int i = 0; i < numInstances; ++i) {
+                auto processor = createInstance(options, i, recordingFolder);
+                processors.push_back(processor.get());
+                const auto node = graph.addNode(std::move(processor))->nodeID;
+
+                for (int channel = 0; channel < 2; ++channel) {
+                    graph.addConnection({ { input, channel }, { node, channel } });
+                    graph.addConnection({ { node, channel }, { output, channel } });
+                }
+            }
+
+            graph.setNumWorkerThreads(options.numGraphThreads);
+            graph.prepareToPlay(options.sampleRate, options.blockSize);
+        }
+        else {
+            for (int i = 0; i < numInstances; ++i) {
+                instances.push_back(createInstance(options, i, recordingFolder));
+                processors.push_back(instances.back().get());
+                instances.back()->setPlayConfigDetails(2, 2, options.sampleRate, options.blockSize);
+                instances.back()->prepareToPlay(options.sampleRate, options.blockSize);
+            }
+        }
+
+        const auto residentAfter = getResidentBytes();
+
+        if (residentBefore >= 0 && residentAfter >= 0)
+            result.memoryBytesPerInstance = juce::jmax(juce::int64(0), residentAfter - residentBefore) / numInstances;
+
+        if (options.record)
+            for (auto* processor : processors)
+                processor->startRecording();
+
+        const auto numBlocks = juce::jmax(1, juce::roundToInt(options.seconds * options.sampleRate / options.blockSize));
+        const auto deadlineMs = 1000.0 * options.blockSize / options.sampleRate;
+
+        juce::AudioBuffer<float> source(2, options.blockSize);
+        std::vector<juce::AudioBuffer<float>> buffers(options.useGraph ? 1 : static_cast<size_t>(numInstances),
+                                                      juce::AudioBuffer<float>(2, options.blockSize));
+        juce::MidiBuffer midi;
+        juce::Random random(1);
+        std::vector<double> blockMs;
+        blockMs.reserve(static_cast<size_t>(numBlocks));
+
+        const auto cpuStart = std::clock();
+        const auto startMs = juce::Time::getMillisecondCounterHiRes();
+        auto totalMs = 0.0;
+
+        for (int block = 0; block < numBlocks; ++block) {
+            fillSignal(source, options.signal, random, static_cast<juce::int64>(block) * options.blockSize, options.sampleRate);
+
+            for (auto& buffer : buffers)
+                buffer.makeCopyOf(source, true);
+
+            const auto blockStart = juce::Time::getMillisecondCounterHiRes();
+
+            if (options.useGraph)
+                graph.processBlock(buffers.front(), midi);
+            else
+                for (size_t i = 0; i < instances.size(); ++i)
+                    instances[i]->processBlock(buffers[i], midi);
+
+            const auto elapsed = juce::Time::getMillisecondCounterHiRes() - blockStart;
+            blockMs.push_back(elapsed);
+            totalMs += elapsed;
+
+            if (elapsed > deadlineMs)
+                ++result.deadlineMisses;
+
+            // Wait for this block's slot to end, as the next callback would
+            if (options.paced) {
+                const auto nextBlockMs = startMs + (block + 1) * deadlineMs;
+                const auto now = juce::Time::getMillisecondCounterHiRes();
+
+                if (nextBlockMs > now)
+                    juce::Thread::sleep(static_cast<int>(nextBlockMs - now));
+            }
+        }
+
+        const auto cpuSeconds = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+        const auto audioSeconds = numBlocks * options.blockSize / options.sampleRate;
+
+        std::sort(blockMs.begin(), blockMs.end());
+        result.numBlocks = numBlocks;
+        result.realTimeFactor = totalMs > 0.0 ? audioSeconds * 1000.0 / totalMs : 0.0;
+        result.meanBlockMs = totalMs / numBlocks;
+        result.p99BlockMs = blockMs[static_cast<size_t>(0.99 * (numBlocks - 1))];
+        result.maxBlockMs = blockMs.back();
+        result.cpuPercentPerInstance = 100.0 * totalMs / (audioSeconds * 1000.0) / numInstances;
+        result.processCpuPercentPerInstance = 100.0 * cpuSeconds / audioSeconds / numInstances;
+
+        for (auto* processor : processors) {
+            if (options.record)
+                processor->stopRecording();
+
+            result.droppedAnalysisHops += processor->getNumDroppedAnalysisHops();
+        }
+
+        return result;
+    }
+
+    juce::var toVar(const Result& result, double deadlineMs)
+    {
+        auto* object = new juce::DynamicObject();
+        object->setProperty("instances", result.numInstances);
+        object->setProperty("real_time_factor", result.realTimeFactor);
+        object->setProperty("mean_block_ms", result.meanBlockMs);
+        object->setProperty("p99_block_ms", result.p99BlockMs);
+        object->setProperty("max_block_ms", result.maxBlockMs);
+        object->setProperty("deadline_ms", deadlineMs);
+        object->setProperty("deadline_misses", result.deadlineMisses);
+        object->setProperty("deadline_miss_ratio", static_cast<double>(result.deadlineMisses) / result.numBlocks);
+        object->setProperty("cpu_percent_per_instance", result.cpuPercentPerInstance);
+        object->setProperty("process_cpu_percent_per_instance", result.processCpuPercentPerInstance);
+        object->setProperty("memory_bytes_per_instance", result.memoryBytesPerInstance >= 0 ? juce::var(result.memoryBytesPerInstance) : juce::var());
+        object->setProperty("dropped_analysis_hops", static_cast<juce::int64>(result.droppedAnalysisHops));
+        return object;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const juce::ScopedJuceInitialiser_GUI libraryInitialiser;
+    const juce::ArgumentList arguments(argc, argv);
+
+    const auto intOption = [&](const char* name, int fallback) {
+        return arguments.containsOption(name) ? arguments.getValueForOption(name).getIntValue() : fallback;
+    };
+
+    const auto doubleOption = [&](const char* name, double fallback) {
+        return arguments.containsOption(name) ? arguments.getValueForOption(name).getDoubleValue() : fallback;
+    };
+
+    Options options;
+    options.maxInstances = juce::jmax(1, intOption("--max-instances", options.maxInstances));
+    options.step = juce::jmax(0, intOption("--step", options.step));
+    options.blockSize = juce::jlimit(1, 8192, intOption("--block-size", options.blockSize));
+    options.sampleRate = juce::jlimit(8000.0, 384000.0, doubleOption("--sample-rate", options.sampleRate));
+    options.seconds = juce::jmax(0.1, doubleOption("--seconds", options.seconds));
+    options.useGraph = arguments.containsOption("--graph");
+    options.numGraphThreads = juce::jmax(0, intOption("--threads", options.numGraphThreads));
+    options.record = arguments.containsOption("--record");
+    options.paced = !arguments.containsOption("--unpaced");
+
+    if (arguments.containsOption("--signal"))
+        options.signal = arguments.getValueForOption("--signal");
+
+    if (arguments.containsOption("--output"))
+        options.output = arguments.getFileForOption("--output");
+
+    const auto recordingFolder = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                                     .getNonexistentChildFile("FXPluginLoadTest", {});
+
+    if (options.record)
+        recordingFolder.createDirectory();
+
+    const auto deadlineMs = 1000.0 * options.blockSize / options.sampleRate;
+    std::map<int, juce::var> results;
+
+    // Returns true if the count kept up with every deadline
+    const auto keepsUp = [&](int numInstances) {
+        const auto result = runInstances(options, numInstances, recordingFolder);
+        results[numInstances] = toVar(result, deadlineMs);
+
+        std::cerr << numInstances << " instances: " << juce::String(result.realTimeFactor, 2) << "x realtime, "
+                  << result.deadlineMisses << " deadline misses" << std::endl;
+
+        return result.deadlineMisses == 0 && result.realTimeFactor >= 1.0;
+    };
+
+    int lastKeptUp = 0, firstMissed = 0;
+
+    for (int numInstances = 1;;) {
+        if (keepsUp(numInstances)) {
+            if (firstMissed == 0)
+                lastKeptUp = numInstances;
+        }
+        else if (firstMissed == 0) {
+            firstMissed = numInstances;
+
+            while (firstMissed - lastKeptUp > 1) {
+                const auto middle = lastKeptUp + (firstMissed - lastKeptUp) / 2;
+
+                if (keepsUp(middle))
+                    lastKeptUp = middle;
+                else
+                    firstMissed = middle;
+            }
+        }
+
+        if (numInstances >= options.maxInstances)
+            break;
+
+        numInstances = juce::jmin(options.maxInstances, options.step > 0 ? numInstances + options.step : numInstances * 2);
+    }
+
+    if (options.record)
+        recordingFolder.deleteRecursively();
+
+    auto* config = new juce::DynamicObject();
+    config->setProperty("mode", options.useGraph ? "graph" : "direct");
+    config->setProperty("graph_threads", options.numGraphThreads);
+    config->setProperty("block_size", options.blockSize);
+    config->setProperty("sample_rate", options.sampleRate);
+    config->setProperty("seconds", options.seconds);
+    config->setProperty("recording", options.record);
+    config->setProperty("paced", options.paced);
+    config->setProperty("signal", options.signal);
+    config->setProperty("hardware_threads", juce::SystemStats::getNumCpus());
+    config->setProperty("cpu", juce::SystemStats::getCpuModel());
+
+    auto* report = new juce::DynamicObject();
+    report->setProperty("config", config);
+    juce::Array<juce::var> sortedResults;
+
+    for (const auto& [numInstances, result] : results)
+        sortedResults.add(result);
+
+    report->setProperty("results", sortedResults);
+    report->setProperty("knee_instances", firstMissed > 0 ? juce::var(firstMissed) : juce::var());
+    report->setProperty("max_sustained_instances", lastKeptUp > 0 ? juce::var(lastKeptUp) : juce::var());
+
+    const auto json = juce::JSON::toString(juce::var(report));
+
+    if (options.output != juce::File())
+        return options.output.replaceWithText(json) ? 0 : 1;
+
+    std::cout << json << std::endl;
+    return 0;
+}
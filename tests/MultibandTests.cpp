@@ -0,0 +1,189 @@
+#include "../include/PluginProcessor.h"
+
+#if JUCE_UNIT_TESTS
+
+//==============================================================================
+// Splits sines into the multiband waveshaper's bands, and checks the per-band
+// parameters, the latency and the analysis bands it adds.
+class MultibandTests final : public juce::UnitTest
+{
+public:
+    MultibandTests() : juce::UnitTest("Multiband waveshaper", "FXPlugin") {}
+
+    void runTest() override
+    {
+        beginTest("Off by default");
+        {
+            FXPluginProcessor processor;
+            expect(!processor.getMultibandSettings().enabled);
+
+            render(processor, 1000.0);
+            expect(findBand(processor, "band_1") == nullptr);
+        }
+
+        beginTest("Clean bands pass the signal at its level");
+        {
+            for (const auto frequency : { 100.0, 1000.0, 10000.0 }) {
+                FXPluginProcessor processor;
+                processor.setMultibandSettings(makeSettings(4));
+                expectWithinAbsoluteError(render(processor, frequency), 0.5f, 0.005f, juce::String(frequency) + " Hz");
+            }
+        }
+
+        beginTest("Each band has its own drive and gain");
+        {
+            // Two bands split at 1 kHz, the high one driven hard and the low one muted
+            const auto renderDriven = [this](double frequency, bool doublePrecision) {
+                FXPluginProcessor processor;
+                processor.setMultibandSettings(makeSettings(2));
+                setValue(processor, "band1Gain", 0.0f);
+                setValue(processor, "band2Drive", 1.0f);
+                return render(processor, frequency, doublePrecision);
+            };
+
+            for (const auto doublePrecision : { false, true }) {
+                expectLessOrEqual(renderDriven(100.0, doublePrecision), 0.01f);
+                expectGreaterThan(renderDriven(5000.0, doublePrecision), 0.95f);
+            }
+        }
+
+        beginTest("The bands join the analysis bands");
+        {
+            FXPluginProcessor processor;
+            processor.setMultibandSettings(makeSettings(3));
+            render(processor, 1000.0);
+
+            const auto* low = findBand(processor, "band_1");
+            const auto* high = findBand(processor, "band_3");
+
+            expect(low != nullptr && high != nullptr && findBand(processor, "band_4") == nullptr);
+
+            if (low != nullptr && high != nullptr) {
+                expectEquals(low->maxFreq, 200.0f);
+                expectEquals(high->minFreq, 2000.0f);
+                expectEquals(high->maxFreq, 20000.0f);
+            }
+
+            // A tone inside band_2 is measured there. At 350 Hz it is only a few FFT
+            // bins above the 200 Hz crossover, so a wrong bin width moves it out.
+            juce::TemporaryFile recordingFile(".json");
+            processor.setOutputFilePath(recordingFile.getFile().getFullPathName());
+            render(processor, 350.0, false, [&] { processor.startRecording(); });
+            processor.stopRecording();
+
+            const auto recording = juce::JSON::parse(recordingFile.getFile());
+            auto* frames = recording["analysis"].getArray();
+            expect(frames != nullptr && frames->size() > 10);
+
+            if (frames != nullptr && frames->size() > 10) {
+                const auto& lastFrame = frames->getReference(frames->size() - 1);
+                const auto& energy = lastFrame["band_energy"];
+
+                expectWithinAbsoluteError((double) energy["band_2"], (double) lastFrame["total_energy_db"], 0.5);
+                expectLessThan((double) energy["band_1"], (double) energy["band_2"] - 20.0);
+                expectLessThan((double) energy["band_3"], (double) energy["band_2"] - 20.0);
+                expectWithinAbsoluteError((double) lastFrame["peak_frequency_hz"], 350.0, sampleRate / 1024.0);
+            }
+
+            // And leave them when it is turned off
+            processor.setMultibandSettings({});
+            render(processor, 1000.0);
+            expect(findBand(processor, "band_1") == nullptr);
+        }
+
+        beginTest("Oversampling without ADAA latency");
+        {
+            FXPluginProcessor multiband, oversampledOnly;
+            multiband.setMultibandSettings(makeSettings(3));
+            multiband.setWaveshaperAntiAliasing(2, 1);
+            oversampledOnly.setWaveshaperAntiAliasing(0, 1);
+
+            const auto multibandLevel = render(multiband, 1000.0);
+            render(oversampledOnly, 1000.0);
+
+            expect(multiband.getLatencySamples() > 0);
+            expectEquals(multiband.getLatencySamples(), oversampledOnly.getLatencySamples());
+            expectWithinAbsoluteError(multibandLevel, 0.5f, 0.005f);
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 480;
+    static constexpr int numBlocks = 40;
+
+    static FXPluginProcessor::MultibandSettings makeSettings(int numBands)
+    {
+        FXPluginProcessor::MultibandSettings settings;
+        settings.enabled = true;
+        settings.numBands = numBands;
+        settings.crossoverFrequencies = { numBands == 2 ? 1000.0f : 200.0f, 2000.0f, 8000.0f };
+        return settings;
+    }
+
+    static void setValue(FXPluginProcessor& processor, const juce::String& id, float value)
+    {
+        auto* parameter = processor.getParameterTree().getParameter(id);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    static const FXPluginProcessor::FrequencyBand* findBand(FXPluginProcessor& processor, const juce::String& name)
+    {
+        for (const auto& band : processor.getAnalysisBands())
+            if (band.name == name)
+                return &band;
+
+        return nullptr;
+    }
+
+    // A 0.5 amplitude sine on both channels, offline so every hop is analysed. Returns
+    // the output's peak over the last quarter, once the crossovers have settled.
+    static float render(FXPluginProcessor& processor, double frequency, bool doublePrecision = false,
+                        std::function<void()> afterPrepare = {})
+    {
+        if (doublePrecision)
+            processor.setProcessingPrecision(juce::AudioProcessor::doublePrecision);
+
+        processor.setNonRealtime(true);
+
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        if (afterPrepare)
+            afterPrepare();
+
+        juce::AudioBuffer<float> floatBuffer(2, blockSize);
+        juce::AudioBuffer<double> doubleBuffer(2, blockSize);
+        juce::MidiBuffer midi;
+        auto peak = 0.0;
+
+        for (int block = 0; block < numBlocks; ++block) {
+            for (int i = 0; i < blockSize; ++i) {
+                const auto time = (block * blockSize + i) / sampleRate;
+                const auto sample = 0.5 * std::sin(juce::MathConstants<double>::twoPi * frequency * time);
+
+                for (int channel = 0; channel < 2; ++channel) {
+                    floatBuffer.setSample(channel, i, (float) sample);
+                    doubleBuffer.setSample(channel, i, sample);
+                }
+            }
+
+            if (doublePrecision)
+                processor.processBlock(doubleBuffer, midi);
+            else
+                processor.processBlock(floatBuffer, midi);
+
+            if (block >= numBlocks * 3 / 4)
+                for (int channel = 0; channel < 2; ++channel)
+                    peak = std::max(peak, doublePrecision ? doubleBuffer.getMagnitude(channel, 0, blockSize)
+                                                          : (double) floatBuffer.getMagnitude(channel, 0, blockSize));
+        }
+
+        processor.releaseResources();
+        return (float) peak;
+    }
+};
+
+static MultibandTests multibandTests;
+
+#endif
@@ -0,0 +1,124 @@
+#include "../include/PluginProcessor.h"
+
+#if JUCE_UNIT_TESTS
+
+//==============================================================================
+// Drives the processor into the output limiter and checks the ceiling, the
+// reported latency and the gain reduction in the recording.
+class OutputLimiterTests final : public juce::UnitTest
+{
+public:
+    OutputLimiterTests() : juce::UnitTest("Output limiter", "FXPlugin") {}
+
+    void runTest() override
+    {
+        beginTest("Off by default");
+        {
+            FXPluginProcessor processor;
+            expect(!processor.getLimiterSettings().enabled);
+
+            render(processor, 0.5f);
+            expectEquals(processor.getLatencySamples(), 0);
+        }
+
+        beginTest("The output stays under the ceiling");
+        {
+            FXPluginProcessor processor;
+            processor.setLimiterSettings(makeSettings(-6.0f));
+
+            // A gain of 2 takes the sine to full scale, 6 dB over the ceiling
+            const auto output = render(processor, 2.0f);
+            const auto ceiling = juce::Decibels::decibelsToGain(-6.0f);
+
+            expectEquals(processor.getLatencySamples(), 240 + 5);
+
+            for (int channel = 0; channel < output.getNumChannels(); ++channel) {
+                const auto peak = output.getMagnitude(channel, 0, output.getNumSamples());
+                expect(peak <= ceiling * 1.001f, "peak " + juce::String(juce::Decibels::gainToDecibels(peak)) + " dB");
+                expect(peak > ceiling * 0.99f, "no more reduction than the ceiling needs");
+            }
+        }
+
+        beginTest("Frames carry the gain reduction");
+        {
+            juce::TemporaryFile recordingFile(".json");
+
+            FXPluginProcessor processor;
+            processor.setLimiterSettings(makeSettings(-6.0f));
+            processor.setOutputFilePath(recordingFile.getFile().getFullPathName());
+
+            render(processor, 2.0f, [&] { processor.startRecording(); });
+            processor.stopRecording();
+
+            const auto recording = juce::JSON::parse(recordingFile.getFile());
+            expectEquals((double) recording["limiter"]["ceiling_db"], -6.0);
+            expectEquals((int) recording["limiter"]["lookahead_samples"], 245);
+
+            auto* frames = recording["analysis"].getArray();
+            expect(frames != nullptr && frames->size() > 10);
+
+            if (frames != nullptr && frames->size() > 10) {
+                // A full-scale sine against a -6 dB ceiling
+                const auto& lastFrame = frames->getReference(frames->size() - 1);
+                const auto reduction = (double) lastFrame["limiter_gain_reduction_db"];
+                const auto peakReduction = (double) lastFrame["limiter_peak_gain_reduction_db"];
+
+                expectWithinAbsoluteError(reduction, 6.0, 0.1);
+                expect(peakReduction >= reduction - 0.01);
+            }
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 480;
+    static constexpr int numBlocks = 100;
+
+    static FXPluginProcessor::LimiterSettings makeSettings(float ceilingDb)
+    {
+        FXPluginProcessor::LimiterSettings settings;
+        settings.enabled = true;
+        settings.ceilingDb = ceilingDb;
+        return settings;
+    }
+
+    // A 0.5 amplitude 1 kHz sine on both channels, offline so every hop is analysed.
+    // Returns the output.
+    static juce::AudioBuffer<float> render(FXPluginProcessor& processor, float gain,
+                                           std::function<void()> afterPrepare = {})
+    {
+        auto* gainParameter = processor.getParameterTree().getParameter("gain");
+        gainParameter->setValueNotifyingHost(gainParameter->convertTo0to1(gain));
+
+        processor.setNonRealtime(true);
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        if (afterPrepare)
+            afterPrepare();
+
+        juce::AudioBuffer<float> buffer(2, blockSize), output(2, numBlocks * blockSize);
+        juce::MidiBuffer midi;
+
+        for (int block = 0; block < numBlocks; ++block) {
+            for (int i = 0; i < blockSize; ++i) {
+                const auto time = (block * blockSize + i) / sampleRate;
+                const auto sample = (float) (0.5 * std::sin(juce::MathConstants<double>::twoPi * 1000.0 * time));
+
+                for (int channel = 0; channel < 2; ++channel)
+                    buffer.setSample(channel, i, sample);
+            }
+
+            processor.processBlock(buffer, midi);
+
+            for (int channel = 0; channel < 2; ++channel)
+                output.copyFrom(channel, block * blockSize, buffer, channel, 0, blockSize);
+        }
+
+        return output;
+    }
+};
+
+static OutputLimiterTests outputLimiterTests;
+
+#endif
@@ -0,0 +1,296 @@
+#include "../include/PluginProcessor.h"
+
+#if JUCE_UNIT_TESTS
+
+//==============================================================================
+// Checks the SIMD kernels against plain loops in both precisions, renders the
+// processor in double precision against the float path, and logs what the
+// kernels save per block.
+class ProcessingKernelTests final : public juce::UnitTest
+{
+public:
+    ProcessingKernelTests() : juce::UnitTest("Processing kernels", "FXPlugin") {}
+
+    void runTest() override
+    {
+        beginTest("Kernels match plain loops, float");
+        checkKernels<float>();
+
+        beginTest("Kernels match plain loops, double");
+        checkKernels<double>();
+
+        beginTest("Double precision matches the float path");
+        {
+            // Plain tanh, then ADAA with oversampling and the limiter
+            checkDoublePrecision(false, 1.0e-5);
+            checkDoublePrecision(true, 1.0e-4);
+        }
+
+        beginTest("Processing kernels benchmark");
+        {
+            logMessage(juce::String(benchmarkBlockSize) + "-sample blocks, per channel:");
+            benchmark<float>("float");
+            benchmark<double>("double");
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 512;
+    static constexpr int benchmarkBlockSize = 512;
+
+    template <typename SampleType>
+    static std::vector<SampleType> makeNoise(juce::Random& random, int numSamples)
+    {
+        std::vector<SampleType> samples((size_t) numSamples);
+
+        for (auto& sample : samples)
+            sample = (SampleType) (random.nextDouble() * 2.0 - 1.0);
+
+        return samples;
+    }
+
+    template <typename SampleType>
+    void checkKernels()
+    {
+        auto random = getRandom();
+        const auto tolerance = (SampleType) (std::is_same_v<SampleType, float> ? 1.0e-6 : 1.0e-14);
+
+        // Odd lengths and offsets, so the scalar tail and unaligned loads are covered
+        for (const auto numSamples : { 0, 1, 3, 4, 7, 64, 509 }) {
+            for (const auto offset : { 0, 1, 3 }) {
+                auto data = makeNoise<SampleType>(random, numSamples + offset);
+                auto expected = data;
+                const auto startGain = (SampleType) 0.5, endGain = (SampleType) 1.75;
+
+                ProcessingKernels::applyGainRamp(data.data() + offset, numSamples, startGain, endGain);
+
+                for (int i = 0; i < numSamples; ++i)
+                    expected[(size_t) (offset + i)] *= startGain + (SampleType) i * (endGain - startGain) / (SampleType) numSamples;
+
+                auto maxError = SampleType();
+
+                for (size_t i = 0; i < data.size(); ++i)
+                    maxError = juce::jmax(maxError, std::abs(data[i] - expected[i]));
+
+                expectLessOrEqual(maxError, tolerance, "gain ramp over " + juce::String(numSamples) + " samples");
+            }
+        }
+
+        {
+            auto data = makeNoise<SampleType>(random, 37);
+            const auto expected = data;
+            const SampleType nonFinite[] = { std::numeric_limits<SampleType>::quiet_NaN(),
+                                             std::numeric_limits<SampleType>::infinity(),
+                                             -std::numeric_limits<SampleType>::infinity() };
+
+            // In the SIMD body, in adjacent lanes, and in the scalar tail
+            const std::vector<size_t> replaced { 0, 5, 6, 7, 17, 33, 34, 35, 36 };
+
+            for (size_t i = 0; i < replaced.size(); ++i)
+                data[replaced[i]] = nonFinite[i % 3];
+
+            ProcessingKernels::zeroNonFinite(data.data(), (int) data.size());
+
+            for (size_t i = 0; i < data.size(); ++i) {
+                const auto wasReplaced = std::find(replaced.begin(), replaced.end(), i) != replaced.end();
+                expect(data[i] == (wasReplaced ? SampleType() : expected[i]));
+            }
+        }
+
+        for (const auto numChannels : { 0, 1, 2, 3 }) {
+            for (const auto numSubtracted : { 0, 1, 2 }) {
+                constexpr int numSamples = 131, startSample = 5;
+                std::vector<std::vector<SampleType>> channels, subtracted;
+                std::vector<const SampleType*> channelPointers, subtractedPointers;
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                    channels.push_back(makeNoise<SampleType>(random, startSample + numSamples));
+
+                for (int channel = 0; channel < numSubtracted; ++channel)
+                    subtracted.push_back(makeNoise<SampleType>(random, startSample + numSamples));
+
+                for (auto& channel : channels)
+                    channelPointers.push_back(channel.data());
+
+                for (auto& channel : subtracted)
+                    subtractedPointers.push_back(channel.data());
+
+                std::vector<float> mono(numSamples);
+                ProcessingKernels::mixToMono(channelPointers.data(), numChannels,
+                                             subtractedPointers.data(), numSubtracted,
+                                             startSample, mono.data(), numSamples);
+
+                auto maxError = 0.0;
+
+                for (int i = 0; i < numSamples; ++i) {
+                    double sum = 0.0, subtractedSum = 0.0;
+
+                    for (auto& channel : channels)
+                        sum += (double) channel[(size_t) (startSample + i)];
+
+                    for (auto& channel : subtracted)
+                        subtractedSum += (double) channel[(size_t) (startSample + i)];
+
+                    const auto expected = (numChannels > 0 ? sum / numChannels : 0.0)
+                                        - (numSubtracted > 0 ? subtractedSum / numSubtracted : 0.0);
+                    maxError = juce::jmax(maxError, std::abs((double) mono[(size_t) i] - expected));
+                }
+
+                expectLessOrEqual(maxError, 1.0e-6, juce::String(numChannels) + " channels minus " + juce::String(numSubtracted));
+            }
+        }
+    }
+
+    // Renders the same noise through a float and a double instance, changing the gain
+    // and distortion part way so the ramps run too
+    void checkDoublePrecision(bool antiAliasedAndLimited, double tolerance)
+    {
+        FXPluginProcessor floatProcessor, doubleProcessor;
+        doubleProcessor.setProcessingPrecision(juce::AudioProcessor::doublePrecision);
+
+        for (auto* processor : { &floatProcessor, &doubleProcessor }) {
+            if (antiAliasedAndLimited) {
+                processor->setWaveshaperAntiAliasing(2, 1);
+
+                FXPluginProcessor::LimiterSettings settings;
+                settings.enabled = true;
+                settings.ceilingDb = -6.0f;
+                processor->setLimiterSettings(settings);
+            }
+
+            processor->getParameterTree().getParameter("distortion")->setValueNotifyingHost(0.5f);
+            processor->setPlayConfigDetails(2, 2, sampleRate, blockSize);
+            processor->prepareToPlay(sampleRate, blockSize);
+        }
+
+        expect(doubleProcessor.isUsingDoublePrecision());
+        expectEquals(doubleProcessor.getLatencySamples(), floatProcessor.getLatencySamples());
+
+        juce::AudioBuffer<float> floatBuffer(2, blockSize);
+        juce::AudioBuffer<double> doubleBuffer(2, blockSize);
+        juce::MidiBuffer midi;
+        auto random = getRandom();
+        auto maxError = 0.0, peak = 0.0;
+
+        RealtimeSanitiser::reset();
+
+        for (int block = 0; block < 200; ++block) {
+            if (block == 100)
+                for (auto* processor : { &floatProcessor, &doubleProcessor }) {
+                    processor->getParameterTree().getParameter("gain")->setValueNotifyingHost(0.6f);
+                    processor->getParameterTree().getParameter("distortion")->setValueNotifyingHost(0.8f);
+                }
+
+            for (int channel = 0; channel < 2; ++channel)
+                for (int i = 0; i < blockSize; ++i) {
+                    const auto sample = random.nextFloat() * 0.8f - 0.4f;
+                    floatBuffer.setSample(channel, i, sample);
+                    doubleBuffer.setSample(channel, i, (double) sample);
+                }
+
+            floatProcessor.processBlock(floatBuffer, midi);
+            doubleProcessor.processBlock(doubleBuffer, midi);
+
+            for (int channel = 0; channel < 2; ++channel)
+                for (int i = 0; i < blockSize; ++i) {
+                    maxError = juce::jmax(maxError, std::abs((double) floatBuffer.getSample(channel, i) - doubleBuffer.getSample(channel, i)));
+                    peak = juce::jmax(peak, std::abs(doubleBuffer.getSample(channel, i)));
+                }
+        }
+
+        expect(peak > 0.1, "the double path produces output");
+        expectLessOrEqual(maxError, tolerance);
+        expectEquals((int) RealtimeSanitiser::getNumViolations(), 0, RealtimeSanitiser::getFirstViolationReport());
+
+        floatProcessor.releaseResources();
+        doubleProcessor.releaseResources();
+    }
+
+    template <typename Function>
+    static double timeNanosecondsPerBlock(Function&& function)
+    {
+        constexpr int numBlocks = 20000;
+
+        // Warm up, then take the best of a few runs
+        function();
+        auto best = std::numeric_limits<double>::max();
+
+        for (int run = 0; run < 5; ++run) {
+            const auto start = juce::Time::getHighResolutionTicks();
+
+            for (int block = 0; block < numBlocks; ++block)
+                function();
+
+            const auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+            best = juce::jmin(best, seconds * 1.0e9 / numBlocks);
+        }
+
+        return best;
+    }
+
+    template <typename SampleType>
+    void benchmark(const juce::String& precision)
+    {
+        auto random = getRandom();
+        auto left = makeNoise<SampleType>(random, benchmarkBlockSize);
+        auto right = makeNoise<SampleType>(random, benchmarkBlockSize);
+        const SampleType* channels[] = { left.data(), right.data() };
+        std::vector<SampleType> scratch(benchmarkBlockSize);
+        std::vector<float> mono(benchmarkBlockSize);
+
+        // Ramps start from a fresh copy each time, as repeated gain would run the
+        // samples off to infinity or into denormals. Both sides pay for the copy.
+        const auto ramp = timeNanosecondsPerBlock([&] {
+            std::copy(left.begin(), left.end(), scratch.begin());
+            ProcessingKernels::applyGainRamp(scratch.data(), benchmarkBlockSize, (SampleType) 0.5, (SampleType) 1.5);
+        });
+
+        const auto plainRamp = timeNanosecondsPerBlock([&] {
+            std::copy(left.begin(), left.end(), scratch.begin());
+            const auto step = (SampleType) 1 / (SampleType) benchmarkBlockSize;
+
+            for (int i = 0; i < benchmarkBlockSize; ++i)
+                scratch[(size_t) i] *= (SampleType) 0.5 + (SampleType) i * step;
+        });
+
+        const auto scrub = timeNanosecondsPerBlock([&] {
+            ProcessingKernels::zeroNonFinite(left.data(), benchmarkBlockSize);
+        });
+
+        const auto plainScrub = timeNanosecondsPerBlock([&] {
+            for (auto& sample : left)
+                if (!std::isfinite(sample))
+                    sample = SampleType();
+        });
+
+        const auto mix = timeNanosecondsPerBlock([&] {
+            ProcessingKernels::mixToMono(channels, 2, channels, 1, 0, mono.data(), benchmarkBlockSize);
+        });
+
+        // The per-sample loop over channels that the analysis used before
+        const auto plainMix = timeNanosecondsPerBlock([&] {
+            for (int i = 0; i < benchmarkBlockSize; ++i) {
+                SampleType sum = 0;
+
+                for (int channel = 0; channel < 2; ++channel)
+                    sum += channels[channel][i];
+
+                mono[(size_t) i] = (float) (sum / (SampleType) 2 - channels[0][i]);
+            }
+        });
+
+        const auto describe = [](double kernel, double plain) {
+            return juce::String(kernel, 0) + " ns (plain loop " + juce::String(plain, 0) + " ns, "
+                 + juce::String(plain / kernel, 1) + "x)";
+        };
+
+        logMessage(precision + ": gain ramp " + describe(ramp, plainRamp)
+                   + ", non-finite scrub " + describe(scrub, plainScrub)
+                   + ", mono mix of 2 minus 1 " + describe(mix, plainMix));
+    }
+};
+
+static ProcessingKernelTests processingKernelTests;
+
+#endif
@@ -0,0 +1,200 @@
+#include "../include/PluginProcessor.h"
+#include <thread>
+
+#if JUCE_UNIT_TESTS
+
+//==============================================================================
+// Saves and restores the binary state, and switches programs from a render
+// thread the way a host's audio thread would.
+class ProgramStateTests final : public juce::UnitTest
+{
+public:
+    ProgramStateTests() : juce::UnitTest("Programs and state", "FXPlugin") {}
+
+    void runTest() override
+    {
+        beginTest("Binary state round trip");
+        {
+            FXPluginProcessor source;
+            source.setCurrentProgram(3);
+            expectEquals(source.getCurrentProgram(), 3);
+            expectWithinAbsoluteError(getValue(source, "distortion"), 0.35f, 1.0e-6f);
+
+            // Edited after the switch, so the parameters no longer match the program
+            setValue(source, "gain", 2.5f);
+            source.changeProgramName(5, "Renamed");
+
+            juce::MemoryBlock state;
+            source.getStateInformation(state);
+            expect(state.getSize() < 512, "state is " + juce::String(state.getSize()) + " bytes");
+
+            FXPluginProcessor destination;
+            destination.setStateInformation(state.getData(), (int) state.getSize());
+
+            expectEquals(destination.getCurrentProgram(), 3);
+            expectWithinAbsoluteError(getValue(destination, "gain"), 2.5f, 1.0e-6f);
+            expectWithinAbsoluteError(getValue(destination, "distortion"), 0.35f, 1.0e-6f);
+            expectEquals(destination.getProgramName(5), juce::String("Renamed"));
+            expectEquals(destination.getProgramName(0), juce::String("Clean"));
+        }
+
+        beginTest("Parameters this version doesn't know are skipped");
+        {
+            // Written by a later version: a new parameter ahead of gain, then no programs
+            juce::MemoryOutputStream stream;
+            stream.writeInt(0x53505846);   // "FXPS"
+            stream.writeInt(FXPluginProcessor::stateFormatVersion);
+            stream.writeInt(2);
+            stream.writeString("gainMode");
+            stream.writeFloat(1.0f);
+            stream.writeString("gain");
+            stream.writeFloat(1.5f);
+            stream.writeInt(0);
+            stream.writeInt(0);
+            stream.writeInt(0);
+
+            FXPluginProcessor destination;
+            destination.setStateInformation(stream.getData(), (int) stream.getDataSize());
+
+            expectWithinAbsoluteError(getValue(destination, "gain"), 1.5f, 1.0e-6f);
+            expectWithinAbsoluteError(getValue(destination, "distortion"), 0.0f, 1.0e-6f);
+        }
+
+        beginTest("XML state from earlier versions still loads");
+        {
+            FXPluginProcessor source;
+            setValue(source, "gain", 0.75f);
+            setValue(source, "distortion", 0.6f);
+
+            std::unique_ptr<juce::XmlElement> xml(source.getParameterTree().copyState().createXml());
+            juce::MemoryBlock state;
+            juce::AudioProcessor::copyXmlToBinary(*xml, state);
+
+            FXPluginProcessor destination;
+            destination.setStateInformation(state.getData(), (int) state.getSize());
+
+            expectWithinAbsoluteError(getValue(destination, "gain"), 0.75f, 1.0e-6f);
+            expectWithinAbsoluteError(getValue(destination, "distortion"), 0.6f, 1.0e-6f);
+        }
+
+        beginTest("A switch on the message thread reaches the parameters at once");
+        {
+            // Some hosts create plugins on a background thread
+            std::unique_ptr<FXPluginProcessor> processor;
+            std::thread([&] { processor = std::make_unique<FXPluginProcessor>(); }).join();
+
+            expect(juce::MessageManager::existsAndIsCurrentThread());
+            processor->setCurrentProgram(1);
+            expectWithinAbsoluteError(getValue(*processor, "gain"), 2.0f, 1.0e-6f);
+        }
+
+        beginTest("Program switches on the audio thread ramp without allocating");
+        {
+            // Clean to Boost doubles the gain; Boost to Crunch turns the waveshaper on
+            const auto boost = renderSwitch(1);
+            const auto rampSamples = juce::roundToInt(FXPluginProcessor::parameterRampSeconds * sampleRate);
+
+            expectEquals(boost.numViolations, 0, boost.violationReport);
+            expectWithinAbsoluteError(boost.output[switchSample - 1], 0.25f, 1.0e-6f);
+            expectWithinAbsoluteError(boost.output[switchSample + rampSamples / 2], 0.375f, 0.01f);
+            expectWithinAbsoluteError(boost.output.back(), 0.5f, 1.0e-6f);
+            expectLessOrEqual(boost.largestStep, 0.25f / (float) rampSamples * 1.5f);
+            expect(boost.parametersFollowed, "the parameters follow the program");
+
+            const auto crunch = renderSwitch(3);
+            expectEquals(crunch.numViolations, 0, crunch.violationReport);
+            expectWithinAbsoluteError(crunch.output.back(), std::tanh(0.25f * 3.5f), 1.0e-5f);
+            expectLessOrEqual(crunch.largestStep, 0.01f);
+
+            const auto antiAliasedCrunch = renderSwitch(3, true);
+            expectEquals(antiAliasedCrunch.numViolations, 0, antiAliasedCrunch.violationReport);
+            expectWithinAbsoluteError(antiAliasedCrunch.output.back(), std::tanh(0.25f * 3.5f), 1.0e-3f);
+            expectLessOrEqual(antiAliasedCrunch.largestStep, 0.01f);
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 64;
+    static constexpr int numBlocks = 1500;
+    static constexpr int switchBlock = 100;
+    static constexpr int switchSample = switchBlock * blockSize;
+
+    struct SwitchResult {
+        std::vector<float> output;
+        float largestStep = 0.0f;
+        int numViolations = 0;
+        juce::String violationReport;
+        bool parametersFollowed = false;
+    };
+
+    static float getValue(FXPluginProcessor& processor, const juce::String& id)
+    {
+        auto* parameter = processor.getParameterTree().getParameter(id);
+        return parameter->convertFrom0to1(parameter->getValue());
+    }
+
+    static void setValue(FXPluginProcessor& processor, const juce::String& id, float value)
+    {
+        auto* parameter = processor.getParameterTree().getParameter(id);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    // Renders DC at 0.25 in realtime on another thread, switching from the Clean
+    // program to another one inside processBlock's realtime scope
+    SwitchResult renderSwitch(int program, bool antiAliased = false)
+    {
+        FXPluginProcessor processor;
+
+        if (antiAliased)
+            processor.setWaveshaperAntiAliasing(2, 1);
+
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        SwitchResult result;
+        result.output.reserve(numBlocks * blockSize);
+
+        std::thread audioThread([&] {
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            juce::MidiBuffer midi;
+
+            RealtimeSanitiser::reset();
+
+            for (int block = 0; block < numBlocks; ++block) {
+                for (int channel = 0; channel < 2; ++channel)
+                    juce::FloatVectorOperations::fill(buffer.getWritePointer(channel), 0.25f, blockSize);
+
+                if (block == switchBlock) {
+                    const RealtimeSanitiser::ScopedRealtime scope;
+                    processor.setCurrentProgram(program);
+                }
+
+                processor.processBlock(buffer, midi);
+                result.output.insert(result.output.end(), buffer.getReadPointer(0), buffer.getReadPointer(0) + blockSize);
+
+                // Roughly realtime, so housekeeping publishes the program during the render
+                if (block % 16 == 0)
+                    juce::Thread::sleep(1);
+            }
+
+            result.numViolations = (int) RealtimeSanitiser::getNumViolations();
+            result.violationReport = RealtimeSanitiser::getFirstViolationReport();
+        });
+
+        audioThread.join();
+        processor.releaseResources();
+
+        // From a block before the switch, once the oversampling filters have settled
+        for (size_t i = switchSample - blockSize; i < result.output.size(); ++i)
+            result.largestStep = juce::jmax(result.largestStep, std::abs(result.output[i] - result.output[i - 1]));
+
+        result.parametersFollowed = processor.getCurrentProgram() == program
+                                 && std::abs(getValue(processor, "gain") - (program == 1 ? 2.0f : 1.0f)) < 1.0e-6f;
+        return result;
+    }
+};
+
+static ProgramStateTests programStateTests;
+
+#endif
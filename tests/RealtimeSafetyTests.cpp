@@ -0,0 +1,194 @@
+#include "../include/PluginProcessor.h"
+
+#if JUCE_UNIT_TESTS
+
+//==============================================================================
+// Runs processBlock under the realtime sanitiser in each processing mode, and
+// fails on any allocation, lock or blocking call it reports.
+class RealtimeSafetyTests final : public juce::UnitTest
+{
+public:
+    RealtimeSafetyTests() : juce::UnitTest("Realtime safety", "FXPlugin") {}
+
+    void runTest() override
+    {
+        beginTest("Sanitiser reports violations");
+        expect(RealtimeSanitiser::isCompiledIn(), "The test runner must be built with FXPLUGIN_REALTIME_SANITISER");
+        checkSanitiser();
+
+        juce::TemporaryFile impulseResponseFile(".wav");
+        juce::TemporaryFile recordingFile(".json");
+        writeImpulseResponse(impulseResponseFile.getFile());
+
+        beginTest("processBlock: plain waveshaper");
+        checkProcessBlock([](FXPluginProcessor&) {});
+
+        beginTest("processBlock: anti-aliased waveshaper");
+        checkProcessBlock([](FXPluginProcessor& processor) { processor.setWaveshaperAntiAliasing(2, 1); });
+
+        beginTest("processBlock: multiband waveshaper");
+        checkProcessBlock([](FXPluginProcessor& processor) {
+            FXPluginProcessor::MultibandSettings settings;
+            settings.enabled = true;
+            settings.numBands = 4;
+            processor.setMultibandSettings(settings);
+            processor.setWaveshaperAntiAliasing(0, 1);
+            processor.getParameterTree().getParameter("band2Drive")->setValueNotifyingHost(0.5f);
+            processor.getParameterTree().getParameter("band4Gain")->setValueNotifyingHost(0.2f);
+        });
+
+        beginTest("processBlock: watch frequencies and constant-Q");
+        checkProcessBlock([](FXPluginProcessor& processor) {
+            processor.setWatchedFrequencies({ 50.0f, 60.0f, 1000.0f });
+            processor.setConstantQ(24);
+        });
+
+        beginTest("processBlock: pre-FX and difference analysis");
+        checkProcessBlock([](FXPluginProcessor& processor) { processor.setAnalysisSource(FXPluginProcessor::AnalysisSource::mainPreFX); });
+        checkProcessBlock([](FXPluginProcessor& processor) { processor.setAnalysisSource(FXPluginProcessor::AnalysisSource::mainMinusSidechain); });
+
+        beginTest("processBlock: cabinet IR");
+        checkProcessBlock([&](FXPluginProcessor& processor) {
+            processor.loadCabinetImpulseResponse(impulseResponseFile.getFile());
+        });
+
+        beginTest("processBlock: output limiter");
+        checkProcessBlock([&](FXPluginProcessor& processor) {
+            FXPluginProcessor::LimiterSettings settings;
+            settings.enabled = true;
+            settings.ceilingDb = -12.0f;
+            processor.setLimiterSettings(settings);
+            processor.setOutputFilePath(recordingFile.getFile().getFullPathName());
+        }, true);
+
+        beginTest("processBlock: recording with an onset trigger");
+        checkProcessBlock([&](FXPluginProcessor& processor) {
+            CaptureTrigger::Settings settings;
+            settings.mode = CaptureTrigger::Mode::onset;
+            processor.setTriggerSettings(settings);
+            processor.setOutputFilePath(recordingFile.getFile().getFullPathName());
+        }, true);
+    }
+
+private:
+    template <typename Action>
+    static uint64_t countViolations(Action&& action)
+    {
+        const auto before = RealtimeSanitiser::getNumViolations();
+
+        {
+            const RealtimeSanitiser::ScopedRealtime scope;
+            action();
+        }
+
+        return RealtimeSanitiser::getNumViolations() - before;
+    }
+
+    void checkSanitiser()
+    {
+        RealtimeSanitiser::reset();
+
+        std::unique_ptr<int> pointer;
+        juce::CriticalSection criticalSection;
+        juce::SpinLock spinLock;
+        juce::WaitableEvent event;
+        juce::Semaphore semaphore;
+
+        expect(countViolations([&] { pointer = std::make_unique<int>(1); }) > 0, "allocation");
+        expect(countViolations([&] { pointer.reset(); }) > 0, "deallocation");
+        expect(countViolations([&] { const juce::ScopedLock lock(criticalSection); }) > 0, "CriticalSection::enter");
+        expect(countViolations([&] { const juce::SpinLock::ScopedLockType lock(spinLock); }) > 0, "SpinLock::enter");
+        expect(countViolations([&] { event.signal(); }) > 0, "WaitableEvent::signal");
+
+        expectEquals((int) countViolations([&] { const juce::SpinLock::ScopedTryLockType lock(spinLock); }), 0, "tryEnter");
+        expectEquals((int) countViolations([&] { semaphore.post(); }), 0, "waking a thread");
+        expectEquals((int) countViolations([&] { const RealtimeSanitiser::ScopedAllow allow; pointer = std::make_unique<int>(2); }), 0, "ScopedAllow");
+
+        // Only the first violation is reported, with where it happened
+        const auto report = RealtimeSanitiser::getFirstViolationReport();
+        expect(report.contains("inside a realtime scope"), report);
+        expect(juce::StringArray::fromLines(report).size() > 2, "stack trace");
+
+        if (RealtimeSanitiser::interceptsSystemCalls()) {
+            expect(countViolations([] { juce::Thread::sleep(1); }) > 0, "sleep");
+
+            RealtimeSanitiser::reset();
+            expect(countViolations([] { try { throw 1; } catch (int) {} }) > 0, "throw");
+            expect(RealtimeSanitiser::getFirstViolationReport().contains("__cxa_allocate_exception"));
+        }
+
+        RealtimeSanitiser::reset();
+    }
+
+    template <typename Setup>
+    void checkProcessBlock(Setup&& setup, bool record = false)
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int maxBlockSize = 512;
+
+        FXPluginProcessor processor;
+        setup(processor);
+        processor.getParameterTree().getParameter("distortion")->setValueNotifyingHost(0.6f);
+        processor.setPlayConfigDetails(2, 2, sampleRate, maxBlockSize);
+        processor.prepareToPlay(sampleRate, maxBlockSize);
+
+        if (record)
+            processor.startRecording();
+
+        // Hosts may send blocks up to twice the announced size
+        juce::AudioBuffer<float> buffer(2, 2 * maxBlockSize);
+        juce::MidiBuffer midi;
+        auto random = getRandom();
+
+        RealtimeSanitiser::reset();
+
+        for (int block = 0; block < 400; ++block) {
+            const int numSamples = block % 50 == 49 ? 2 * maxBlockSize : 1 + random.nextInt(maxBlockSize);
+            buffer.setSize(2, numSamples, false, false, true);
+
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                for (int i = 0; i < numSamples; ++i)
+                    buffer.setSample(channel, i, random.nextFloat() * 0.5f - 0.25f);
+
+            processor.processBlock(buffer, midi);
+
+            // Give the background threads roughly realtime conditions
+            if (block % 20 == 0)
+                juce::Thread::sleep(5);
+        }
+
+        expectEquals((int) RealtimeSanitiser::getNumViolations(), 0, RealtimeSanitiser::getFirstViolationReport());
+
+        if (record)
+            processor.stopRecording();
+
+        processor.releaseResources();
+    }
+
+    static void writeImpulseResponse(const juce::File& file)
+    {
+        juce::AudioBuffer<float> impulseResponse(2, 24000);
+        juce::Random random(1);
+
+        for (int channel = 0; channel < impulseResponse.getNumChannels(); ++channel)
+            for (int i = 0; i < impulseResponse.getNumSamples(); ++i)
+                impulseResponse.setSample(channel, i, (random.nextFloat() - 0.5f) * std::exp(-i / 4000.0f));
+
+        juce::WavAudioFormat wav;
+        auto stream = file.createOutputStream();
+
+        if (stream == nullptr)
+            return;
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), 48000.0, 2, 24, {}, 0));
+
+        if (writer != nullptr) {
+            stream.release();
+            writer->writeFromAudioSampleBuffer(impulseResponse, 0, impulseResponse.getNumSamples());
+        }
+    }
+};
+
+static RealtimeSafetyTests realtimeSafetyTests;
+
+#endif
@@ -0,0 +1,157 @@
+#include "../include/PluginProcessor.h"
+
+#if JUCE_UNIT_TESTS
+
+//==============================================================================
+// Records with each analysis source from an offline render, where every hop is
+// analysed, and checks the recording describes the signal that was selected.
+class SidechainAnalysisTests final : public juce::UnitTest
+{
+public:
+    SidechainAnalysisTests() : juce::UnitTest("Sidechain analysis", "FXPlugin") {}
+
+    void runTest() override
+    {
+        using Source = FXPluginProcessor::AnalysisSource;
+
+        beginTest("Sidechain layouts");
+        {
+            FXPluginProcessor processor;
+            expect(!processor.isSidechainConnected(), "the sidechain is off by default");
+            expect(processor.setBusesLayout(makeLayout(juce::AudioChannelSet::mono())));
+            expect(processor.isSidechainConnected());
+            expect(processor.setBusesLayout(makeLayout(juce::AudioChannelSet::stereo())));
+            expect(processor.setBusesLayout(makeLayout(juce::AudioChannelSet::disabled())));
+            expect(!processor.isSidechainConnected());
+            expect(!processor.setBusesLayout(makeLayout(juce::AudioChannelSet::create5point1())));
+        }
+
+        beginTest("The sidechain doesn't reach the output");
+        {
+            FXPluginProcessor plain, withSidechain;
+            withSidechain.setAnalysisSource(Source::sidechain);
+
+            const auto plainOutput = render(plain, juce::AudioChannelSet::disabled(), 1000.0f, 0.0f);
+            const auto sidechainOutput = render(withSidechain, juce::AudioChannelSet::stereo(), 1000.0f, 3000.0f);
+
+            expect(std::memcmp(plainOutput.getReadPointer(0), sidechainOutput.getReadPointer(0),
+                               sizeof(float) * (size_t) plainOutput.getNumSamples()) == 0);
+        }
+
+        beginTest("Each source is what gets analysed");
+        {
+            // Compared with the same sines analysed on the main bus, in the recording's own units
+            const auto peak1k = recordPeakFrequency(Source::mainPostFX, 1000.0f, 0.0f);
+            const auto peak3k = recordPeakFrequency(Source::mainPostFX, 3000.0f, 0.0f);
+            expect(peak1k > 0.0f && peak3k > peak1k);
+
+            // With the gain at 0 only pre-FX analysis still sees the input
+            expectEquals(recordPeakFrequency(Source::mainPreFX, 1000.0f, 3000.0f, 0.0f), peak1k);
+            expectEquals(recordPeakFrequency(Source::sidechain, 1000.0f, 3000.0f), peak3k);
+            expectEquals(recordPeakFrequency(Source::sidechain, 0.0f, 3000.0f), peak3k);
+            expectEquals(recordPeakFrequency(Source::mainMinusSidechain, 1000.0f, 3000.0f, 0.0f), peak3k);
+            expectEquals(recordPeakFrequency(Source::mainMinusSidechain, 1000.0f, 0.0f), peak1k);
+        }
+
+        beginTest("Post-FX minus an identical sidechain nulls");
+        {
+            const auto recording = record(Source::mainMinusSidechain, 1000.0f, 1000.0f);
+            auto loudestDb = -200.0;
+
+            for (const auto& frame : *recording["analysis"].getArray())
+                loudestDb = juce::jmax(loudestDb, (double) frame["rms_db"]);
+
+            expect(loudestDb < -80.0, "loudest frame " + juce::String(loudestDb) + " dB");
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 480;
+    static constexpr int numBlocks = 100;
+
+    static juce::AudioProcessor::BusesLayout makeLayout(const juce::AudioChannelSet& sidechain)
+    {
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses = { juce::AudioChannelSet::stereo(), sidechain };
+        layout.outputBuses = { juce::AudioChannelSet::stereo() };
+        return layout;
+    }
+
+    // Sines on both channels of the main input and the sidechain; 0 Hz is silence.
+    // Returns the main output.
+    static juce::AudioBuffer<float> render(FXPluginProcessor& processor, const juce::AudioChannelSet& sidechain,
+                                           float mainFrequency, float sidechainFrequency,
+                                           std::function<void()> afterPrepare = {})
+    {
+        processor.setNonRealtime(true);
+        processor.setBusesLayout(makeLayout(sidechain));
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        if (afterPrepare)
+            afterPrepare();
+
+        juce::AudioBuffer<float> buffer(4, blockSize), output(2, numBlocks * blockSize);
+        juce::MidiBuffer midi;
+
+        for (int block = 0; block < numBlocks; ++block) {
+            for (int i = 0; i < blockSize; ++i) {
+                const auto time = (block * blockSize + i) / sampleRate;
+                const auto mainSample = (float) (0.5 * std::sin(juce::MathConstants<double>::twoPi * mainFrequency * time));
+                const auto sidechainSample = (float) (0.5 * std::sin(juce::MathConstants<double>::twoPi * sidechainFrequency * time));
+
+                for (int channel = 0; channel < 2; ++channel) {
+                    buffer.setSample(channel, i, mainSample);
+                    buffer.setSample(2 + channel, i, sidechainSample);
+                }
+            }
+
+            processor.processBlock(buffer, midi);
+
+            for (int channel = 0; channel < 2; ++channel)
+                output.copyFrom(channel, block * blockSize, buffer, channel, 0, blockSize);
+        }
+
+        return output;
+    }
+
+    static juce::var record(FXPluginProcessor::AnalysisSource source, float mainFrequency, float sidechainFrequency,
+                            float gain = 1.0f)
+    {
+        juce::TemporaryFile recordingFile(".json");
+
+        FXPluginProcessor processor;
+        processor.setAnalysisSource(source);
+        processor.setOutputFilePath(recordingFile.getFile().getFullPathName());
+        auto* gainParameter = processor.getParameterTree().getParameter("gain");
+        gainParameter->setValueNotifyingHost(gainParameter->convertTo0to1(gain));
+
+        render(processor, juce::AudioChannelSet::stereo(), mainFrequency, sidechainFrequency,
+               [&] { processor.startRecording(); });
+
+        processor.stopRecording();
+        return juce::JSON::parse(recordingFile.getFile());
+    }
+
+    // The most common peak frequency over the recording's frames
+    static float recordPeakFrequency(FXPluginProcessor::AnalysisSource source, float mainFrequency,
+                                     float sidechainFrequency, float gain = 1.0f)
+    {
+        const auto recording = record(source, mainFrequency, sidechainFrequency, gain);
+        std::map<int, int> counts;
+
+        if (auto* frames = recording["analysis"].getArray())
+            for (const auto& frame : *frames)
+                ++counts[(int) frame["peak_frequency_hz"]];
+
+        auto mostCommon = std::max_element(counts.begin(), counts.end(),
+                                           [](const auto& a, const auto& b) { return a.second < b.second; });
+
+        return mostCommon != counts.end() ? (float) mostCommon->first : -1.0f;
+    }
+};
+
+static SidechainAnalysisTests sidechainAnalysisTests;
+
+#endif